@@ -0,0 +1,197 @@
+/* Copyright 2024 Esri
+ *
+ * Licensed under the Apache License Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "BatchGenerateCallbackProxy.h"
+
+#include "Async/Async.h"
+#include "GenerateCompletedCallbackProxy.h"
+#include "VitruvioComponent.h"
+#include "VitruvioModule.h"
+
+UBatchGenerateCallbackProxy* UBatchGenerateCallbackProxy::SetAttributesForComponents(UObject* WorldContextObject,
+																					   const TArray<FVitruvioComponentAttributes>& ComponentAttributes,
+																					   bool bGenerateModels)
+{
+	UBatchGenerateCallbackProxy* Proxy = NewObject<UBatchGenerateCallbackProxy>();
+	Proxy->RegisterWithGameInstance(WorldContextObject);
+	Proxy->bShouldGenerateModels = bGenerateModels;
+
+	TArray<UVitruvioComponent*> ComponentsWithoutAttributes;
+	for (const FVitruvioComponentAttributes& Entry : ComponentAttributes)
+	{
+		UVitruvioComponent* VitruvioComponent = Entry.VitruvioComponent;
+		if (!VitruvioComponent)
+		{
+			UE_LOG(LogVitruvioComponent, Error, TEXT("Cannot execute \"SetAttributesForComponents\" without valid VitruvioComponent argument."))
+			continue;
+		}
+
+		VitruvioComponent->Initialize();
+		if (!VitruvioComponent->HasValidInputData())
+		{
+			UE_LOG(LogVitruvioComponent, Warning, TEXT("Skipping %s in \"SetAttributesForComponents\" since it has no initial shape or Rule Package."),
+				   *VitruvioComponent->GetOwner()->GetName())
+			continue;
+		}
+
+		Proxy->VitruvioComponents.Add(VitruvioComponent);
+		Proxy->Attributes.Add(Entry.Attributes);
+
+		if (!VitruvioComponent->GetAttributesReady())
+		{
+			ComponentsWithoutAttributes.Add(VitruvioComponent);
+		}
+	}
+
+	if (Proxy->VitruvioComponents.IsEmpty())
+	{
+		// Complete asynchronously so that the caller can register for the completion events first
+		AsyncTask(ENamedThreads::GameThread, [WeakProxy = TWeakObjectPtr<UBatchGenerateCallbackProxy>(Proxy)]() {
+			if (WeakProxy.IsValid())
+			{
+				WeakProxy->Complete();
+			}
+		});
+		return Proxy;
+	}
+
+	// Components which have never been evaluated have no attributes yet on which the new values could be set
+	if (ComponentsWithoutAttributes.IsEmpty())
+	{
+		Proxy->SetAttributesAndEvaluate();
+	}
+	else
+	{
+		Proxy->EvaluateAttributes(ComponentsWithoutAttributes, [Proxy]() { Proxy->SetAttributesAndEvaluate(); });
+	}
+
+	return Proxy;
+}
+
+void UBatchGenerateCallbackProxy::EvaluateAttributes(const TArray<UVitruvioComponent*>& Components, TFunction<void()> OnEvaluated)
+{
+	TArray<FInitialShape> InitialShapes;
+	TArray<TWeakObjectPtr<UVitruvioComponent>> EvaluatedComponents;
+	for (UVitruvioComponent* VitruvioComponent : Components)
+	{
+		InitialShapes.Add(VitruvioComponent->CreateInitialShape());
+		EvaluatedComponents.Add(VitruvioComponent);
+	}
+
+	FBatchAttributeMapResult AttributesResult = VitruvioModule::Get().BatchEvaluateRuleAttributesAsync(MoveTemp(InitialShapes));
+
+	// clang-format off
+	AttributesResult.Result.Next([WeakThis = TWeakObjectPtr<UBatchGenerateCallbackProxy>(this), EvaluatedComponents = MoveTemp(EvaluatedComponents),
+		OnEvaluated = MoveTemp(OnEvaluated)](const FBatchAttributeMapResult::ResultType& Result)
+	{
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, EvaluatedComponents, OnEvaluated, AttributeMaps = Result.Value]()
+		{
+			if (!WeakThis.IsValid())
+			{
+				return;
+			}
+
+			for (int32 ComponentIndex = 0; ComponentIndex < EvaluatedComponents.Num(); ++ComponentIndex)
+			{
+				UVitruvioComponent* VitruvioComponent = EvaluatedComponents[ComponentIndex].Get();
+				if (VitruvioComponent && AttributeMaps.IsValidIndex(ComponentIndex) && AttributeMaps[ComponentIndex])
+				{
+					VitruvioComponent->ApplyEvaluatedAttributes(AttributeMaps[ComponentIndex]);
+				}
+			}
+
+			OnEvaluated();
+		});
+	});
+	// clang-format on
+}
+
+void UBatchGenerateCallbackProxy::SetAttributesAndEvaluate()
+{
+	TArray<UVitruvioComponent*> Components;
+	for (int32 ComponentIndex = 0; ComponentIndex < VitruvioComponents.Num(); ++ComponentIndex)
+	{
+		if (UVitruvioComponent* VitruvioComponent = VitruvioComponents[ComponentIndex].Get())
+		{
+			VitruvioComponent->SetAttributeValues(Attributes[ComponentIndex]);
+			Components.Add(VitruvioComponent);
+		}
+	}
+
+	EvaluateAttributes(Components, [this]() {
+		OnAttributesEvaluatedBlueprint.Broadcast();
+		OnAttributesEvaluated.Broadcast();
+
+		if (bShouldGenerateModels)
+		{
+			GenerateModels();
+		}
+		else
+		{
+			for (const TWeakObjectPtr<UVitruvioComponent>& VitruvioComponent : VitruvioComponents)
+			{
+				CompleteComponent(VitruvioComponent.Get());
+			}
+		}
+	});
+}
+
+void UBatchGenerateCallbackProxy::GenerateModels()
+{
+	for (const TWeakObjectPtr<UVitruvioComponent>& WeakComponent : VitruvioComponents)
+	{
+		UVitruvioComponent* VitruvioComponent = WeakComponent.Get();
+		if (!VitruvioComponent)
+		{
+			CompleteComponent(nullptr);
+			continue;
+		}
+
+		// Batch generated components are collected by their tile and generated together with all other components of the tile
+		UGenerateCompletedCallbackProxy* ComponentProxy = NewObject<UGenerateCompletedCallbackProxy>();
+		ComponentProxy->RegisterWithGameInstance(VitruvioComponent);
+		ComponentProxy->OnGenerateCompleted.AddLambda([WeakThis = TWeakObjectPtr<UBatchGenerateCallbackProxy>(this), WeakComponent]() {
+			if (WeakThis.IsValid())
+			{
+				WeakThis->CompleteComponent(WeakComponent.Get());
+			}
+		});
+		VitruvioComponent->Generate(ComponentProxy);
+	}
+}
+
+void UBatchGenerateCallbackProxy::CompleteComponent(UVitruvioComponent* VitruvioComponent)
+{
+	++NumCompleted;
+
+	// Components which have been destroyed in the meantime only count towards the progress
+	if (VitruvioComponent)
+	{
+		OnComponentCompletedBlueprint.Broadcast(VitruvioComponent, NumCompleted, VitruvioComponents.Num());
+		OnComponentCompleted.Broadcast(VitruvioComponent, NumCompleted, VitruvioComponents.Num());
+	}
+
+	if (NumCompleted == VitruvioComponents.Num())
+	{
+		Complete();
+	}
+}
+
+void UBatchGenerateCallbackProxy::Complete()
+{
+	OnCompletedBlueprint.Broadcast();
+	OnCompleted.Broadcast();
+	SetReadyToDestroy();
+}
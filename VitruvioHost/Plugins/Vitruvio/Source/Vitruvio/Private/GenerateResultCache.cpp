@@ -0,0 +1,150 @@
+/* Copyright 2024 Esri
+ *
+ * Licensed under the Apache License Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "GenerateResultCache.h"
+
+#include "PersistedGenerateResult.h"
+#include "RulePackage.h"
+#include "VitruvioModule.h"
+#include "VitruvioStats.h"
+
+#include "Async/Async.h"
+
+FGenerateResultKey::FGenerateResultKey(URulePackage* RulePackage, const FInitialShapePolygon& Polygon, TArray<TPair<FString, FString>> Attributes,
+									   int32 RandomSeed, const FGeneratedCollisionSettings& CollisionSettings)
+	: RulePackage(RulePackage), RulePackageDataHash(RulePackage ? RulePackage->GetDataHash() : 0), Polygon(Polygon),
+	  Attributes(MoveTemp(Attributes)), RandomSeed(RandomSeed), CollisionKey(CollisionSettings.ToCacheKey())
+{
+	Hash = HashCombine(GetTypeHash(this->RulePackage), GetTypeHash(RulePackageDataHash));
+	Hash = HashCombine(Hash, GetTypeHash(Vitruvio::GetPolygonHash(Polygon)));
+
+	// FString hashes are case insensitive, attribute values are not
+	for (const TPair<FString, FString>& Attribute : this->Attributes)
+	{
+		Hash = HashCombine(Hash, FCrc::StrCrc32(*Attribute.Key));
+		Hash = HashCombine(Hash, FCrc::StrCrc32(*Attribute.Value));
+	}
+
+	Hash = HashCombine(Hash, GetTypeHash(RandomSeed));
+	Hash = HashCombine(Hash, GetTypeHash(CollisionKey));
+}
+
+bool FGenerateResultKey::Equals(const FGenerateResultKey& Other) const
+{
+	if (Hash != Other.Hash || RulePackage != Other.RulePackage || RulePackageDataHash != Other.RulePackageDataHash ||
+		RandomSeed != Other.RandomSeed || CollisionKey != Other.CollisionKey || Attributes.Num() != Other.Attributes.Num())
+	{
+		return false;
+	}
+
+	for (int32 AttributeIndex = 0; AttributeIndex < Attributes.Num(); ++AttributeIndex)
+	{
+		const TPair<FString, FString>& Attribute = Attributes[AttributeIndex];
+		const TPair<FString, FString>& OtherAttribute = Other.Attributes[AttributeIndex];
+		if (!Attribute.Key.Equals(OtherAttribute.Key, ESearchCase::CaseSensitive) ||
+			!Attribute.Value.Equals(OtherAttribute.Value, ESearchCase::CaseSensitive))
+		{
+			return false;
+		}
+	}
+
+	return Polygon == Other.Polygon;
+}
+
+TFuture<FGenerateResultCache::FGenerateResultPtr> FGenerateResultCache::GetOrGenerateAsync(const FGenerateResultKey& Key,
+																							TUniqueFunction<FGenerateResultPtr()> Generate)
+{
+	{
+		FScopeLock Lock(&CacheCriticalSection);
+
+		if (FEntry* Entry = Cache.Find(Key))
+		{
+			Entry->LastAccess = ++AccessCounter;
+			return MakeFulfilledPromise<FGenerateResultPtr>(Entry->Result).GetFuture();
+		}
+
+		// Wait for the identical request which is already in flight instead of generating the same model again
+		if (TArray<TPromise<FGenerateResultPtr>>* Waiting = PendingResults.Find(Key))
+		{
+			return Waiting->AddDefaulted_GetRef().GetFuture();
+		}
+
+		PendingResults.Add(Key);
+	}
+
+	return Async(EAsyncExecution::Thread, [this, Key, Generate = MoveTemp(Generate)]() {
+		FGenerateResultPtr Result = Generate();
+		CompleteResult(Key, Result);
+		return Result;
+	});
+}
+
+void FGenerateResultCache::CompleteResult(const FGenerateResultKey& Key, const FGenerateResultPtr& Result)
+{
+	TArray<TPromise<FGenerateResultPtr>> Waiting;
+	{
+		FScopeLock Lock(&CacheCriticalSection);
+
+		PendingResults.RemoveAndCopyValue(Key, Waiting);
+
+		// Failed generate calls return an empty result and are retried by the next request
+		if (Result && (Result->GeneratedModel || !Result->Instances.IsEmpty()) && MaxEntries > 0)
+		{
+			Cache.Add(Key, {Result, ++AccessCounter});
+			Trim();
+		}
+	}
+
+	for (TPromise<FGenerateResultPtr>& Promise : Waiting)
+	{
+		Promise.SetValue(Result);
+	}
+}
+
+void FGenerateResultCache::SetMaxEntries(int32 NumEntries)
+{
+	FScopeLock Lock(&CacheCriticalSection);
+	MaxEntries = FMath::Max(NumEntries, 0);
+	Trim();
+}
+
+void FGenerateResultCache::Empty()
+{
+	FScopeLock Lock(&CacheCriticalSection);
+	Cache.Empty();
+	SET_DWORD_STAT(STAT_Vitruvio_GenerateResultCacheEntries, 0);
+}
+
+void FGenerateResultCache::Trim()
+{
+	// Every insert exceeds the limit by at most one entry, so only the least recently used entry is searched and removed instead of sorting
+	while (Cache.Num() > MaxEntries)
+	{
+		FSetElementId OldestId;
+		int64 OldestAccess = TNumericLimits<int64>::Max();
+		for (auto It = Cache.CreateConstIterator(); It; ++It)
+		{
+			if (It.Value().LastAccess < OldestAccess)
+			{
+				OldestAccess = It.Value().LastAccess;
+				OldestId = It.GetId();
+			}
+		}
+		Cache.Remove(OldestId);
+	}
+
+	SET_DWORD_STAT(STAT_Vitruvio_GenerateResultCacheEntries, Cache.Num());
+}
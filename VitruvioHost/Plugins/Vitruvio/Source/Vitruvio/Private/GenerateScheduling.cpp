@@ -0,0 +1,199 @@
+/* Copyright 2024 Esri
+ *
+ * Licensed under the Apache License Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "GenerateScheduling.h"
+
+#include "Algo/Sort.h"
+#include "HAL/Event.h"
+#include "Misc/ScopeLock.h"
+#include "RulePackage.h"
+
+namespace
+{
+// A small footprint with few vertices has a cost of about one
+constexpr double BaseCost = 1.0;
+constexpr double CostPerSquareMeter = 0.01;
+constexpr double CostPerVertex = 0.05;
+
+// Used for rule packages which have not been generated yet (if no other rule package has been generated either)
+constexpr double DefaultSecondsPerCost = 0.001;
+constexpr double ObservationWeight = 0.25;
+
+double GetArea(const TArray<FVector>& Vertices, const TArray<int32>& Indices)
+{
+	// Newell's method, also correct for non planar and concave polygons
+	FVector Normal = FVector::ZeroVector;
+	for (int32 Index = 0; Index < Indices.Num(); ++Index)
+	{
+		const FVector& Current = Vertices[Indices[Index]];
+		const FVector& Next = Vertices[Indices[(Index + 1) % Indices.Num()]];
+		Normal += FVector::CrossProduct(Current, Next);
+	}
+	return Normal.Size() / 2.0;
+}
+} // namespace
+
+namespace Vitruvio
+{
+double EstimateGeometryCost(const FInitialShapePolygon& Polygon)
+{
+	double Area = 0.0;
+	for (const FInitialShapeFace& Face : Polygon.Faces)
+	{
+		Area += GetArea(Polygon.Vertices, Face.Indices);
+		for (const FInitialShapeHole& Hole : Face.Holes)
+		{
+			Area -= GetArea(Polygon.Vertices, Hole.Indices);
+		}
+	}
+
+	const double AreaSquareMeters = FMath::Max(0.0, Area) / 10000.0;
+	return BaseCost + AreaSquareMeters * CostPerSquareMeter + Polygon.Vertices.Num() * CostPerVertex;
+}
+
+TArray<int32> GetLongestFirstOrder(const TArray<double>& Costs, const TArray<int32>& ShapeIndices)
+{
+	check(ShapeIndices.IsEmpty() || ShapeIndices.Num() == Costs.Num());
+
+	TArray<int32> Order;
+	Order.Reserve(Costs.Num());
+	for (int32 Index = 0; Index < Costs.Num(); ++Index)
+	{
+		Order.Add(Index);
+	}
+
+	// Ties are broken by the shape index so that the order does not depend on how the costs have been collected
+	auto GetShapeIndex = [&ShapeIndices](int32 Index) { return ShapeIndices.IsEmpty() ? Index : ShapeIndices[Index]; };
+	Algo::Sort(Order, [&Costs, &GetShapeIndex](int32 A, int32 B)
+	{
+		return Costs[A] != Costs[B] ? Costs[A] > Costs[B] : GetShapeIndex(A) < GetShapeIndex(B);
+	});
+	return Order;
+}
+
+int32 GetUsefulWorkerThreads(const TArray<double>& Costs, int32 MaxThreads)
+{
+	double TotalCost = 0.0;
+	double MaxCost = 0.0;
+	for (const double Cost : Costs)
+	{
+		TotalCost += Cost;
+		MaxCost = FMath::Max(MaxCost, Cost);
+	}
+
+	const int32 NumThreads = MaxCost > 0.0 ? FMath::CeilToInt32(TotalCost / MaxCost) : Costs.Num();
+	return FMath::Clamp(FMath::Min(NumThreads, Costs.Num()), 1, FMath::Max(1, MaxThreads));
+}
+
+double FGenerateCostModel::GetSecondsPerCost(const URulePackage* RulePackage) const
+{
+	FScopeLock ScopeLock(&Lock);
+
+	if (const double* Rate = SecondsPerCost.Find(RulePackage))
+	{
+		return *Rate;
+	}
+
+	if (SecondsPerCost.IsEmpty())
+	{
+		return DefaultSecondsPerCost;
+	}
+
+	double RateSum = 0.0;
+	for (const auto& [Key, Rate] : SecondsPerCost)
+	{
+		RateSum += Rate;
+	}
+	return RateSum / SecondsPerCost.Num();
+}
+
+void FGenerateCostModel::Observe(const URulePackage* RulePackage, double GeometryCost, double Seconds)
+{
+	if (GeometryCost <= 0.0 || Seconds <= 0.0)
+	{
+		return;
+	}
+
+	const double ObservedRate = Seconds / GeometryCost;
+
+	FScopeLock ScopeLock(&Lock);
+
+	if (double* Rate = SecondsPerCost.Find(RulePackage))
+	{
+		*Rate = FMath::Lerp(*Rate, ObservedRate, ObservationWeight);
+	}
+	else
+	{
+		SecondsPerCost.Add(RulePackage, ObservedRate);
+	}
+}
+
+int32 FWorkerThreadBudget::Acquire(int32 Requested, int32 Budget)
+{
+	Budget = FMath::Max(1, Budget);
+
+	FScopeLock ScopeLock(&Lock);
+
+	++NumActiveRequests;
+
+	// Calls which are already waiting are not overtaken, even if a thread is available for this call
+	if (!Waiters.IsEmpty() || NumThreadsInUse >= Budget)
+	{
+		FEventRef WakeUp;
+		Waiters.Add(&*WakeUp);
+		while (Waiters[0] != &*WakeUp || NumThreadsInUse >= Budget)
+		{
+			FScopeUnlock ScopeUnlock(&Lock);
+			WakeUp->Wait();
+		}
+		Waiters.RemoveAt(0);
+	}
+
+	// The fair share also counts the waiting calls so that the first call does not take the threads of all calls behind it
+	const int32 FairShare = FMath::Max(1, Budget / NumActiveRequests);
+	const int32 Available = Budget - NumThreadsInUse;
+	const int32 NumThreads = FMath::Clamp(FMath::Min(FairShare, Available), 1, FMath::Max(1, Requested));
+	NumThreadsInUse += NumThreads;
+
+	// Threads may be left for the next waiting call
+	WakeUpFirstWaiting();
+	return NumThreads;
+}
+
+void FWorkerThreadBudget::Release(int32 NumThreads)
+{
+	FScopeLock ScopeLock(&Lock);
+
+	NumThreadsInUse -= NumThreads;
+	--NumActiveRequests;
+
+	WakeUpFirstWaiting();
+}
+
+int32 FWorkerThreadBudget::GetNumWaiting() const
+{
+	FScopeLock ScopeLock(&Lock);
+	return Waiters.Num();
+}
+
+void FWorkerThreadBudget::WakeUpFirstWaiting()
+{
+	if (!Waiters.IsEmpty())
+	{
+		Waiters[0]->Trigger();
+	}
+}
+} // namespace Vitruvio
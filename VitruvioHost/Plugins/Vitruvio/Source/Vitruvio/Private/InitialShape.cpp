@@ -14,7 +14,9 @@
  */
 
 #include "InitialShape.h"
+#include "PolygonValidation.h"
 #include "PolygonWindings.h"
+#include "VertexHashGrid.h"
 #include "StaticMeshAttributes.h"
 #include "VitruvioComponent.h"
 
@@ -24,6 +26,8 @@
 #include "Misc/MessageDialog.h"
 #include "UObject/SavePackage.h"
 
+DEFINE_LOG_CATEGORY_STATIC(LogInitialShape, Log, All);
+
 namespace
 {
 template <typename T>
@@ -80,46 +84,6 @@ FMeshDescription CreateMeshDescription(const FInitialShapePolygon& InPolygon)
 	return Description;
 }
 
-// Returns false if all faces are degenerate or true otherwise
-bool HasValidGeometry(const FInitialShapePolygon& Polygon)
-{
-	// 1. Construct MeshDescription from Polygon
-	FMeshDescription Description = CreateMeshDescription(Polygon);
-
-	// 2. Triangulate as the input initial shape is in non triangulated form
-	Description.TriangulateMesh();
-
-	// 3. Check if any of the triangles is NOT degenerate (which means the polygon has valid geometry) if all
-	// faces are degenerate we return false (meaning non valid geometry)
-	const float ComparisonThreshold = 0.0001;
-	const float AdjustedComparisonThreshold = FMath::Max(ComparisonThreshold, MIN_flt);
-
-	FStaticMeshAttributes Attributes(Description);
-	const auto VertexPositions = Attributes.GetVertexPositions();
-	for (const FPolygonID& PolygonID : Description.Polygons().GetElementIDs())
-	{
-		for (const FTriangleID TriangleID : Description.GetPolygonTriangles(PolygonID))
-		{
-			TArrayView<const FVertexInstanceID> TriangleVertexInstances = Description.GetTriangleVertexInstances(TriangleID);
-			const FVertexID VertexID0 = Description.GetVertexInstanceVertex(TriangleVertexInstances[0]);
-			const FVertexID VertexID1 = Description.GetVertexInstanceVertex(TriangleVertexInstances[1]);
-			const FVertexID VertexID2 = Description.GetVertexInstanceVertex(TriangleVertexInstances[2]);
-
-			const FVector3f Position0 = VertexPositions[VertexID0];
-			const FVector3f DPosition1 = VertexPositions[VertexID1] - Position0;
-			const FVector3f DPosition2 = VertexPositions[VertexID2] - Position0;
-
-			FVector3f TmpNormal = FVector3f::CrossProduct(DPosition2, DPosition1).GetSafeNormal(AdjustedComparisonThreshold);
-			if (!TmpNormal.IsNearlyZero(ComparisonThreshold))
-			{
-				return true;
-			}
-		}
-	}
-
-	return false;
-}
-
 FInitialShapePolygon CreateInitialPolygonFromStaticMesh(const UStaticMesh* StaticMesh)
 {
 	if (!StaticMesh)
@@ -132,40 +96,45 @@ FInitialShapePolygon CreateInitialPolygonFromStaticMesh(const UStaticMesh* Stati
 	TArray<FTextureCoordinateSet> MeshTextureCoordinateSets;
 	MeshTextureCoordinateSets.AddDefaulted(8);
 
-	if (StaticMesh->GetRenderData() && StaticMesh->GetRenderData()->LODResources.IsValidIndex(0))
+	if (StaticMesh->GetRenderData() && StaticMesh->GetRenderData()->LODResources.IsValidIndex(0) &&
+		!StaticMesh->GetRenderData()->LODResources[0].Sections.IsEmpty())
 	{
-		TArray<int32> RemappedIndices;
 		const FStaticMeshLODResources& LOD = StaticMesh->GetRenderData()->LODResources[0];
+		const uint32 NumVertices = LOD.VertexBuffers.PositionVertexBuffer.GetNumVertices();
 
-		for (auto SectionIndex = 0; SectionIndex < LOD.Sections.Num(); ++SectionIndex)
+		// All sections share the same vertex buffer, so we only need to deduplicate the vertices once
+		TArray<int32> RemappedIndices;
+		RemappedIndices.SetNumUninitialized(NumVertices);
+		MeshVertices.Reserve(NumVertices);
+
+		Vitruvio::FVertexHashGrid VertexHashGrid(NumVertices);
+		for (uint32 VertexIndex = 0; VertexIndex < NumVertices; ++VertexIndex)
 		{
-			for (uint32 VertexIndex = 0; VertexIndex < LOD.VertexBuffers.PositionVertexBuffer.GetNumVertices(); ++VertexIndex)
-			{
-				FVector Vertex = FVector(LOD.VertexBuffers.PositionVertexBuffer.VertexPosition(VertexIndex));
+			FVector Vertex = FVector(LOD.VertexBuffers.PositionVertexBuffer.VertexPosition(VertexIndex));
 
-				auto VertexFindPredicate = [Vertex](const FVector& In) {
-					return Vertex.Equals(In);
-				};
-				int32 MappedVertexIndex = MeshVertices.IndexOfByPredicate(VertexFindPredicate);
+			int32 MappedVertexIndex = VertexHashGrid.Find(Vertex, MeshVertices);
 
-				if (MappedVertexIndex == INDEX_NONE)
-				{
-					RemappedIndices.Add(MeshVertices.Num());
-					MeshVertices.Add(Vertex);
-					for (uint32 TextCoordIndex = 0; TextCoordIndex < LOD.VertexBuffers.StaticMeshVertexBuffer.GetNumTexCoords(); ++TextCoordIndex)
-					{
-						FVector2f TexCoord = LOD.VertexBuffers.StaticMeshVertexBuffer.GetVertexUV(VertexIndex, TextCoordIndex);
-						MeshTextureCoordinateSets[TextCoordIndex].TextureCoordinates.Add(TexCoord);
-					}
-				}
-				else
+			if (MappedVertexIndex == INDEX_NONE)
+			{
+				RemappedIndices[VertexIndex] = MeshVertices.Num();
+				VertexHashGrid.Add(Vertex, MeshVertices.Num());
+				MeshVertices.Add(Vertex);
+				for (uint32 TextCoordIndex = 0; TextCoordIndex < LOD.VertexBuffers.StaticMeshVertexBuffer.GetNumTexCoords(); ++TextCoordIndex)
 				{
-					RemappedIndices.Add(MappedVertexIndex);
+					FVector2f TexCoord = LOD.VertexBuffers.StaticMeshVertexBuffer.GetVertexUV(VertexIndex, TextCoordIndex);
+					MeshTextureCoordinateSets[TextCoordIndex].TextureCoordinates.Add(TexCoord);
 				}
 			}
+			else
+			{
+				RemappedIndices[VertexIndex] = MappedVertexIndex;
+			}
+		}
 
+		const FIndexArrayView IndicesView = LOD.IndexBuffer.GetArrayView();
+		for (auto SectionIndex = 0; SectionIndex < LOD.Sections.Num(); ++SectionIndex)
+		{
 			const FStaticMeshSection& Section = LOD.Sections[SectionIndex];
-			FIndexArrayView IndicesView = LOD.IndexBuffer.GetArrayView();
 
 			for (uint32 Triangle = 0; Triangle < Section.NumTriangles; ++Triangle)
 			{
@@ -413,7 +382,17 @@ void FInitialShapePolygon::FixOrientation()
 void UInitialShape::SetPolygon(const FInitialShapePolygon& NewPolygon)
 {
 	Polygon = NewPolygon;
-	bIsPolygonValid = HasValidGeometry(Polygon);
+
+	const Vitruvio::FPolygonValidationResult ValidationResult = Vitruvio::ValidatePolygon(Polygon);
+	bIsPolygonValid = ValidationResult.bHasValidGeometry;
+
+	if (UE_LOG_ACTIVE(LogInitialShape, Verbose))
+	{
+		for (const Vitruvio::FPolygonIssue& Issue : ValidationResult.Issues)
+		{
+			UE_LOG(LogInitialShape, Verbose, TEXT("Initial shape polygon of %s: %s"), *GetPathName(), *Issue.ToString());
+		}
+	}
 }
 
 const TArray<FVector>& UInitialShape::GetVertices() const
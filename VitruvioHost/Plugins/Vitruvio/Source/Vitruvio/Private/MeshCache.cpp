@@ -15,6 +15,8 @@
 
 #include "MeshCache.h"
 
+#include "VitruvioStats.h"
+
 TSharedPtr<FVitruvioMesh> FMeshCache::Get(const FString& Id)
 {
 	FScopeLock Lock(&MeshCacheCriticalSection);
@@ -32,6 +34,7 @@ TSharedPtr<FVitruvioMesh> FMeshCache::InsertOrGet(const FString& Id, const TShar
 		return *Result;
 	}
 	Cache.Add(Id, Mesh);
+	INC_MEMORY_STAT_BY(STAT_Vitruvio_MeshCacheMemory, Mesh->GetAllocatedSize());
 	return Mesh;
 }
 
@@ -39,4 +42,5 @@ void FMeshCache::Empty()
 {
 	FScopeLock Lock(&MeshCacheCriticalSection);
 	Cache.Empty();
+	SET_MEMORY_STAT(STAT_Vitruvio_MeshCacheMemory, 0);
 }
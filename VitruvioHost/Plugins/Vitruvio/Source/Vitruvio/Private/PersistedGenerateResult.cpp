@@ -0,0 +1,372 @@
+/* Copyright 2024 Esri
+ *
+ * Licensed under the Apache License Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "PersistedGenerateResult.h"
+
+#include "Async/Async.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "Serialization/CustomVersion.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "UObject/ObjectVersion.h"
+
+namespace
+{
+// Increment whenever the layout of the serialized data changes. Results persisted with another version are generated again.
+constexpr int32 PersistedGenerateResultVersion = 2;
+
+const FString RpkFolderPlaceholder = TEXT("{RpkFolder}");
+
+bool ReplaceTexturePaths(TArray<Vitruvio::FMaterialAttributeContainer>& Materials, const FString& From, const FString& To)
+{
+	bool bReplaced = false;
+	for (Vitruvio::FMaterialAttributeContainer& Material : Materials)
+	{
+		for (auto& [Key, TexturePath] : Material.TextureProperties)
+		{
+			if (TexturePath.Contains(From, ESearchCase::CaseSensitive))
+			{
+				TexturePath.ReplaceInline(*From, *To, ESearchCase::CaseSensitive);
+				bReplaced = true;
+			}
+		}
+	}
+	return bReplaced;
+}
+
+void SerializeCollisionData(FArchive& Ar, FCollisionData& CollisionData)
+{
+	uint8 CollisionType = static_cast<uint8>(CollisionData.CollisionType);
+	Ar << CollisionType;
+	CollisionData.CollisionType = static_cast<EGeneratedCollisionType>(CollisionType);
+
+	int32 NumIndices = CollisionData.Indices.Num();
+	Ar << NumIndices;
+	if (Ar.IsLoading())
+	{
+		CollisionData.Indices.SetNumUninitialized(FMath::Max(NumIndices, 0));
+	}
+	for (FTriIndices& Triangle : CollisionData.Indices)
+	{
+		Ar << Triangle.v0 << Triangle.v1 << Triangle.v2;
+	}
+
+	Ar << CollisionData.Vertices << CollisionData.MaterialIndices << CollisionData.Boxes << CollisionData.ConvexHulls;
+}
+
+void SaveMesh(FArchive& Ar, const FVitruvioMesh& Mesh, bool& bUsesRulePackageTextures)
+{
+	FString Identifier = Mesh.GetIdentifier();
+	TArray<Vitruvio::FMaterialAttributeContainer> Materials = Mesh.GetMaterials();
+	bUsesRulePackageTextures |= ReplaceTexturePaths(Materials, VitruvioModule::Get().GetRpkFolderUri(), RpkFolderPlaceholder);
+
+	// Archives only serialize mutable data, the mesh is shared with the generated components and is therefore saved from copies
+	FMeshDescription MeshDescription = Mesh.GetMeshDescription();
+	FCollisionData CollisionData = Mesh.GetCollisionData() ? *Mesh.GetCollisionData() : FCollisionData();
+
+	Ar << Identifier << MeshDescription << Materials;
+	SerializeCollisionData(Ar, CollisionData);
+}
+
+TSharedPtr<FVitruvioMesh> LoadMesh(FArchive& Ar)
+{
+	FString Identifier;
+	FMeshDescription MeshDescription;
+	TArray<Vitruvio::FMaterialAttributeContainer> Materials;
+	FCollisionData CollisionData;
+
+	Ar << Identifier << MeshDescription << Materials;
+	SerializeCollisionData(Ar, CollisionData);
+	if (Ar.IsError())
+	{
+		return {};
+	}
+
+	ReplaceTexturePaths(Materials, RpkFolderPlaceholder, VitruvioModule::Get().GetRpkFolderUri());
+	return MakeShared<FVitruvioMesh>(Identifier, MeshDescription, Materials, MoveTemp(CollisionData));
+}
+
+template <typename T>
+void SerializeStructMap(FArchive& Ar, TMap<FString, T>& Map)
+{
+	int32 Num = Map.Num();
+	Ar << Num;
+	if (Ar.IsLoading())
+	{
+		for (int32 Index = 0; Index < Num && !Ar.IsError(); ++Index)
+		{
+			FString Key;
+			T Value;
+			Ar << Key;
+			T::StaticStruct()->SerializeItem(Ar, &Value, nullptr);
+			Map.Add(MoveTemp(Key), MoveTemp(Value));
+		}
+	}
+	else
+	{
+		for (auto& [Key, Value] : Map)
+		{
+			Ar << Key;
+			T::StaticStruct()->SerializeItem(Ar, &Value, nullptr);
+		}
+	}
+}
+
+} // namespace
+
+namespace Vitruvio
+{
+
+uint64 GetPolygonHash(const FInitialShapePolygon& Polygon)
+{
+	FXxHash64Builder Builder;
+
+	// Every array is prefixed by its length so that elements can not move from one array to the next without changing the hash
+	auto AppendArray = [&Builder](const auto& Array)
+	{
+		const int32 Num = Array.Num();
+		Builder.Update(&Num, sizeof(Num));
+		Builder.Update(Array.GetData(), Array.Num() * Array.GetTypeSize());
+	};
+
+	AppendArray(Polygon.Vertices);
+	for (const FInitialShapeFace& Face : Polygon.Faces)
+	{
+		AppendArray(Face.Indices);
+
+		const int32 NumHoles = Face.Holes.Num();
+		Builder.Update(&NumHoles, sizeof(NumHoles));
+		for (const FInitialShapeHole& Hole : Face.Holes)
+		{
+			AppendArray(Hole.Indices);
+		}
+	}
+
+	for (const FTextureCoordinateSet& TextureCoordinateSet : Polygon.TextureCoordinateSets)
+	{
+		AppendArray(TextureCoordinateSet.TextureCoordinates);
+	}
+
+	return Builder.Finalize().Hash;
+}
+
+void AppendStringHash(FXxHash64Builder& Builder, const FString& String)
+{
+	const int32 Len = String.Len();
+	Builder.Update(&Len, sizeof(Len));
+	Builder.Update(*String, Len * sizeof(TCHAR));
+}
+
+FPersistedGenerateResult PersistGenerateResult(const FGenerateResultDescription& Result, uint64 InputHash)
+{
+	FPersistedGenerateResult PersistedResult;
+	PersistedResult.InputHash = InputHash;
+
+	TArray<uint8> Payload;
+	FMemoryWriter PayloadWriter(Payload, true);
+
+	bool bHasGeneratedModel = Result.GeneratedModel.IsValid();
+	PayloadWriter << bHasGeneratedModel;
+	if (bHasGeneratedModel)
+	{
+		SaveMesh(PayloadWriter, *Result.GeneratedModel, PersistedResult.bUsesRulePackageTextures);
+	}
+
+	int32 NumInstanceMeshes = Result.InstanceMeshes.Num();
+	PayloadWriter << NumInstanceMeshes;
+	for (const auto& [MeshId, InstanceMesh] : Result.InstanceMeshes)
+	{
+		FString Id = MeshId;
+		FString Name = Result.InstanceNames.FindRef(MeshId);
+		PayloadWriter << Id << Name;
+		SaveMesh(PayloadWriter, *InstanceMesh, PersistedResult.bUsesRulePackageTextures);
+	}
+
+	int32 NumInstances = Result.Instances.Num();
+	PayloadWriter << NumInstances;
+	for (const auto& [Key, Transforms] : Result.Instances)
+	{
+		FInstanceCacheKey PersistedKey = Key;
+		PersistedResult.bUsesRulePackageTextures |=
+			ReplaceTexturePaths(PersistedKey.MaterialOverrides, VitruvioModule::Get().GetRpkFolderUri(), RpkFolderPlaceholder);
+		TArray<FTransform> PersistedTransforms = Transforms;
+		PayloadWriter << PersistedKey << PersistedTransforms;
+	}
+
+	TMap<FString, FReport> Reports = Result.Reports;
+	TMap<FString, FReportStatistics> ReportStatistics = Result.ReportStatistics;
+	SerializeStructMap(PayloadWriter, Reports);
+	SerializeStructMap(PayloadWriter, ReportStatistics);
+
+	// The engine and custom versions used by the payload are stored in front of it, so that later engine versions can still read it
+	FMemoryWriter Writer(PersistedResult.Data, true);
+	int32 Version = PersistedGenerateResultVersion;
+	int32 FileVersionUE4 = GPackageFileUEVersion.FileVersionUE4;
+	int32 FileVersionUE5 = GPackageFileUEVersion.FileVersionUE5;
+	FCustomVersionContainer CustomVersions = PayloadWriter.GetCustomVersions();
+	Writer << Version << FileVersionUE4 << FileVersionUE5;
+	CustomVersions.Serialize(Writer);
+	Writer.Serialize(Payload.GetData(), Payload.Num());
+
+	return PersistedResult;
+}
+
+bool RestoreGenerateResult(const FPersistedGenerateResult& PersistedResult, const FGeneratedCollisionSettings& CollisionSettings,
+						   FGenerateResultDescription& OutResult)
+{
+	if (!PersistedResult.IsValid())
+	{
+		return false;
+	}
+
+	FMemoryReader Reader(PersistedResult.Data, true);
+
+	int32 Version = 0;
+	Reader << Version;
+	if (Version != PersistedGenerateResultVersion)
+	{
+		return false;
+	}
+
+	int32 FileVersionUE4 = 0;
+	int32 FileVersionUE5 = 0;
+	FCustomVersionContainer CustomVersions;
+	Reader << FileVersionUE4 << FileVersionUE5;
+	CustomVersions.Serialize(Reader);
+	if (Reader.IsError())
+	{
+		return false;
+	}
+	Reader.SetUEVer(FPackageFileVersion(FileVersionUE4, static_cast<EUnrealEngineObjectUE5Version>(FileVersionUE5)));
+	Reader.SetCustomVersions(CustomVersions);
+
+	FGenerateResultDescription Result;
+
+	bool bHasGeneratedModel = false;
+	Reader << bHasGeneratedModel;
+	if (bHasGeneratedModel)
+	{
+		Result.GeneratedModel = LoadMesh(Reader);
+		if (!Result.GeneratedModel)
+		{
+			return false;
+		}
+	}
+
+	int32 NumInstanceMeshes = 0;
+	Reader << NumInstanceMeshes;
+	for (int32 MeshIndex = 0; MeshIndex < NumInstanceMeshes && !Reader.IsError(); ++MeshIndex)
+	{
+		FString MeshId;
+		FString Name;
+		Reader << MeshId << Name;
+		TSharedPtr<FVitruvioMesh> InstanceMesh = LoadMesh(Reader);
+		if (!InstanceMesh)
+		{
+			return false;
+		}
+
+		// Meshes with different collision settings can not share their static mesh, see UnrealCallbacks::addMesh
+		const FString CacheKey = InstanceMesh->GetIdentifier() + TEXT("#") + CollisionSettings.ToCacheKey();
+		Result.InstanceMeshes.Add(MeshId, VitruvioModule::Get().GetMeshCache().InsertOrGet(CacheKey, InstanceMesh));
+		Result.InstanceNames.Add(MeshId, Name);
+	}
+
+	int32 NumInstances = 0;
+	Reader << NumInstances;
+	for (int32 InstanceIndex = 0; InstanceIndex < NumInstances && !Reader.IsError(); ++InstanceIndex)
+	{
+		FInstanceCacheKey Key;
+		TArray<FTransform> Transforms;
+		Reader << Key << Transforms;
+		ReplaceTexturePaths(Key.MaterialOverrides, RpkFolderPlaceholder, VitruvioModule::Get().GetRpkFolderUri());
+
+		if (!Result.InstanceMeshes.Contains(Key.MeshId))
+		{
+			return false;
+		}
+		Result.Instances.Add(MoveTemp(Key), MoveTemp(Transforms));
+	}
+
+	SerializeStructMap(Reader, Result.Reports);
+	SerializeStructMap(Reader, Result.ReportStatistics);
+
+	if (Reader.IsError())
+	{
+		return false;
+	}
+
+	OutResult = MoveTemp(Result);
+	return true;
+}
+
+TFuture<TOptional<FGenerateResultDescription>> RestoreGenerateResultAsync(FPersistedGenerateResult PersistedResult,
+																		  const TArray<URulePackage*>& RulePackages,
+																		  const FGeneratedCollisionSettings& CollisionSettings)
+{
+	struct FRestoreState
+	{
+		FPersistedGenerateResult PersistedResult;
+		FGeneratedCollisionSettings CollisionSettings;
+		TPromise<TOptional<FGenerateResultDescription>> Promise;
+		FThreadSafeCounter NumPendingLoads;
+	};
+
+	const TSharedRef<FRestoreState, ESPMode::ThreadSafe> State = MakeShared<FRestoreState, ESPMode::ThreadSafe>();
+	State->PersistedResult = MoveTemp(PersistedResult);
+	State->CollisionSettings = CollisionSettings;
+	TFuture<TOptional<FGenerateResultDescription>> Future = State->Promise.GetFuture();
+
+	// Continuations run on the thread which completes the load or on the calling thread if it is already loaded, restore on the pool instead
+	auto Restore = [State]()
+	{
+		Async(EAsyncExecution::ThreadPool, [State]()
+		{
+			FGenerateResultDescription Result;
+			if (RestoreGenerateResult(State->PersistedResult, State->CollisionSettings, Result))
+			{
+				State->Promise.SetValue(MoveTemp(Result));
+			}
+			else
+			{
+				State->Promise.SetValue({});
+			}
+		});
+	};
+
+	// Textures inside a Rule Package can only be decoded once the Rule Package has been extracted for PRT
+	if (!State->PersistedResult.bUsesRulePackageTextures || RulePackages.IsEmpty())
+	{
+		Restore();
+		return Future;
+	}
+
+	State->NumPendingLoads.Set(RulePackages.Num());
+	for (URulePackage* RulePackage : RulePackages)
+	{
+		VitruvioModule::Get().LoadRulePackageAsync(RulePackage).Next([State, Restore](bool)
+		{
+			if (State->NumPendingLoads.Decrement() == 0)
+			{
+				Restore();
+			}
+		});
+	}
+
+	return Future;
+}
+
+} // namespace Vitruvio
@@ -0,0 +1,169 @@
+/* Copyright 2024 Esri
+ *
+ * Licensed under the Apache License Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Report.h"
+
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+namespace
+{
+FString GetTypeName(EReportPrimitiveType Type)
+{
+	return StaticEnum<EReportPrimitiveType>()->GetNameStringByValue(static_cast<int64>(Type));
+}
+
+FString EscapeCsv(const FString& Value)
+{
+	if (Value.Contains(TEXT(",")) || Value.Contains(TEXT("\"")) || Value.Contains(TEXT("\n")))
+	{
+		return TEXT("\"") + Value.Replace(TEXT("\""), TEXT("\"\"")) + TEXT("\"");
+	}
+	return Value;
+}
+
+TArray<const FReportStatistics*> SortByName(const TMap<FString, FReportStatistics>& Statistics)
+{
+	TArray<const FReportStatistics*> Sorted;
+	Sorted.Reserve(Statistics.Num());
+	for (const auto& [Name, ReportStatistics] : Statistics)
+	{
+		Sorted.Add(&ReportStatistics);
+	}
+	Sorted.Sort([](const FReportStatistics& A, const FReportStatistics& B) { return A.Name < B.Name; });
+	return Sorted;
+}
+} // namespace
+
+void FReportStatistics::Add(const FReport& Report)
+{
+	if (Count == 0)
+	{
+		Name = Report.Name;
+		Type = Report.Type;
+	}
+	else if (Type != Report.Type && IsNumeric() && Report.IsNumeric())
+	{
+		// The same report may be emitted as Int by one shape and as Float by another
+		Type = EReportPrimitiveType::Float;
+	}
+
+	++Count;
+
+	if (!Report.IsNumeric())
+	{
+		return;
+	}
+
+	// Min and Max are seeded by the first numeric report, preceding String reports have no value
+	Min = NumericCount == 0 ? Report.NumericValue : FMath::Min(Min, Report.NumericValue);
+	Max = NumericCount == 0 ? Report.NumericValue : FMath::Max(Max, Report.NumericValue);
+	Sum += Report.NumericValue;
+	++NumericCount;
+}
+
+void FReportStatistics::Merge(const FReportStatistics& Other)
+{
+	if (Other.Count == 0)
+	{
+		return;
+	}
+
+	if (Count == 0)
+	{
+		*this = Other;
+		return;
+	}
+
+	if (Type != Other.Type && IsNumeric() && Other.IsNumeric())
+	{
+		Type = EReportPrimitiveType::Float;
+	}
+
+	if (Other.NumericCount > 0)
+	{
+		Min = NumericCount == 0 ? Other.Min : FMath::Min(Min, Other.Min);
+		Max = NumericCount == 0 ? Other.Max : FMath::Max(Max, Other.Max);
+	}
+
+	Count += Other.Count;
+	NumericCount += Other.NumericCount;
+	Sum += Other.Sum;
+}
+
+bool FReportStatistics::IsNumeric() const
+{
+	return Type == EReportPrimitiveType::Float || Type == EReportPrimitiveType::Int || Type == EReportPrimitiveType::Bool;
+}
+
+namespace Vitruvio
+{
+void AddReports(TMap<FString, FReportStatistics>& Statistics, const TMap<FString, FReport>& Reports)
+{
+	for (const auto& [Name, Report] : Reports)
+	{
+		Statistics.FindOrAdd(Name).Add(Report);
+	}
+}
+
+void AddReport(TMap<FString, FReportStatistics>& Statistics, const FReport& Report)
+{
+	Statistics.FindOrAdd(Report.Name).Add(Report);
+}
+
+void MergeReportStatistics(TMap<FString, FReportStatistics>& Statistics, const TMap<FString, FReportStatistics>& Other)
+{
+	for (const auto& [Name, OtherStatistics] : Other)
+	{
+		Statistics.FindOrAdd(Name).Merge(OtherStatistics);
+	}
+}
+
+FString ReportStatisticsToCsv(const TMap<FString, FReportStatistics>& Statistics)
+{
+	FString Csv = TEXT("Name,Type,Count,Sum,Min,Max,Mean\n");
+	for (const FReportStatistics* ReportStatistics : SortByName(Statistics))
+	{
+		Csv += FString::Printf(TEXT("%s,%s,%d,%s,%s,%s,%s\n"), *EscapeCsv(ReportStatistics->Name), *GetTypeName(ReportStatistics->Type),
+							   ReportStatistics->Count, *FString::SanitizeFloat(ReportStatistics->Sum),
+							   *FString::SanitizeFloat(ReportStatistics->Min), *FString::SanitizeFloat(ReportStatistics->Max),
+							   *FString::SanitizeFloat(ReportStatistics->GetMean()));
+	}
+	return Csv;
+}
+
+FString ReportStatisticsToJson(const TMap<FString, FReportStatistics>& Statistics)
+{
+	TArray<TSharedPtr<FJsonValue>> Reports;
+	for (const FReportStatistics* ReportStatistics : SortByName(Statistics))
+	{
+		TSharedRef<FJsonObject> Report = MakeShared<FJsonObject>();
+		Report->SetStringField(TEXT("name"), ReportStatistics->Name);
+		Report->SetStringField(TEXT("type"), GetTypeName(ReportStatistics->Type));
+		Report->SetNumberField(TEXT("count"), ReportStatistics->Count);
+		Report->SetNumberField(TEXT("sum"), ReportStatistics->Sum);
+		Report->SetNumberField(TEXT("min"), ReportStatistics->Min);
+		Report->SetNumberField(TEXT("max"), ReportStatistics->Max);
+		Report->SetNumberField(TEXT("mean"), ReportStatistics->GetMean());
+		Reports.Add(MakeShared<FJsonValueObject>(Report));
+	}
+
+	FString Json;
+	const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Json);
+	FJsonSerializer::Serialize(Reports, Writer);
+	return Json;
+}
+} // namespace Vitruvio
@@ -0,0 +1,111 @@
+/* Copyright 2024 Esri
+ *
+ * Licensed under the Apache License Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "Engine/World.h"
+#include "GenerateCompletedCallbackProxy.h"
+#include "Misc/AutomationTest.h"
+#include "Tests/MockGenerateBackend.h"
+#include "Util/AttributeConversion.h"
+#include "VitruvioBatchActor.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace AttributeMapCacheTests
+{
+constexpr double TimeoutSeconds = 10.0;
+constexpr int32 TileSize = 10000;
+constexpr int32 NumComponents = 8;
+
+// Generates through the batch actor and ticks it like the engine would in a headless session until the generate has completed
+bool GenerateAndWait(AVitruvioBatchActor* BatchActor, UVitruvioComponent* VitruvioComponent)
+{
+	bool bCompleted = false;
+	UGenerateCompletedCallbackProxy* CallbackProxy = NewObject<UGenerateCompletedCallbackProxy>();
+	CallbackProxy->OnGenerateCompleted.AddLambda([&bCompleted]() { bCompleted = true; });
+	if (VitruvioComponent)
+	{
+		BatchActor->Generate(VitruvioComponent, CallbackProxy);
+	}
+	else
+	{
+		BatchActor->GenerateAll(CallbackProxy);
+	}
+
+	const double EndTime = FPlatformTime::Seconds() + TimeoutSeconds;
+	while (!bCompleted && FPlatformTime::Seconds() < EndTime)
+	{
+		BatchActor->Tick(0.0f);
+		FPlatformProcess::Sleep(0.001f);
+	}
+	return bCompleted;
+}
+} // namespace AttributeMapCacheTests
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAttributeMapCacheTileRegenerateTest, "Vitruvio.AttributeMapCache.TileRegenerate",
+								 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FAttributeMapCacheTileRegenerateTest::RunTest(const FString& Parameters)
+{
+	using namespace AttributeMapCacheTests;
+	using namespace VitruvioTests;
+
+	const FScopedMockGenerateBackend Backend;
+	URulePackage* RulePackage = CreateRulePackage();
+
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("AttributeMapCacheTileRegenerateTest"));
+	AVitruvioBatchActor* BatchActor = World->SpawnActor<AVitruvioBatchActor>();
+	BatchActor->GridDimension = {TileSize, TileSize};
+
+	// All components are in the same tile, a change of one of them regenerates the whole tile
+	TArray<UVitruvioComponent*> VitruvioComponents;
+	for (int32 ComponentIndex = 0; ComponentIndex < NumComponents; ++ComponentIndex)
+	{
+		UVitruvioComponent* VitruvioComponent = CreateVitruvioComponent(World, RulePackage, FVector(ComponentIndex * 100.0, 0.0, 0.0));
+		BatchActor->RegisterVitruvioComponent(VitruvioComponent);
+		VitruvioComponents.Add(VitruvioComponent);
+	}
+
+	const int32 NumAttributeMapsBefore = Vitruvio::GetNumCreatedAttributeMaps();
+	if (!TestTrue(TEXT("Initial generate completes"), GenerateAndWait(BatchActor, nullptr)))
+	{
+		World->DestroyWorld(false);
+		return false;
+	}
+	TestEqual(TEXT("Attribute maps built by the initial generate"), Vitruvio::GetNumCreatedAttributeMaps() - NumAttributeMapsBefore,
+			  NumComponents);
+
+	const AttributeMapSPtr UnchangedAttributeMap = VitruvioComponents[1]->GetAttributeMap();
+	const AttributeMapSPtr ChangedAttributeMap = VitruvioComponents[0]->GetAttributeMap();
+
+	const int32 NumAttributeMapsBeforeChange = Vitruvio::GetNumCreatedAttributeMaps();
+	VitruvioComponents[0]->MarkAttributesChanged();
+	TestTrue(TEXT("Regenerate after a change completes"), GenerateAndWait(BatchActor, VitruvioComponents[0]));
+	TestEqual(TEXT("Only the attribute map of the changed component is rebuilt"),
+			  Vitruvio::GetNumCreatedAttributeMaps() - NumAttributeMapsBeforeChange, 1);
+	TestTrue(TEXT("Unchanged components reuse their attribute map"), VitruvioComponents[1]->GetAttributeMap() == UnchangedAttributeMap);
+	TestTrue(TEXT("Changed component has a new attribute map"), VitruvioComponents[0]->GetAttributeMap() != ChangedAttributeMap);
+
+	const int32 NumAttributeMapsBeforeRegenerate = Vitruvio::GetNumCreatedAttributeMaps();
+	TestTrue(TEXT("Regenerate without changes completes"), GenerateAndWait(BatchActor, nullptr));
+	TestEqual(TEXT("No attribute map is rebuilt without changes"), Vitruvio::GetNumCreatedAttributeMaps() - NumAttributeMapsBeforeRegenerate,
+			  0);
+
+	TestTrue(TEXT("Waiting for idle succeeds"), VitruvioModule::Get().WaitUntilIdle(TimeoutSeconds));
+	World->DestroyWorld(false);
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,254 @@
+/* Copyright 2024 Esri
+ *
+ * Licensed under the Apache License Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "Async/ParallelFor.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/Guid.h"
+#include "PRTTypes.h"
+#include "RuleAttributes.h"
+#include "Util/AttributeConversion.h"
+#include "Util/AttributeNames.h"
+#include "VitruvioModule.h"
+#include "VitruvioTypes.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace AttributeNameTableTests
+{
+constexpr int32 NumNames = 100;
+constexpr int32 NumRequests = 100000;
+
+// Names which have not been interned by earlier runs
+FString CreateUniqueName(const TCHAR* Name)
+{
+	return FString::Printf(TEXT("%s_%s"), Name, *FGuid::NewGuid().ToString());
+}
+
+AttributeMapUPtr CreateMaterialAttributeMap()
+{
+	AttributeMapBuilderUPtr AttributeMapBuilder(prt::AttributeMapBuilder::create());
+	const double Color[] = {0.5, 0.25, 1.0};
+	const wchar_t* DiffuseMaps[] = {L"color.png", L"dirt.png"};
+	const wchar_t* NormalMaps[] = {L"normal.png"};
+	AttributeMapBuilder->setFloatArray(L"diffuseColor", Color, 3);
+	AttributeMapBuilder->setFloatArray(L"emissiveColor", Color, 3);
+	AttributeMapBuilder->setFloatArray(L"specularColor", Color, 3);
+	AttributeMapBuilder->setStringArray(L"diffuseMap", DiffuseMaps, 2);
+	AttributeMapBuilder->setStringArray(L"normalMap", NormalMaps, 1);
+	AttributeMapBuilder->setFloat(L"metallic", 0.5);
+	AttributeMapBuilder->setFloat(L"opacity", 1.0);
+	AttributeMapBuilder->setFloat(L"roughness", 0.75);
+	AttributeMapBuilder->setFloat(L"shininess", 10.0);
+	AttributeMapBuilder->setString(L"shader", L"CityEngineShader");
+	AttributeMapBuilder->setString(L"name", L"Facade");
+	return AttributeMapUPtr(AttributeMapBuilder->createAttributeMap(), PRTDestroyer());
+}
+
+TMap<FString, URuleAttribute*> CreateRuleAttributes(int32 NumAttributes)
+{
+	TMap<FString, URuleAttribute*> Attributes;
+	for (int32 AttributeIndex = 0; AttributeIndex < NumAttributes; ++AttributeIndex)
+	{
+		URuleAttribute* Attribute;
+		if (AttributeIndex % 2 == 0)
+		{
+			UFloatAttribute* FloatAttribute = NewObject<UFloatAttribute>();
+			FloatAttribute->Value = AttributeIndex;
+			Attribute = FloatAttribute;
+		}
+		else
+		{
+			UStringAttribute* StringAttribute = NewObject<UStringAttribute>();
+			StringAttribute->Value = TEXT("Residential");
+			Attribute = StringAttribute;
+		}
+		Attribute->Name = FString::Printf(TEXT("Default$Building.Attribute%d"), AttributeIndex);
+		Attribute->bUserSet = true;
+		Attributes.Add(Attribute->Name, Attribute);
+	}
+	return Attributes;
+}
+} // namespace AttributeNameTableTests
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAttributeNameTableInterningTest, "Vitruvio.AttributeNames.Interning",
+								 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FAttributeNameTableInterningTest::RunTest(const FString& Parameters)
+{
+	using namespace AttributeNameTableTests;
+	using namespace Vitruvio;
+
+	FAttributeNameTable& AttributeNameTable = FAttributeNameTable::Get();
+
+	const FString Name = CreateUniqueName(TEXT("buildingHeight"));
+	const FAttributeName& WideName = AttributeNameTable.FindOrAdd(TCHAR_TO_WCHAR(*Name));
+	const FAttributeName& StringName = AttributeNameTable.FindOrAdd(Name);
+	TestTrue(TEXT("Wide and FString names are interned once"), &WideName == &StringName);
+	TestEqual(TEXT("Interned name"), WideName.Name, Name);
+	TestTrue(TEXT("Interned wide name"), WideName.WideName == std::wstring(TCHAR_TO_WCHAR(*Name)));
+	TestEqual(TEXT("Name by id"), AttributeNameTable.GetName(WideName.Id), Name);
+	TestEqual(TEXT("First name of its case-insensitive names"), WideName.CaseInsensitiveId, WideName.Id);
+
+	const FAttributeName& UpperCaseName = AttributeNameTable.FindOrAdd(Name.ToUpper());
+	TestNotEqual(TEXT("Names which differ in case have different ids"), UpperCaseName.Id, WideName.Id);
+	TestEqual(TEXT("Names which differ in case share the case-insensitive id"), UpperCaseName.CaseInsensitiveId, WideName.Id);
+	TestEqual(TEXT("Names keep their case"), UpperCaseName.Name, Name.ToUpper());
+
+	// Requesters race to add the same names, all of them must get the same ids
+	const FString Prefix = CreateUniqueName(TEXT("Concurrent"));
+	TArray<const FAttributeName*> Names;
+	Names.SetNum(NumRequests);
+	ParallelFor(NumRequests, [&AttributeNameTable, &Prefix, &Names](int32 RequestIndex)
+	{
+		const FString ConcurrentName = FString::Printf(TEXT("%s%d"), *Prefix, RequestIndex % NumNames);
+		Names[RequestIndex] = RequestIndex % 2 == 0 ? &AttributeNameTable.FindOrAdd(ConcurrentName)
+													: &AttributeNameTable.FindOrAdd(TCHAR_TO_WCHAR(*ConcurrentName));
+	});
+
+	TSet<int32> Ids;
+	for (int32 RequestIndex = 0; RequestIndex < NumRequests; ++RequestIndex)
+	{
+		const FAttributeName* ConcurrentName = Names[RequestIndex];
+		if (!TestTrue(TEXT("Concurrent requesters get the same names"), ConcurrentName == Names[RequestIndex % NumNames]))
+		{
+			return false;
+		}
+		TestEqual(TEXT("Concurrently added name"), ConcurrentName->Name, FString::Printf(TEXT("%s%d"), *Prefix, RequestIndex % NumNames));
+		Ids.Add(ConcurrentName->Id);
+	}
+	TestEqual(TEXT("Every distinct name has its own id"), Ids.Num(), NumNames);
+
+	TestTrue(TEXT("Interned names stay valid while the table grows"), &AttributeNameTable.FindOrAdd(Name) == &WideName);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAttributeNameTableBenchmark, "Vitruvio.AttributeNames.Benchmark",
+								 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FAttributeNameTableBenchmark::RunTest(const FString& Parameters)
+{
+	using namespace AttributeNameTableTests;
+
+	if (!VitruvioModule::Get().IsInitialized())
+	{
+		AddWarning(TEXT("PRT is not initialized, the attribute maps can not be created"));
+		return true;
+	}
+
+	constexpr int32 NumMaterials = 100000;
+	constexpr int32 NumAttributeMaps = 10000;
+	constexpr int32 NumRuleAttributes = 50;
+
+	// Before: every key of every material was converted to an FString and looked up case-insensitively
+	const TMap<FString, int32> KeyToType = {{TEXT("diffuseColor"), 0}, {TEXT("emissiveColor"), 0}, {TEXT("diffuseMap"), 1},
+											{TEXT("normalMap"), 1},	   {TEXT("metallic"), 2},	   {TEXT("opacity"), 2},
+											{TEXT("roughness"), 2},	   {TEXT("shader"), 3}};
+	const AttributeMapUPtr MaterialAttributeMap = CreateMaterialAttributeMap();
+	size_t KeyCount = 0;
+	wchar_t const* const* Keys = MaterialAttributeMap->getKeys(&KeyCount);
+
+	int32 NumKnownKeys = 0;
+	const double ConvertedKeysStartTime = FPlatformTime::Seconds();
+	for (int32 MaterialIndex = 0; MaterialIndex < NumMaterials; ++MaterialIndex)
+	{
+		for (size_t KeyIndex = 0; KeyIndex < KeyCount; ++KeyIndex)
+		{
+			NumKnownKeys += KeyToType.Contains(FString(Keys[KeyIndex])) ? 1 : 0;
+		}
+	}
+	const double ConvertedKeysSeconds = FPlatformTime::Seconds() - ConvertedKeysStartTime;
+
+	Vitruvio::FAttributeNameTable& AttributeNameTable = Vitruvio::FAttributeNameTable::Get();
+	TMap<int32, int32> KeyIdToType;
+	for (const TPair<FString, int32>& KeyAndType : KeyToType)
+	{
+		KeyIdToType.Add(AttributeNameTable.FindOrAdd(KeyAndType.Key).CaseInsensitiveId, KeyAndType.Value);
+	}
+
+	int32 NumInternedKnownKeys = 0;
+	const double InternedKeysStartTime = FPlatformTime::Seconds();
+	for (int32 MaterialIndex = 0; MaterialIndex < NumMaterials; ++MaterialIndex)
+	{
+		for (size_t KeyIndex = 0; KeyIndex < KeyCount; ++KeyIndex)
+		{
+			NumInternedKnownKeys += KeyIdToType.Contains(AttributeNameTable.FindOrAdd(Keys[KeyIndex]).CaseInsensitiveId) ? 1 : 0;
+		}
+	}
+	const double InternedKeysSeconds = FPlatformTime::Seconds() - InternedKeysStartTime;
+	TestEqual(TEXT("Interned keys are found"), NumInternedKnownKeys, NumKnownKeys);
+
+	// After: the whole material construction, which resolves the keys by their interned ids
+	const double MaterialStartTime = FPlatformTime::Seconds();
+	for (int32 MaterialIndex = 0; MaterialIndex < NumMaterials; ++MaterialIndex)
+	{
+		const Vitruvio::FMaterialAttributeContainer Material(MaterialAttributeMap.get());
+		if (MaterialIndex == 0)
+		{
+			TestEqual(TEXT("Material colors"), Material.ColorProperties.Num(), 2);
+			TestEqual(TEXT("Material textures"), Material.TextureProperties.Num(), 3);
+			TestEqual(TEXT("Material scalars"), Material.ScalarProperties.Num(), 3);
+		}
+	}
+	const double MaterialSeconds = FPlatformTime::Seconds() - MaterialStartTime;
+
+	// Before: every attribute name was converted when the attribute map was built
+	const TMap<FString, URuleAttribute*> Attributes = CreateRuleAttributes(NumRuleAttributes);
+	const double ConvertedNamesStartTime = FPlatformTime::Seconds();
+	for (int32 AttributeMapIndex = 0; AttributeMapIndex < NumAttributeMaps; ++AttributeMapIndex)
+	{
+		AttributeMapBuilderUPtr AttributeMapBuilder(prt::AttributeMapBuilder::create());
+		for (const TPair<FString, URuleAttribute*>& AttributeEntry : Attributes)
+		{
+			const FString Name(AttributeEntry.Value->Name);
+			if (const UFloatAttribute* FloatAttribute = Cast<UFloatAttribute>(AttributeEntry.Value))
+			{
+				AttributeMapBuilder->setFloat(TCHAR_TO_WCHAR(*Name), FloatAttribute->Value);
+			}
+			else if (const UStringAttribute* StringAttribute = Cast<UStringAttribute>(AttributeEntry.Value))
+			{
+				AttributeMapBuilder->setString(TCHAR_TO_WCHAR(*Name), TCHAR_TO_WCHAR(*StringAttribute->Value));
+			}
+		}
+		const AttributeMapUPtr AttributeMap(AttributeMapBuilder->createAttributeMap(), PRTDestroyer());
+	}
+	const double ConvertedNamesSeconds = FPlatformTime::Seconds() - ConvertedNamesStartTime;
+
+	// After: the attribute maps are built from the interned wide names
+	const double InternedNamesStartTime = FPlatformTime::Seconds();
+	for (int32 AttributeMapIndex = 0; AttributeMapIndex < NumAttributeMaps; ++AttributeMapIndex)
+	{
+		const AttributeMapUPtr AttributeMap = Vitruvio::CreateAttributeMap(Attributes);
+		if (AttributeMapIndex == 0)
+		{
+			size_t NumKeys = 0;
+			AttributeMap->getKeys(&NumKeys);
+			TestEqual(TEXT("Every attribute is set"), static_cast<int32>(NumKeys), NumRuleAttributes);
+		}
+	}
+	const double InternedNamesSeconds = FPlatformTime::Seconds() - InternedNamesStartTime;
+
+	AddInfo(FString::Printf(TEXT("Resolved the keys of %d materials in %.2f ms by converting and in %.2f ms by interning them"), NumMaterials,
+							ConvertedKeysSeconds * 1000.0, InternedKeysSeconds * 1000.0));
+	AddInfo(FString::Printf(TEXT("Constructed %d materials in %.2f ms"), NumMaterials, MaterialSeconds * 1000.0));
+	AddInfo(FString::Printf(TEXT("Built %d attribute maps of %d attributes in %.2f ms with converted and in %.2f ms with interned names"),
+							NumAttributeMaps, NumRuleAttributes, ConvertedNamesSeconds * 1000.0, InternedNamesSeconds * 1000.0));
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,98 @@
+/* Copyright 2024 Esri
+ *
+ * Licensed under the Apache License Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "Engine/World.h"
+#include "GenerateCompletedCallbackProxy.h"
+#include "Misc/AutomationTest.h"
+#include "Tests/MockGenerateBackend.h"
+#include "VitruvioBatchActor.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace BatchActorFailureTests
+{
+constexpr double TimeoutSeconds = 10.0;
+constexpr int32 TileSize = 10000;
+
+// Ticks the batch actor like the engine would in a headless session until the given condition is met
+bool TickUntil(AVitruvioBatchActor* BatchActor, TFunctionRef<bool()> Condition)
+{
+	const double EndTime = FPlatformTime::Seconds() + TimeoutSeconds;
+	while (FPlatformTime::Seconds() < EndTime)
+	{
+		BatchActor->Tick(0.0f);
+		if (Condition())
+		{
+			return true;
+		}
+		FPlatformProcess::Sleep(0.001f);
+	}
+	return false;
+}
+} // namespace BatchActorFailureTests
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBatchActorFailedTileTest, "Vitruvio.BatchActor.FailedTile",
+								 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FBatchActorFailedTileTest::RunTest(const FString& Parameters)
+{
+	using namespace BatchActorFailureTests;
+	using namespace VitruvioTests;
+
+	const FScopedMockGenerateBackend Backend;
+	URulePackage* RulePackage = CreateRulePackage();
+	URulePackage* FailingRulePackage = CreateRulePackage();
+	Backend->SetFailing(FailingRulePackage);
+
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("BatchActorFailedTileTest"));
+	AVitruvioBatchActor* BatchActor = World->SpawnActor<AVitruvioBatchActor>();
+	BatchActor->GridDimension = {TileSize, TileSize};
+	BatchActor->bPersistGeneratedModels = true;
+
+	// The first tile only contains shapes of the failing Rule Package, its generate returns an empty result
+	BatchActor->RegisterVitruvioComponent(CreateVitruvioComponent(World, FailingRulePackage, FVector(TileSize / 2, TileSize / 2, 0.0)));
+	BatchActor->RegisterVitruvioComponent(CreateVitruvioComponent(World, FailingRulePackage, FVector(TileSize / 4, TileSize / 4, 0.0)));
+	BatchActor->RegisterVitruvioComponent(CreateVitruvioComponent(World, RulePackage, FVector(TileSize + TileSize / 2, TileSize / 2, 0.0)));
+
+	// The third tile mixes both Rule Packages, only the shape of the failing one is skipped
+	const FVector MixedTileCenter(2 * TileSize + TileSize / 2, TileSize / 2, 0.0);
+	UVitruvioComponent* FailingComponent = CreateVitruvioComponent(World, FailingRulePackage, MixedTileCenter);
+	UVitruvioComponent* GeneratedComponent = CreateVitruvioComponent(World, RulePackage, MixedTileCenter - FVector(TileSize / 4, TileSize / 4, 0.0));
+	BatchActor->RegisterVitruvioComponent(FailingComponent);
+	BatchActor->RegisterVitruvioComponent(GeneratedComponent);
+
+	bool bCompleted = false;
+	UGenerateCompletedCallbackProxy* CallbackProxy = NewObject<UGenerateCompletedCallbackProxy>();
+	CallbackProxy->OnGenerateCompleted.AddLambda([&bCompleted]() { bCompleted = true; });
+	BatchActor->GenerateAll(CallbackProxy);
+
+	TestTrue(TEXT("Generate all completes although a tile has failed"), TickUntil(BatchActor, [&bCompleted]() { return bCompleted; }));
+	TestTrue(TEXT("Only the tile of the failing Rule Package has failed"), BatchActor->GetFailedTiles() == TArray<FIntPoint>{FIntPoint(0, 0)});
+	TestTrue(TEXT("Failed tile has no model"), BatchActor->GetTilesWithoutModel().Contains(FIntPoint(0, 0)));
+	TestTrue(TEXT("Failed tile has no reports"), BatchActor->GetTileReportStatistics(FIntPoint(0, 0)).IsEmpty());
+
+	const TMap<FString, FReportStatistics> MixedTileReportStatistics = BatchActor->GetTileReportStatistics(FIntPoint(2, 0));
+	const FReportStatistics* MixedTileSeeds = MixedTileReportStatistics.Find(TEXT("Seed"));
+	TestTrue(TEXT("Only the shape of the loaded Rule Package is generated"), MixedTileSeeds && MixedTileSeeds->Count == 1);
+	TestTrue(TEXT("Generated shape has its reports"), !BatchActor->GetComponentReportStatistics(GeneratedComponent).IsEmpty());
+	TestTrue(TEXT("Skipped shape has no reports"), BatchActor->GetComponentReportStatistics(FailingComponent).IsEmpty());
+
+	TestTrue(TEXT("Waiting for idle succeeds"), VitruvioModule::Get().WaitUntilIdle(TimeoutSeconds));
+	World->DestroyWorld(false);
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
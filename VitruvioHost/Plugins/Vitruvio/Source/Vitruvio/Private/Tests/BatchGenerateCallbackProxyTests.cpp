@@ -0,0 +1,140 @@
+/* Copyright 2024 Esri
+ *
+ * Licensed under the Apache License Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Async/TaskGraphInterfaces.h"
+#include "BatchGenerateCallbackProxy.h"
+#include "Misc/AutomationTest.h"
+#include "Tests/MockGenerateBackend.h"
+#include "VitruvioBatchActor.h"
+#include "VitruvioBatchSubsystem.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace BatchGenerateCallbackProxyTests
+{
+constexpr double TimeoutSeconds = 10.0;
+constexpr int32 NumComponents = 50;
+
+TArray<FVitruvioComponentAttributes> CreateComponentAttributes(UWorld* World, URulePackage* RulePackage)
+{
+	TArray<FVitruvioComponentAttributes> ComponentAttributes;
+	for (int32 ComponentIndex = 0; ComponentIndex < NumComponents; ++ComponentIndex)
+	{
+		// All components are placed within a single tile of the batch actor
+		FVitruvioComponentAttributes& Entry = ComponentAttributes.AddDefaulted_GetRef();
+		Entry.VitruvioComponent = VitruvioTests::CreateVitruvioComponent(World, RulePackage, FVector(ComponentIndex * 500.0, 0.0, 0.0));
+		Entry.Attributes.Add(TEXT("Height"), FString::FromInt(ComponentIndex));
+	}
+	return ComponentAttributes;
+}
+
+// Delivers the results to the game thread like the engine would until the given condition is met
+bool WaitUntil(TFunctionRef<void()> Tick, TFunctionRef<bool()> Condition)
+{
+	const double EndTime = FPlatformTime::Seconds() + TimeoutSeconds;
+	while (FPlatformTime::Seconds() < EndTime)
+	{
+		FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+		Tick();
+		if (Condition())
+		{
+			return true;
+		}
+		FPlatformProcess::Sleep(0.001f);
+	}
+	return false;
+}
+} // namespace BatchGenerateCallbackProxyTests
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBatchGenerateCallbackProxyCallCountTest, "Vitruvio.BatchGenerateCallbackProxy.GenerateCalls",
+								 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FBatchGenerateCallbackProxyCallCountTest::RunTest(const FString& Parameters)
+{
+	using namespace BatchGenerateCallbackProxyTests;
+	using namespace VitruvioTests;
+
+	const FScopedMockGenerateBackend Backend;
+	URulePackage* RulePackage = CreateRulePackage();
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("BatchGenerateCallbackProxyTest"));
+	const TArray<FVitruvioComponentAttributes> ComponentAttributes = CreateComponentAttributes(World, RulePackage);
+
+	bool bAttributesEvaluated = false;
+	int32 NumCompleted = 0;
+	bool bCompleted = false;
+	UBatchGenerateCallbackProxy* Proxy = UBatchGenerateCallbackProxy::SetAttributesForComponents(World, ComponentAttributes, true);
+	Proxy->OnAttributesEvaluated.AddLambda([&bAttributesEvaluated]() { bAttributesEvaluated = true; });
+	Proxy->OnComponentCompleted.AddLambda([&NumCompleted](UVitruvioComponent*, int32, int32) { ++NumCompleted; });
+	Proxy->OnCompleted.AddLambda([&bCompleted]() { bCompleted = true; });
+
+	const auto TickComponents = [&ComponentAttributes]() {
+		for (const FVitruvioComponentAttributes& Entry : ComponentAttributes)
+		{
+			Entry.VitruvioComponent->TickComponent(0.0f, LEVELTICK_All, nullptr);
+		}
+	};
+	TestTrue(TEXT("All components complete"), WaitUntil(TickComponents, [&bCompleted]() { return bCompleted; }));
+	TestTrue(TEXT("Attributes have been evaluated"), bAttributesEvaluated);
+	TestEqual(TEXT("Every component is reported"), NumCompleted, NumComponents);
+
+	// Never evaluated components are evaluated once before and once after setting the attributes, each time in a single batch
+	TestEqual(TEXT("One evaluate call per pass and Rule Package"), Backend->NumEvaluateCalls.GetValue(), 2);
+
+	// The geometry of a generate call can not be split into separate models, components which are not batch generated are generated separately
+	TestEqual(TEXT("One generate call per component"), Backend->NumGenerateCalls.GetValue(), NumComponents);
+
+	TestTrue(TEXT("Waiting for idle succeeds"), VitruvioModule::Get().WaitUntilIdle(TimeoutSeconds));
+	World->DestroyWorld(false);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBatchGenerateCallbackProxyBatchedCallCountTest, "Vitruvio.BatchGenerateCallbackProxy.BatchedGenerateCalls",
+								 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FBatchGenerateCallbackProxyBatchedCallCountTest::RunTest(const FString& Parameters)
+{
+	using namespace BatchGenerateCallbackProxyTests;
+	using namespace VitruvioTests;
+
+	const FScopedMockGenerateBackend Backend;
+	URulePackage* RulePackage = CreateRulePackage();
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("BatchGenerateCallbackProxyBatchedTest"));
+	const TArray<FVitruvioComponentAttributes> ComponentAttributes = CreateComponentAttributes(World, RulePackage);
+	for (const FVitruvioComponentAttributes& Entry : ComponentAttributes)
+	{
+		Entry.VitruvioComponent->SetBatchGenerated(true);
+	}
+	AVitruvioBatchActor* BatchActor = World->GetSubsystem<UVitruvioBatchSubsystem>()->GetBatchActor();
+
+	bool bAttributesEvaluated = false;
+	bool bCompleted = false;
+	UBatchGenerateCallbackProxy* Proxy = UBatchGenerateCallbackProxy::SetAttributesForComponents(World, ComponentAttributes, true);
+	Proxy->OnAttributesEvaluated.AddLambda([&bAttributesEvaluated]() { bAttributesEvaluated = true; });
+	Proxy->OnCompleted.AddLambda([&bCompleted]() { bCompleted = true; });
+
+	// The batch actor is not ticked until the attributes are set, the tile would otherwise already be generated after registration
+	TestTrue(TEXT("Attributes have been evaluated"), WaitUntil([]() {}, [&bAttributesEvaluated]() { return bAttributesEvaluated; }));
+	TestEqual(TEXT("One evaluate call per pass and Rule Package"), Backend->NumEvaluateCalls.GetValue(), 2);
+	TestEqual(TEXT("Nothing has been generated before the attributes are set"), Backend->NumGenerateCalls.GetValue(), 0);
+
+	TestTrue(TEXT("All components complete"), WaitUntil([BatchActor]() { BatchActor->Tick(0.0f); }, [&bCompleted]() { return bCompleted; }));
+	TestEqual(TEXT("Batch generated components are generated with a single call per tile"), Backend->NumGenerateCalls.GetValue(), 1);
+
+	TestTrue(TEXT("Waiting for idle succeeds"), VitruvioModule::Get().WaitUntilIdle(TimeoutSeconds));
+	World->DestroyWorld(false);
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
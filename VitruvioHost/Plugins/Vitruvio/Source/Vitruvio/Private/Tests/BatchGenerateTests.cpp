@@ -0,0 +1,154 @@
+/* Copyright 2024 Esri
+ *
+ * Licensed under the Apache License Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "HAL/PlatformTime.h"
+#include "Misc/AutomationTest.h"
+#include "Tests/MockGenerateBackend.h"
+#include "VitruvioModule.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace BatchGenerateTests
+{
+constexpr int32 NumRulePackages = 4;
+constexpr int32 NumShapesPerRulePackage = 4;
+constexpr int32 LoadMilliseconds = 200;
+
+// The Rule Packages of consecutive initial shapes alternate so that the grouping by Rule Package reorders them
+TArray<FInitialShape> CreateInterleavedInitialShapes(const TArray<URulePackage*>& RulePackages)
+{
+	TArray<FInitialShape> InitialShapes;
+	for (int32 RandomSeed = 0; RandomSeed < RulePackages.Num() * NumShapesPerRulePackage; ++RandomSeed)
+	{
+		InitialShapes.Add(VitruvioTests::CreateInitialShape(RulePackages[RandomSeed % RulePackages.Num()], RandomSeed));
+	}
+	return InitialShapes;
+}
+
+const FReportStatistics* FindSeedReport(const FGenerateResultDescription& Result, int32 BatchIndex)
+{
+	return Result.ShapeReportStatistics.IsValidIndex(BatchIndex) ? Result.ShapeReportStatistics[BatchIndex].Find(TEXT("Seed")) : nullptr;
+}
+} // namespace BatchGenerateTests
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBatchGenerateParallelLoadsTest, "Vitruvio.BatchGenerate.ParallelLoadsKeepBatchOrder",
+								 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FBatchGenerateParallelLoadsTest::RunTest(const FString& Parameters)
+{
+	using namespace BatchGenerateTests;
+	using namespace VitruvioTests;
+
+	const FScopedMockGenerateBackend Backend;
+	Backend->SetLoadMilliseconds(LoadMilliseconds);
+
+	TArray<URulePackage*> RulePackages;
+	for (int32 RulePackageIndex = 0; RulePackageIndex < NumRulePackages; ++RulePackageIndex)
+	{
+		RulePackages.Add(CreateRulePackage());
+	}
+	const TArray<FInitialShape> InitialShapes = CreateInterleavedInitialShapes(RulePackages);
+
+	const double StartTime = FPlatformTime::Seconds();
+	const FGenerateResultDescription Result = VitruvioModule::Get().BatchGenerate(InitialShapes);
+	const double Seconds = FPlatformTime::Seconds() - StartTime;
+
+	TestEqual(TEXT("Every Rule Package is loaded once"), Backend->NumLoads.GetValue(), NumRulePackages);
+	TestTrue(TEXT("Rule Packages are loaded concurrently"), Backend->GetMaxConcurrentLoads() > 1);
+	TestTrue(TEXT("Loads do not wait for each other"), Seconds < NumRulePackages * LoadMilliseconds / 1000.0);
+	TestEqual(TEXT("All initial shapes are generated by a single call"), Backend->NumGenerateCalls.GetValue(), 1);
+
+	if (!TestEqual(TEXT("Every initial shape has evaluated attributes"), Result.EvaluatedAttributes.Num(), InitialShapes.Num()))
+	{
+		return false;
+	}
+
+	// The random seed identifies the initial shapes in the mock backend
+	for (int32 BatchIndex = 0; BatchIndex < InitialShapes.Num(); ++BatchIndex)
+	{
+		const int32 RandomSeed = InitialShapes[BatchIndex].RandomSeed;
+		TestTrue(TEXT("Evaluated attributes are in batch order"),
+				 Result.EvaluatedAttributes[BatchIndex] == Backend->GetEvaluatedAttributes(RandomSeed));
+
+		const FReportStatistics* SeedReport = FindSeedReport(Result, BatchIndex);
+		TestTrue(TEXT("Reports are in batch order"), SeedReport && SeedReport->Min == RandomSeed);
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBatchGenerateFailedRulePackageTest, "Vitruvio.BatchGenerate.FailedRulePackageOnlySkipsItsShapes",
+								 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FBatchGenerateFailedRulePackageTest::RunTest(const FString& Parameters)
+{
+	using namespace BatchGenerateTests;
+	using namespace VitruvioTests;
+
+	const FScopedMockGenerateBackend Backend;
+
+	TArray<URulePackage*> RulePackages;
+	for (int32 RulePackageIndex = 0; RulePackageIndex < NumRulePackages; ++RulePackageIndex)
+	{
+		RulePackages.Add(CreateRulePackage());
+	}
+	URulePackage* FailingRulePackage = RulePackages[1];
+	Backend->SetFailing(FailingRulePackage);
+
+	const TArray<FInitialShape> InitialShapes = CreateInterleavedInitialShapes(RulePackages);
+	const FGenerateResultDescription Result = VitruvioModule::Get().BatchGenerate(InitialShapes);
+
+	if (!TestEqual(TEXT("Results are matched to the initial shapes by index"), Result.EvaluatedAttributes.Num(), InitialShapes.Num()) ||
+		!TestEqual(TEXT("Reports are matched to the initial shapes by index"), Result.ShapeReportStatistics.Num(), InitialShapes.Num()))
+	{
+		return false;
+	}
+
+	TArray<int32> ExpectedSeeds;
+	for (int32 BatchIndex = 0; BatchIndex < InitialShapes.Num(); ++BatchIndex)
+	{
+		const FInitialShape& InitialShape = InitialShapes[BatchIndex];
+		if (InitialShape.RulePackage == FailingRulePackage)
+		{
+			TestFalse(TEXT("Skipped shape has no evaluated attributes"), Result.EvaluatedAttributes[BatchIndex].IsValid());
+			TestTrue(TEXT("Skipped shape has no reports"), Result.ShapeReportStatistics[BatchIndex].IsEmpty());
+			continue;
+		}
+
+		ExpectedSeeds.Add(InitialShape.RandomSeed);
+		TestTrue(TEXT("Generated shape has its evaluated attributes"),
+				 Result.EvaluatedAttributes[BatchIndex] == Backend->GetEvaluatedAttributes(InitialShape.RandomSeed));
+
+		const FReportStatistics* SeedReport = FindSeedReport(Result, BatchIndex);
+		TestTrue(TEXT("Generated shape has its reports"), SeedReport && SeedReport->Min == InitialShape.RandomSeed);
+	}
+
+	TArray<int32> GeneratedSeeds = Backend->GetGeneratedSeeds();
+	GeneratedSeeds.Sort();
+	TestTrue(TEXT("Shapes of all loaded Rule Packages are generated"), GeneratedSeeds == ExpectedSeeds);
+
+	const FReportStatistics* SeedReports = Result.ReportStatistics.Find(TEXT("Seed"));
+	TestTrue(TEXT("Only generated shapes are aggregated"), SeedReports && SeedReports->Count == ExpectedSeeds.Num());
+
+	// Without any loaded Rule Package the whole batch fails
+	const FGenerateResultDescription FailedResult = VitruvioModule::Get().BatchGenerate({CreateInitialShape(FailingRulePackage, 0)});
+	TestTrue(TEXT("Batch without loaded Rule Package has no result"), FailedResult.EvaluatedAttributes.IsEmpty());
+
+	TestTrue(TEXT("Waiting for idle succeeds"), VitruvioModule::Get().WaitUntilIdle(10.0));
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,131 @@
+/* Copyright 2024 Esri
+ *
+ * Licensed under the Apache License Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "CacheEviction.h"
+#include "Misc/AutomationTest.h"
+#include "Tests/MockGenerateBackend.h"
+#include "VitruvioModule.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace CacheEvictionTests
+{
+constexpr int32 RulePackageSize = 1024;
+
+// Default budget of VitruvioModule, restored after the tests which change it
+constexpr int64 DefaultResolveMapCacheBudget = 512 * 1024 * 1024;
+
+bool Load(URulePackage* RulePackage)
+{
+	return VitruvioModule::Get().LoadRulePackageAsync(RulePackage).Get();
+}
+} // namespace CacheEvictionTests
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCacheEvictionLeastRecentlyUsedTest, "Vitruvio.CacheEviction.LeastRecentlyUsedFirst",
+								 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FCacheEvictionLeastRecentlyUsedTest::RunTest(const FString& Parameters)
+{
+	TestTrue(TEXT("Nothing is evicted within the budget"), Vitruvio::SelectEntriesToEvict({{1, 50}, {2, 50}}, 100).IsEmpty());
+
+	// Eviction stops as soon as the entries fit into the budget
+	const TArray<int32> Evicted = Vitruvio::SelectEntriesToEvict({{3, 10}, {1, 100}, {2, 10}}, 50);
+	TestTrue(TEXT("Only the least recently used entry is evicted"), Evicted == TArray<int32>{1});
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCacheEvictionInUseTest, "Vitruvio.CacheEviction.SkipsEntriesInUse",
+								 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FCacheEvictionInUseTest::RunTest(const FString& Parameters)
+{
+	using Vitruvio::FCacheEntryUsage;
+
+	// The least recently used entry is in use and the most recently used entry is kept, so the two entries in between are evicted
+	const TArray<FCacheEntryUsage> Usages = {{4, 60}, {1, 60, true}, {3, 60}, {2, 60}};
+	const TArray<int32> Evicted = Vitruvio::SelectEntriesToEvict(Usages, 100);
+	TestTrue(TEXT("Entries in use are skipped"), Evicted == TArray<int32>{3, 2});
+
+	const TArray<FCacheEntryUsage> AllInUse = {{1, 60, true}, {2, 60, true}, {3, 60}};
+	TestTrue(TEXT("Nothing is evicted if all other entries are in use"), Vitruvio::SelectEntriesToEvict(AllInUse, 100).IsEmpty());
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCacheEvictionKeepsNewestTest, "Vitruvio.CacheEviction.KeepsMostRecentlyUsed",
+								 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FCacheEvictionKeepsNewestTest::RunTest(const FString& Parameters)
+{
+	TestTrue(TEXT("A single entry exceeding the budget is kept"), Vitruvio::SelectEntriesToEvict({{1, 1000}}, 100).IsEmpty());
+
+	const TArray<int32> Evicted = Vitruvio::SelectEntriesToEvict({{2, 1000}, {1, 10}}, 100);
+	TestTrue(TEXT("All but the most recently used entry are evicted"), Evicted == TArray<int32>{1});
+
+	TestTrue(TEXT("An empty cache evicts nothing"), Vitruvio::SelectEntriesToEvict({}, 0).IsEmpty());
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCacheEvictionResolveMapHitTest, "Vitruvio.CacheEviction.ResolveMapHitSurvivesEviction",
+								 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FCacheEvictionResolveMapHitTest::RunTest(const FString& Parameters)
+{
+	using namespace CacheEvictionTests;
+	using namespace VitruvioTests;
+
+	VitruvioModule& Module = VitruvioModule::Get();
+	const FScopedMockGenerateBackend Backend;
+
+	// The budget fits three Rule Packages, every other load has to evict one of them
+	Module.SetResolveMapCacheBudget(3 * RulePackageSize);
+	ON_SCOPE_EXIT
+	{
+		Module.SetResolveMapCacheBudget(DefaultResolveMapCacheBudget);
+	};
+
+	URulePackage* HotRulePackage = CreateRulePackage(RulePackageSize);
+	TestTrue(TEXT("Hot Rule Package has been loaded"), Load(HotRulePackage));
+
+	constexpr int32 NumOtherRulePackages = 10;
+	TArray<URulePackage*> OtherRulePackages;
+	for (int32 Index = 0; Index < NumOtherRulePackages; ++Index)
+	{
+		URulePackage* OtherRulePackage = OtherRulePackages.Add_GetRef(CreateRulePackage(RulePackageSize));
+		TestTrue(TEXT("Other Rule Package has been loaded"), Load(OtherRulePackage));
+
+		// The cache hit makes the hot Rule Package the most recently used one after the newly loaded Rule Package
+		TestTrue(TEXT("Hot Rule Package is still loaded"), Load(HotRulePackage));
+	}
+
+	TestEqual(TEXT("Hot Rule Package has only been loaded once"), Backend->NumLoads.GetValue(), NumOtherRulePackages + 1);
+
+	// The least recently used Rule Package has been evicted and is loaded again
+	TestTrue(TEXT("Evicted Rule Package has been reloaded"), Load(OtherRulePackages[0]));
+	TestEqual(TEXT("Evicted Rule Package is loaded again"), Backend->NumLoads.GetValue(), NumOtherRulePackages + 2);
+
+	// Without further hits the hot Rule Package becomes the least recently used one and is evicted as well
+	Load(OtherRulePackages[1]);
+	Load(OtherRulePackages[2]);
+	const int32 NumLoads = Backend->NumLoads.GetValue();
+	TestTrue(TEXT("Hot Rule Package has been reloaded"), Load(HotRulePackage));
+	TestEqual(TEXT("Hot Rule Package is evicted once it is not used anymore"), Backend->NumLoads.GetValue(), NumLoads + 1);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
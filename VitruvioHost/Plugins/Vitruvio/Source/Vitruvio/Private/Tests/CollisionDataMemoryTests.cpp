@@ -0,0 +1,138 @@
+/* Copyright 2024 Esri
+ *
+ * Licensed under the Apache License Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "CollisionGeneration.h"
+#include "Engine/World.h"
+#include "GeneratedModelHISMComponent.h"
+#include "GeneratedModelStaticMeshComponent.h"
+#include "Materials/Material.h"
+#include "Misc/AutomationTest.h"
+#include "StaticMeshAttributes.h"
+#include "VitruvioMesh.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace CollisionDataMemoryTests
+{
+FMeshDescription CreateGridMeshDescription(int32 NumCells, float CellSize)
+{
+	FMeshDescription Description;
+	FStaticMeshAttributes Attributes(Description);
+	Attributes.Register();
+	Attributes.GetVertexInstanceUVs().SetNumChannels(1);
+
+	const FPolygonGroupID PolygonGroupId = Description.CreatePolygonGroup();
+	TArray<FVertexID> VertexIDs;
+	for (int32 Y = 0; Y <= NumCells; ++Y)
+	{
+		for (int32 X = 0; X <= NumCells; ++X)
+		{
+			const FVertexID VertexID = Description.CreateVertex();
+			Attributes.GetVertexPositions()[VertexID] = FVector3f(X * CellSize, Y * CellSize, 0.0f);
+			VertexIDs.Add(VertexID);
+		}
+	}
+
+	auto CreateTriangle = [&Description, &Attributes, &VertexIDs, PolygonGroupId](int32 A, int32 B, int32 C) {
+		TArray<FVertexInstanceID> VertexInstances;
+		for (const int32 Index : {A, B, C})
+		{
+			const FVertexInstanceID VertexInstanceID = Description.CreateVertexInstance(VertexIDs[Index]);
+			Attributes.GetVertexInstanceNormals()[VertexInstanceID] = FVector3f::UpVector;
+			VertexInstances.Add(VertexInstanceID);
+		}
+		Description.CreateTriangle(PolygonGroupId, VertexInstances);
+	};
+	for (int32 Y = 0; Y < NumCells; ++Y)
+	{
+		for (int32 X = 0; X < NumCells; ++X)
+		{
+			const int32 Corner = Y * (NumCells + 1) + X;
+			CreateTriangle(Corner, Corner + 1, Corner + NumCells + 2);
+			CreateTriangle(Corner, Corner + NumCells + 2, Corner + NumCells + 1);
+		}
+	}
+	return Description;
+}
+} // namespace CollisionDataMemoryTests
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCollisionDataReleasedAfterCookingTest, "Vitruvio.CollisionData.ReleasedAfterCooking",
+								 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FCollisionDataReleasedAfterCookingTest::RunTest(const FString& Parameters)
+{
+	using namespace CollisionDataMemoryTests;
+
+	UMaterial* OpaqueParent = LoadObject<UMaterial>(nullptr, TEXT("/Vitruvio/Materials/M_OpaqueParent.M_OpaqueParent"));
+	UMaterial* MaskedParent = LoadObject<UMaterial>(nullptr, TEXT("/Vitruvio/Materials/M_MaskedParent.M_MaskedParent"));
+	UMaterial* TranslucentParent = LoadObject<UMaterial>(nullptr, TEXT("/Vitruvio/Materials/M_TranslucentParent.M_TranslucentParent"));
+
+	FGeneratedCollisionSettings Settings;
+	Settings.CollisionType = EGeneratedCollisionType::SimplifiedMesh;
+	const FMeshDescription Description = CreateGridMeshDescription(64, 100.0f);
+	const TArray<Vitruvio::FMaterialAttributeContainer> Materials = {Vitruvio::FMaterialAttributeContainer()};
+	const TSharedPtr<FVitruvioMesh> Mesh =
+		MakeShared<FVitruvioMesh>(TEXT("CollisionDataMemoryTest"), Description, Materials, Vitruvio::CreateCollisionData(Description, Settings));
+	const SIZE_T CollisionDataSize = Mesh->GetCollisionData()->GetAllocatedSize();
+
+	TMap<Vitruvio::FMaterialAttributeContainer, TObjectPtr<UMaterialInstanceDynamic>> MaterialCache;
+	TMap<FString, Vitruvio::FTextureData> TextureCache;
+	TMap<UMaterialInterface*, FString> MaterialIdentifiers;
+	TMap<FString, int32> UniqueMaterialNames;
+	Mesh->Build(TEXT("CollisionDataMemoryTest"), MaterialCache, TextureCache, MaterialIdentifiers, UniqueMaterialNames, OpaqueParent, MaskedParent,
+				TranslucentParent);
+
+	const UBodySetup* BodySetup = Mesh->GetStaticMesh()->GetBodySetup();
+	if (!TestTrue(TEXT("Collision has been cooked"), BodySetup && BodySetup->bCreatedPhysicsMeshes && !BodySetup->bFailedToCreatePhysicsMeshes))
+	{
+		return false;
+	}
+
+	// Only the mesh itself keeps the collision data, eg. to persist it
+	TestEqual(TEXT("Cooking input released after building"), Mesh->GetCollisionData().GetSharedReferenceCount(), 1);
+
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("CollisionDataMemoryTest"));
+	AActor* Actor = World->SpawnActor<AActor>();
+
+	UGeneratedModelStaticMeshComponent* ModelComponent = NewObject<UGeneratedModelStaticMeshComponent>(Actor);
+	ModelComponent->SetCollisionData(Mesh->GetCollisionData());
+	ModelComponent->SetStaticMesh(Mesh->GetStaticMesh());
+	TestEqual(TEXT("Model component holds the collision data until its physics state is created"), Mesh->GetCollisionData().GetSharedReferenceCount(),
+			  2);
+	Actor->SetRootComponent(ModelComponent);
+	Actor->AddOwnedComponent(ModelComponent);
+	ModelComponent->RegisterComponent();
+
+	UGeneratedModelHISMComponent* InstancedComponent = NewObject<UGeneratedModelHISMComponent>(ModelComponent);
+	InstancedComponent->SetCollisionData(Mesh->GetCollisionData());
+	InstancedComponent->SetStaticMesh(Mesh->GetStaticMesh());
+	InstancedComponent->AddInstance(FTransform::Identity);
+	InstancedComponent->AttachToComponent(ModelComponent, FAttachmentTransformRules::KeepRelativeTransform);
+	Actor->AddOwnedComponent(InstancedComponent);
+	InstancedComponent->RegisterComponent();
+
+	TestTrue(TEXT("Physics state of the model component has been created"), ModelComponent->IsPhysicsStateCreated());
+	TestFalse(TEXT("Model component released the collision data"), ModelComponent->HasCollisionData());
+	TestTrue(TEXT("Physics state of the instanced component has been created"), InstancedComponent->IsPhysicsStateCreated());
+	TestFalse(TEXT("Instanced component released the collision data"), InstancedComponent->HasCollisionData());
+	TestEqual(TEXT("Components do not keep the collision data alive"), Mesh->GetCollisionData().GetSharedReferenceCount(), 1);
+
+	AddInfo(FString::Printf(TEXT("%llu bytes of collision data are kept once by the mesh"), static_cast<uint64>(CollisionDataSize)));
+
+	World->DestroyWorld(false);
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
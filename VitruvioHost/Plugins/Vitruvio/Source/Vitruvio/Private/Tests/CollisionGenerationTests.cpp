@@ -0,0 +1,229 @@
+/* Copyright 2024 Esri
+ *
+ * Licensed under the Apache License Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "CollisionGeneration.h"
+#include "Misc/AutomationTest.h"
+#include "StaticMeshAttributes.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace CollisionGenerationTests
+{
+class FMeshBuilder
+{
+public:
+	FMeshBuilder() : Attributes(Description)
+	{
+		Attributes.Register();
+		PolygonGroupId = Description.CreatePolygonGroup();
+	}
+
+	void AddTriangle(const FVector3f& A, const FVector3f& B, const FVector3f& C)
+	{
+		TArray<FVertexInstanceID> VertexInstances;
+		for (const FVector3f& Position : {A, B, C})
+		{
+			const FVertexID VertexID = Description.CreateVertex();
+			Attributes.GetVertexPositions()[VertexID] = Position;
+			VertexInstances.Add(Description.CreateVertexInstance(VertexID));
+		}
+		Description.CreateTriangle(PolygonGroupId, VertexInstances);
+	}
+
+	void AddQuad(const FVector3f& A, const FVector3f& B, const FVector3f& C, const FVector3f& D)
+	{
+		AddTriangle(A, B, C);
+		AddTriangle(A, C, D);
+	}
+
+	void AddBox(const FBox3f& Box)
+	{
+		auto Corner = [&Box](int32 Index) {
+			return FVector3f(Index & 1 ? Box.Max.X : Box.Min.X, Index & 2 ? Box.Max.Y : Box.Min.Y, Index & 4 ? Box.Max.Z : Box.Min.Z);
+		};
+		const int32 Faces[6][4] = {{0, 1, 3, 2}, {4, 6, 7, 5}, {0, 4, 5, 1}, {2, 3, 7, 6}, {0, 2, 6, 4}, {1, 5, 7, 3}};
+		for (const int32(&Face)[4] : Faces)
+		{
+			AddQuad(Corner(Face[0]), Corner(Face[1]), Corner(Face[2]), Corner(Face[3]));
+		}
+	}
+
+	// Adds a connected grid of NumCells x NumCells quads in the XY plane with a wave in Z so that the grid is not flat
+	void AddGrid(int32 NumCells, float CellSize)
+	{
+		auto Point = [CellSize](int32 X, int32 Y) {
+			return FVector3f(X * CellSize, Y * CellSize, 100.0f * FMath::Sin(X * 0.2f) * FMath::Cos(Y * 0.2f));
+		};
+		for (int32 Y = 0; Y < NumCells; ++Y)
+		{
+			for (int32 X = 0; X < NumCells; ++X)
+			{
+				AddQuad(Point(X, Y), Point(X + 1, Y), Point(X + 1, Y + 1), Point(X, Y + 1));
+			}
+		}
+	}
+
+	const FMeshDescription& GetMeshDescription() const
+	{
+		return Description;
+	}
+
+	TArray<FVector3f> GetVertexPositions() const
+	{
+		TArray<FVector3f> Positions;
+		for (const FVertexID VertexID : Description.Vertices().GetElementIDs())
+		{
+			Positions.Add(Attributes.GetVertexPositions()[VertexID]);
+		}
+		return Positions;
+	}
+
+private:
+	FMeshDescription Description;
+	FStaticMeshAttributes Attributes;
+	FPolygonGroupID PolygonGroupId;
+};
+
+double GetVolume(const FBox3f& Box)
+{
+	const FVector3f Size = Box.GetSize();
+	return static_cast<double>(Size.X) * Size.Y * Size.Z;
+}
+
+// Adds a row of NumCubes separated 10 cm cubes starting at Origin and returns the bounds of the row
+FBox3f AddCubeRow(FMeshBuilder& Builder, const FVector3f& Origin, int32 NumCubes)
+{
+	FBox3f RowBounds(ForceInit);
+	for (int32 CubeIndex = 0; CubeIndex < NumCubes; ++CubeIndex)
+	{
+		const FVector3f Min = Origin + FVector3f(CubeIndex * 20.0f, 0.0f, 0.0f);
+		const FBox3f Cube(Min, Min + FVector3f(10.0f));
+		Builder.AddBox(Cube);
+		RowBounds += Cube;
+	}
+	return RowBounds;
+}
+} // namespace CollisionGenerationTests
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCollisionGenerationPartBoxesTest, "Vitruvio.CollisionGeneration.PartBoxesVolumeError",
+								 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FCollisionGenerationPartBoxesTest::RunTest(const FString& Parameters)
+{
+	using namespace CollisionGenerationTests;
+
+	// Four far apart rows of small cubes, eg. the windows of four buildings. Merging has to keep the rows apart.
+	const FVector3f RowOrigins[] = {{0.0f, 0.0f, 0.0f}, {100000.0f, 0.0f, 0.0f}, {0.0f, 100000.0f, 0.0f}, {100000.0f, 100000.0f, 5000.0f}};
+
+	FMeshBuilder Builder;
+	double RowsVolume = 0.0;
+	for (const FVector3f& RowOrigin : RowOrigins)
+	{
+		RowsVolume += GetVolume(AddCubeRow(Builder, RowOrigin, 20));
+	}
+
+	FGeneratedCollisionSettings Settings;
+	Settings.CollisionType = EGeneratedCollisionType::PartBoxes;
+	Settings.MaxElements = UE_ARRAY_COUNT(RowOrigins);
+
+	const FCollisionData CollisionData = Vitruvio::CreateCollisionData(Builder.GetMeshDescription(), Settings);
+	TestEqual(TEXT("One box per row"), CollisionData.Boxes.Num(), Settings.MaxElements);
+
+	double BoxesVolume = 0.0;
+	for (const FBox3f& Box : CollisionData.Boxes)
+	{
+		BoxesVolume += GetVolume(Box);
+	}
+	TestEqual(TEXT("Boxes do not cover more than the rows"), BoxesVolume, RowsVolume, RowsVolume * 0.001);
+
+	// Without merging every cube gets its own box
+	Settings.MaxElements = 256;
+	const FCollisionData UnmergedData = Vitruvio::CreateCollisionData(Builder.GetMeshDescription(), Settings);
+	TestEqual(TEXT("One box per cube"), UnmergedData.Boxes.Num(), 80);
+
+	// Convex hulls are merged the same way
+	Settings.CollisionType = EGeneratedCollisionType::ConvexHulls;
+	Settings.MaxElements = UE_ARRAY_COUNT(RowOrigins);
+	const FCollisionData HullData = Vitruvio::CreateCollisionData(Builder.GetMeshDescription(), Settings);
+	if (TestEqual(TEXT("One convex hull per row"), HullData.ConvexHulls.Num(), Settings.MaxElements))
+	{
+		for (const TArray<FVector3f>& ConvexHull : HullData.ConvexHulls)
+		{
+			const FVector3f HullSize = FBox3f(ConvexHull).GetSize();
+			TestTrue(TEXT("Convex hull does not span several rows"), HullSize.X < 1000.0f && HullSize.Y < 1000.0f);
+		}
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCollisionGenerationSimplifiedMeshTest, "Vitruvio.CollisionGeneration.SimplifiedMeshTriangleCount",
+								 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FCollisionGenerationSimplifiedMeshTest::RunTest(const FString& Parameters)
+{
+	using namespace CollisionGenerationTests;
+
+	constexpr int32 NumCells = 100;
+	constexpr int32 NumTriangles = NumCells * NumCells * 2;
+
+	FMeshBuilder Builder;
+	Builder.AddGrid(NumCells, 10.0f);
+
+	FGeneratedCollisionSettings Settings;
+	Settings.CollisionType = EGeneratedCollisionType::SimplifiedMesh;
+	Settings.MaxSimplificationError = 1.0f;
+	Settings.MaxSimplifiedTriangles = 0;
+
+	// The error is smaller than the grid spacing, so nothing is simplified without a triangle limit
+	const FCollisionData Unlimited = Vitruvio::CreateCollisionData(Builder.GetMeshDescription(), Settings);
+	TestEqual(TEXT("Unlimited triangle count"), Unlimited.Indices.Num(), NumTriangles);
+
+	for (const int32 MaxTriangles : {10000, 1000, 100})
+	{
+		Settings.MaxSimplifiedTriangles = MaxTriangles;
+		const FCollisionData Limited = Vitruvio::CreateCollisionData(Builder.GetMeshDescription(), Settings);
+		const FString What = FString::Printf(TEXT("At most %d triangles"), MaxTriangles);
+		TestTrue(What + TEXT(": within the limit"), Limited.Indices.Num() <= MaxTriangles);
+		TestTrue(What + TEXT(": not collapsed"), Limited.Indices.Num() > 0);
+		TestEqual(What + TEXT(": one material index per triangle"), Limited.MaterialIndices.Num(), Limited.Indices.Num());
+	}
+
+	// Within the limit no simplified vertex moves further than the maximum error away from the vertices of its cluster
+	FMeshBuilder SmallBuilder;
+	SmallBuilder.AddGrid(20, 10.0f);
+	Settings.MaxSimplificationError = 25.0f;
+	Settings.MaxSimplifiedTriangles = NumTriangles;
+	const FCollisionData Simplified = Vitruvio::CreateCollisionData(SmallBuilder.GetMeshDescription(), Settings);
+	TestTrue(TEXT("Mesh has been simplified"), Simplified.Indices.Num() > 0 && Simplified.Indices.Num() < 20 * 20 * 2);
+
+	const TArray<FVector3f> OriginalVertices = SmallBuilder.GetVertexPositions();
+	for (const FVector3f& Vertex : Simplified.Vertices)
+	{
+		float MinDistance = TNumericLimits<float>::Max();
+		for (const FVector3f& OriginalVertex : OriginalVertices)
+		{
+			MinDistance = FMath::Min(MinDistance, FVector3f::Distance(Vertex, OriginalVertex));
+		}
+		if (!TestTrue(TEXT("Simplified vertex is within the maximum error"), MinDistance <= Settings.MaxSimplificationError))
+		{
+			break;
+		}
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,102 @@
+/* Copyright 2024 Esri
+ *
+ * Licensed under the Apache License Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Misc/AutomationTest.h"
+#include "Tests/MockGenerateBackend.h"
+#include "VitruvioModule.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace GenerateCountersTests
+{
+constexpr double TimeoutSeconds = 10.0;
+} // namespace GenerateCountersTests
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGenerateCountersInFlightTest, "Vitruvio.GenerateCounters.InFlightGenerates",
+								 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FGenerateCountersInFlightTest::RunTest(const FString& Parameters)
+{
+	using namespace GenerateCountersTests;
+	using namespace VitruvioTests;
+
+	VitruvioModule& Module = VitruvioModule::Get();
+	const FScopedMockGenerateBackend Backend;
+	URulePackage* RulePackage = CreateRulePackage();
+
+	Backend->Block();
+	FBatchGenerateResult Result = Module.BatchGenerateAsync({CreateInitialShape(RulePackage, 0), CreateInitialShape(RulePackage, 1),
+															 CreateInitialShape(RulePackage, 2)});
+	FGenerateResult SingleResult = Module.GenerateAsync(CreateInitialShape(RulePackage, 3));
+
+	// Both calls wait for the same load, one is then blocked in the mock generator while the other one may wait for a worker thread
+	if (!TestTrue(TEXT("Generate has been called"), Backend->WaitForGenerateCalls(1, TimeoutSeconds)))
+	{
+		return false;
+	}
+
+	const double EndTime = FPlatformTime::Seconds() + TimeoutSeconds;
+	while (Module.GetNumGenerateCalls() < 4 && FPlatformTime::Seconds() < EndTime)
+	{
+		FPlatformProcess::Sleep(0.001f);
+	}
+
+	TestEqual(TEXT("Every initial shape is counted as one in-flight generate call"), Module.GetNumGenerateCalls(), 4);
+	TestTrue(TEXT("Module is generating"), Module.IsGenerating());
+
+	Backend->Release();
+	const FGenerateResultDescription BatchDescription = Result.Result.Get().Value;
+	SingleResult.Result.Wait();
+
+	TestTrue(TEXT("Waiting for idle succeeds"), Module.WaitUntilIdle(TimeoutSeconds));
+	TestEqual(TEXT("All in-flight generate calls have been released"), Module.GetNumGenerateCalls(), 0);
+	TestEqual(TEXT("Rule Package has been loaded once"), Backend->NumLoads.GetValue(), 1);
+	TestEqual(TEXT("Attributes have been evaluated for every initial shape"), BatchDescription.EvaluatedAttributes.Num(), 3);
+	TestTrue(TEXT("Stage timings are measured"), BatchDescription.LoadResolveMapTime >= 0.0 && BatchDescription.EvaluateAttributesTime >= 0.0 &&
+													BatchDescription.GenerateTime >= 0.0);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGenerateCountersFailedLoadTest, "Vitruvio.GenerateCounters.FailedLoadReleasesCounters",
+								 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FGenerateCountersFailedLoadTest::RunTest(const FString& Parameters)
+{
+	using namespace GenerateCountersTests;
+	using namespace VitruvioTests;
+
+	VitruvioModule& Module = VitruvioModule::Get();
+	const FScopedMockGenerateBackend Backend;
+	URulePackage* RulePackage = CreateRulePackage();
+	Backend->SetFailing(RulePackage);
+
+	const FGenerateResultDescription Result = Module.BatchGenerate({CreateInitialShape(RulePackage, 0), CreateInitialShape(RulePackage, 1)});
+	FAttributeMapResult AttributeResult = Module.EvaluateRuleAttributesAsync(CreateInitialShape(RulePackage, 2));
+	TestFalse(TEXT("Attribute evaluation of a failed Rule Package has no result"), AttributeResult.Result.Get().Value.IsValid());
+
+	TestTrue(TEXT("Waiting for idle succeeds"), Module.WaitUntilIdle(TimeoutSeconds));
+	TestFalse(TEXT("No model has been generated"), Result.GeneratedModel.IsValid());
+	TestEqual(TEXT("Failed generate calls are released"), Module.GetNumGenerateCalls(), 0);
+	TestFalse(TEXT("Failed loads are released"), Module.IsLoadingRpks());
+	TestEqual(TEXT("Nothing is generated"), Backend->NumGenerateCalls.GetValue(), 0);
+
+	// Failed loads are not cached, every request tries again
+	TestEqual(TEXT("Rule Package has been loaded twice"), Backend->NumLoads.GetValue(), 2);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,127 @@
+/* Copyright 2024 Esri
+ *
+ * Licensed under the Apache License Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Async/TaskGraphInterfaces.h"
+#include "Misc/AutomationTest.h"
+#include "Tests/MockGenerateBackend.h"
+#include "VitruvioComponent.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace GenerateRequestReplayTests
+{
+constexpr double TimeoutSeconds = 10.0;
+constexpr int32 NumEdits = 200;
+constexpr int32 NumBursts = 4;
+constexpr int32 NumEditsPerBurst = NumEdits / NumBursts;
+
+// Delivers the results to the game thread like the engine would until the given condition is met
+bool WaitUntil(UVitruvioComponent* VitruvioComponent, TFunctionRef<bool()> Condition)
+{
+	const double EndTime = FPlatformTime::Seconds() + TimeoutSeconds;
+	while (FPlatformTime::Seconds() < EndTime)
+	{
+		FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+		VitruvioComponent->TickComponent(0.0f, LEVELTICK_All, nullptr);
+		if (Condition())
+		{
+			return true;
+		}
+		FPlatformProcess::Sleep(0.001f);
+	}
+	return false;
+}
+} // namespace GenerateRequestReplayTests
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGenerateRequestReplayTest, "Vitruvio.GenerateRequest.ReplayEdits",
+								 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FGenerateRequestReplayTest::RunTest(const FString& Parameters)
+{
+	using namespace GenerateRequestReplayTests;
+	using namespace VitruvioTests;
+
+	const FScopedMockGenerateBackend Backend;
+	URulePackage* RulePackage = CreateRulePackage();
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("GenerateRequestReplayTest"));
+	UVitruvioComponent* VitruvioComponent = CreateVitruvioComponent(World, RulePackage, FVector::ZeroVector);
+	VitruvioComponent->RegenerateDelay = 0.1f;
+
+	// Every built model changes the hierarchy of the component
+	int32 NumBuiltModels = 0;
+	const FDelegateHandle HierarchyChangedHandle = UVitruvioComponent::OnHierarchyChanged.AddLambda(
+		[VitruvioComponent, &NumBuiltModels](UVitruvioComponent* Component)
+		{
+			if (Component == VitruvioComponent)
+			{
+				++NumBuiltModels;
+			}
+		});
+
+	VitruvioComponent->TickComponent(0.0f, LEVELTICK_All, nullptr);
+	VitruvioComponent->EvaluateRuleAttributes(true);
+	const bool bGenerated = WaitUntil(VitruvioComponent, [VitruvioComponent]()
+	{
+		return VitruvioComponent->HasGeneratedModel() && !VitruvioComponent->HasPendingPrtCalls();
+	});
+	if (!TestTrue(TEXT("Initial model has been generated"), bGenerated))
+	{
+		UVitruvioComponent::OnHierarchyChanged.Remove(HierarchyChangedHandle);
+		World->DestroyWorld(false);
+		return false;
+	}
+
+	const int32 InitialGenerateCalls = Backend->NumGenerateCalls.GetValue();
+	int32 Edit = 0;
+	for (int32 Burst = 0; Burst < NumBursts; ++Burst)
+	{
+		// Like dragging the initial shape, every other burst pauses while the shape is still held and the others end with releasing it
+		const bool bReleased = Burst % 2 == 1;
+		const int32 GenerateCallsBefore = Backend->NumGenerateCalls.GetValue();
+		const int32 NumBuiltModelsBefore = NumBuiltModels;
+
+		for (int32 BurstEdit = 0; BurstEdit < NumEditsPerBurst; ++BurstEdit, ++Edit)
+		{
+			const bool bInteractive = !bReleased || BurstEdit < NumEditsPerBurst - 1;
+			VitruvioComponent->InitialShape->SetPolygon(CreateInitialShape(RulePackage, 0, 1000.0 + Edit).Polygon);
+			VitruvioComponent->RequestGenerate(false, true, bInteractive);
+			VitruvioComponent->TickComponent(0.0f, LEVELTICK_All, nullptr);
+		}
+
+		// Every generate call of a burst has to be built, results are never discarded
+		const bool bSettled = WaitUntil(VitruvioComponent, [&]()
+		{
+			const int32 NumGenerateCalls = Backend->NumGenerateCalls.GetValue() - GenerateCallsBefore;
+			return NumGenerateCalls > 0 && NumBuiltModels - NumBuiltModelsBefore == NumGenerateCalls && !VitruvioComponent->HasPendingPrtCalls();
+		});
+		if (!TestTrue(TEXT("Burst has been generated"), bSettled))
+		{
+			break;
+		}
+
+		TestEqual(TEXT("Edits of a burst are coalesced into a single generate call"), Backend->NumGenerateCalls.GetValue() - GenerateCallsBefore, 1);
+		TestEqual(TEXT("Only interactive edits generate a preview"), VitruvioComponent->HasPreviewModel(), !bReleased);
+	}
+
+	TestEqual(TEXT("One generate call per burst"), Backend->NumGenerateCalls.GetValue() - InitialGenerateCalls, NumBursts);
+	TestFalse(TEXT("Final model is complete"), VitruvioComponent->HasPreviewModel());
+
+	UVitruvioComponent::OnHierarchyChanged.Remove(HierarchyChangedHandle);
+	TestTrue(TEXT("Waiting for idle succeeds"), VitruvioModule::Get().WaitUntilIdle(TimeoutSeconds));
+	World->DestroyWorld(false);
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,174 @@
+/* Copyright 2024 Esri
+ *
+ * Licensed under the Apache License Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "GenerateResultCache.h"
+#include "Misc/AutomationTest.h"
+#include "VitruvioModule.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace GenerateResultCacheTests
+{
+using FGenerateResultPtr = FGenerateResultCache::FGenerateResultPtr;
+
+constexpr int32 NumRequests = 8;
+
+FGenerateResultKey CreateKey(int32 RandomSeed)
+{
+	FInitialShapePolygon Polygon;
+	Polygon.Vertices = {FVector(0.0, 0.0, 0.0), FVector(1000.0, 0.0, 0.0), FVector(1000.0, 1000.0, 0.0), FVector(0.0, 1000.0, 0.0)};
+	Polygon.Faces.AddDefaulted_GetRef().Indices = {0, 1, 2, 3};
+
+	TArray<TPair<FString, FString>> Attributes;
+	Attributes.Emplace(TEXT("Height"), TEXT("10"));
+
+	return FGenerateResultKey(nullptr, Polygon, MoveTemp(Attributes), RandomSeed, FGeneratedCollisionSettings());
+}
+
+// Only non empty results are cached
+FGenerateResultPtr CreateResult()
+{
+	TSharedPtr<FGenerateResultDescription, ESPMode::ThreadSafe> Result = MakeShared<FGenerateResultDescription, ESPMode::ThreadSafe>();
+	Result->Instances.Add(Vitruvio::FInstanceCacheKey{TEXT("Instance"), {}}, TArray<FTransform>{FTransform::Identity});
+	return Result;
+}
+} // namespace GenerateResultCacheTests
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGenerateResultCacheCoalescingTest, "Vitruvio.GenerateResultCache.EqualRequestsGenerateOnce",
+								 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FGenerateResultCacheCoalescingTest::RunTest(const FString& Parameters)
+{
+	using namespace GenerateResultCacheTests;
+
+	FGenerateResultCache Cache;
+	const FGenerateResultPtr Result = CreateResult();
+
+	FThreadSafeCounter NumGenerateCalls;
+	FEvent* ReleaseGenerate = FPlatformProcess::GetSynchEventFromPool(true);
+
+	// The first request blocks in Generate until all other requests have been made, so they all take the in flight path
+	TArray<TFuture<FGenerateResultPtr>> Futures;
+	for (int32 RequestIndex = 0; RequestIndex < NumRequests; ++RequestIndex)
+	{
+		Futures.Add(Cache.GetOrGenerateAsync(CreateKey(0), [&NumGenerateCalls, ReleaseGenerate, Result]() {
+			NumGenerateCalls.Increment();
+			ReleaseGenerate->Wait();
+			return Result;
+		}));
+	}
+
+	TestFalse(TEXT("Requests wait for the generate call in flight"), Futures.Last().IsReady());
+
+	ReleaseGenerate->Trigger();
+	for (TFuture<FGenerateResultPtr>& Future : Futures)
+	{
+		TestTrue(TEXT("Waiting requests share the result"), Future.Get() == Result);
+	}
+	TestEqual(TEXT("Generate calls for requests in flight"), NumGenerateCalls.GetValue(), 1);
+
+	// Cached results are returned immediately without generating again
+	TFuture<FGenerateResultPtr> Cached = Cache.GetOrGenerateAsync(CreateKey(0), [&NumGenerateCalls, Result]() {
+		NumGenerateCalls.Increment();
+		return Result;
+	});
+	TestTrue(TEXT("Cached result is ready"), Cached.IsReady());
+	TestTrue(TEXT("Cached result is shared"), Cached.Get() == Result);
+	TestEqual(TEXT("Generate calls for cached requests"), NumGenerateCalls.GetValue(), 1);
+
+	// A request with a different key generates again
+	TFuture<FGenerateResultPtr> Other = Cache.GetOrGenerateAsync(CreateKey(1), [&NumGenerateCalls]() {
+		NumGenerateCalls.Increment();
+		return CreateResult();
+	});
+	TestTrue(TEXT("Other key generates a new result"), Other.Get() != Result);
+	TestEqual(TEXT("Generate calls for different keys"), NumGenerateCalls.GetValue(), 2);
+
+	FPlatformProcess::ReturnSynchEventToPool(ReleaseGenerate);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGenerateResultCacheFailedTest, "Vitruvio.GenerateResultCache.FailedResultsAreRetried",
+								 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FGenerateResultCacheFailedTest::RunTest(const FString& Parameters)
+{
+	using namespace GenerateResultCacheTests;
+
+	FGenerateResultCache Cache;
+	FThreadSafeCounter NumGenerateCalls;
+
+	for (int32 RequestIndex = 0; RequestIndex < 2; ++RequestIndex)
+	{
+		TFuture<FGenerateResultPtr> Future = Cache.GetOrGenerateAsync(CreateKey(0), [&NumGenerateCalls]() {
+			NumGenerateCalls.Increment();
+			return FGenerateResultPtr();
+		});
+		TestFalse(TEXT("Failed result is empty"), Future.Get().IsValid());
+	}
+
+	TestEqual(TEXT("Generate calls after a failed result"), NumGenerateCalls.GetValue(), 2);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGenerateResultCacheEvictionTest, "Vitruvio.GenerateResultCache.LeastRecentlyUsedEvicted",
+								 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FGenerateResultCacheEvictionTest::RunTest(const FString& Parameters)
+{
+	using namespace GenerateResultCacheTests;
+
+	FGenerateResultCache Cache;
+	Cache.SetMaxEntries(NumRequests);
+	FThreadSafeCounter NumGenerateCalls;
+
+	auto Request = [&Cache, &NumGenerateCalls](int32 RandomSeed) {
+		return Cache.GetOrGenerateAsync(CreateKey(RandomSeed), [&NumGenerateCalls]() {
+			NumGenerateCalls.Increment();
+			return CreateResult();
+		}).Get();
+	};
+
+	for (int32 RandomSeed = 0; RandomSeed < NumRequests; ++RandomSeed)
+	{
+		Request(RandomSeed);
+	}
+
+	// The hit makes the first result the most recently used one, every later insert evicts the oldest of the others
+	Request(0);
+	for (int32 RandomSeed = NumRequests; RandomSeed < 2 * NumRequests - 1; ++RandomSeed)
+	{
+		Request(RandomSeed);
+	}
+	TestEqual(TEXT("Generate calls before requesting evicted results"), NumGenerateCalls.GetValue(), 2 * NumRequests - 1);
+
+	Request(0);
+	TestEqual(TEXT("Recently used result is kept"), NumGenerateCalls.GetValue(), 2 * NumRequests - 1);
+	Request(1);
+	TestEqual(TEXT("Least recently used result is evicted"), NumGenerateCalls.GetValue(), 2 * NumRequests);
+
+	// Lowering the limit evicts all but the most recently used results at once
+	Cache.SetMaxEntries(1);
+	Request(1);
+	TestEqual(TEXT("Most recently used result is kept after lowering the limit"), NumGenerateCalls.GetValue(), 2 * NumRequests);
+	Request(0);
+	TestEqual(TEXT("Other results are evicted after lowering the limit"), NumGenerateCalls.GetValue(), 2 * NumRequests + 1);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
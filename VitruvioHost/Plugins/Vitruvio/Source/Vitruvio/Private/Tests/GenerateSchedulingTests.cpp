@@ -0,0 +1,254 @@
+/* Copyright 2024 Esri
+ *
+ * Licensed under the Apache License Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Async/Async.h"
+#include "Async/ParallelFor.h"
+#include "GenerateScheduling.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/ScopeLock.h"
+#include "RulePackage.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+bool WaitForWaiting(const Vitruvio::FWorkerThreadBudget& WorkerThreadBudget, int32 NumWaiting, double TimeoutSeconds = 10.0)
+{
+	const double EndTime = FPlatformTime::Seconds() + TimeoutSeconds;
+	while (WorkerThreadBudget.GetNumWaiting() < NumWaiting)
+	{
+		if (FPlatformTime::Seconds() > EndTime)
+		{
+			return false;
+		}
+		FPlatformProcess::Sleep(0.001f);
+	}
+	return true;
+}
+
+// Acquires threads on a new thread and returns once the request is waiting as the NumWaiting-th request, which fixes the order of requests
+TFuture<int32> AcquireAsync(Vitruvio::FWorkerThreadBudget& WorkerThreadBudget, int32 Requested, int32 Budget, int32 NumWaiting)
+{
+	TFuture<int32> Result = Async(EAsyncExecution::Thread, [&WorkerThreadBudget, Requested, Budget]()
+	{
+		return WorkerThreadBudget.Acquire(Requested, Budget);
+	});
+	WaitForWaiting(WorkerThreadBudget, NumWaiting);
+	return Result;
+}
+
+FInitialShapeFace CreateSquareFace(FInitialShapePolygon& Polygon, double Size)
+{
+	FInitialShapeFace Face;
+	const int32 FirstIndex = Polygon.Vertices.Num();
+	Polygon.Vertices.Add(FVector(0, 0, 0));
+	Polygon.Vertices.Add(FVector(Size, 0, 0));
+	Polygon.Vertices.Add(FVector(Size, Size, 0));
+	Polygon.Vertices.Add(FVector(0, Size, 0));
+	Face.Indices = {FirstIndex, FirstIndex + 1, FirstIndex + 2, FirstIndex + 3};
+	return Face;
+}
+} // namespace
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FEstimateGeometryCostTest, "Vitruvio.GenerateScheduling.EstimateGeometryCost",
+								 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FEstimateGeometryCostTest::RunTest(const FString& Parameters)
+{
+	// 10m x 10m square: 1 + 100m^2 * 0.01 + 4 vertices * 0.05
+	FInitialShapePolygon Square;
+	Square.Faces.Add(CreateSquareFace(Square, 1000.0));
+	TestEqual(TEXT("Square"), Vitruvio::EstimateGeometryCost(Square), 2.2, UE_KINDA_SMALL_NUMBER);
+
+	// The area of holes is subtracted while their vertices are still counted
+	FInitialShapePolygon SquareWithHole;
+	FInitialShapeFace Face = CreateSquareFace(SquareWithHole, 1000.0);
+	FInitialShapeHole Hole;
+	Hole.Indices = CreateSquareFace(SquareWithHole, 500.0).Indices;
+	Face.Holes.Add(Hole);
+	SquareWithHole.Faces.Add(Face);
+	TestEqual(TEXT("Square with hole"), Vitruvio::EstimateGeometryCost(SquareWithHole), 2.15, UE_KINDA_SMALL_NUMBER);
+
+	TestEqual(TEXT("Empty polygon"), Vitruvio::EstimateGeometryCost(FInitialShapePolygon()), 1.0, UE_KINDA_SMALL_NUMBER);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLongestFirstOrderTest, "Vitruvio.GenerateScheduling.LongestFirstOrder",
+								 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FLongestFirstOrderTest::RunTest(const FString& Parameters)
+{
+	// Shapes with equal costs keep their original order
+	TestEqual(TEXT("Order"), Vitruvio::GetLongestFirstOrder({1.0, 5.0, 3.0, 5.0, 2.0}), TArray<int32>{1, 3, 2, 4, 0});
+	TestEqual(TEXT("Equal costs"), Vitruvio::GetLongestFirstOrder({2.0, 2.0, 2.0}), TArray<int32>{0, 1, 2});
+	TestTrue(TEXT("Empty"), Vitruvio::GetLongestFirstOrder({}).IsEmpty());
+
+	// Costs collected in another order than the shapes, eg. grouped by Rule Package, are ordered by shape index on ties
+	TestEqual(TEXT("Ties broken by shape index"), Vitruvio::GetLongestFirstOrder({2.0, 5.0, 2.0, 2.0}, {3, 0, 1, 2}), TArray<int32>{1, 2, 3, 0});
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FUsefulWorkerThreadsTest, "Vitruvio.GenerateScheduling.UsefulWorkerThreads",
+								 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FUsefulWorkerThreadsTest::RunTest(const FString& Parameters)
+{
+	// A single expensive shape bounds the makespan, more threads than total cost / max cost do not finish earlier
+	TestEqual(TEXT("Dominated by one shape"), Vitruvio::GetUsefulWorkerThreads({4.0, 1.0, 1.0, 1.0, 1.0}, 8), 2);
+	TestEqual(TEXT("Equal costs"), Vitruvio::GetUsefulWorkerThreads({1.0, 1.0, 1.0, 1.0}, 8), 4);
+	TestEqual(TEXT("Limited by max threads"), Vitruvio::GetUsefulWorkerThreads({1.0, 1.0, 1.0, 1.0}, 2), 2);
+	TestEqual(TEXT("No costs"), Vitruvio::GetUsefulWorkerThreads({}, 8), 1);
+	TestEqual(TEXT("Zero costs"), Vitruvio::GetUsefulWorkerThreads({0.0, 0.0, 0.0}, 8), 3);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWorkerThreadBudgetTest, "Vitruvio.GenerateScheduling.WorkerThreadBudget",
+								 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FWorkerThreadBudgetTest::RunTest(const FString& Parameters)
+{
+	constexpr int32 Budget = 8;
+
+	{
+		// Concurrent requests get at most their fair share and together stay within the budget
+		Vitruvio::FWorkerThreadBudget WorkerThreadBudget;
+		const int32 First = WorkerThreadBudget.Acquire(3, Budget);
+		const int32 Second = WorkerThreadBudget.Acquire(3, Budget);
+		const int32 Third = WorkerThreadBudget.Acquire(3, Budget);
+		TestEqual(TEXT("First request"), First, 3);
+		TestEqual(TEXT("Second request"), Second, 3);
+		TestEqual(TEXT("Third request limited by the remaining budget"), Third, 2);
+		TestTrue(TEXT("Within budget"), First + Second + Third <= Budget);
+	}
+
+	{
+		Vitruvio::FWorkerThreadBudget WorkerThreadBudget;
+		const int32 A = WorkerThreadBudget.Acquire(Budget, Budget);
+		TestEqual(TEXT("Single request gets the whole budget"), A, Budget);
+
+		// An exhausted budget blocks further requests, which are then served in order
+		TFuture<int32> B = AcquireAsync(WorkerThreadBudget, Budget, Budget, 1);
+		TFuture<int32> C = AcquireAsync(WorkerThreadBudget, 2, Budget, 2);
+		if (!TestTrue(TEXT("Requests wait while the budget is exhausted"), WaitForWaiting(WorkerThreadBudget, 2)))
+		{
+			WorkerThreadBudget.Release(A);
+			return false;
+		}
+		TestFalse(TEXT("First waiting request is blocked"), B.IsReady());
+		TestFalse(TEXT("Second waiting request is blocked"), C.IsReady());
+
+		WorkerThreadBudget.Release(A);
+
+		// The first waiting request does not take the threads of the request behind it
+		TestEqual(TEXT("Fair share of two requests"), B.Get(), Budget / 2);
+
+		// Requests never get more threads than they can use
+		TestEqual(TEXT("Limited by requested threads"), C.Get(), 2);
+
+		const int32 D = WorkerThreadBudget.Acquire(Budget, Budget);
+		TestEqual(TEXT("Limited by available threads"), D, Budget - Budget / 2 - 2);
+
+		TFuture<int32> E = AcquireAsync(WorkerThreadBudget, 0, Budget, 1);
+		if (!TestTrue(TEXT("Request waits while the budget is exhausted"), WaitForWaiting(WorkerThreadBudget, 1)))
+		{
+			WorkerThreadBudget.Release(D);
+			return false;
+		}
+		WorkerThreadBudget.Release(D);
+		TestEqual(TEXT("At least one thread"), E.Get(), 1);
+
+		WorkerThreadBudget.Release(B.Get());
+		WorkerThreadBudget.Release(C.Get());
+		WorkerThreadBudget.Release(E.Get());
+
+		TestEqual(TEXT("Whole budget available after release"), WorkerThreadBudget.Acquire(Budget, Budget), Budget);
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWorkerThreadBudgetContentionTest, "Vitruvio.GenerateScheduling.WorkerThreadBudgetContention",
+								 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FWorkerThreadBudgetContentionTest::RunTest(const FString& Parameters)
+{
+	constexpr int32 Budget = 4;
+	constexpr int32 NumRequests = 64;
+
+	Vitruvio::FWorkerThreadBudget WorkerThreadBudget;
+	FThreadSafeCounter NumThreadsInUse;
+	FCriticalSection MaxThreadsInUseLock;
+	int32 MaxThreadsInUse = 0;
+
+	// More concurrent requests than threads in the budget, the threads in use must never exceed the budget
+	ParallelFor(NumRequests, [&](int32 RequestIndex)
+	{
+		const int32 NumThreads = WorkerThreadBudget.Acquire(1 + RequestIndex % Budget, Budget);
+		const int32 InUse = NumThreadsInUse.Add(NumThreads) + NumThreads;
+		{
+			FScopeLock Lock(&MaxThreadsInUseLock);
+			MaxThreadsInUse = FMath::Max(MaxThreadsInUse, InUse);
+		}
+
+		FPlatformProcess::Sleep(0.001f);
+		NumThreadsInUse.Subtract(NumThreads);
+		WorkerThreadBudget.Release(NumThreads);
+	});
+
+	TestTrue(TEXT("Threads in use never exceed the budget"), MaxThreadsInUse <= Budget);
+	TestEqual(TEXT("No request is waiting anymore"), WorkerThreadBudget.GetNumWaiting(), 0);
+	TestEqual(TEXT("Whole budget available after release"), WorkerThreadBudget.Acquire(Budget, Budget), Budget);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGenerateCostModelTest, "Vitruvio.GenerateScheduling.GenerateCostModel",
+								 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FGenerateCostModelTest::RunTest(const FString& Parameters)
+{
+	const URulePackage* RulePackageA = NewObject<URulePackage>();
+	const URulePackage* RulePackageB = NewObject<URulePackage>();
+	const URulePackage* RulePackageC = NewObject<URulePackage>();
+
+	Vitruvio::FGenerateCostModel CostModel;
+	TestEqual(TEXT("Default without observations"), CostModel.GetSecondsPerCost(RulePackageA), 0.001, UE_KINDA_SMALL_NUMBER);
+
+	CostModel.Observe(RulePackageA, 10.0, 1.0);
+	TestEqual(TEXT("First observation"), CostModel.GetSecondsPerCost(RulePackageA), 0.1, UE_KINDA_SMALL_NUMBER);
+	TestEqual(TEXT("Unobserved uses the average"), CostModel.GetSecondsPerCost(RulePackageB), 0.1, UE_KINDA_SMALL_NUMBER);
+
+	// Later observations are blended in with a weight of 0.25
+	CostModel.Observe(RulePackageA, 10.0, 2.0);
+	TestEqual(TEXT("Blended observation"), CostModel.GetSecondsPerCost(RulePackageA), 0.125, UE_KINDA_SMALL_NUMBER);
+
+	CostModel.Observe(RulePackageB, 10.0, 0.5);
+	TestEqual(TEXT("Average of observed"), CostModel.GetSecondsPerCost(RulePackageC), (0.125 + 0.05) / 2.0, UE_KINDA_SMALL_NUMBER);
+
+	// Invalid observations are ignored
+	CostModel.Observe(RulePackageB, 0.0, 1.0);
+	CostModel.Observe(RulePackageB, 10.0, 0.0);
+	TestEqual(TEXT("Invalid observations"), CostModel.GetSecondsPerCost(RulePackageB), 0.05, UE_KINDA_SMALL_NUMBER);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
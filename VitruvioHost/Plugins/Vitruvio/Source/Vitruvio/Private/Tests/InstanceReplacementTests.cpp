@@ -0,0 +1,214 @@
+/* Copyright 2024 Esri
+ *
+ * Licensed under the Apache License Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Algo/Reverse.h"
+#include "Misc/AutomationTest.h"
+#include "VitruvioComponent.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace InstanceReplacementTests
+{
+FInstanceReplacement CreateInstanceReplacement()
+{
+	FInstanceReplacement InstanceReplacement;
+
+	InstanceReplacement.Replacements.AddDefaulted_GetRef().Frequency = 1.0;
+
+	FReplacementOption& UniformScale = InstanceReplacement.Replacements.AddDefaulted_GetRef();
+	UniformScale.Frequency = 2.0;
+	UniformScale.bRandomScale = true;
+	UniformScale.UniformMinScale = 0.5f;
+	UniformScale.UniformMaxScale = 2.0f;
+
+	FReplacementOption& ScaleAndRotation = InstanceReplacement.Replacements.AddDefaulted_GetRef();
+	ScaleAndRotation.Frequency = 3.0;
+	ScaleAndRotation.bRandomScale = true;
+	ScaleAndRotation.bUniformScale = false;
+	ScaleAndRotation.MinScale = {0.5, 0.75, 1.0};
+	ScaleAndRotation.MaxScale = {1.5, 1.25, 3.0};
+	ScaleAndRotation.bRandomRotation = true;
+	ScaleAndRotation.MaxRotation = {0.0, 0.0, 360.0};
+
+	return InstanceReplacement;
+}
+
+TArray<FTransform> CreateTransforms(int32 NumTransforms)
+{
+	TArray<FTransform> Transforms;
+	for (int32 TransformIndex = 0; TransformIndex < NumTransforms; ++TransformIndex)
+	{
+		Transforms.Add(FTransform(FVector((TransformIndex % 100) * 137.0, (TransformIndex / 100) * 91.0, TransformIndex % 7)));
+	}
+	return Transforms;
+}
+
+bool AreTransformsIdentical(const TArray<FTransform>& A, const TArray<FTransform>& B)
+{
+	if (A.Num() != B.Num())
+	{
+		return false;
+	}
+
+	for (int32 TransformIndex = 0; TransformIndex < A.Num(); ++TransformIndex)
+	{
+		if (!A[TransformIndex].Equals(B[TransformIndex], 0.0))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+} // namespace InstanceReplacementTests
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInstanceReplacementThreadingTest, "Vitruvio.InstanceReplacement.SamplingIndependentOfThreads",
+								 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FInstanceReplacementThreadingTest::RunTest(const FString& Parameters)
+{
+	using namespace InstanceReplacementTests;
+
+	const FInstanceReplacement InstanceReplacement = CreateInstanceReplacement();
+	const TArray<FTransform> Transforms = CreateTransforms(5000);
+	constexpr uint32 InstanceSeed = 42;
+
+	TArray<int32> SingleThreadOptions;
+	TArray<FTransform> SingleThreadTransforms;
+	SampleInstanceReplacements(InstanceReplacement, Transforms, InstanceSeed, true, SingleThreadOptions, SingleThreadTransforms);
+
+	TArray<int32> ParallelOptions;
+	TArray<FTransform> ParallelTransforms;
+	SampleInstanceReplacements(InstanceReplacement, Transforms, InstanceSeed, false, ParallelOptions, ParallelTransforms);
+
+	TestTrue(TEXT("Same options with and without threads"), SingleThreadOptions == ParallelOptions);
+	TestTrue(TEXT("Same transforms with and without threads"), AreTransformsIdentical(SingleThreadTransforms, ParallelTransforms));
+
+	TArray<int32> NumSamplesPerOption;
+	NumSamplesPerOption.SetNumZeroed(InstanceReplacement.Replacements.Num());
+	for (const int32 OptionIndex : SingleThreadOptions)
+	{
+		++NumSamplesPerOption[OptionIndex];
+	}
+	for (int32 OptionIndex = 0; OptionIndex < NumSamplesPerOption.Num(); ++OptionIndex)
+	{
+		TestTrue(FString::Printf(TEXT("Option %d is sampled"), OptionIndex), NumSamplesPerOption[OptionIndex] > 0);
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInstanceReplacementOrderTest, "Vitruvio.InstanceReplacement.SamplingIndependentOfOrder",
+								 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FInstanceReplacementOrderTest::RunTest(const FString& Parameters)
+{
+	using namespace InstanceReplacementTests;
+
+	const FInstanceReplacement InstanceReplacement = CreateInstanceReplacement();
+	const TArray<FTransform> Transforms = CreateTransforms(500);
+	TArray<FTransform> ReversedTransforms = Transforms;
+	Algo::Reverse(ReversedTransforms);
+	constexpr uint32 InstanceSeed = 7;
+
+	TArray<int32> Options;
+	TArray<FTransform> SampledTransforms;
+	SampleInstanceReplacements(InstanceReplacement, Transforms, InstanceSeed, true, Options, SampledTransforms);
+
+	TArray<int32> ReversedOptions;
+	TArray<FTransform> ReversedSampledTransforms;
+	SampleInstanceReplacements(InstanceReplacement, ReversedTransforms, InstanceSeed, true, ReversedOptions, ReversedSampledTransforms);
+
+	Algo::Reverse(ReversedOptions);
+	Algo::Reverse(ReversedSampledTransforms);
+	TestTrue(TEXT("Same options for reversed transforms"), Options == ReversedOptions);
+	TestTrue(TEXT("Same transforms for reversed transforms"), AreTransformsIdentical(SampledTransforms, ReversedSampledTransforms));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInstanceReplacementColocatedTest, "Vitruvio.InstanceReplacement.ColocatedInstancesSampledIndependently",
+								 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FInstanceReplacementColocatedTest::RunTest(const FString& Parameters)
+{
+	using namespace InstanceReplacementTests;
+
+	const FInstanceReplacement InstanceReplacement = CreateInstanceReplacement();
+	TArray<FTransform> Transforms;
+	Transforms.Init(FTransform(FVector(100.0, 200.0, 0.0)), 600);
+	constexpr uint32 InstanceSeed = 11;
+
+	TArray<int32> Options;
+	TArray<FTransform> SampledTransforms;
+	SampleInstanceReplacements(InstanceReplacement, Transforms, InstanceSeed, true, Options, SampledTransforms);
+
+	TArray<int32> NumSamplesPerOption;
+	NumSamplesPerOption.SetNumZeroed(InstanceReplacement.Replacements.Num());
+	for (const int32 OptionIndex : Options)
+	{
+		++NumSamplesPerOption[OptionIndex];
+	}
+	for (int32 OptionIndex = 0; OptionIndex < NumSamplesPerOption.Num(); ++OptionIndex)
+	{
+		TestTrue(FString::Printf(TEXT("Option %d is sampled for co-located instances"), OptionIndex), NumSamplesPerOption[OptionIndex] > 0);
+	}
+
+	TSet<double> Scales;
+	for (const FTransform& SampledTransform : SampledTransforms)
+	{
+		Scales.Add(SampledTransform.GetScale3D().Z);
+	}
+	TestTrue(TEXT("Co-located instances are scaled differently"), Scales.Num() > Transforms.Num() / 2);
+
+	TArray<int32> ParallelOptions;
+	TArray<FTransform> ParallelTransforms;
+	SampleInstanceReplacements(InstanceReplacement, Transforms, InstanceSeed, false, ParallelOptions, ParallelTransforms);
+	TestTrue(TEXT("Same options for co-located instances with and without threads"), Options == ParallelOptions);
+	TestTrue(TEXT("Same transforms for co-located instances with and without threads"),
+			 AreTransformsIdentical(SampledTransforms, ParallelTransforms));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInstanceReplacementBenchmark, "Vitruvio.InstanceReplacement.Benchmark",
+								 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FInstanceReplacementBenchmark::RunTest(const FString& Parameters)
+{
+	using namespace InstanceReplacementTests;
+
+	constexpr int32 NumTransforms = 100000;
+	const FInstanceReplacement InstanceReplacement = CreateInstanceReplacement();
+	TArray<FTransform> Transforms = CreateTransforms(NumTransforms / 2);
+	Transforms.Append(CreateTransforms(NumTransforms / 2));
+	constexpr uint32 InstanceSeed = 3;
+
+	for (const bool bForceSingleThread : {true, false})
+	{
+		TArray<int32> Options;
+		TArray<FTransform> SampledTransforms;
+		const double StartTime = FPlatformTime::Seconds();
+		SampleInstanceReplacements(InstanceReplacement, Transforms, InstanceSeed, bForceSingleThread, Options, SampledTransforms);
+		const double Seconds = FPlatformTime::Seconds() - StartTime;
+
+		TestEqual(TEXT("Every transform is sampled"), SampledTransforms.Num(), NumTransforms);
+		AddInfo(FString::Printf(TEXT("%s: sampled %d transforms with half of them co-located in %.2f ms"),
+								bForceSingleThread ? TEXT("Single thread") : TEXT("Parallel"), NumTransforms, Seconds * 1000.0));
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
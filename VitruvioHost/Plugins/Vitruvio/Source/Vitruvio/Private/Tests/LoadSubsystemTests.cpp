@@ -0,0 +1,239 @@
+/* Copyright 2024 Esri
+ *
+ * Licensed under the Apache License Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "Algo/AllOf.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "Engine/World.h"
+#include "Misc/AutomationTest.h"
+#include "Tests/MockGenerateBackend.h"
+#include "VitruvioComponent.h"
+#include "VitruvioLoadSubsystem.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace LoadSubsystemTests
+{
+constexpr double TimeoutSeconds = 60.0;
+constexpr int32 NumComponents = 5000;
+constexpr int32 NumRulePackages = 4;
+constexpr int32 MaxInFlightRequests = 8;
+constexpr double ComponentSpacing = 1000.0;
+
+// Same as the group size of the load subsystem
+constexpr int32 MaxComponentsPerEvaluation = 32;
+
+constexpr int32 NumPreloadComponents = 100;
+constexpr int32 NumUnrelatedActors = 10000;
+constexpr int32 LoadMilliseconds = 500;
+} // namespace LoadSubsystemTests
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLoadSubsystemLevelLoadTest, "Vitruvio.LoadSubsystem.LevelLoad",
+								 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FLoadSubsystemLevelLoadTest::RunTest(const FString& Parameters)
+{
+	using namespace LoadSubsystemTests;
+	using namespace VitruvioTests;
+
+	const FScopedMockGenerateBackend Backend;
+	VitruvioModule& Module = VitruvioModule::Get();
+
+	TArray<URulePackage*> RulePackages;
+	for (int32 Index = 0; Index < NumRulePackages; ++Index)
+	{
+		RulePackages.Add(CreateRulePackage());
+	}
+
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("LoadSubsystemLevelLoadTest"));
+	UVitruvioLoadSubsystem* LoadSubsystem = World->GetSubsystem<UVitruvioLoadSubsystem>();
+	if (!TestNotNull(TEXT("Load subsystem"), LoadSubsystem))
+	{
+		World->DestroyWorld(false);
+		return false;
+	}
+	LoadSubsystem->SetMaxInFlightRequests(MaxInFlightRequests);
+
+	// Components in a row away from the viewer, created from the farthest to the closest so that only the priority starts the closest first
+	World->ViewLocationsRenderedLastFrame = {FVector::ZeroVector};
+	TArray<UVitruvioComponent*> Components;
+	Components.SetNumZeroed(NumComponents);
+	for (int32 Index = NumComponents - 1; Index >= 0; --Index)
+	{
+		const FVector Location(Index * ComponentSpacing, 0.0, 0.0);
+		UVitruvioComponent* VitruvioComponent = CreateVitruvioComponent(World, RulePackages[Index % NumRulePackages], Location);
+		VitruvioComponent->GenerateAutomatically = true;
+		Components[Index] = VitruvioComponent;
+	}
+
+	// Like opening a level, all components are initialized in the same frame
+	const double StartTime = FPlatformTime::Seconds();
+	for (UVitruvioComponent* VitruvioComponent : Components)
+	{
+		VitruvioComponent->TickComponent(0.0f, LEVELTICK_All, nullptr);
+	}
+	TestEqual(TEXT("All components have been scheduled"), LoadSubsystem->GetNumTotal(), NumComponents);
+
+	int32 PeakGenerateCalls = 0;
+	int32 ClosestFirstVisible = INDEX_NONE;
+	int32 FarthestFirstVisible = INDEX_NONE;
+	const double EndTime = StartTime + TimeoutSeconds;
+	while (LoadSubsystem->IsLoading() && FPlatformTime::Seconds() < EndTime)
+	{
+		FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+		LoadSubsystem->Tick(0.0f);
+		for (UVitruvioComponent* VitruvioComponent : Components)
+		{
+			VitruvioComponent->TickComponent(0.0f, LEVELTICK_All, nullptr);
+		}
+		PeakGenerateCalls = FMath::Max(PeakGenerateCalls, Module.GetNumGenerateCalls());
+
+		// The time to the first visible model is only set once a model has actually been registered
+		if (ClosestFirstVisible == INDEX_NONE && LoadSubsystem->GetTimeToFirstVisibleModel() >= 0.0)
+		{
+			for (int32 Index = 0; Index < NumComponents; ++Index)
+			{
+				if (Components[Index]->HasGeneratedModel())
+				{
+					ClosestFirstVisible = ClosestFirstVisible == INDEX_NONE ? Index : ClosestFirstVisible;
+					FarthestFirstVisible = Index;
+				}
+			}
+		}
+
+		FPlatformProcess::Sleep(0.001f);
+	}
+	const double LoadSeconds = FPlatformTime::Seconds() - StartTime;
+
+	TestFalse(TEXT("Load has finished"), LoadSubsystem->IsLoading());
+	TestEqual(TEXT("All components have been completed"), LoadSubsystem->GetNumCompleted(), NumComponents);
+	TestTrue(TEXT("All components have a model"), Algo::AllOf(Components, [](const UVitruvioComponent* Component) {
+		return Component->HasGeneratedModel();
+	}));
+
+	TestTrue(TEXT("PRT calls in flight are limited"), LoadSubsystem->GetPeakInFlightRequests() <= MaxInFlightRequests);
+	TestTrue(TEXT("Generate calls in flight are limited"), PeakGenerateCalls <= MaxInFlightRequests);
+	TestTrue(TEXT("Components sharing a Rule Package are evaluated together"),
+			 Backend->NumEvaluateCalls.GetValue() <= NumComponents / MaxComponentsPerEvaluation + NumRulePackages);
+
+	const double TimeToFirstVisibleModel = LoadSubsystem->GetTimeToFirstVisibleModel();
+	TestTrue(TEXT("Time to the first visible model has been measured"), TimeToFirstVisibleModel >= 0.0 && TimeToFirstVisibleModel < LoadSeconds);
+	TestTrue(TEXT("A model is visible once the time has been measured"), ClosestFirstVisible != INDEX_NONE);
+
+	// The first evaluations in flight are the groups of the closest components, the first models are generated from one of them
+	TestTrue(TEXT("The closest components become visible first"), FarthestFirstVisible < MaxComponentsPerEvaluation * MaxInFlightRequests);
+
+	AddInfo(FString::Printf(TEXT("%d components loaded in %.2f s, first visible model after %.3f s, at most %d PRT calls in flight"),
+							NumComponents, LoadSeconds, TimeToFirstVisibleModel, LoadSubsystem->GetPeakInFlightRequests()));
+
+	TestTrue(TEXT("Waiting for idle succeeds"), Module.WaitUntilIdle(TimeoutSeconds));
+	World->DestroyWorld(false);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLoadSubsystemPreloadLatencyTest, "Vitruvio.LoadSubsystem.PreloadLatency",
+								 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FLoadSubsystemPreloadLatencyTest::RunTest(const FString& Parameters)
+{
+	using namespace LoadSubsystemTests;
+	using namespace VitruvioTests;
+
+	const FScopedMockGenerateBackend Backend;
+	Backend->SetLoadMilliseconds(LoadMilliseconds);
+	VitruvioModule& Module = VitruvioModule::Get();
+
+	URulePackage* FirstRulePackage = CreateRulePackage();
+	URulePackage* SecondRulePackage = CreateRulePackage();
+	URulePackage* UnregisteredRulePackage = CreateRulePackage();
+
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("LoadSubsystemPreloadLatencyTest"));
+	UVitruvioLoadSubsystem* LoadSubsystem = World->GetSubsystem<UVitruvioLoadSubsystem>();
+	if (!TestNotNull(TEXT("Load subsystem"), LoadSubsystem))
+	{
+		World->DestroyWorld(false);
+		return false;
+	}
+
+	// Actors without a VitruvioComponent must not slow down the preload
+	for (int32 Index = 0; Index < NumUnrelatedActors; ++Index)
+	{
+		World->SpawnActor<AActor>();
+	}
+
+	World->ViewLocationsRenderedLastFrame = {FVector::ZeroVector};
+	TArray<UVitruvioComponent*> Components;
+	for (int32 Index = 0; Index < NumPreloadComponents; ++Index)
+	{
+		const FVector Location(Index * ComponentSpacing, 0.0, 0.0);
+		UVitruvioComponent* VitruvioComponent = CreateVitruvioComponent(World, Index % 2 ? SecondRulePackage : FirstRulePackage, Location);
+		VitruvioComponent->GenerateAutomatically = true;
+		VitruvioComponent->RegisterComponent();
+		Components.Add(VitruvioComponent);
+	}
+
+	UVitruvioComponent* UnregisteredComponent = CreateVitruvioComponent(World, UnregisteredRulePackage, FVector::ZeroVector);
+	UnregisteredComponent->RegisterComponent();
+	UnregisteredComponent->UnregisterComponent();
+
+	// Like after opening a level, the Rule Packages are preloaded before the components are initialized on their first tick
+	const double PreloadStartTime = FPlatformTime::Seconds();
+	LoadSubsystem->PreloadRulePackages();
+	const double PreloadSeconds = FPlatformTime::Seconds() - PreloadStartTime;
+	TestTrue(TEXT("Preloading does not wait for the loads"), PreloadSeconds < LoadMilliseconds / 1000.0);
+
+	TestTrue(TEXT("Waiting for the preloads succeeds"), Module.WaitUntilIdle(TimeoutSeconds));
+	TestEqual(TEXT("First Rule Package has been preloaded once"), Backend->GetNumLoads(FirstRulePackage), 1);
+	TestEqual(TEXT("Second Rule Package has been preloaded once"), Backend->GetNumLoads(SecondRulePackage), 1);
+	TestEqual(TEXT("Rule Package of an unregistered component has not been preloaded"), Backend->GetNumLoads(UnregisteredRulePackage), 0);
+
+	LoadSubsystem->PreloadRulePackages();
+	TestFalse(TEXT("Preloaded Rule Packages are not loaded again"), Module.IsLoadingRpks());
+
+	const double StartTime = FPlatformTime::Seconds();
+	for (UVitruvioComponent* VitruvioComponent : Components)
+	{
+		VitruvioComponent->TickComponent(0.0f, LEVELTICK_All, nullptr);
+	}
+
+	const double EndTime = StartTime + TimeoutSeconds;
+	while (LoadSubsystem->IsLoading() && FPlatformTime::Seconds() < EndTime)
+	{
+		FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+		LoadSubsystem->Tick(0.0f);
+		for (UVitruvioComponent* VitruvioComponent : Components)
+		{
+			VitruvioComponent->TickComponent(0.0f, LEVELTICK_All, nullptr);
+		}
+		FPlatformProcess::Sleep(0.001f);
+	}
+
+	TestFalse(TEXT("Load has finished"), LoadSubsystem->IsLoading());
+	TestEqual(TEXT("Initializing the components does not load the Rule Packages again"), Backend->NumLoads.GetValue(), 2);
+
+	// Without the preload the first model could only become visible after its Rule Package has been loaded
+	const double TimeToFirstVisibleModel = LoadSubsystem->GetTimeToFirstVisibleModel();
+	TestTrue(TEXT("First model is visible before a Rule Package could have been loaded"),
+			 TimeToFirstVisibleModel >= 0.0 && TimeToFirstVisibleModel < LoadMilliseconds / 1000.0);
+
+	AddInfo(FString::Printf(TEXT("Preloading %d components among %d actors took %.3f ms, first visible model after %.3f s"), NumPreloadComponents,
+							NumUnrelatedActors, PreloadSeconds * 1000.0, TimeToFirstVisibleModel));
+
+	TestTrue(TEXT("Waiting for idle succeeds"), Module.WaitUntilIdle(TimeoutSeconds));
+	World->DestroyWorld(false);
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,256 @@
+/* Copyright 2024 Esri
+ *
+ * Licensed under the Apache License Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "VitruvioModule.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Engine/World.h"
+#include "HAL/Event.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "Misc/ScopeLock.h"
+#include "UObject/Package.h"
+#include "VitruvioComponent.h"
+
+namespace VitruvioTests
+{
+// Generate backend which records the calls of VitruvioModule instead of calling PRT. Calls can be blocked to observe the module while they
+// are in flight.
+class FMockGenerateBackend final : public IGenerateBackend
+{
+public:
+	FThreadSafeCounter NumLoads;
+	FThreadSafeCounter NumEvaluateCalls;
+	FThreadSafeCounter NumGenerateCalls;
+
+	virtual bool LoadRulePackage(URulePackage* RulePackage) override
+	{
+		NumLoads.Increment();
+
+		{
+			FScopeLock Lock(&CriticalSection);
+			MaxConcurrentLoads = FMath::Max(MaxConcurrentLoads, ++ConcurrentLoads);
+			++NumLoadsByRulePackage.FindOrAdd(RulePackage);
+		}
+
+		FPlatformProcess::Sleep(LoadMilliseconds / 1000.0f);
+
+		FScopeLock Lock(&CriticalSection);
+		--ConcurrentLoads;
+		return !FailingRulePackages.Contains(RulePackage);
+	}
+
+	virtual TArray<FAttributeMapPtr> EvaluateAttributes(const TArray<const FInitialShape*>& InitialShapes) override
+	{
+		NumEvaluateCalls.Increment();
+
+		TArray<FAttributeMapPtr> AttributeMaps;
+		FScopeLock Lock(&CriticalSection);
+		for (const FInitialShape* InitialShape : InitialShapes)
+		{
+			// The random seed identifies the initial shape in the tests
+			const FAttributeMapPtr& AttributeMap = AttributesBySeed.FindOrAdd(InitialShape->RandomSeed, MakeShared<FAttributeMap>());
+			AttributeMaps.Add(AttributeMap);
+		}
+		return AttributeMaps;
+	}
+
+	virtual FGenerateResultDescription Generate(const TArray<const FInitialShape*>& InitialShapes, int32 NumWorkerThreads) override
+	{
+		NumGenerateCalls.Increment();
+
+		if (bBlocked)
+		{
+			Released->Wait();
+		}
+
+		FGenerateResultDescription Result;
+		FScopeLock Lock(&CriticalSection);
+		for (const FInitialShape* InitialShape : InitialShapes)
+		{
+			GeneratedSeeds.Add(InitialShape->RandomSeed);
+
+			// Every shape reports its random seed, see GetSeedReport
+			TMap<FString, FReportStatistics>& ShapeReportStatistics = Result.ShapeReportStatistics.AddDefaulted_GetRef();
+			Vitruvio::AddReport(ShapeReportStatistics, GetSeedReport(InitialShape->RandomSeed));
+		}
+		return Result;
+	}
+
+	static FReport GetSeedReport(int32 RandomSeed)
+	{
+		FReport Report;
+		Report.Type = EReportPrimitiveType::Int;
+		Report.Name = TEXT("Seed");
+		Report.NumericValue = RandomSeed;
+		Report.Value = FString::FromInt(RandomSeed);
+		return Report;
+	}
+
+	// Blocks all following generate calls until Release is called
+	void Block()
+	{
+		Released->Reset();
+		bBlocked = true;
+	}
+
+	void Release()
+	{
+		bBlocked = false;
+		Released->Trigger();
+	}
+
+	// Makes every load take the given time, eg. to check that loads run concurrently
+	void SetLoadMilliseconds(int32 Milliseconds)
+	{
+		LoadMilliseconds = Milliseconds;
+	}
+
+	// Waits until the given number of generate calls has been entered, also if they are blocked
+	bool WaitForGenerateCalls(int32 Num, double TimeoutSeconds = 10.0) const
+	{
+		const double EndTime = FPlatformTime::Seconds() + TimeoutSeconds;
+		while (NumGenerateCalls.GetValue() < Num)
+		{
+			if (FPlatformTime::Seconds() > EndTime)
+			{
+				return false;
+			}
+			FPlatformProcess::Sleep(0.001f);
+		}
+		return true;
+	}
+
+	void SetFailing(URulePackage* RulePackage)
+	{
+		FScopeLock Lock(&CriticalSection);
+		FailingRulePackages.Add(RulePackage);
+	}
+
+	FAttributeMapPtr GetEvaluatedAttributes(int32 RandomSeed) const
+	{
+		FScopeLock Lock(&CriticalSection);
+		const FAttributeMapPtr* AttributeMap = AttributesBySeed.Find(RandomSeed);
+		return AttributeMap ? *AttributeMap : nullptr;
+	}
+
+	TArray<int32> GetGeneratedSeeds() const
+	{
+		FScopeLock Lock(&CriticalSection);
+		return GeneratedSeeds;
+	}
+
+	int32 GetMaxConcurrentLoads() const
+	{
+		FScopeLock Lock(&CriticalSection);
+		return MaxConcurrentLoads;
+	}
+
+	int32 GetNumLoads(URulePackage* RulePackage) const
+	{
+		FScopeLock Lock(&CriticalSection);
+		const int32* NumLoadsOfRulePackage = NumLoadsByRulePackage.Find(RulePackage);
+		return NumLoadsOfRulePackage ? *NumLoadsOfRulePackage : 0;
+	}
+
+private:
+	mutable FCriticalSection CriticalSection;
+
+	TSet<URulePackage*> FailingRulePackages;
+	TMap<int32, FAttributeMapPtr> AttributesBySeed;
+	TArray<int32> GeneratedSeeds;
+	TMap<URulePackage*, int32> NumLoadsByRulePackage;
+	int32 ConcurrentLoads = 0;
+	int32 MaxConcurrentLoads = 0;
+
+	TAtomic<int32> LoadMilliseconds{0};
+	TAtomic<bool> bBlocked{false};
+	FEventRef Released{EEventMode::ManualReset};
+};
+
+// Installs a mock generate backend for the lifetime of a test and restores PRT afterwards
+class FScopedMockGenerateBackend
+{
+public:
+	FScopedMockGenerateBackend() : Backend(MakeShared<FMockGenerateBackend, ESPMode::ThreadSafe>())
+	{
+		VitruvioModule::Get().SetGenerateBackend(Backend);
+	}
+
+	~FScopedMockGenerateBackend()
+	{
+		// Blocked calls have to complete before PRT can be used again
+		Backend->Release();
+		VitruvioModule::Get().WaitUntilIdle(10.0);
+		VitruvioModule::Get().SetGenerateBackend(nullptr);
+	}
+
+	FMockGenerateBackend* operator->() const
+	{
+		return &Backend.Get();
+	}
+
+	FMockGenerateBackend& operator*() const
+	{
+		return Backend.Get();
+	}
+
+private:
+	TSharedRef<FMockGenerateBackend, ESPMode::ThreadSafe> Backend;
+};
+
+inline URulePackage* CreateRulePackage(int32 Size = 1024)
+{
+	URulePackage* RulePackage = NewObject<URulePackage>(GetTransientPackage(), NAME_None, RF_Transient);
+	TArray<uint8> Data;
+	Data.SetNumZeroed(Size);
+	RulePackage->SetData(MoveTemp(Data));
+	return RulePackage;
+}
+
+inline FInitialShape CreateInitialShape(URulePackage* RulePackage, int32 RandomSeed, double Size = 1000.0)
+{
+	FInitialShape InitialShape;
+	InitialShape.Offset = FVector::ZeroVector;
+	InitialShape.Polygon.Vertices = {FVector(0.0, 0.0, 0.0), FVector(Size, 0.0, 0.0), FVector(Size, Size, 0.0), FVector(0.0, Size, 0.0)};
+	InitialShape.Polygon.Faces.AddDefaulted_GetRef().Indices = {0, 1, 2, 3};
+	InitialShape.RandomSeed = RandomSeed;
+	InitialShape.RulePackage = RulePackage;
+	return InitialShape;
+}
+
+// Creates an actor at the given location with a square initial shape which is neither registered nor initialized yet
+inline UVitruvioComponent* CreateVitruvioComponent(UWorld* World, URulePackage* RulePackage, const FVector& Location)
+{
+	AActor* Actor = World->SpawnActor<AActor>();
+	USceneComponent* RootComponent = NewObject<USceneComponent>(Actor);
+	Actor->SetRootComponent(RootComponent);
+	RootComponent->RegisterComponent();
+	Actor->SetActorLocation(Location);
+
+	UVitruvioComponent* VitruvioComponent = NewObject<UVitruvioComponent>(Actor);
+	VitruvioComponent->GenerateAutomatically = false;
+	VitruvioComponent->InitialShape = NewObject<UStaticMeshInitialShape>(VitruvioComponent);
+	VitruvioComponent->InitialShape->SetPolygon(CreateInitialShape(RulePackage, 0).Polygon);
+	VitruvioComponent->SetRpk(RulePackage, false, false);
+	return VitruvioComponent;
+}
+} // namespace VitruvioTests
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,165 @@
+/* Copyright 2024 Esri
+ *
+ * Licensed under the Apache License Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "Misc/AutomationTest.h"
+#include "PersistedGenerateResult.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "StaticMeshAttributes.h"
+#include "Tests/MockGenerateBackend.h"
+#include "VitruvioMesh.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace PersistedGenerateResultTests
+{
+constexpr uint64 InputHash = 0x0123456789abcdefull;
+
+FMeshDescription CreateTriangleMeshDescription()
+{
+	FMeshDescription Description;
+	FStaticMeshAttributes Attributes(Description);
+	Attributes.Register();
+
+	const FPolygonGroupID PolygonGroupId = Description.CreatePolygonGroup();
+	TArray<FVertexInstanceID> VertexInstances;
+	for (const FVector3f& Position : {FVector3f(0.0f, 0.0f, 0.0f), FVector3f(100.0f, 0.0f, 0.0f), FVector3f(0.0f, 100.0f, 0.0f)})
+	{
+		const FVertexID VertexID = Description.CreateVertex();
+		Attributes.GetVertexPositions()[VertexID] = Position;
+		VertexInstances.Add(Description.CreateVertexInstance(VertexID));
+	}
+	Description.CreateTriangle(PolygonGroupId, VertexInstances);
+	return Description;
+}
+
+FGenerateResultDescription CreateGenerateResult()
+{
+	const FMeshDescription Description = CreateTriangleMeshDescription();
+	const TArray<Vitruvio::FMaterialAttributeContainer> Materials = {Vitruvio::FMaterialAttributeContainer()};
+
+	FGenerateResultDescription Result;
+	Result.GeneratedModel = MakeShared<FVitruvioMesh>(TEXT("PersistedGenerateResultTestModel"), Description, Materials);
+	Result.InstanceMeshes.Add(TEXT("Instance"), MakeShared<FVitruvioMesh>(TEXT("PersistedGenerateResultTestInstance"), Description, Materials));
+	Result.InstanceNames.Add(TEXT("Instance"), TEXT("Tree"));
+
+	FInstanceCacheKey Key;
+	Key.MeshId = TEXT("Instance");
+	Result.Instances.Add(Key, {FTransform(FVector(100.0, 0.0, 0.0)), FTransform(FVector(200.0, 0.0, 0.0))});
+
+	const FReport Report = VitruvioTests::FMockGenerateBackend::GetSeedReport(7);
+	Result.Reports.Add(Report.Name, Report);
+	Vitruvio::AddReport(Result.ReportStatistics, Report);
+	return Result;
+}
+
+// Writes the persisted result like a level stores its properties and reads it back like loading the level again
+FPersistedGenerateResult SaveAndReload(FPersistedGenerateResult PersistedResult)
+{
+	TArray<uint8> LevelData;
+	FMemoryWriter Writer(LevelData);
+	FPersistedGenerateResult::StaticStruct()->SerializeItem(Writer, &PersistedResult, nullptr);
+
+	FPersistedGenerateResult ReloadedResult;
+	FMemoryReader Reader(LevelData);
+	FPersistedGenerateResult::StaticStruct()->SerializeItem(Reader, &ReloadedResult, nullptr);
+	return ReloadedResult;
+}
+} // namespace PersistedGenerateResultTests
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPersistedGenerateResultRoundTripTest, "Vitruvio.PersistedGenerateResult.RoundTrip",
+								 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FPersistedGenerateResultRoundTripTest::RunTest(const FString& Parameters)
+{
+	using namespace PersistedGenerateResultTests;
+	using namespace VitruvioTests;
+
+	const FScopedMockGenerateBackend Backend;
+
+	const FPersistedGenerateResult ReloadedResult = SaveAndReload(Vitruvio::PersistGenerateResult(CreateGenerateResult(), InputHash));
+	TestEqual(TEXT("The whole 64 bit input hash is stored"), ReloadedResult.InputHash, InputHash);
+	TestFalse(TEXT("Result does not use textures of a Rule Package"), ReloadedResult.bUsesRulePackageTextures);
+
+	const TOptional<FGenerateResultDescription> RestoredResult =
+		Vitruvio::RestoreGenerateResultAsync(ReloadedResult, {}, FGeneratedCollisionSettings()).Get();
+	if (!TestTrue(TEXT("Result has been restored"), RestoredResult.IsSet()))
+	{
+		return false;
+	}
+
+	const FGenerateResultDescription& Result = RestoredResult.GetValue();
+	if (TestTrue(TEXT("Generated model has been restored"), Result.GeneratedModel.IsValid()))
+	{
+		TestEqual(TEXT("Generated model vertices"), Result.GeneratedModel->GetMeshDescription().Vertices().Num(), 3);
+		TestEqual(TEXT("Generated model triangles"), Result.GeneratedModel->GetMeshDescription().Triangles().Num(), 1);
+		TestEqual(TEXT("Generated model materials"), Result.GeneratedModel->GetMaterials().Num(), 1);
+	}
+
+	FInstanceCacheKey Key;
+	Key.MeshId = TEXT("Instance");
+	TestTrue(TEXT("Instance mesh has been restored"), Result.InstanceMeshes.Contains(Key.MeshId));
+	TestEqual(TEXT("Instance name"), Result.InstanceNames.FindRef(Key.MeshId), FString(TEXT("Tree")));
+	if (const TArray<FTransform>* Transforms = Result.Instances.Find(Key); TestNotNull(TEXT("Instances have been restored"), Transforms))
+	{
+		TestEqual(TEXT("Instance transforms"), Transforms->Num(), 2);
+		TestEqual(TEXT("Instance location"), (*Transforms)[1].GetLocation(), FVector(200.0, 0.0, 0.0));
+	}
+
+	TestTrue(TEXT("Report has been restored"), Result.Reports.Contains(TEXT("Seed")));
+	if (const FReportStatistics* Statistics = Result.ReportStatistics.Find(TEXT("Seed")); TestNotNull(TEXT("Statistics"), Statistics))
+	{
+		TestEqual(TEXT("Report count"), Statistics->Count, 1);
+		TestEqual(TEXT("Report value"), Statistics->Sum, 7.0);
+	}
+
+	// Restoring neither generates nor loads the Rule Package since no textures of it are used
+	TestEqual(TEXT("No generate calls"), Backend->NumGenerateCalls.GetValue(), 0);
+	TestEqual(TEXT("No Rule Package loads"), Backend->NumLoads.GetValue(), 0);
+	TestEqual(TEXT("No generate calls in flight"), VitruvioModule::Get().GetNumGenerateCalls(), 0);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPersistedGenerateResultRulePackageTexturesTest, "Vitruvio.PersistedGenerateResult.RestoreAfterRulePackageLoad",
+								 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FPersistedGenerateResultRulePackageTexturesTest::RunTest(const FString& Parameters)
+{
+	using namespace PersistedGenerateResultTests;
+	using namespace VitruvioTests;
+
+	const FScopedMockGenerateBackend Backend;
+	Backend->SetLoadMilliseconds(200);
+
+	FPersistedGenerateResult PersistedResult = Vitruvio::PersistGenerateResult(CreateGenerateResult(), InputHash);
+	PersistedResult.bUsesRulePackageTextures = true;
+
+	// Restoring waits for the load without blocking the calling thread or a worker thread
+	const double StartTime = FPlatformTime::Seconds();
+	TFuture<TOptional<FGenerateResultDescription>> RestoredResult =
+		Vitruvio::RestoreGenerateResultAsync(PersistedResult, {CreateRulePackage()}, FGeneratedCollisionSettings());
+	TestTrue(TEXT("Restoring returns immediately"), FPlatformTime::Seconds() - StartTime < 0.1);
+	TestFalse(TEXT("Result is restored after the Rule Package has been loaded"), RestoredResult.IsReady());
+
+	TestTrue(TEXT("Result has been restored"), RestoredResult.Get().IsSet());
+	TestEqual(TEXT("Rule Package has been loaded"), Backend->NumLoads.GetValue(), 1);
+	TestEqual(TEXT("No generate calls"), Backend->NumGenerateCalls.GetValue(), 0);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
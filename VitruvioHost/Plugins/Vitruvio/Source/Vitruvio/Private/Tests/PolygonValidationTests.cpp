@@ -0,0 +1,384 @@
+/* Copyright 2024 Esri
+ *
+ * Licensed under the Apache License Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Algo/Reverse.h"
+#include "Math/RandomStream.h"
+#include "Misc/AutomationTest.h"
+#include "PolygonValidation.h"
+#include "StaticMeshAttributes.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace PolygonValidationTests
+{
+// Offsets used to check that the results do not change far away from the origin, where the coordinates lose precision
+const FVector2D Offsets[] = {FVector2D::ZeroVector, FVector2D(1.0e6, -1.0e6)};
+
+void AddRing(FInitialShapePolygon& Polygon, TArray<int32>& OutIndices, const TArray<FVector2D>& Points, const FVector2D& Offset)
+{
+	for (const FVector2D& Point : Points)
+	{
+		OutIndices.Add(Polygon.Vertices.Add(FVector(Point + Offset, 0.0)));
+	}
+}
+
+FInitialShapePolygon CreatePolygon(const TArray<FVector2D>& FacePoints, const TArray<TArray<FVector2D>>& HolePoints, const FVector2D& Offset)
+{
+	FInitialShapePolygon Polygon;
+	FInitialShapeFace& Face = Polygon.Faces.AddDefaulted_GetRef();
+	AddRing(Polygon, Face.Indices, FacePoints, Offset);
+	for (const TArray<FVector2D>& Points : HolePoints)
+	{
+		AddRing(Polygon, Face.Holes.AddDefaulted_GetRef().Indices, Points, Offset);
+	}
+	return Polygon;
+}
+
+// Points on a circle with jittered angles, which are always in convex position
+TArray<FVector2D> CreateConvexRing(FRandomStream& RandomStream, int32 NumPoints, const FVector2D& Center, double Radius)
+{
+	TArray<FVector2D> Points;
+	for (int32 Index = 0; Index < NumPoints; ++Index)
+	{
+		const double Angle = (Index + 0.8 * RandomStream.FRand()) * UE_TWO_PI / NumPoints;
+		Points.Add(Center + Radius * FVector2D(FMath::Cos(Angle), FMath::Sin(Angle)));
+	}
+	return Points;
+}
+
+// Star shaped ring around the origin. With at least 6 points no edge comes closer than 0.29 * Radius to the origin.
+TArray<FVector2D> CreateStarRing(FRandomStream& RandomStream, int32 NumPoints, double Radius)
+{
+	TArray<FVector2D> Points = CreateConvexRing(RandomStream, NumPoints, FVector2D::ZeroVector, 1.0);
+	for (FVector2D& Point : Points)
+	{
+		Point *= RandomStream.FRandRange(0.5 * Radius, Radius);
+	}
+	return Points;
+}
+
+void Rotate(FInitialShapePolygon& Polygon, const FRotator& Rotation)
+{
+	for (FVector& Vertex : Polygon.Vertices)
+	{
+		Vertex = Rotation.RotateVector(Vertex);
+	}
+}
+
+// The previous triangulation based check of UInitialShape::SetPolygon, used as the baseline of the benchmark
+bool HasValidGeometryTriangulated(const FInitialShapePolygon& Polygon)
+{
+	FMeshDescription Description;
+	FStaticMeshAttributes Attributes(Description);
+	Attributes.Register();
+
+	const auto VertexPositions = Attributes.GetVertexPositions();
+	const FPolygonGroupID PolygonGroupId = Description.CreatePolygonGroup();
+	for (const FVector& Vertex : Polygon.Vertices)
+	{
+		VertexPositions[Description.CreateVertex()] = FVector3f(Vertex);
+	}
+	for (const FInitialShapeFace& Face : Polygon.Faces)
+	{
+		TArray<FVertexInstanceID> PolygonVertexInstances;
+		for (const int32 VertexIndex : Face.Indices)
+		{
+			PolygonVertexInstances.Add(Description.CreateVertexInstance(FVertexID(VertexIndex)));
+		}
+		if (PolygonVertexInstances.Num() >= 3)
+		{
+			Description.CreatePolygon(PolygonGroupId, PolygonVertexInstances);
+		}
+	}
+
+	Description.TriangulateMesh();
+
+	const float ComparisonThreshold = 0.0001;
+	const float AdjustedComparisonThreshold = FMath::Max(ComparisonThreshold, MIN_flt);
+	for (const FTriangleID TriangleID : Description.Triangles().GetElementIDs())
+	{
+		TArrayView<const FVertexID> TriangleVertices = Description.GetTriangleVertices(TriangleID);
+		const FVector3f Position0 = VertexPositions[TriangleVertices[0]];
+		const FVector3f DPosition1 = VertexPositions[TriangleVertices[1]] - Position0;
+		const FVector3f DPosition2 = VertexPositions[TriangleVertices[2]] - Position0;
+		if (!FVector3f::CrossProduct(DPosition2, DPosition1).GetSafeNormal(AdjustedComparisonThreshold).IsNearlyZero(ComparisonThreshold))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+void TestSingleIssue(FAutomationTestBase& Test, const FString& What, const Vitruvio::FPolygonValidationResult& Result,
+					 Vitruvio::EPolygonIssueType ExpectedType, int32 ExpectedHoleIndex)
+{
+	if (Test.TestEqual(What + TEXT(": number of issues"), Result.Issues.Num(), 1))
+	{
+		const Vitruvio::FPolygonIssue& Issue = Result.Issues[0];
+		Test.TestTrue(What + TEXT(": issue type"), Issue.Type == ExpectedType);
+		Test.TestEqual(What + TEXT(": face index"), Issue.FaceIndex, 0);
+		Test.TestEqual(What + TEXT(": hole index"), Issue.HoleIndex, ExpectedHoleIndex);
+	}
+}
+
+struct FCorpusCase
+{
+	const TCHAR* Name;
+	FInitialShapePolygon Polygon;
+	bool bExpectValidGeometry = true;
+	TOptional<Vitruvio::EPolygonIssueType> ExpectedIssue;
+	int32 ExpectedHoleIndex = INDEX_NONE;
+};
+
+// Creates a valid polygon and one mutation for every issue type with a known outcome
+TArray<FCorpusCase> CreateCorpusCases(FRandomStream& RandomStream, const FVector2D& Offset)
+{
+	using Vitruvio::EPolygonIssueType;
+
+	constexpr double Radius = 1000.0;
+	const int32 NumPoints = RandomStream.RandRange(6, 64);
+
+	TArray<FVector2D> Hole = CreateConvexRing(RandomStream, RandomStream.RandRange(3, 8), FVector2D::ZeroVector, 0.2 * Radius);
+	Algo::Reverse(Hole);
+
+	TArray<FCorpusCase> Cases;
+	Cases.Add({TEXT("Star with hole"), CreatePolygon(CreateStarRing(RandomStream, NumPoints, Radius), {Hole}, Offset)});
+
+	TArray<FVector2D> Duplicate = CreateConvexRing(RandomStream, NumPoints, FVector2D::ZeroVector, Radius);
+	const int32 DuplicateIndex = RandomStream.RandRange(0, NumPoints - 1);
+	Duplicate.Insert(Duplicate[DuplicateIndex], DuplicateIndex + 1);
+	Cases.Add({TEXT("Duplicate vertex"), CreatePolygon(Duplicate, {}, Offset), true, EPolygonIssueType::DuplicateVertex});
+
+	// Swapping two non adjacent points of a convex ring makes the edges before the first and after the second point cross
+	TArray<FVector2D> Swapped = CreateConvexRing(RandomStream, NumPoints, FVector2D::ZeroVector, Radius);
+	const int32 First = RandomStream.RandRange(1, NumPoints - 4);
+	Swapped.Swap(First, RandomStream.RandRange(First + 2, NumPoints - 2));
+	Cases.Add({TEXT("Swapped vertices"), CreatePolygon(Swapped, {}, Offset), true, EPolygonIssueType::SelfIntersection});
+
+	TArray<FVector2D> OutsideHole = Hole;
+	for (FVector2D& Point : OutsideHole)
+	{
+		Point.X += 3.0 * Radius;
+	}
+	Cases.Add({TEXT("Hole outside of the face"), CreatePolygon(CreateStarRing(RandomStream, NumPoints, Radius), {OutsideHole}, Offset), true,
+			   EPolygonIssueType::InvalidHoleNesting, 0});
+
+	TArray<double> LineParameters;
+	for (int32 Index = 0; Index < NumPoints; ++Index)
+	{
+		LineParameters.Add(RandomStream.FRand());
+	}
+	LineParameters.Sort();
+	TArray<FVector2D> Collinear;
+	for (const double LineParameter : LineParameters)
+	{
+		Collinear.Add(LineParameter * FVector2D(Radius, 0.5 * Radius));
+	}
+	Cases.Add({TEXT("Collinear vertices"), CreatePolygon(Collinear, {}, Offset), false, EPolygonIssueType::DegenerateArea});
+
+	return Cases;
+}
+} // namespace PolygonValidationTests
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPolygonValidationNearCollinearTest, "Vitruvio.PolygonValidation.NearCollinearVertex",
+								 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FPolygonValidationNearCollinearTest::RunTest(const FString& Parameters)
+{
+	using namespace PolygonValidationTests;
+
+	// The tip of the notch lies slightly above, slightly below or exactly on the slanted bottom edge. The bottom edge is not axis aligned so
+	// that the bounds of the crossing edges overlap and the orientation test decides.
+	struct FTestCase
+	{
+		const TCHAR* Name;
+		double TipDistance;
+		bool bExpectIntersection;
+	};
+
+	const FTestCase TestCases[] = {
+		{TEXT("Tip above the edge"), 1.0e-6, false},
+		{TEXT("Tip below the edge"), -1.0e-6, true},
+		{TEXT("Tip on the edge"), 0.0, true},
+	};
+
+	for (const FVector2D& Offset : Offsets)
+	{
+		for (const FTestCase& TestCase : TestCases)
+		{
+			const FInitialShapePolygon Polygon =
+				CreatePolygon({{0.0, -1.0}, {100.0, 1.0}, {100.0, 10.0}, {50.0, TestCase.TipDistance}, {0.0, 10.0}}, {}, Offset);
+			const Vitruvio::FPolygonValidationResult Result = Vitruvio::ValidatePolygon(Polygon);
+
+			const FString What = FString::Printf(TEXT("%s (offset %s)"), TestCase.Name, *Offset.ToString());
+			TestTrue(What + TEXT(": has valid geometry"), Result.bHasValidGeometry);
+			if (TestCase.bExpectIntersection)
+			{
+				TestSingleIssue(*this, What, Result, Vitruvio::EPolygonIssueType::SelfIntersection, INDEX_NONE);
+			}
+			else
+			{
+				TestEqual(What + TEXT(": number of issues"), Result.Issues.Num(), 0);
+			}
+		}
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPolygonValidationSliverTest, "Vitruvio.PolygonValidation.ThinSliver",
+								 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FPolygonValidationSliverTest::RunTest(const FString& Parameters)
+{
+	using namespace PolygonValidationTests;
+
+	for (const FVector2D& Offset : Offsets)
+	{
+		// Long and thin parallelogram whose opposite edges have overlapping bounds but never meet
+		const FInitialShapePolygon Polygon = CreatePolygon({{0.0, 0.0}, {1000.0, 1.0}, {1000.0, 1.01}, {0.0, 0.01}}, {}, Offset);
+		const Vitruvio::FPolygonValidationResult Result = Vitruvio::ValidatePolygon(Polygon);
+
+		const FString What = FString::Printf(TEXT("Offset %s"), *Offset.ToString());
+		TestTrue(What + TEXT(": has valid geometry"), Result.bHasValidGeometry);
+		TestEqual(What + TEXT(": number of issues"), Result.Issues.Num(), 0);
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPolygonValidationHoleTest, "Vitruvio.PolygonValidation.CollinearHoleEdge",
+								 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FPolygonValidationHoleTest::RunTest(const FString& Parameters)
+{
+	using namespace PolygonValidationTests;
+
+	const TArray<FVector2D> FacePoints = {{0.0, 0.0}, {10.0, 0.0}, {10.0, 10.0}, {0.0, 10.0}};
+
+	for (const FVector2D& Offset : Offsets)
+	{
+		const FString What = FString::Printf(TEXT("Offset %s"), *Offset.ToString());
+
+		const FInitialShapePolygon NestedHole = CreatePolygon(FacePoints, {{{2.0, 2.0}, {2.0, 8.0}, {8.0, 8.0}, {8.0, 2.0}}}, Offset);
+		const Vitruvio::FPolygonValidationResult NestedResult = Vitruvio::ValidatePolygon(NestedHole);
+		TestTrue(What + TEXT(": nested hole has valid geometry"), NestedResult.bHasValidGeometry);
+		TestEqual(What + TEXT(": nested hole number of issues"), NestedResult.Issues.Num(), 0);
+
+		// The bottom edge of the hole lies on the bottom edge of the face, which is reported once for the hole
+		const FInitialShapePolygon CollinearHole = CreatePolygon(FacePoints, {{{2.0, 0.0}, {2.0, 5.0}, {8.0, 5.0}, {8.0, 0.0}}}, Offset);
+		const Vitruvio::FPolygonValidationResult CollinearResult = Vitruvio::ValidatePolygon(CollinearHole);
+		TestTrue(What + TEXT(": collinear hole has valid geometry"), CollinearResult.bHasValidGeometry);
+		TestSingleIssue(*this, What + TEXT(": collinear hole"), CollinearResult, Vitruvio::EPolygonIssueType::SelfIntersection, 0);
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPolygonValidationCorpusTest, "Vitruvio.PolygonValidation.RandomCorpus",
+								 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FPolygonValidationCorpusTest::RunTest(const FString& Parameters)
+{
+	using namespace PolygonValidationTests;
+
+	constexpr int32 NumIterations = 200;
+	FRandomStream RandomStream(42);
+
+	for (int32 Iteration = 0; Iteration < NumIterations; ++Iteration)
+	{
+		const FVector2D& Offset = Offsets[Iteration % UE_ARRAY_COUNT(Offsets)];
+		const FRotator Rotation(RandomStream.FRandRange(-90.0, 90.0), RandomStream.FRandRange(-180.0, 180.0), RandomStream.FRandRange(-180.0, 180.0));
+
+		for (FCorpusCase& Case : CreateCorpusCases(RandomStream, Offset))
+		{
+			// The results do not depend on the orientation of the polygon
+			Rotate(Case.Polygon, Rotation);
+
+			const FString What = FString::Printf(TEXT("%s (iteration %d)"), Case.Name, Iteration);
+			const Vitruvio::FPolygonValidationResult Result = Vitruvio::ValidatePolygon(Case.Polygon);
+			TestEqual(What + TEXT(": has valid geometry"), Result.bHasValidGeometry, Case.bExpectValidGeometry);
+			TestEqual(What + TEXT(": matches HasValidGeometry"), Result.bHasValidGeometry, Vitruvio::HasValidGeometry(Case.Polygon));
+			if (Case.ExpectedIssue.IsSet())
+			{
+				TestSingleIssue(*this, What, Result, Case.ExpectedIssue.GetValue(), Case.ExpectedHoleIndex);
+			}
+			else
+			{
+				TestEqual(What + TEXT(": number of issues"), Result.Issues.Num(), 0);
+			}
+
+			// Stopping early reports the first issue of the full validation and does not change the validity
+			const Vitruvio::FPolygonValidationResult EarlyResult = Vitruvio::ValidatePolygon(Case.Polygon, true);
+			TestEqual(What + TEXT(": early exit validity"), EarlyResult.bHasValidGeometry, Result.bHasValidGeometry);
+			if (TestEqual(What + TEXT(": early exit number of issues"), EarlyResult.Issues.Num(), FMath::Min(Result.Issues.Num(), 1)) &&
+				EarlyResult.Issues.Num() == 1)
+			{
+				TestTrue(What + TEXT(": early exit issue type"), EarlyResult.Issues[0].Type == Result.Issues[0].Type);
+			}
+		}
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPolygonValidationBenchmark, "Vitruvio.PolygonValidation.Benchmark",
+								 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FPolygonValidationBenchmark::RunTest(const FString& Parameters)
+{
+	using namespace PolygonValidationTests;
+
+	constexpr int32 NumPolygons = 200;
+	FRandomStream RandomStream(7);
+
+	TArray<FInitialShapePolygon> Polygons;
+	for (int32 PolygonIndex = 0; PolygonIndex < NumPolygons; ++PolygonIndex)
+	{
+		TArray<FVector2D> Hole = CreateConvexRing(RandomStream, 16, FVector2D::ZeroVector, 200.0);
+		Algo::Reverse(Hole);
+		Polygons.Add(CreatePolygon(CreateStarRing(RandomStream, RandomStream.RandRange(8, 512), 1000.0), {Hole}, FVector2D::ZeroVector));
+	}
+
+	auto Measure = [&Polygons](TFunctionRef<bool(const FInitialShapePolygon&)> Check, int32& OutNumValid)
+	{
+		OutNumValid = 0;
+		const double StartTime = FPlatformTime::Seconds();
+		for (const FInitialShapePolygon& Polygon : Polygons)
+		{
+			OutNumValid += Check(Polygon) ? 1 : 0;
+		}
+		return (FPlatformTime::Seconds() - StartTime) * 1000.0;
+	};
+
+	int32 NumValidTriangulated;
+	int32 NumValidValidated;
+	int32 NumValidEarlyExit;
+	const double TriangulatedMs = Measure(&HasValidGeometryTriangulated, NumValidTriangulated);
+	const double ValidatedMs = Measure([](const FInitialShapePolygon& Polygon) { return Vitruvio::ValidatePolygon(Polygon).bHasValidGeometry; },
+									   NumValidValidated);
+	const double EarlyExitMs = Measure(&Vitruvio::HasValidGeometry, NumValidEarlyExit);
+
+	TestEqual(TEXT("Triangulation based check"), NumValidTriangulated, NumPolygons);
+	TestEqual(TEXT("Full validation"), NumValidValidated, NumPolygons);
+	TestEqual(TEXT("Early exit check"), NumValidEarlyExit, NumPolygons);
+
+	AddInfo(FString::Printf(TEXT("%d polygons: triangulation %.2f ms, full validation %.2f ms, early exit %.2f ms"), NumPolygons, TriangulatedMs,
+							ValidatedMs, EarlyExitMs));
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
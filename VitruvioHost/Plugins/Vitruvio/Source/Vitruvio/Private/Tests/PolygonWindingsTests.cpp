@@ -0,0 +1,367 @@
+/* Copyright 2024 Esri
+ *
+ * Licensed under the Apache License Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Misc/AutomationTest.h"
+#include "PolygonWindings.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace PolygonWindingsTests
+{
+// The previous (recursive and quadratic) implementation of Vitruvio::GetPolygon, used as reference for the current implementation
+namespace Reference
+{
+struct FWindingEdge
+{
+	const int32 Index0;
+	const int32 Index1;
+	int32 Color;
+
+	FWindingEdge() : Index0(-1), Index1(-1), Color(-1) {}
+
+	FWindingEdge(const int32 Index0, const int32 Index1, const int32 Color) : Index0(Index0), Index1(Index1), Color(Color) {}
+
+	bool operator==(const FWindingEdge& E) const
+	{
+		return (E.Index0 == Index0 && E.Index1 == Index1);
+	}
+};
+
+struct FWinding
+{
+	TArray<int32> Indices;
+	int Color;
+
+	FWinding(const TArray<int32>& Indices, const int Color) : Indices(Indices), Color(Color) {}
+};
+
+uint32 GetTypeHash(const FWindingEdge& Edge)
+{
+	std::size_t Hash = 0x04C76972;
+	Hash = HashCombine(Hash, Edge.Index0);
+	return HashCombine(Hash, Edge.Index1);
+}
+
+void ColorEdges(FWindingEdge& Edge, TSortedMap<int32, TArray<FWindingEdge>>& EdgeMap, TSet<FWindingEdge>& Visited, int Color)
+{
+	if (Visited.Contains(Edge))
+	{
+		return;
+	}
+
+	Edge.Color = Color;
+	Visited.Add(Edge);
+	for (FWindingEdge& Connected : EdgeMap[Edge.Index0])
+	{
+		ColorEdges(Connected, EdgeMap, Visited, Color);
+	}
+	for (FWindingEdge& Connected : EdgeMap[Edge.Index1])
+	{
+		ColorEdges(Connected, EdgeMap, Visited, Color);
+	}
+}
+
+bool PointInPolygon2D(const FVector& Point, const TArray<int32>& PolygonIndices, const TArray<FVector>& PolygonVertices)
+{
+	if (PolygonIndices.Num() < 3)
+	{
+		return false;
+	}
+
+	bool bIsInside = false;
+	for (int Index = 0; Index < PolygonIndices.Num(); Index++)
+	{
+		const FVector& Current = PolygonVertices[PolygonIndices[Index]];
+		const FVector& Next = PolygonVertices[PolygonIndices[Index + 1 >= PolygonIndices.Num() ? 0 : Index + 1]];
+		if (Current.Y < Point.Y && Next.Y >= Point.Y || Next.Y < Point.Y && Current.Y >= Point.Y)
+		{
+			if (Current.X + (Point.Y - Current.Y) / (Next.Y - Current.Y) * (Next.X - Current.X) < Point.X)
+			{
+				bIsInside = !bIsInside;
+			}
+		}
+	}
+
+	return bIsInside;
+}
+
+bool IsInsideOf2D(const TArray<int32>& FaceA, const TArray<int32>& FaceB, const TArray<FVector>& Vertices)
+{
+	if (FaceB.Num() == 1)
+	{
+		return false;
+	}
+
+	for (int IndexA = 0; IndexA < FaceA.Num() - 1; IndexA++)
+	{
+		for (int IndexB = 0; IndexB < FaceB.Num() - 1; IndexB++)
+		{
+			FVector Intersection;
+			const bool Intersected = FMath::SegmentIntersection2D(Vertices[FaceA[IndexA]], Vertices[FaceA[IndexA + 1]], Vertices[FaceB[IndexB]],
+																  Vertices[FaceB[IndexB + 1]], Intersection);
+			if (Intersected)
+			{
+				return false;
+			}
+		}
+	}
+
+	return PointInPolygon2D(Vertices[FaceA[0]], FaceB, Vertices);
+}
+
+FInitialShapePolygon GetPolygon(const TArray<FVector>& InVertices, const TArray<int32>& InIndices)
+{
+	const int32 NumTriangles = InIndices.Num() / 3;
+
+	TSet<FWindingEdge> Edges;
+	for (int32 TriangleIndex = 0; TriangleIndex < NumTriangles; ++TriangleIndex)
+	{
+		for (int32 VertexIndex = 0; VertexIndex < 3; ++VertexIndex)
+		{
+			const int32 Index0 = InIndices[TriangleIndex * 3 + VertexIndex];
+			const int32 Index1 = InIndices[TriangleIndex * 3 + (VertexIndex + 1) % 3];
+			Edges.Add({Index0, Index1, -1});
+		}
+	}
+
+	TSortedMap<int32, TArray<FWindingEdge>> EdgeMap;
+	for (const FWindingEdge& Edge : Edges)
+	{
+		EdgeMap.FindOrAdd(Edge.Index0).Add(Edge);
+	}
+
+	TSet<FWindingEdge> Visited;
+	int CurrentColor = 0;
+	for (auto& KeyValue : EdgeMap)
+	{
+		for (FWindingEdge& Edge : KeyValue.Value)
+		{
+			if (!Visited.Contains(Edge))
+			{
+				ColorEdges(Edge, EdgeMap, Visited, CurrentColor++);
+			}
+		}
+	}
+
+	TSortedMap<int32, FWindingEdge> WindingEdgeMap;
+	for (auto& KeyValue : EdgeMap)
+	{
+		for (const FWindingEdge& Current : KeyValue.Value)
+		{
+			const FWindingEdge Opposite(Current.Index1, Current.Index0, Current.Color);
+			if (!Edges.Contains(Opposite))
+			{
+				WindingEdgeMap.Add(Current.Index0, Current);
+			}
+		}
+	}
+
+	TArray<FWinding> Windings;
+	while (WindingEdgeMap.Num() > 0)
+	{
+		TArray<int32> WindingIndices;
+
+		auto EdgeIter = WindingEdgeMap.CreateIterator();
+		const FWindingEdge FirstEdge = EdgeIter.Value();
+		EdgeIter.RemoveCurrent();
+
+		WindingIndices.Add(FirstEdge.Index0);
+		int NextIndex = FirstEdge.Index1;
+
+		while (WindingEdgeMap.Contains(NextIndex))
+		{
+			const FWindingEdge& Current = WindingEdgeMap.FindAndRemoveChecked(NextIndex);
+			WindingIndices.Add(Current.Index0);
+			NextIndex = Current.Index1;
+		}
+
+		Windings.Add({WindingIndices, FirstEdge.Color});
+	}
+
+	TMap<int32, int32> InsideOf;
+	for (int32 IndexA = 0; IndexA < Windings.Num(); IndexA++)
+	{
+		for (int32 IndexB = IndexA + 1; IndexB < Windings.Num(); IndexB++)
+		{
+			if (Windings[IndexA].Color != Windings[IndexB].Color)
+			{
+				continue;
+			}
+
+			if (IsInsideOf2D(Windings[IndexA].Indices, Windings[IndexB].Indices, InVertices))
+			{
+				InsideOf.Add(IndexA, IndexB);
+			}
+			else if (IsInsideOf2D(Windings[IndexB].Indices, Windings[IndexA].Indices, InVertices))
+			{
+				InsideOf.Add(IndexB, IndexA);
+			}
+		}
+	}
+
+	TSet<int32> HoleSet;
+	TMap<int32, FInitialShapeFace> FaceMap;
+	for (int32 FaceIndex = 0; FaceIndex < Windings.Num(); ++FaceIndex)
+	{
+		if (!InsideOf.Contains(FaceIndex))
+		{
+			FaceMap.Add(FaceIndex, FInitialShapeFace{Windings[FaceIndex].Indices});
+		}
+		else
+		{
+			HoleSet.Add(FaceIndex);
+		}
+	}
+
+	for (int32 HoleIndex : HoleSet)
+	{
+		int32 InsideOfIndex = InsideOf[HoleIndex];
+		if (FaceMap.Contains(InsideOfIndex))
+		{
+			FInitialShapeFace& ParentFace = FaceMap[InsideOfIndex];
+			ParentFace.Holes.Add(FInitialShapeHole{Windings[HoleIndex].Indices});
+		}
+	}
+
+	TArray<FInitialShapeFace> Faces;
+	FaceMap.GenerateValueArray(Faces);
+	FInitialShapePolygon Result = {Faces, InVertices};
+	return Result;
+}
+} // namespace Reference
+
+// A triangulated grid of unit cells in the xy plane. Removed cells form holes, cells which are completely surrounded by removed cells
+// form islands inside of these holes.
+struct FGridMesh
+{
+	TArray<FVector> Vertices;
+	TArray<int32> Indices;
+
+	FGridMesh(int32 NumCellsX, int32 NumCellsY, TFunctionRef<bool(int32, int32)> IsCellRemoved)
+	{
+		for (int32 Y = 0; Y <= NumCellsY; ++Y)
+		{
+			for (int32 X = 0; X <= NumCellsX; ++X)
+			{
+				Vertices.Add(FVector(X * 100.0, Y * 100.0, 0.0));
+			}
+		}
+
+		for (int32 Y = 0; Y < NumCellsY; ++Y)
+		{
+			for (int32 X = 0; X < NumCellsX; ++X)
+			{
+				if (IsCellRemoved(X, Y))
+				{
+					continue;
+				}
+
+				const int32 V00 = Y * (NumCellsX + 1) + X;
+				const int32 V10 = V00 + 1;
+				const int32 V01 = V00 + NumCellsX + 1;
+				const int32 V11 = V01 + 1;
+				Indices.Append({V00, V10, V11, V00, V11, V01});
+			}
+		}
+	}
+};
+
+int32 GetChebyshevDistance(int32 X, int32 Y, int32 CenterX, int32 CenterY)
+{
+	return FMath::Max(FMath::Abs(X - CenterX), FMath::Abs(Y - CenterY));
+}
+
+TArray<int32> GetNumHolesPerFace(const FInitialShapePolygon& Polygon)
+{
+	TArray<int32> NumHoles;
+	for (const FInitialShapeFace& Face : Polygon.Faces)
+	{
+		NumHoles.Add(Face.Holes.Num());
+	}
+	return NumHoles;
+}
+} // namespace PolygonWindingsTests
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPolygonWindingsReferenceTest, "Vitruvio.PolygonWindings.MatchesReference",
+								 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FPolygonWindingsReferenceTest::RunTest(const FString& Parameters)
+{
+	using namespace PolygonWindingsTests;
+
+	struct FTestCase
+	{
+		const TCHAR* Name;
+		FGridMesh Mesh;
+		TArray<int32> ExpectedNumHolesPerFace;
+	};
+
+	// clang-format off
+	const FTestCase TestCases[] = {
+		{TEXT("Single cell"), FGridMesh(1, 1, [](int32, int32) { return false; }), {0}},
+		{TEXT("Hole"), FGridMesh(3, 3, [](int32 X, int32 Y) { return X == 1 && Y == 1; }), {1}},
+		{TEXT("Two holes"), FGridMesh(5, 5, [](int32 X, int32 Y) { return (X == 1 && Y == 1) || (X == 3 && Y == 3); }), {2}},
+		{TEXT("Separate faces"), FGridMesh(5, 1, [](int32 X, int32 Y) { return X == 2; }), {0, 0}},
+		{TEXT("Island inside of a hole"), FGridMesh(7, 7, [](int32 X, int32 Y) { return GetChebyshevDistance(X, Y, 3, 3) == 1; }), {1, 0}},
+		{TEXT("Island with a hole inside of a hole"), FGridMesh(11, 11, [](int32 X, int32 Y)
+		{
+			const int32 Distance = GetChebyshevDistance(X, Y, 5, 5);
+			return Distance == 0 || Distance == 2;
+		}), {1, 1}},
+		{TEXT("Grid with holes"), FGridMesh(20, 20, [](int32 X, int32 Y) { return X % 4 == 2 && Y % 4 == 2; }), {25}},
+	};
+	// clang-format on
+
+	for (const FTestCase& TestCase : TestCases)
+	{
+		const FInitialShapePolygon Polygon = Vitruvio::GetPolygon(TestCase.Mesh.Vertices, TestCase.Mesh.Indices);
+		const FInitialShapePolygon ReferencePolygon = Reference::GetPolygon(TestCase.Mesh.Vertices, TestCase.Mesh.Indices);
+
+		TestTrue(FString::Printf(TEXT("%s: same faces and holes as the reference"), TestCase.Name), Polygon.Faces == ReferencePolygon.Faces);
+		TestTrue(FString::Printf(TEXT("%s: number of holes per face"), TestCase.Name),
+				 GetNumHolesPerFace(Polygon) == TestCase.ExpectedNumHolesPerFace);
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPolygonWindingsLargeMeshTest, "Vitruvio.PolygonWindings.LargeMesh",
+								 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FPolygonWindingsLargeMeshTest::RunTest(const FString& Parameters)
+{
+	using namespace PolygonWindingsTests;
+
+	// Large enough that the connected edges would have exceeded the stack with the recursive edge coloring
+	constexpr int32 NumCells = 200;
+	const FGridMesh Mesh(NumCells, NumCells, [](int32 X, int32 Y) { return (X == 50 && Y == 50) || (X == 150 && Y == 120); });
+
+	const FInitialShapePolygon Polygon = Vitruvio::GetPolygon(Mesh.Vertices, Mesh.Indices);
+
+	if (TestEqual(TEXT("Number of faces"), Polygon.Faces.Num(), 1))
+	{
+		const FInitialShapeFace& Face = Polygon.Faces[0];
+		TestEqual(TEXT("Boundary vertices"), Face.Indices.Num(), 4 * NumCells);
+		if (TestEqual(TEXT("Number of holes"), Face.Holes.Num(), 2))
+		{
+			TestEqual(TEXT("First hole vertices"), Face.Holes[0].Indices.Num(), 4);
+			TestEqual(TEXT("Second hole vertices"), Face.Holes[1].Indices.Num(), 4);
+		}
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
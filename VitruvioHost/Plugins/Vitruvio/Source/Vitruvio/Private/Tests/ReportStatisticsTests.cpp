@@ -0,0 +1,217 @@
+/* Copyright 2024 Esri
+ *
+ * Licensed under the Apache License Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Async/ParallelFor.h"
+#include "Misc/AutomationTest.h"
+#include "Report.h"
+#include "Tests/MockGenerateBackend.h"
+#include "UnrealCallbacks.h"
+#include "VitruvioModule.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace ReportStatisticsTests
+{
+FReport CreateReport(const FString& Name, EReportPrimitiveType Type, double NumericValue, const FString& Value = {})
+{
+	FReport Report;
+	Report.Name = Name;
+	Report.Type = Type;
+	Report.NumericValue = NumericValue;
+	Report.Value = Value;
+	return Report;
+}
+} // namespace ReportStatisticsTests
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FReportStatisticsNumericCountTest, "Vitruvio.Reports.StringReportsAreOnlyCounted",
+								 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FReportStatisticsNumericCountTest::RunTest(const FString& Parameters)
+{
+	using namespace ReportStatisticsTests;
+
+	// A String report first must not seed Min and Max with its missing value
+	FReportStatistics Statistics;
+	Statistics.Add(CreateReport(TEXT("Height"), EReportPrimitiveType::String, 0.0, TEXT("unknown")));
+	Statistics.Add(CreateReport(TEXT("Height"), EReportPrimitiveType::Float, 5.0));
+	Statistics.Add(CreateReport(TEXT("Height"), EReportPrimitiveType::Float, 3.0));
+
+	TestEqual(TEXT("All reports are counted"), Statistics.Count, 3);
+	TestEqual(TEXT("Only numeric reports have a value"), Statistics.NumericCount, 2);
+	TestEqual(TEXT("Min is seeded by the first numeric report"), Statistics.Min, 3.0);
+	TestEqual(TEXT("Max is seeded by the first numeric report"), Statistics.Max, 5.0);
+	TestEqual(TEXT("Mean only covers numeric reports"), Statistics.GetMean(), 4.0);
+
+	FReportStatistics StringOnly;
+	StringOnly.Add(CreateReport(TEXT("Height"), EReportPrimitiveType::String, 0.0, TEXT("unknown")));
+
+	FReportStatistics Negative;
+	Negative.Add(CreateReport(TEXT("Height"), EReportPrimitiveType::Float, -2.0));
+	Negative.Add(CreateReport(TEXT("Height"), EReportPrimitiveType::Float, -1.0));
+
+	FReportStatistics Merged = StringOnly;
+	Merged.Merge(Negative);
+	TestEqual(TEXT("Merging into String reports takes Min of the numeric reports"), Merged.Min, -2.0);
+	TestEqual(TEXT("Merging into String reports takes Max of the numeric reports"), Merged.Max, -1.0);
+
+	Merged.Merge(StringOnly);
+	Merged.Merge(Statistics);
+	TestEqual(TEXT("Merged reports are counted"), Merged.Count, 7);
+	TestEqual(TEXT("Merged numeric reports are counted"), Merged.NumericCount, 4);
+	TestEqual(TEXT("Merged Min"), Merged.Min, -2.0);
+	TestEqual(TEXT("Merged Max"), Merged.Max, 5.0);
+	TestEqual(TEXT("Merged mean"), Merged.GetMean(), 5.0 / 4.0);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FReportStatisticsPerShapeTest, "Vitruvio.Reports.CallbacksAggregatePerShape",
+								 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FReportStatisticsPerShapeTest::RunTest(const FString& Parameters)
+{
+	constexpr int32 NumInitialShapes = 64;
+	constexpr int32 NumReportsPerShape = 10;
+
+	TArray<AttributeMapBuilderUPtr> AttributeMapBuilders;
+	UnrealCallbacks Callbacks(AttributeMapBuilders);
+
+	// PRT reports the shapes of a generate call concurrently
+	ParallelFor(NumInitialShapes, [&Callbacks](int32 InitialShapeIndex)
+	{
+		for (int32 ReportIndex = 0; ReportIndex < NumReportsPerShape; ++ReportIndex)
+		{
+			Callbacks.cgaReportFloat(InitialShapeIndex, ReportIndex, L"Area", InitialShapeIndex + ReportIndex);
+			Callbacks.cgaReportBool(InitialShapeIndex, ReportIndex, L"IsRoof", ReportIndex % 2 == 0);
+		}
+		Callbacks.cgaReportString(InitialShapeIndex, 0, L"Usage", L"Residential");
+	});
+
+	const TArray<TMap<FString, FReportStatistics>> ShapeReportStatistics = Callbacks.GetShapeReportStatistics(NumInitialShapes);
+	if (!TestEqual(TEXT("Every initial shape has its statistics"), ShapeReportStatistics.Num(), NumInitialShapes))
+	{
+		return false;
+	}
+
+	for (int32 InitialShapeIndex = 0; InitialShapeIndex < NumInitialShapes; ++InitialShapeIndex)
+	{
+		const FReportStatistics* Area = ShapeReportStatistics[InitialShapeIndex].Find(TEXT("Area"));
+		const FReportStatistics* IsRoof = ShapeReportStatistics[InitialShapeIndex].Find(TEXT("IsRoof"));
+		const FReportStatistics* Usage = ShapeReportStatistics[InitialShapeIndex].Find(TEXT("Usage"));
+		if (!TestTrue(TEXT("Every report is aggregated"), Area && IsRoof && Usage))
+		{
+			return false;
+		}
+
+		TestEqual(TEXT("Reports of a shape are counted"), Area->Count, NumReportsPerShape);
+		TestEqual(TEXT("Min is the first report of the shape"), Area->Min, static_cast<double>(InitialShapeIndex));
+		TestEqual(TEXT("Max is the last report of the shape"), Area->Max, static_cast<double>(InitialShapeIndex + NumReportsPerShape - 1));
+		TestEqual(TEXT("Sum of a Bool report is the number of true values"), IsRoof->Sum, NumReportsPerShape / 2.0);
+		TestEqual(TEXT("String reports have no numeric value"), Usage->NumericCount, 0);
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FReportStatisticsBatchGenerateTest, "Vitruvio.Reports.BatchGenerateAggregatesShapes",
+								 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FReportStatisticsBatchGenerateTest::RunTest(const FString& Parameters)
+{
+	using namespace VitruvioTests;
+
+	constexpr int32 NumInitialShapes = 20;
+
+	const FScopedMockGenerateBackend Backend;
+	URulePackage* RulePackages[] = {CreateRulePackage(), CreateRulePackage()};
+
+	// The larger shapes are generated first, the results are nevertheless expected in the order of the initial shapes
+	TArray<FInitialShape> InitialShapes;
+	double SeedSum = 0.0;
+	for (int32 Seed = 0; Seed < NumInitialShapes; ++Seed)
+	{
+		InitialShapes.Add(CreateInitialShape(RulePackages[Seed % 2], Seed, 100.0 * (Seed + 1)));
+		SeedSum += Seed;
+	}
+
+	const FGenerateResultDescription Result = VitruvioModule::Get().BatchGenerate(MoveTemp(InitialShapes));
+	if (!TestEqual(TEXT("Every initial shape has its statistics"), Result.ShapeReportStatistics.Num(), NumInitialShapes))
+	{
+		return false;
+	}
+
+	for (int32 Seed = 0; Seed < NumInitialShapes; ++Seed)
+	{
+		const FReportStatistics* SeedStatistics = Result.ShapeReportStatistics[Seed].Find(TEXT("Seed"));
+		TestTrue(TEXT("Statistics are in the order of the initial shapes"), SeedStatistics && SeedStatistics->Sum == Seed);
+	}
+
+	const FReportStatistics* BatchStatistics = Result.ReportStatistics.Find(TEXT("Seed"));
+	if (!TestNotNull(TEXT("Batch statistics are aggregated"), BatchStatistics))
+	{
+		return false;
+	}
+	TestEqual(TEXT("Batch statistics count every shape"), BatchStatistics->Count, NumInitialShapes);
+	TestEqual(TEXT("Batch statistics sum every shape"), BatchStatistics->Sum, SeedSum);
+	TestEqual(TEXT("Batch Min"), BatchStatistics->Min, 0.0);
+	TestEqual(TEXT("Batch Max"), BatchStatistics->Max, static_cast<double>(NumInitialShapes - 1));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FReportStatisticsBenchmark, "Vitruvio.Reports.Benchmark",
+								 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FReportStatisticsBenchmark::RunTest(const FString& Parameters)
+{
+	constexpr int32 NumInitialShapes = 1000;
+	constexpr int32 NumReportsPerShape = 1000;
+	const wchar_t* ReportNames[] = {L"Area", L"Height", L"Volume", L"Floors"};
+
+	TArray<AttributeMapBuilderUPtr> AttributeMapBuilders;
+	UnrealCallbacks Callbacks(AttributeMapBuilders);
+
+	const double ReportStartTime = FPlatformTime::Seconds();
+	ParallelFor(NumInitialShapes, [&Callbacks, &ReportNames](int32 InitialShapeIndex)
+	{
+		for (int32 ReportIndex = 0; ReportIndex < NumReportsPerShape; ++ReportIndex)
+		{
+			Callbacks.cgaReportFloat(InitialShapeIndex, ReportIndex, ReportNames[ReportIndex % UE_ARRAY_COUNT(ReportNames)], ReportIndex);
+		}
+	});
+	const double ReportSeconds = FPlatformTime::Seconds() - ReportStartTime;
+
+	const double AggregateStartTime = FPlatformTime::Seconds();
+	TMap<FString, FReportStatistics> ReportStatistics;
+	for (const TMap<FString, FReportStatistics>& ShapeReportStatistics : Callbacks.GetShapeReportStatistics(NumInitialShapes))
+	{
+		Vitruvio::MergeReportStatistics(ReportStatistics, ShapeReportStatistics);
+	}
+	const double AggregateSeconds = FPlatformTime::Seconds() - AggregateStartTime;
+
+	int32 NumReports = 0;
+	for (const auto& [Name, Statistics] : ReportStatistics)
+	{
+		NumReports += Statistics.Count;
+	}
+	TestEqual(TEXT("Every report is aggregated"), NumReports, NumInitialShapes * NumReportsPerShape);
+
+	AddInfo(FString::Printf(TEXT("Reported %d values of %d shapes in %.2f ms, aggregated the batch in %.2f ms"), NumReports, NumInitialShapes,
+							ReportSeconds * 1000.0, AggregateSeconds * 1000.0));
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
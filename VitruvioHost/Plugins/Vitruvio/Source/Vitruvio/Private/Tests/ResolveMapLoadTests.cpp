@@ -0,0 +1,165 @@
+/* Copyright 2024 Esri
+ *
+ * Licensed under the Apache License Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "Async/Async.h"
+#include "HAL/Event.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "Misc/AutomationTest.h"
+#include "Tests/MockGenerateBackend.h"
+#include "VitruvioModule.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace ResolveMapLoadTests
+{
+constexpr int32 NumRequesters = 64;
+
+// Default budget of VitruvioModule, restored after the tests which change it
+constexpr int64 DefaultResolveMapCacheBudget = 512 * 1024 * 1024;
+
+// Runs the given function on NumRequesters threads which are all started at once to maximize the contention on the resolve map cache
+void RunConcurrently(TFunction<void(int32)> Function)
+{
+	FEventRef Start(EEventMode::ManualReset);
+	TArray<TFuture<void>> Requesters;
+	for (int32 RequesterIndex = 0; RequesterIndex < NumRequesters; ++RequesterIndex)
+	{
+		Requesters.Add(Async(EAsyncExecution::Thread, [&Start, &Function, RequesterIndex]() {
+			Start->Wait();
+			Function(RequesterIndex);
+		}));
+	}
+
+	Start->Trigger();
+	for (TFuture<void>& Requester : Requesters)
+	{
+		Requester.Wait();
+	}
+}
+} // namespace ResolveMapLoadTests
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FResolveMapLoadStressTest, "Vitruvio.ResolveMapLoad.ConcurrentRequesters",
+								 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FResolveMapLoadStressTest::RunTest(const FString& Parameters)
+{
+	using namespace ResolveMapLoadTests;
+	using namespace VitruvioTests;
+
+	VitruvioModule& Module = VitruvioModule::Get();
+	const FScopedMockGenerateBackend Backend;
+
+	// Slow loads so that most requests arrive while a load of the same Rule Package is in flight
+	Backend->SetLoadMilliseconds(20);
+
+	constexpr int32 NumRulePackages = 8;
+	TArray<URulePackage*> RulePackages;
+	for (int32 Index = 0; Index < NumRulePackages; ++Index)
+	{
+		RulePackages.Add(CreateRulePackage());
+	}
+	Backend->SetFailing(RulePackages[0]);
+	Backend->SetFailing(RulePackages[1]);
+
+	constexpr int32 NumRequestsPerRequester = 50;
+	FThreadSafeCounter NumUnexpectedResults;
+	RunConcurrently([&Module, &RulePackages, &NumUnexpectedResults](int32 RequesterIndex) {
+		for (int32 RequestIndex = 0; RequestIndex < NumRequestsPerRequester; ++RequestIndex)
+		{
+			const int32 RulePackageIndex = (RequesterIndex + RequestIndex) % NumRulePackages;
+			const bool bLoaded = Module.LoadRulePackageAsync(RulePackages[RulePackageIndex]).Get();
+
+			// Every waiter of a failed load is completed with the failure, all other requests get the shared resolve map
+			if (bLoaded != (RulePackageIndex > 1))
+			{
+				NumUnexpectedResults.Increment();
+			}
+		}
+	});
+
+	TestEqual(TEXT("Every request completes with the result of its load"), NumUnexpectedResults.GetValue(), 0);
+	for (int32 RulePackageIndex = 2; RulePackageIndex < NumRulePackages; ++RulePackageIndex)
+	{
+		TestEqual(TEXT("Concurrent requests share a single load"), Backend->GetNumLoads(RulePackages[RulePackageIndex]), 1);
+	}
+
+	// Failed loads are not cached, the next request loads again
+	const int32 NumFailedLoads = Backend->GetNumLoads(RulePackages[0]);
+	TestTrue(TEXT("Failed Rule Package has been loaded"), NumFailedLoads >= 1);
+	TestFalse(TEXT("Failed Rule Package fails again"), Module.LoadRulePackageAsync(RulePackages[0]).Get());
+	TestEqual(TEXT("Failed Rule Package is loaded again"), Backend->GetNumLoads(RulePackages[0]), NumFailedLoads + 1);
+
+	// Evictions concurrent to cache hits and loads, every request still has to complete with its resolve map
+	Backend->SetLoadMilliseconds(1);
+	Module.SetResolveMapCacheBudget(3 * RulePackages[2]->Data.Num());
+	ON_SCOPE_EXIT
+	{
+		Module.SetResolveMapCacheBudget(DefaultResolveMapCacheBudget);
+	};
+	NumUnexpectedResults.Reset();
+	RunConcurrently([&Module, &RulePackages, &NumUnexpectedResults](int32 RequesterIndex) {
+		for (int32 RequestIndex = 0; RequestIndex < NumRequestsPerRequester; ++RequestIndex)
+		{
+			const int32 RulePackageIndex = 2 + (RequesterIndex * 7 + RequestIndex) % (NumRulePackages - 2);
+			if (!Module.LoadRulePackageAsync(RulePackages[RulePackageIndex]).Get())
+			{
+				NumUnexpectedResults.Increment();
+			}
+		}
+	});
+
+	TestEqual(TEXT("Every request completes while resolve maps are evicted"), NumUnexpectedResults.GetValue(), 0);
+	TestFalse(TEXT("No Rule Package is loading anymore"), Module.IsLoadingRpks());
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FResolveMapLoadBenchmark, "Vitruvio.ResolveMapLoad.ContentionBenchmark",
+								 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FResolveMapLoadBenchmark::RunTest(const FString& Parameters)
+{
+	using namespace ResolveMapLoadTests;
+	using namespace VitruvioTests;
+
+	VitruvioModule& Module = VitruvioModule::Get();
+	const FScopedMockGenerateBackend Backend;
+
+	URulePackage* RulePackage = CreateRulePackage();
+	TestTrue(TEXT("Rule Package has been loaded"), Module.LoadRulePackageAsync(RulePackage).Get());
+
+	// All requesters hit the same cached resolve map, which is the case of many generate threads of a single Rule Package
+	constexpr int32 NumRequestsPerRequester = 10000;
+	const double StartTime = FPlatformTime::Seconds();
+	RunConcurrently([&Module, RulePackage](int32 RequesterIndex) {
+		for (int32 RequestIndex = 0; RequestIndex < NumRequestsPerRequester; ++RequestIndex)
+		{
+			Module.LoadRulePackageAsync(RulePackage).Get();
+		}
+	});
+	const double Seconds = FPlatformTime::Seconds() - StartTime;
+
+	TestEqual(TEXT("Cache hits do not load again"), Backend->NumLoads.GetValue(), 1);
+
+	const int32 NumRequests = NumRequesters * NumRequestsPerRequester;
+	AddInfo(FString::Printf(TEXT("%d cache hits by %d requesters in %.2f ms, %.0f hits per second"), NumRequests, NumRequesters,
+							Seconds * 1000.0, NumRequests / Seconds));
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
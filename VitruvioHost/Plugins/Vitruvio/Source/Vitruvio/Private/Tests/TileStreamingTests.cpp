@@ -0,0 +1,116 @@
+/* Copyright 2024 Esri
+ *
+ * Licensed under the Apache License Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Engine/World.h"
+#include "GenerateCompletedCallbackProxy.h"
+#include "Misc/AutomationTest.h"
+#include "Tests/MockGenerateBackend.h"
+#include "VitruvioBatchActor.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace TileStreamingTests
+{
+constexpr double TimeoutSeconds = 10.0;
+constexpr int32 TileSize = 10000;
+constexpr int32 NumTiles = 8;
+
+FVector GetTileCenter(int32 TileIndex)
+{
+	return FVector(TileIndex * TileSize + TileSize / 2, TileSize / 2, 0.0);
+}
+
+// Ticks the batch actor like the engine would in a headless session until the given condition is met
+bool TickUntil(AVitruvioBatchActor* BatchActor, TFunctionRef<bool()> Condition)
+{
+	const double EndTime = FPlatformTime::Seconds() + TimeoutSeconds;
+	while (FPlatformTime::Seconds() < EndTime)
+	{
+		BatchActor->Tick(0.0f);
+		if (Condition())
+		{
+			return true;
+		}
+		FPlatformProcess::Sleep(0.001f);
+	}
+	return false;
+}
+} // namespace TileStreamingTests
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTileStreamingTest, "Vitruvio.BatchActor.TileStreaming",
+								 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FTileStreamingTest::RunTest(const FString& Parameters)
+{
+	using namespace TileStreamingTests;
+	using namespace VitruvioTests;
+
+	const FScopedMockGenerateBackend Backend;
+	URulePackage* RulePackage = CreateRulePackage();
+
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("TileStreamingTest"));
+	AVitruvioBatchActor* BatchActor = World->SpawnActor<AVitruvioBatchActor>();
+	BatchActor->GridDimension = {TileSize, TileSize};
+	BatchActor->bEnableTileStreaming = true;
+	BatchActor->StreamingLoadRadius = 1.5 * TileSize;
+	BatchActor->StreamingHysteresis = 0.5 * TileSize;
+
+	// One component per tile in a row, only the first three tiles are within the unload radius of the viewer
+	for (int32 TileIndex = 0; TileIndex < NumTiles; ++TileIndex)
+	{
+		BatchActor->RegisterVitruvioComponent(CreateVitruvioComponent(World, RulePackage, GetTileCenter(TileIndex)));
+	}
+	BatchActor->SetStreamingSources({GetTileCenter(0)});
+
+	int32 NumGenerateCallsWhenCompleted = -1;
+	UGenerateCompletedCallbackProxy* CallbackProxy = NewObject<UGenerateCompletedCallbackProxy>();
+	CallbackProxy->OnGenerateCompleted.AddLambda([&Backend, &NumGenerateCallsWhenCompleted]() {
+		NumGenerateCallsWhenCompleted = Backend->NumGenerateCalls.GetValue();
+	});
+	BatchActor->GenerateAll(CallbackProxy);
+
+	const auto IsCompleted = [&NumGenerateCallsWhenCompleted]() { return NumGenerateCallsWhenCompleted >= 0; };
+	TestTrue(TEXT("Generate all completes"), TickUntil(BatchActor, IsCompleted));
+	TestEqual(TEXT("Generate all completes after streamed out tiles have been generated as well"), NumGenerateCallsWhenCompleted, NumTiles);
+	TestEqual(TEXT("Tiles far away from the viewer are streamed out"), BatchActor->GetNumResidentTiles(), 3);
+	TestEqual(TEXT("Every tile is known"), BatchActor->GetNumTiles(), NumTiles);
+
+	// The mock generates empty models, completed resident tiles are therefore reported without model
+	const auto AreResidentTilesBuilt = [BatchActor]() {
+		return BatchActor->GetNumResidentTiles() == 3 && BatchActor->GetTilesWithoutModel().Num() == 3;
+	};
+	TestTrue(TEXT("Resident tiles are built"), TickUntil(BatchActor, AreResidentTilesBuilt));
+
+	// Moving the viewer to the other end streams in the tiles which have been generated while being streamed out
+	BatchActor->SetStreamingSources({GetTileCenter(NumTiles - 1)});
+	TestTrue(TEXT("Tiles close to the moved viewer are restored"), TickUntil(BatchActor, AreResidentTilesBuilt));
+	TestEqual(TEXT("Streamed in tiles are restored from their cached results"), Backend->NumGenerateCalls.GetValue(), NumTiles);
+
+	// Moving back restores the tiles which have been resident at first from the cache as well
+	BatchActor->SetStreamingSources({GetTileCenter(0)});
+	TestTrue(TEXT("Tiles close to the original viewer are restored"), TickUntil(BatchActor, AreResidentTilesBuilt));
+	TestEqual(TEXT("Tiles streamed out after generating are restored from their cached results"), Backend->NumGenerateCalls.GetValue(), NumTiles);
+
+	// Without streaming all tiles become resident again
+	BatchActor->bEnableTileStreaming = false;
+	TickUntil(BatchActor, [BatchActor]() { return BatchActor->GetNumResidentTiles() == NumTiles; });
+	TestEqual(TEXT("All tiles are resident without streaming"), BatchActor->GetNumResidentTiles(), NumTiles);
+
+	TestTrue(TEXT("Waiting for idle succeeds"), VitruvioModule::Get().WaitUntilIdle(TimeoutSeconds));
+	World->DestroyWorld(false);
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,144 @@
+/* Copyright 2024 Esri
+ *
+ * Licensed under the Apache License Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Async/Async.h"
+#include "Async/ParallelFor.h"
+#include "Misc/AutomationTest.h"
+#include "UnrealLogHandler.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace UnrealLogHandlerTests
+{
+// Debug messages are only logged verbosely, so the tests do not flood the output log
+constexpr prt::LogLevel Level = prt::LOG_DEBUG;
+
+constexpr int32 Capacity = 1024;
+constexpr int32 NumThreads = 16;
+
+void LogMessages(UnrealLogHandler& LogHandler, int32 NumMessages)
+{
+	ParallelFor(NumThreads, [&LogHandler, NumMessages](int32 ThreadIndex)
+	{
+		for (int32 MessageIndex = ThreadIndex; MessageIndex < NumMessages; MessageIndex += NumThreads)
+		{
+			LogHandler.handleLogEvent(TCHAR_TO_WCHAR(*FString::Printf(TEXT("Message %d"), MessageIndex)), Level);
+		}
+	});
+}
+
+bool IsInCaptureOrder(const TArray<FLogMessage>& Messages)
+{
+	for (int32 Index = 1; Index < Messages.Num(); ++Index)
+	{
+		if (Messages[Index - 1].Sequence >= Messages[Index].Sequence)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+} // namespace UnrealLogHandlerTests
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FUnrealLogHandlerBoundedTest, "Vitruvio.UnrealLogHandler.CapturedMessagesAreBounded",
+								 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FUnrealLogHandlerBoundedTest::RunTest(const FString& Parameters)
+{
+	using namespace UnrealLogHandlerTests;
+
+	constexpr int32 NumMessages = 200000;
+
+	UnrealLogHandler LogHandler(Level, Capacity);
+	LogMessages(LogHandler, NumMessages);
+
+	FLogMessageCounts Counts;
+	const TArray<FLogMessage> Messages = LogHandler.PopMessages(&Counts);
+
+	TestTrue(TEXT("Captured messages do not exceed the capacity"), Messages.Num() <= Capacity);
+	TestEqual(TEXT("Every message is counted"), Counts[Level], NumMessages);
+	TestEqual(TEXT("Every message is either captured or dropped"), Messages.Num() + LogHandler.GetNumDroppedMessages(), NumMessages);
+	TestTrue(TEXT("Messages are returned in capture order"), IsInCaptureOrder(Messages));
+
+	FLogMessageCounts CountsAfterPop;
+	TestTrue(TEXT("Popping removes the captured messages"), LogHandler.PopMessages(&CountsAfterPop).IsEmpty());
+	TestEqual(TEXT("Popping resets the counts"), CountsAfterPop[Level], 0);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FUnrealLogHandlerLevelTest, "Vitruvio.UnrealLogHandler.MessagesBelowCaptureLevelAreCounted",
+								 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FUnrealLogHandlerLevelTest::RunTest(const FString& Parameters)
+{
+	using namespace UnrealLogHandlerTests;
+
+	UnrealLogHandler LogHandler(prt::LOG_INFO, Capacity);
+	LogHandler.handleLogEvent(L"Debug", prt::LOG_DEBUG);
+	LogHandler.handleLogEvent(L"Trace", prt::LOG_TRACE);
+
+	FLogMessageCounts Counts;
+	TestTrue(TEXT("Messages below the capture level are not captured"), LogHandler.PopMessages(&Counts).IsEmpty());
+	TestEqual(TEXT("Debug messages are counted"), Counts[prt::LOG_DEBUG], 1);
+	TestEqual(TEXT("Trace messages are counted"), Counts[prt::LOG_TRACE], 1);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FUnrealLogHandlerStressTest, "Vitruvio.UnrealLogHandler.ConcurrentLogAndPop",
+								 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FUnrealLogHandlerStressTest::RunTest(const FString& Parameters)
+{
+	using namespace UnrealLogHandlerTests;
+
+	constexpr int32 NumMessages = 500000;
+
+	UnrealLogHandler LogHandler(Level, Capacity);
+
+	// Pop concurrently while the PRT worker threads log, like NotifyGenerateCompleted does on the game thread
+	TAtomic<bool> bLogging{true};
+	TFuture<TTuple<int32, int32, bool>> Popped = Async(EAsyncExecution::Thread, [&LogHandler, &bLogging]()
+	{
+		int32 NumPopped = 0;
+		int32 NumCounted = 0;
+		bool bInOrder = true;
+		bool bLastPop = false;
+		while (!bLastPop)
+		{
+			bLastPop = !bLogging;
+
+			FLogMessageCounts Counts;
+			const TArray<FLogMessage> Messages = LogHandler.PopMessages(&Counts);
+			NumPopped += Messages.Num();
+			NumCounted += Counts[Level];
+			bInOrder &= IsInCaptureOrder(Messages);
+		}
+		return MakeTuple(NumPopped, NumCounted, bInOrder);
+	});
+
+	LogMessages(LogHandler, NumMessages);
+	bLogging = false;
+
+	const auto [NumPopped, NumCounted, bInOrder] = Popped.Get();
+	TestEqual(TEXT("Every message is counted exactly once"), NumCounted, NumMessages);
+	TestEqual(TEXT("Every message is either popped or dropped"), NumPopped + LogHandler.GetNumDroppedMessages(), NumMessages);
+	TestTrue(TEXT("Every pop returns the messages in capture order"), bInOrder);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
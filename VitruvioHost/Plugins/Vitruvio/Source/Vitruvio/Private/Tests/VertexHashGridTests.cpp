@@ -0,0 +1,118 @@
+/* Copyright 2024 Esri
+ *
+ * Licensed under the Apache License Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Misc/AutomationTest.h"
+#include "VertexHashGrid.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FVertexHashGridNeighbourCellsTest, "Vitruvio.VertexHashGrid.NeighbourCells",
+								 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FVertexHashGridNeighbourCellsTest::RunTest(const FString& Parameters)
+{
+	constexpr double Tolerance = 1.0;
+
+	TArray<FVector> Vertices = {FVector(0.9, 0.0, 0.0), FVector(0.999, 0.999, 0.999)};
+	Vitruvio::FVertexHashGrid Grid(Vertices.Num(), Tolerance);
+	Grid.Add(Vertices[0], 0);
+	Grid.Add(Vertices[1], 1);
+
+	// Vertices within the tolerance are found across cell boundaries in every direction, including diagonal neighbour cells
+	TestEqual(TEXT("Next cell"), Grid.Find(FVector(1.1, 0.0, 0.0), Vertices), 0);
+	TestEqual(TEXT("Previous cell"), Grid.Find(FVector(-0.05, 0.0, 0.0), Vertices), 0);
+	TestEqual(TEXT("Diagonal cell"), Grid.Find(FVector(1.001, 1.001, 1.001), Vertices), 1);
+
+	TestEqual(TEXT("Outside of the tolerance"), Grid.Find(FVector(2.0, 0.0, 0.0), Vertices), INDEX_NONE);
+	TestEqual(TEXT("Two cells away"), Grid.Find(FVector(0.9, 0.0, 2.5), Vertices), INDEX_NONE);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FVertexHashGridLowestIndexTest, "Vitruvio.VertexHashGrid.LowestIndex",
+								 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FVertexHashGridLowestIndexTest::RunTest(const FString& Parameters)
+{
+	constexpr double Tolerance = 1.0;
+
+	// The lower index is located in a cell which is visited after the cell of the higher index
+	TArray<FVector> Vertices = {FVector(1.2, 0.0, 0.0), FVector(0.8, 0.0, 0.0), FVector(0.5, 5.0, 0.0), FVector(0.6, 5.0, 0.0)};
+	Vitruvio::FVertexHashGrid Grid(Vertices.Num(), Tolerance);
+	for (int32 Index = 0; Index < Vertices.Num(); ++Index)
+	{
+		Grid.Add(Vertices[Index], Index);
+	}
+
+	TestEqual(TEXT("Lowest index across cells"), Grid.Find(FVector(1.0, 0.0, 0.0), Vertices), 0);
+	TestEqual(TEXT("Lowest index in the same cell"), Grid.Find(FVector(0.55, 5.0, 0.0), Vertices), 2);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FVertexHashGridLinearSearchTest, "Vitruvio.VertexHashGrid.MatchesLinearSearch",
+								 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FVertexHashGridLinearSearchTest::RunTest(const FString& Parameters)
+{
+	constexpr double Tolerance = KINDA_SMALL_NUMBER;
+	constexpr int32 NumVertices = 2000;
+
+	// Vertices on a lattice of half the tolerance with some jitter, so that many of them are equal and close to cell boundaries
+	FRandomStream RandomStream(42);
+	TArray<FVector> InputVertices;
+	for (int32 Index = 0; Index < NumVertices; ++Index)
+	{
+		auto RandomCoordinate = [&RandomStream]() {
+			return RandomStream.RandRange(0, 20) * Tolerance * 0.5 + RandomStream.FRandRange(-0.1f, 0.1f) * Tolerance;
+		};
+		InputVertices.Add(FVector(RandomCoordinate(), RandomCoordinate(), RandomCoordinate()));
+	}
+
+	// Deduplicate the same way as the static mesh initial shape and compare with the lowest index found by a linear search
+	TArray<FVector> UniqueVertices;
+	Vitruvio::FVertexHashGrid Grid(NumVertices, Tolerance);
+	int32 NumMismatches = 0;
+	for (const FVector& Vertex : InputVertices)
+	{
+		int32 ExpectedIndex = INDEX_NONE;
+		for (int32 UniqueIndex = 0; UniqueIndex < UniqueVertices.Num(); ++UniqueIndex)
+		{
+			if (Vertex.Equals(UniqueVertices[UniqueIndex], Tolerance))
+			{
+				ExpectedIndex = UniqueIndex;
+				break;
+			}
+		}
+
+		if (Grid.Find(Vertex, UniqueVertices) != ExpectedIndex)
+		{
+			++NumMismatches;
+		}
+
+		if (ExpectedIndex == INDEX_NONE)
+		{
+			Grid.Add(Vertex, UniqueVertices.Num());
+			UniqueVertices.Add(Vertex);
+		}
+	}
+
+	TestEqual(TEXT("Mismatches with linear search"), NumMismatches, 0);
+	TestTrue(TEXT("Vertices have been merged"), UniqueVertices.Num() < NumVertices);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,114 @@
+/* Copyright 2024 Esri
+ *
+ * Licensed under the Apache License Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Async/Async.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "Misc/AutomationTest.h"
+#include "Tests/MockGenerateBackend.h"
+#include "VitruvioModule.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace WaitUntilIdleTests
+{
+constexpr double TimeoutSeconds = 10.0;
+
+// Time the generate call is blocked while waiting
+constexpr float BlockedSeconds = 0.3f;
+
+// Releases the blocked generate calls of the mock from another thread after BlockedSeconds and returns the release time
+TFuture<double> ReleaseDelayed(VitruvioTests::FMockGenerateBackend* Backend)
+{
+	return Async(EAsyncExecution::Thread, [Backend]() {
+		FPlatformProcess::Sleep(BlockedSeconds);
+		const double ReleaseTime = FPlatformTime::Seconds();
+		Backend->Release();
+		return ReleaseTime;
+	});
+}
+} // namespace WaitUntilIdleTests
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWaitUntilIdleLatencyTest, "Vitruvio.WaitUntilIdle.LatencyAndWakeUps",
+								 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FWaitUntilIdleLatencyTest::RunTest(const FString& Parameters)
+{
+	using namespace WaitUntilIdleTests;
+	using namespace VitruvioTests;
+
+	VitruvioModule& Module = VitruvioModule::Get();
+	const FScopedMockGenerateBackend Backend;
+
+	Backend->Block();
+	FGenerateResult Result = Module.GenerateAsync(CreateInitialShape(CreateRulePackage(), 0));
+	if (!TestTrue(TEXT("Generate has been called"), Backend->WaitForGenerateCalls(1, TimeoutSeconds)))
+	{
+		return false;
+	}
+
+	// Every wake up of the waiting thread calls the progress callback, so it counts the CPU work done while nothing completes
+	int32 NumWakeUps = 0;
+	TFuture<double> ReleaseTime = ReleaseDelayed(&*Backend);
+	TestTrue(TEXT("Waiting for idle succeeds"), Module.WaitUntilIdle(TimeoutSeconds, [&NumWakeUps](int32) { ++NumWakeUps; }));
+	const double Latency = FPlatformTime::Seconds() - ReleaseTime.Get();
+
+	// Without completions the thread only wakes up every 100 ms, a completion wakes it up immediately
+	TestTrue(TEXT("Waiting thread sleeps while the generate call is blocked"), NumWakeUps <= 10);
+	TestTrue(TEXT("Waiting thread wakes up when the generate call completes"), Latency < 0.05);
+	AddInfo(FString::Printf(TEXT("%d wake ups in %.0f ms, returned %.2f ms after completion"), NumWakeUps, BlockedSeconds * 1000.0f,
+							Latency * 1000.0));
+
+	Result.Result.Wait();
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWaitUntilIdleGameThreadTaskTest, "Vitruvio.WaitUntilIdle.FromGameThreadTask",
+								 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FWaitUntilIdleGameThreadTaskTest::RunTest(const FString& Parameters)
+{
+	using namespace WaitUntilIdleTests;
+	using namespace VitruvioTests;
+
+	VitruvioModule& Module = VitruvioModule::Get();
+	const FScopedMockGenerateBackend Backend;
+
+	Backend->Block();
+	FGenerateResult Result = Module.GenerateAsync(CreateInitialShape(CreateRulePackage(), 0));
+	if (!TestTrue(TEXT("Generate has been called"), Backend->WaitForGenerateCalls(1, TimeoutSeconds)))
+	{
+		return false;
+	}
+
+	// Waiting from inside of a game thread task must not process the game thread tasks again
+	TOptional<bool> bIdle;
+	const FGraphEventRef WaitTask = FFunctionGraphTask::CreateAndDispatchWhenReady(
+		[&Module, &bIdle]() { bIdle = Module.WaitUntilIdle(TimeoutSeconds); }, TStatId(), nullptr, ENamedThreads::GameThread);
+
+	TFuture<double> ReleaseTime = ReleaseDelayed(&*Backend);
+	FTaskGraphInterface::Get().WaitUntilTaskCompletes(WaitTask, ENamedThreads::GameThread);
+	ReleaseTime.Wait();
+
+	if (TestTrue(TEXT("Game thread task has waited"), bIdle.IsSet()))
+	{
+		TestTrue(TEXT("Waiting for idle from a game thread task succeeds"), bIdle.GetValue());
+	}
+	TestEqual(TEXT("All generate calls have completed"), Module.GetNumGenerateCalls(), 0);
+
+	Result.Result.Wait();
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
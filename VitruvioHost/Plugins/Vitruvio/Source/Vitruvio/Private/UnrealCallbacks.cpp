@@ -22,11 +22,15 @@
 #include "Engine/StaticMesh.h"
 #include "IImageWrapper.h"
 #include "Materials/MaterialInstanceDynamic.h"
+#include "Misc/ScopeLock.h"
 #include "StaticMeshAttributes.h"
 #include "StaticMeshDescription.h"
 #include "StaticMeshOperations.h"
 #include "Util/AsyncHelpers.h"
+#include "Util/AttributeNames.h"
+#include "Util/CollisionGeneration.h"
 #include "VitruvioModule.h"
+#include "VitruvioStats.h"
 #include "prtx/Mesh.h"
 
 DEFINE_LOG_CATEGORY(LogUnrealCallbacks);
@@ -106,6 +110,8 @@ TMap<FString, double> CreateAvailableUVSetMaterialParameterMap(uint32_t const* c
 FModelDescription ConvertMesh(const double* vtx, size_t vtxSize, const double* nrm, size_t nrmSize, const uint32_t* faceVertexCounts, size_t faceVertexCountsSize, const uint32_t* vertexIndices, size_t vertexIndicesSize, const uint32_t* normalIndices, size_t normalIndicesSize,
 	double const* const* uvs, uint32_t const* const* uvCounts, uint32_t const* const* uvIndices, size_t uvSets, const uint32_t* faceRanges, size_t faceRangesSize, const prt::AttributeMap** materials)
 {
+	SCOPE_CYCLE_COUNTER(STAT_Vitruvio_ConvertMesh);
+
 	FModelDescription ModelDescription;
     FStaticMeshAttributes Attributes(ModelDescription.MeshDescription);
     Attributes.Register();
@@ -213,8 +219,11 @@ FModelDescription ConvertMesh(const double* vtx, size_t vtxSize, const double* n
 	return ModelDescription;
 }
 
-TSharedPtr<FVitruvioMesh> CreateVitruvioMesh(const FString& Identifier, FMeshDescription Description, TArray<Vitruvio::FMaterialAttributeContainer> ModelMaterials)
+TSharedPtr<FVitruvioMesh> CreateVitruvioMesh(const FString& Identifier, FMeshDescription Description, TArray<Vitruvio::FMaterialAttributeContainer> ModelMaterials,
+	const FGeneratedCollisionSettings& CollisionSettings)
 {
+	SCOPE_CYCLE_COUNTER(STAT_Vitruvio_CreateVitruvioMesh);
+
 	bool bHasInvalidNormals;
 	bool bHasInvalidTangents;
 	FStaticMeshOperations::AreNormalsAndTangentsValid(Description, bHasInvalidNormals, bHasInvalidTangents);
@@ -232,7 +241,9 @@ TSharedPtr<FVitruvioMesh> CreateVitruvioMesh(const FString& Identifier, FMeshDes
 		FStaticMeshOperations::ComputeMikktTangents(Description, true);
 	}
 
-	return MakeShared<FVitruvioMesh>(Identifier, Description, ModelMaterials);
+	FCollisionData CollisionData = Vitruvio::CreateCollisionData(Description, CollisionSettings);
+
+	return MakeShared<FVitruvioMesh>(Identifier, Description, ModelMaterials, MoveTemp(CollisionData));
 }
 
 TMap<FString, FReport> ExtractReports(const prt::AttributeMap* reports)
@@ -253,6 +264,7 @@ TMap<FString, FReport> ExtractReports(const prt::AttributeMap* reports)
 		case prt::AttributeMap::PrimitiveType::PT_BOOL:
 			Report.Type = EReportPrimitiveType::Bool;
 			Report.Value = reports->getBool(key) ? TEXT("true") : TEXT("false");
+			Report.NumericValue = reports->getBool(key) ? 1.0 : 0.0;
 			break;
 		case prt::AttributeMap::PrimitiveType::PT_STRING:
 			Report.Type = EReportPrimitiveType::String;
@@ -260,10 +272,12 @@ TMap<FString, FReport> ExtractReports(const prt::AttributeMap* reports)
 			break;
 		case prt::AttributeMap::PrimitiveType::PT_FLOAT:
 			Report.Type = EReportPrimitiveType::Float;
-			Report.Value = FString::SanitizeFloat(reports->getFloat(key));
+			Report.NumericValue = reports->getFloat(key);
+			Report.Value = FString::SanitizeFloat(Report.NumericValue);
 			break;
 		case prt::AttributeMap::PrimitiveType::PT_INT:
 			Report.Type = EReportPrimitiveType::Int;
+			Report.NumericValue = reports->getInt(key);
 			Report.Value = FString::FromInt(reports->getInt(key));
 			break;
 		default:
@@ -298,6 +312,8 @@ void UnrealCallbacks::addMesh(const wchar_t* name, const wchar_t* meshId, int32_
 
                               const uint32_t* faceRanges, size_t faceRangesSize, const prt::AttributeMap** materials)
 {
+	TRACE_CPUPROFILER_EVENT_SCOPE(UnrealCallbacks::addMesh);
+
 	if (prototypeId == NoPrototypeIndex)
 	{
 		ModelDescription = ConvertMesh(vtx, vtxSize, nrm, nrmSize, faceVertexCounts, faceVertexCountsSize, vertexIndices, vertexIndicesSize,
@@ -308,7 +324,10 @@ void UnrealCallbacks::addMesh(const wchar_t* name, const wchar_t* meshId, int32_
 		const FString NameString(name);
 		const FString IdentifierString(meshId);
 
-		if (const TSharedPtr<FVitruvioMesh> Mesh = VitruvioModule::Get().GetMeshCache().Get(IdentifierString))
+		// Meshes with different collision settings can not share their static mesh (and therefore their body setup)
+		const FString CacheKey = IdentifierString + TEXT("#") + CollisionSettings.ToCacheKey();
+
+		if (const TSharedPtr<FVitruvioMesh> Mesh = VitruvioModule::Get().GetMeshCache().Get(CacheKey))
 		{
 			InstanceMeshes.Add(meshId, Mesh);
 			InstanceNames.Add(meshId, NameString);
@@ -322,8 +341,9 @@ void UnrealCallbacks::addMesh(const wchar_t* name, const wchar_t* meshId, int32_
 		{
 			InstanceModelDescription.MeshDescription.TriangulateMesh();
 			
-			TSharedPtr<FVitruvioMesh> Mesh = CreateVitruvioMesh(IdentifierString, InstanceModelDescription.MeshDescription, InstanceModelDescription.Materials);
-			Mesh = VitruvioModule::Get().GetMeshCache().InsertOrGet(IdentifierString, Mesh);
+			TSharedPtr<FVitruvioMesh> Mesh = CreateVitruvioMesh(IdentifierString, InstanceModelDescription.MeshDescription, InstanceModelDescription.Materials,
+				CollisionSettings);
+			Mesh = VitruvioModule::Get().GetMeshCache().InsertOrGet(CacheKey, Mesh);
 
 			InstanceMeshes.Add(meshId, Mesh);
 			InstanceNames.Add(meshId, NameString);
@@ -333,26 +353,91 @@ void UnrealCallbacks::addMesh(const wchar_t* name, const wchar_t* meshId, int32_
 
 void UnrealCallbacks::finish()
 {
+	TRACE_CPUPROFILER_EVENT_SCOPE(UnrealCallbacks::finish);
+
 	if (!ModelDescription.MeshDescription.IsEmpty())
 	{
-		GeneratedModel = CreateVitruvioMesh(TEXT("GeneratedMesh"), ModelDescription.MeshDescription, ModelDescription.Materials);
+		GeneratedModel = CreateVitruvioMesh(TEXT("GeneratedMesh"), ModelDescription.MeshDescription, ModelDescription.Materials, CollisionSettings);
 	}
 }
 
 void UnrealCallbacks::addReport(const prt::AttributeMap* reports)
 {
+	TRACE_CPUPROFILER_EVENT_SCOPE(UnrealCallbacks::addReport);
+
 	if (!reports)
 	{
 		UE_LOG(LogUnrealCallbacks, Warning, TEXT("Trying to add empty report, ignoring."));
 		return;
 	}
 
+	// Batch generates report once per initial shape without its index, the statistics are therefore aggregated from the CGA report callbacks
 	Reports = ExtractReports(reports);
 }
 
+prt::Status UnrealCallbacks::AddShapeReport(size_t isIndex, const wchar_t* Key, const FReport& Report)
+{
+	// The report name is only converted to an FString once per shape instead of once per report
+	const Vitruvio::FAttributeName& Name = Vitruvio::FAttributeNameTable::Get().FindOrAdd(Key);
+
+	FScopeLock Lock(&ShapeReportsLock);
+	FReportStatistics& Statistics = ShapeReportStatistics.FindOrAdd(static_cast<int32>(isIndex)).FindOrAdd(Name.CaseInsensitiveId);
+	const bool bFirstReport = Statistics.Count == 0;
+	Statistics.Add(Report);
+	if (bFirstReport)
+	{
+		Statistics.Name = Name.Name;
+	}
+	return prt::STATUS_OK;
+}
+
+prt::Status UnrealCallbacks::cgaReportBool(size_t isIndex, int32_t /*shapeID*/, const wchar_t* key, bool value)
+{
+	FReport Report;
+	Report.Type = EReportPrimitiveType::Bool;
+	Report.NumericValue = value ? 1.0 : 0.0;
+	return AddShapeReport(isIndex, key, Report);
+}
+
+prt::Status UnrealCallbacks::cgaReportFloat(size_t isIndex, int32_t /*shapeID*/, const wchar_t* key, double value)
+{
+	FReport Report;
+	Report.Type = EReportPrimitiveType::Float;
+	Report.NumericValue = value;
+	return AddShapeReport(isIndex, key, Report);
+}
+
+prt::Status UnrealCallbacks::cgaReportString(size_t isIndex, int32_t /*shapeID*/, const wchar_t* key, const wchar_t* value)
+{
+	FReport Report;
+	Report.Type = EReportPrimitiveType::String;
+	Report.Value = value;
+	return AddShapeReport(isIndex, key, Report);
+}
+
+TArray<TMap<FString, FReportStatistics>> UnrealCallbacks::GetShapeReportStatistics(int32 NumInitialShapes) const
+{
+	TArray<TMap<FString, FReportStatistics>> Result;
+	Result.SetNum(NumInitialShapes);
+	for (const auto& [InitialShapeIndex, Statistics] : ShapeReportStatistics)
+	{
+		if (Result.IsValidIndex(InitialShapeIndex))
+		{
+			Result[InitialShapeIndex].Reserve(Statistics.Num());
+			for (const auto& [NameId, ReportStatistics] : Statistics)
+			{
+				Result[InitialShapeIndex].Add(ReportStatistics.Name, ReportStatistics);
+			}
+		}
+	}
+	return Result;
+}
+
 void UnrealCallbacks::addInstance(int32_t prototypeId, const wchar_t* meshId, const double* transform, const prt::AttributeMap** instanceMaterials,
                                   size_t numInstanceMaterials)
 {
+	TRACE_CPUPROFILER_EVENT_SCOPE(UnrealCallbacks::addInstance);
+
 	const FMatrix TransformationMat(GetColumn(transform, 0), GetColumn(transform, 1), GetColumn(transform, 2), GetColumn(transform, 3));
 	const int32 SignumDet = FMath::Sign(TransformationMat.Determinant());
 
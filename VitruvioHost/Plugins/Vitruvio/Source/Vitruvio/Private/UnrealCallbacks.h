@@ -25,6 +25,7 @@
 #include "MeshDescription.h"
 #include "StaticMeshAttributes.h"
 #include "Modules/ModuleManager.h"
+#include "GeneratedCollision.h"
 #include "VitruvioMesh.h"
 
 DECLARE_LOG_CATEGORY_EXTERN(LogUnrealCallbacks, Log, All);
@@ -48,10 +49,22 @@ class UnrealCallbacks final : public IUnrealCallbacks
 	FModelDescription ModelDescription;
 	TSharedPtr<FVitruvioMesh> GeneratedModel;
 	TMap<FString, FReport> Reports;
+
+	// Reports of the CGA report operations aggregated per initial shape, indexed by the position of the shape in the generate call. The
+	// statistics of a shape are keyed by the case-insensitive id of the interned report name, see Vitruvio::FAttributeNameTable.
+	FCriticalSection ShapeReportsLock;
+	TMap<int32, TMap<int32, FReportStatistics>> ShapeReportStatistics;
+
+	prt::Status AddShapeReport(size_t isIndex, const wchar_t* Key, const FReport& Report);
+
+	FGeneratedCollisionSettings CollisionSettings;
 	
 public:
 	virtual ~UnrealCallbacks() override = default;
-	UnrealCallbacks(TArray<AttributeMapBuilderUPtr>& AttributeMapBuilders) : AttributeMapBuilders(AttributeMapBuilders) {}
+	UnrealCallbacks(TArray<AttributeMapBuilderUPtr>& AttributeMapBuilders, const FGeneratedCollisionSettings& CollisionSettings = {})
+		: AttributeMapBuilders(AttributeMapBuilders), CollisionSettings(CollisionSettings)
+	{
+	}
 
 	static constexpr int32 NoPrototypeIndex = -1;
 
@@ -75,6 +88,14 @@ public:
 		return Reports;
 	}
 
+	/**
+	 * Only valid once the generate call has returned.
+	 *
+	 * @param NumInitialShapes the number of initial shapes of the generate call.
+	 * @return the reports of every initial shape aggregated by name, in the order of the initial shapes of the generate call.
+	 */
+	TArray<TMap<FString, FReportStatistics>> GetShapeReportStatistics(int32 NumInitialShapes) const;
+
 	const TMap<FString, FString>& GetInstanceNames() const
 	{
 		return InstanceNames;
@@ -165,18 +186,14 @@ public:
 		return prt::STATUS_OK;
 	}
 
-	virtual prt::Status cgaReportBool(size_t isIndex, int32_t shapeID, const wchar_t* key, bool value) override
-	{
-		return prt::STATUS_OK;
-	}
-	virtual prt::Status cgaReportFloat(size_t isIndex, int32_t shapeID, const wchar_t* key, double value) override
-	{
-		return prt::STATUS_OK;
-	}
-	virtual prt::Status cgaReportString(size_t isIndex, int32_t shapeID, const wchar_t* key, const wchar_t* value) override
-	{
-		return prt::STATUS_OK;
-	}
+	/**
+	 * Called by the CGA report encoder for every report operation, possibly concurrently for different initial shapes.
+	 *
+	 * @param isIndex the position of the reporting initial shape in the generate call
+	 */
+	virtual prt::Status cgaReportBool(size_t isIndex, int32_t shapeID, const wchar_t* key, bool value) override;
+	virtual prt::Status cgaReportFloat(size_t isIndex, int32_t shapeID, const wchar_t* key, double value) override;
+	virtual prt::Status cgaReportString(size_t isIndex, int32_t shapeID, const wchar_t* key, const wchar_t* value) override;
 
 	virtual prt::Status attrBool(size_t isIndex, int32_t shapeID, const wchar_t* key, bool value) override;
 	virtual prt::Status attrFloat(size_t isIndex, int32_t shapeID, const wchar_t* key, double value) override;
@@ -14,24 +14,81 @@
  */
 
 #include "UnrealLogHandler.h"
+#include "Algo/Sort.h"
+#include "HAL/PlatformTLS.h"
 #include "Logging/LogMacros.h"
 #include "Misc/ScopeLock.h"
 
 DEFINE_LOG_CATEGORY_STATIC(UnrealPrtLog, Log, All);
 
-TArray<FLogMessage> UnrealLogHandler::PopMessages()
+UnrealLogHandler::UnrealLogHandler(prt::LogLevel MinCaptureLevel, int32 Capacity)
+	: ShardCapacity(FMath::Max(1, FMath::DivideAndRoundUp(Capacity, NumShards))), MinCaptureLevel(MinCaptureLevel)
 {
-	FScopeLock Lock(&MessageLock);
-	TArray<FLogMessage> Result(Messages);
-	Messages.Empty();
+}
+
+TArray<FLogMessage> UnrealLogHandler::PopMessages(FLogMessageCounts* OutCounts)
+{
+	TArray<FLogMessage> Result;
+
+	for (FMessageShard& Shard : Shards)
+	{
+		// Only swap the buffer while holding the lock so that PRT threads are not blocked while we copy the messages
+		TArray<FLogMessage> ShardMessages;
+		int32 Head;
+		{
+			FScopeLock Lock(&Shard.Lock);
+			Swap(ShardMessages, Shard.Messages);
+			Head = Shard.Head;
+			Shard.Head = 0;
+		}
+
+		// The oldest message of a full ring buffer is located at its head
+		Result.Reserve(Result.Num() + ShardMessages.Num());
+		for (int32 Index = 0; Index < ShardMessages.Num(); ++Index)
+		{
+			Result.Add(MoveTemp(ShardMessages[(Head + Index) % ShardMessages.Num()]));
+		}
+	}
+
+	// Every shard is in order by itself, merging them by their sequence numbers restores the order across threads
+	Algo::SortBy(Result, &FLogMessage::Sequence);
+
+	for (int32 Level = 0; Level <= prt::LOG_FATAL; ++Level)
+	{
+		const int32 Count = MessageCounts[Level].Reset();
+		if (OutCounts)
+		{
+			OutCounts->Counts[Level] = Count;
+		}
+	}
+
 	return Result;
 }
 
 void UnrealLogHandler::handleLogEvent(const wchar_t* msg, prt::LogLevel level)
 {
-	FScopeLock Lock(&MessageLock);
-	const FString MessageString(WCHAR_TO_TCHAR(msg));
-	Messages.Push({MessageString, level});
+	if (level <= prt::LOG_FATAL)
+	{
+		MessageCounts[level].Increment();
+	}
+
+	if (level >= MinCaptureLevel && level <= prt::LOG_FATAL)
+	{
+		FLogMessage Message{FString(WCHAR_TO_TCHAR(msg)), level, static_cast<uint64>(NextSequence.Increment())};
+
+		FMessageShard& Shard = Shards[FPlatformTLS::GetCurrentThreadId() % NumShards];
+		FScopeLock Lock(&Shard.Lock);
+		if (Shard.Messages.Num() < ShardCapacity)
+		{
+			Shard.Messages.Add(MoveTemp(Message));
+		}
+		else
+		{
+			Shard.Messages[Shard.Head] = MoveTemp(Message);
+			Shard.Head = (Shard.Head + 1) % ShardCapacity;
+			DroppedMessages.Increment();
+		}
+	}
 
 	switch (level)
 	{
@@ -18,6 +18,9 @@
 #include "AttributeConversion.h"
 
 #include "AnnotationParsing.h"
+#include "AttributeNames.h"
+
+#include "HAL/ThreadSafeCounter.h"
 
 #include "PRTTypes.h"
 #include "PRTUtils.h"
@@ -27,6 +30,8 @@ namespace
 {
 const FString DEFAULT_STYLE = TEXT("Default");
 
+FThreadSafeCounter NumCreatedAttributeMaps;
+
 std::vector<const wchar_t*> ToPtrVector(const TArray<FString>& Input)
 {
 	std::vector<const wchar_t*> PtrVec(Input.Num());
@@ -326,7 +331,7 @@ void UpdateAttributeMap(TMap<FString, URuleAttribute*>& AttributeMapOut, const A
 
 		if (Attribute)
 		{
-			const FString AttributeName = WCHAR_TO_TCHAR(Name.c_str());
+			const FString& AttributeName = FAttributeNameTable::Get().FindOrAdd(Name.c_str()).Name;
 			Attribute->Name = AttributeName;
 
 			ParseAttributeAnnotations(AttrInfo, *Attribute, Outer);
@@ -373,6 +378,8 @@ void UpdateAttributeMap(TMap<FString, URuleAttribute*>& AttributeMapOut, const A
 AttributeMapUPtr CreateAttributeMap(const TMap<FString, URuleAttribute*>& Attributes)
 {
 	AttributeMapBuilderUPtr AttributeMapBuilder(prt::AttributeMapBuilder::create());
+	FAttributeNameTable& AttributeNameTable = FAttributeNameTable::Get();
+	NumCreatedAttributeMaps.Increment();
 
 	for (const TPair<FString, URuleAttribute*>& AttributeEntry : Attributes)
 	{
@@ -381,35 +388,41 @@ AttributeMapUPtr CreateAttributeMap(const TMap<FString, URuleAttribute*>& Attrib
 		if (!Attribute->bUserSet)
 			continue;
 
+		// The interned wide name avoids converting the attribute name on every generate
+		const wchar_t* Name = AttributeNameTable.FindOrAdd(Attribute->Name).WideName.c_str();
+
 		if (const UFloatAttribute* FloatAttribute = Cast<UFloatAttribute>(Attribute))
 		{
-			AttributeMapBuilder->setFloat(TCHAR_TO_WCHAR(*Attribute->Name), FloatAttribute->Value);
+			AttributeMapBuilder->setFloat(Name, FloatAttribute->Value);
 		}
 		else if (const UStringAttribute* StringAttribute = Cast<UStringAttribute>(Attribute))
 		{
-			AttributeMapBuilder->setString(TCHAR_TO_WCHAR(*Attribute->Name), TCHAR_TO_WCHAR(*StringAttribute->Value));
+			AttributeMapBuilder->setString(Name, TCHAR_TO_WCHAR(*StringAttribute->Value));
 		}
 		else if (const UBoolAttribute* BoolAttribute = Cast<UBoolAttribute>(Attribute))
 		{
-			AttributeMapBuilder->setBool(TCHAR_TO_WCHAR(*Attribute->Name), BoolAttribute->Value);
+			AttributeMapBuilder->setBool(Name, BoolAttribute->Value);
 		}
 		else if (const UStringArrayAttribute* StringArrayAttribute = Cast<UStringArrayAttribute>(Attribute))
 		{
 			std::vector<const wchar_t*> PtrVec = ToPtrVector(StringArrayAttribute->Values);
-			AttributeMapBuilder->setStringArray(TCHAR_TO_WCHAR(*Attribute->Name), PtrVec.data(), StringArrayAttribute->Values.Num());
+			AttributeMapBuilder->setStringArray(Name, PtrVec.data(), StringArrayAttribute->Values.Num());
 		}
 		else if (const UBoolArrayAttribute* BoolArrayAttribute = Cast<UBoolArrayAttribute>(Attribute))
 		{
-			AttributeMapBuilder->setBoolArray(TCHAR_TO_WCHAR(*Attribute->Name), BoolArrayAttribute->Values.GetData(),
-			                                  BoolArrayAttribute->Values.Num());
+			AttributeMapBuilder->setBoolArray(Name, BoolArrayAttribute->Values.GetData(), BoolArrayAttribute->Values.Num());
 		}
 		else if (const UFloatArrayAttribute* FloatArrayAttribute = Cast<UFloatArrayAttribute>(Attribute))
 		{
-			AttributeMapBuilder->setFloatArray(TCHAR_TO_WCHAR(*Attribute->Name), FloatArrayAttribute->Values.GetData(),
-			                                   FloatArrayAttribute->Values.Num());
+			AttributeMapBuilder->setFloatArray(Name, FloatArrayAttribute->Values.GetData(), FloatArrayAttribute->Values.Num());
 		}
 	}
 
 	return AttributeMapUPtr(AttributeMapBuilder->createAttributeMap(), PRTDestroyer());
 }
+
+int32 GetNumCreatedAttributeMaps()
+{
+	return NumCreatedAttributeMaps.GetValue();
+}
 } // namespace Vitruvio
@@ -24,4 +24,7 @@ void UpdateAttributeMap(TMap<FString, URuleAttribute*>& AttributeMapOut, const A
 						UObject* const Outer);
 
 AttributeMapUPtr CreateAttributeMap(const TMap<FString, URuleAttribute*>& Attributes);
+
+// The number of attribute maps which have been created by CreateAttributeMap since the module has been started
+int32 GetNumCreatedAttributeMaps();
 } // namespace Vitruvio
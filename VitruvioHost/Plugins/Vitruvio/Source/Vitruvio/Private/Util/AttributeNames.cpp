@@ -0,0 +1,102 @@
+/* Copyright 2024 Esri
+ *
+ * Licensed under the Apache License Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "AttributeNames.h"
+
+namespace Vitruvio
+{
+
+FAttributeNameTable& FAttributeNameTable::Get()
+{
+	static FAttributeNameTable AttributeNameTable;
+	return AttributeNameTable;
+}
+
+const FAttributeName& FAttributeNameTable::FindOrAdd(const wchar_t* Name)
+{
+	const uint32 Hash = FCrc::StrCrc32(Name);
+
+	{
+		FReadScopeLock ReadLock(Lock);
+		if (const FAttributeName* AttributeName = Find(Name, Hash))
+		{
+			return *AttributeName;
+		}
+	}
+
+	FWriteScopeLock WriteLock(Lock);
+
+	// The name might have been added while the lock was released
+	if (const FAttributeName* AttributeName = Find(Name, Hash))
+	{
+		return *AttributeName;
+	}
+
+	return Add(Name, WCHAR_TO_TCHAR(Name));
+}
+
+const FAttributeName& FAttributeNameTable::FindOrAdd(const FString& Name)
+{
+	{
+		FReadScopeLock ReadLock(Lock);
+		if (const int32* Id = IdsByName.Find(Name))
+		{
+			return *Entries[*Id];
+		}
+	}
+
+	FWriteScopeLock WriteLock(Lock);
+
+	// The name might have been added while the lock was released
+	if (const int32* Id = IdsByName.Find(Name))
+	{
+		return *Entries[*Id];
+	}
+
+	return Add(TCHAR_TO_WCHAR(*Name), Name);
+}
+
+const FString& FAttributeNameTable::GetName(int32 Id) const
+{
+	FReadScopeLock ReadLock(Lock);
+	return Entries[Id]->Name;
+}
+
+const FAttributeName* FAttributeNameTable::Find(const wchar_t* Name, uint32 Hash) const
+{
+	for (auto It = IdsByHash.CreateConstKeyIterator(Hash); It; ++It)
+	{
+		const FAttributeName& AttributeName = *Entries[It.Value()];
+		if (AttributeName.WideName == Name)
+		{
+			return &AttributeName;
+		}
+	}
+	return nullptr;
+}
+
+const FAttributeName& FAttributeNameTable::Add(const wchar_t* WideName, const FString& Name)
+{
+	const int32 Id = Entries.Num();
+	const int32 CaseInsensitiveId = CaseInsensitiveIds.FindOrAdd(Name, Id);
+
+	const FAttributeName& AttributeName = *Entries.Add_GetRef(MakeUnique<FAttributeName>(FAttributeName{Id, CaseInsensitiveId, WideName, Name}));
+	IdsByHash.Add(FCrc::StrCrc32(WideName), Id);
+	IdsByName.Add(Name, Id);
+	return AttributeName;
+}
+
+} // namespace Vitruvio
@@ -0,0 +1,93 @@
+/* Copyright 2024 Esri
+ *
+ * Licensed under the Apache License Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/ScopeRWLock.h"
+
+#include <string>
+
+namespace Vitruvio
+{
+
+/**
+ * An attribute name interned by FAttributeNameTable, which holds both the wide name passed to and reported by PRT and the converted FString.
+ */
+struct FAttributeName
+{
+	/** Equal names have equal ids, ids are compared case-sensitively. */
+	int32 Id = INDEX_NONE;
+
+	/** The id of the first interned name which only differs in case, the same name matching as for FString keyed maps. */
+	int32 CaseInsensitiveId = INDEX_NONE;
+
+	std::wstring WideName;
+	FString Name;
+};
+
+/**
+ * Interns the attribute names exchanged with PRT. Every distinct name is converted between its wide and FString representation only once
+ * and afterwards identified by a compact id, which can be compared and used as map key without hashing or converting the name again. Names
+ * are shared by all Rule Packages and kept for the lifetime of the module.
+ */
+class FAttributeNameTable
+{
+public:
+	static FAttributeNameTable& Get();
+
+	/**
+	 * \brief Returns the interned name and adds the name to the table if it has not been seen before. Thread safe.
+	 *
+	 * \return the interned name. Names are never removed, the returned reference therefore stays valid.
+	 */
+	const FAttributeName& FindOrAdd(const wchar_t* Name);
+	const FAttributeName& FindOrAdd(const FString& Name);
+
+	/**
+	 * \return the name with the given id. Names are never removed, the returned reference therefore stays valid.
+	 */
+	const FString& GetName(int32 Id) const;
+
+private:
+	// The names are compared case-sensitively, unlike the default FString keys
+	struct FCaseSensitiveKeyFuncs : TDefaultMapKeyFuncs<FString, int32, false>
+	{
+		static bool Matches(KeyInitType A, KeyInitType B)
+		{
+			return A.Equals(B, ESearchCase::CaseSensitive);
+		}
+
+		static uint32 GetKeyHash(KeyInitType Key)
+		{
+			return FCrc::StrCrc32(*Key);
+		}
+	};
+
+	mutable FRWLock Lock;
+
+	TMultiMap<uint32, int32> IdsByHash;
+	TMap<FString, int32, FDefaultSetAllocator, FCaseSensitiveKeyFuncs> IdsByName;
+	TMap<FString, int32> CaseInsensitiveIds;
+	TArray<TUniquePtr<FAttributeName>> Entries;
+
+	const FAttributeName* Find(const wchar_t* Name, uint32 Hash) const;
+
+	// Requires Lock to be held for writing
+	const FAttributeName& Add(const wchar_t* WideName, const FString& Name);
+};
+
+} // namespace Vitruvio
@@ -0,0 +1,57 @@
+/* Copyright 2024 Esri
+ *
+ * Licensed under the Apache License Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "CacheEviction.h"
+
+#include "Algo/Sort.h"
+
+namespace Vitruvio
+{
+
+TArray<int32> SelectEntriesToEvict(const TArray<FCacheEntryUsage>& Usages, int64 Budget)
+{
+	int64 CacheSize = 0;
+	TArray<int32> LeastRecentlyUsed;
+	LeastRecentlyUsed.Reserve(Usages.Num());
+	for (int32 UsageIndex = 0; UsageIndex < Usages.Num(); ++UsageIndex)
+	{
+		CacheSize += Usages[UsageIndex].Size;
+		LeastRecentlyUsed.Add(UsageIndex);
+	}
+
+	TArray<int32> EvictedIndices;
+	if (CacheSize <= Budget)
+	{
+		return EvictedIndices;
+	}
+
+	Algo::SortBy(LeastRecentlyUsed, [&Usages](int32 UsageIndex) { return Usages[UsageIndex].LastAccess; });
+
+	for (int32 OrderIndex = 0; CacheSize > Budget && OrderIndex < LeastRecentlyUsed.Num() - 1; ++OrderIndex)
+	{
+		const FCacheEntryUsage& Usage = Usages[LeastRecentlyUsed[OrderIndex]];
+		if (Usage.bInUse)
+		{
+			continue;
+		}
+
+		CacheSize -= Usage.Size;
+		EvictedIndices.Add(LeastRecentlyUsed[OrderIndex]);
+	}
+
+	return EvictedIndices;
+}
+
+} // namespace Vitruvio
@@ -0,0 +1,42 @@
+/* Copyright 2024 Esri
+ *
+ * Licensed under the Apache License Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+namespace Vitruvio
+{
+
+struct FCacheEntryUsage
+{
+	// Higher values have been used more recently
+	int64 LastAccess = 0;
+	int64 Size = 0;
+	// Entries which are still referenced outside of the cache can not be evicted
+	bool bInUse = false;
+};
+
+/**
+ * Selects the least recently used entries which have to be evicted for the total size of all entries to fit into the budget. Entries which
+ * are in use are skipped and the most recently used entry is always kept.
+ *
+ * @param Usages	The usage of every cache entry
+ * @param Budget	The maximum total size of all entries
+ * @return the indices into Usages of the entries to evict, least recently used first
+ */
+TArray<int32> SelectEntriesToEvict(const TArray<FCacheEntryUsage>& Usages, int64 Budget);
+
+} // namespace Vitruvio
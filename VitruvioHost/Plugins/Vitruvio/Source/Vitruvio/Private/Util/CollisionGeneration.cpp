@@ -0,0 +1,476 @@
+/* Copyright 2024 Esri
+ *
+ * Licensed under the Apache License Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "CollisionGeneration.h"
+
+#include "Algo/Sort.h"
+#include "CompGeom/ConvexHull3.h"
+#include "StaticMeshAttributes.h"
+#include "VitruvioStats.h"
+
+namespace
+{
+
+// Minimum thickness in cm of collision boxes, flat parts (eg. a single facade) would otherwise result in boxes without volume
+constexpr float MinBoxThickness = 1.0f;
+
+struct FCollisionPart
+{
+	TArray<FVector3f> Points;
+	FBox3f Bounds = FBox3f(ForceInit);
+};
+
+void GetTriangleMesh(const FMeshDescription& MeshDescription, TArray<FVector3f>& OutVertices, TArray<FTriIndices>& OutIndices,
+					 TArray<uint16>& OutMaterialIndices)
+{
+	const FStaticMeshConstAttributes MeshAttributes(MeshDescription);
+	const TVertexAttributesConstRef<FVector3f> VertexPositions = MeshAttributes.GetVertexPositions();
+
+	OutVertices.Reserve(VertexPositions.GetNumElements());
+	for (int32 VertexIndex = 0; VertexIndex < VertexPositions.GetNumElements(); ++VertexIndex)
+	{
+		OutVertices.Add(VertexPositions[FVertexID(VertexIndex)]);
+	}
+
+	OutIndices.Reserve(MeshDescription.Triangles().Num());
+	OutMaterialIndices.Reserve(MeshDescription.Triangles().Num());
+	uint16 MaterialIndex = 0;
+	for (const FPolygonGroupID PolygonGroupId : MeshDescription.PolygonGroups().GetElementIDs())
+	{
+		for (const FPolygonID PolygonID : MeshDescription.GetPolygonGroupPolygonIDs(PolygonGroupId))
+		{
+			for (const FTriangleID TriangleID : MeshDescription.GetPolygonTriangles(PolygonID))
+			{
+				const TArrayView<const FVertexInstanceID> TriangleVertexInstances = MeshDescription.GetTriangleVertexInstances(TriangleID);
+
+				FTriIndices TriIndex;
+				TriIndex.v0 = MeshDescription.GetVertexInstanceVertex(TriangleVertexInstances[0]).GetValue();
+				TriIndex.v1 = MeshDescription.GetVertexInstanceVertex(TriangleVertexInstances[1]).GetValue();
+				TriIndex.v2 = MeshDescription.GetVertexInstanceVertex(TriangleVertexInstances[2]).GetValue();
+				OutIndices.Add(TriIndex);
+				OutMaterialIndices.Add(MaterialIndex);
+			}
+		}
+
+		++MaterialIndex;
+	}
+}
+
+int32 FindRoot(TArray<int32>& Parents, int32 Index)
+{
+	while (Parents[Index] != Index)
+	{
+		Parents[Index] = Parents[Parents[Index]];
+		Index = Parents[Index];
+	}
+	return Index;
+}
+
+FBox3f GetPaddedBox(const FBox3f& Bounds)
+{
+	const FVector3f Size = Bounds.GetSize();
+	const FVector3f Padding(FMath::Max(0.0f, MinBoxThickness - Size.X), FMath::Max(0.0f, MinBoxThickness - Size.Y),
+							FMath::Max(0.0f, MinBoxThickness - Size.Z));
+	return FBox3f(Bounds.Min - Padding * 0.5f, Bounds.Max + Padding * 0.5f);
+}
+
+double GetPaddedVolume(const FBox3f& Bounds)
+{
+	const FVector3f Size = GetPaddedBox(Bounds).GetSize();
+	return static_cast<double>(Size.X) * Size.Y * Size.Z;
+}
+
+// Spreads the lowest 10 bits of Value to every third bit
+uint32 SpreadBits(uint32 Value)
+{
+	Value &= 0x000003ff;
+	Value = (Value | (Value << 16)) & 0xff0000ff;
+	Value = (Value | (Value << 8)) & 0x0300f00f;
+	Value = (Value | (Value << 4)) & 0x030c30c3;
+	Value = (Value | (Value << 2)) & 0x09249249;
+	return Value;
+}
+
+// Position of the given point on a Z-order curve through the given bounds, points close to each other are mostly close on the curve as well
+uint32 GetMortonCode(const FVector3f& Point, const FBox3f& Bounds)
+{
+	const FVector3f Normalized = (Point - Bounds.Min) / Bounds.GetSize().ComponentMax(FVector3f(UE_SMALL_NUMBER));
+	auto Quantize = [](float Value) { return static_cast<uint32>(FMath::Clamp(Value * 1023.0f, 0.0f, 1023.0f)); };
+	return SpreadBits(Quantize(Normalized.X)) | (SpreadBits(Quantize(Normalized.Y)) << 1) | (SpreadBits(Quantize(Normalized.Z)) << 2);
+}
+
+struct FMergeCandidate
+{
+	// Volume which is added by merging the bounds of both parts
+	double Cost;
+	int32 Left;
+	int32 Right;
+	uint32 LeftVersion;
+	uint32 RightVersion;
+
+	bool operator<(const FMergeCandidate& Other) const
+	{
+		return Cost < Other.Cost;
+	}
+};
+
+// Merges neighbouring parts until at most MaxParts are left. The parts are ordered along a Z-order curve and the neighbours whose merged bounds
+// add the least volume are merged first, so distant parts are only merged once no closer parts are left. This keeps the collision error
+// close to the smallest possible one instead of collapsing all small parts into a single box spanning the whole mesh.
+void MergeParts(TArray<FCollisionPart>& Parts, int32 MaxParts)
+{
+	FBox3f Bounds(ForceInit);
+	for (const FCollisionPart& Part : Parts)
+	{
+		Bounds += Part.Bounds;
+	}
+	Parts.Sort([&Bounds](const FCollisionPart& A, const FCollisionPart& B) {
+		return GetMortonCode(A.Bounds.GetCenter(), Bounds) < GetMortonCode(B.Bounds.GetCenter(), Bounds);
+	});
+
+	const int32 NumParts = Parts.Num();
+	TArray<int32> Previous;
+	TArray<int32> Next;
+	TArray<uint32> Versions;
+	Previous.SetNumUninitialized(NumParts);
+	Next.SetNumUninitialized(NumParts);
+	Versions.SetNumZeroed(NumParts);
+	for (int32 PartIndex = 0; PartIndex < NumParts; ++PartIndex)
+	{
+		Previous[PartIndex] = PartIndex - 1;
+		Next[PartIndex] = PartIndex + 1 < NumParts ? PartIndex + 1 : INDEX_NONE;
+	}
+
+	TArray<FMergeCandidate> Candidates;
+	auto AddCandidate = [&Parts, &Versions, &Candidates](int32 Left, int32 Right) {
+		if (Left != INDEX_NONE && Right != INDEX_NONE)
+		{
+			const double Cost = GetPaddedVolume(Parts[Left].Bounds + Parts[Right].Bounds) - GetPaddedVolume(Parts[Left].Bounds) -
+								GetPaddedVolume(Parts[Right].Bounds);
+			Candidates.HeapPush({Cost, Left, Right, Versions[Left], Versions[Right]});
+		}
+	};
+	for (int32 PartIndex = 0; PartIndex + 1 < NumParts; ++PartIndex)
+	{
+		AddCandidate(PartIndex, PartIndex + 1);
+	}
+
+	TBitArray<> IsMerged(false, NumParts);
+	int32 NumRemainingParts = NumParts;
+	while (NumRemainingParts > MaxParts && !Candidates.IsEmpty())
+	{
+		FMergeCandidate Candidate;
+		Candidates.HeapPop(Candidate, EAllowShrinking::No);
+
+		// Candidates are not removed when one of their parts changes, skip the outdated ones
+		if (IsMerged[Candidate.Left] || IsMerged[Candidate.Right] || Versions[Candidate.Left] != Candidate.LeftVersion ||
+			Versions[Candidate.Right] != Candidate.RightVersion)
+		{
+			continue;
+		}
+
+		FCollisionPart& Left = Parts[Candidate.Left];
+		FCollisionPart& Right = Parts[Candidate.Right];
+		Left.Points.Append(MoveTemp(Right.Points));
+		Left.Bounds += Right.Bounds;
+		IsMerged[Candidate.Right] = true;
+		++Versions[Candidate.Left];
+		--NumRemainingParts;
+
+		Next[Candidate.Left] = Next[Candidate.Right];
+		if (Next[Candidate.Left] != INDEX_NONE)
+		{
+			Previous[Next[Candidate.Left]] = Candidate.Left;
+		}
+		AddCandidate(Previous[Candidate.Left], Candidate.Left);
+		AddCandidate(Candidate.Left, Next[Candidate.Left]);
+	}
+
+	TArray<FCollisionPart> MergedParts;
+	MergedParts.Reserve(NumRemainingParts);
+	for (int32 PartIndex = 0; PartIndex < NumParts; ++PartIndex)
+	{
+		if (!IsMerged[PartIndex])
+		{
+			MergedParts.Add(MoveTemp(Parts[PartIndex]));
+		}
+	}
+	Parts = MoveTemp(MergedParts);
+}
+
+// Splits the mesh into parts of triangles which are connected by (welded) vertices. If there are more than MaxParts parts, neighbouring parts
+// are merged, see MergeParts.
+TArray<FCollisionPart> GetConnectedParts(const TArray<FVector3f>& Vertices, const TArray<FTriIndices>& Indices, int32 MaxParts)
+{
+	// Weld vertices at the same position, PRT does not necessarily share vertices between faces
+	TArray<int32> WeldedIndices;
+	WeldedIndices.SetNumUninitialized(Vertices.Num());
+	TMap<FVector3f, int32> UniqueVertices;
+	UniqueVertices.Reserve(Vertices.Num());
+	for (int32 VertexIndex = 0; VertexIndex < Vertices.Num(); ++VertexIndex)
+	{
+		WeldedIndices[VertexIndex] = UniqueVertices.FindOrAdd(Vertices[VertexIndex], VertexIndex);
+	}
+
+	TArray<int32> Parents;
+	Parents.SetNumUninitialized(Vertices.Num());
+	for (int32 VertexIndex = 0; VertexIndex < Vertices.Num(); ++VertexIndex)
+	{
+		Parents[VertexIndex] = VertexIndex;
+	}
+
+	TBitArray<> IsUsed(false, Vertices.Num());
+	for (const FTriIndices& Triangle : Indices)
+	{
+		const int32 Root0 = FindRoot(Parents, WeldedIndices[Triangle.v0]);
+		const int32 Root1 = FindRoot(Parents, WeldedIndices[Triangle.v1]);
+		const int32 Root2 = FindRoot(Parents, WeldedIndices[Triangle.v2]);
+		Parents[Root1] = Root0;
+		Parents[Root2] = Root0;
+
+		IsUsed[WeldedIndices[Triangle.v0]] = true;
+		IsUsed[WeldedIndices[Triangle.v1]] = true;
+		IsUsed[WeldedIndices[Triangle.v2]] = true;
+	}
+
+	TArray<FCollisionPart> Parts;
+	TMap<int32, int32> PartIndices;
+	for (TConstSetBitIterator<> It(IsUsed); It; ++It)
+	{
+		const int32 VertexIndex = It.GetIndex();
+		const int32 Root = FindRoot(Parents, VertexIndex);
+
+		int32* PartIndex = PartIndices.Find(Root);
+		FCollisionPart& Part = PartIndex ? Parts[*PartIndex] : Parts[PartIndices.Add(Root, Parts.AddDefaulted())];
+		Part.Points.Add(Vertices[VertexIndex]);
+		Part.Bounds += Vertices[VertexIndex];
+	}
+
+	if (Parts.Num() > MaxParts)
+	{
+		MergeParts(Parts, MaxParts);
+	}
+
+	return Parts;
+}
+
+TArray<FVector3f> GetConvexHullPoints(const FCollisionPart& Part)
+{
+	UE::Geometry::TConvexHull3<float> ConvexHull;
+	if (ConvexHull.Solve(TArrayView<const FVector3f>(Part.Points)))
+	{
+		TSet<int32> HullIndices;
+		for (const UE::Geometry::FIndex3i& Triangle : ConvexHull.GetTriangles())
+		{
+			HullIndices.Add(Triangle.A);
+			HullIndices.Add(Triangle.B);
+			HullIndices.Add(Triangle.C);
+		}
+
+		TArray<FVector3f> HullPoints;
+		HullPoints.Reserve(HullIndices.Num());
+		for (const int32 HullIndex : HullIndices)
+		{
+			HullPoints.Add(Part.Points[HullIndex]);
+		}
+		return HullPoints;
+	}
+
+	// Flat or degenerate parts do not have a (3D) convex hull, use the corners of their padded bounding box instead
+	const FBox3f Box = GetPaddedBox(Part.Bounds);
+	TArray<FVector3f> BoxPoints;
+	for (int32 Corner = 0; Corner < 8; ++Corner)
+	{
+		BoxPoints.Emplace(Corner & 1 ? Box.Max.X : Box.Min.X, Corner & 2 ? Box.Max.Y : Box.Min.Y, Corner & 4 ? Box.Max.Z : Box.Min.Z);
+	}
+	return BoxPoints;
+}
+
+// Simplifies the mesh by clustering all vertices in a regular grid and replacing them by the average of their cluster. The cell size is chosen
+// such that no vertex moves by more than MaxError.
+void ClusterVertices(const TArray<FVector3f>& Vertices, const TArray<FTriIndices>& Indices, const TArray<uint16>& MaterialIndices, float MaxError,
+					 TArray<FVector3f>& OutVertices, TArray<FTriIndices>& OutIndices, TArray<uint16>& OutMaterialIndices)
+{
+	OutVertices.Reset();
+	OutIndices.Reset();
+	OutMaterialIndices.Reset();
+	if (Vertices.IsEmpty())
+	{
+		return;
+	}
+
+	const float CellSize = MaxError / FMath::Sqrt(3.0f);
+	const FBox3f Bounds(Vertices);
+
+	TMap<FIntVector, int32> Clusters;
+	TArray<FVector3f> ClusterSums;
+	TArray<int32> ClusterCounts;
+	TArray<int32> VertexClusters;
+	VertexClusters.SetNumUninitialized(Vertices.Num());
+
+	for (int32 VertexIndex = 0; VertexIndex < Vertices.Num(); ++VertexIndex)
+	{
+		const FVector3f CellPosition = (Vertices[VertexIndex] - Bounds.Min) / CellSize;
+		const FIntVector Cell(FMath::FloorToInt32(CellPosition.X), FMath::FloorToInt32(CellPosition.Y), FMath::FloorToInt32(CellPosition.Z));
+
+		int32& ClusterIndex = Clusters.FindOrAdd(Cell, INDEX_NONE);
+		if (ClusterIndex == INDEX_NONE)
+		{
+			ClusterIndex = ClusterSums.Add(FVector3f::ZeroVector);
+			ClusterCounts.Add(0);
+		}
+		ClusterSums[ClusterIndex] += Vertices[VertexIndex];
+		ClusterCounts[ClusterIndex]++;
+		VertexClusters[VertexIndex] = ClusterIndex;
+	}
+
+	// Remove triangles which collapsed and triangles which are duplicates of others after clustering
+	TSet<FIntVector> UniqueTriangles;
+	TArray<int32> CompactClusterIndices;
+	CompactClusterIndices.Init(INDEX_NONE, ClusterSums.Num());
+
+	for (int32 TriangleIndex = 0; TriangleIndex < Indices.Num(); ++TriangleIndex)
+	{
+		const FTriIndices& Triangle = Indices[TriangleIndex];
+		int32 Corners[3] = {VertexClusters[Triangle.v0], VertexClusters[Triangle.v1], VertexClusters[Triangle.v2]};
+		if (Corners[0] == Corners[1] || Corners[1] == Corners[2] || Corners[0] == Corners[2])
+		{
+			continue;
+		}
+
+		int32 SortedCorners[3] = {Corners[0], Corners[1], Corners[2]};
+		Algo::Sort(SortedCorners);
+		bool bIsDuplicate;
+		UniqueTriangles.Add(FIntVector(SortedCorners[0], SortedCorners[1], SortedCorners[2]), &bIsDuplicate);
+		if (bIsDuplicate)
+		{
+			continue;
+		}
+
+		for (int32& Corner : Corners)
+		{
+			int32& CompactIndex = CompactClusterIndices[Corner];
+			if (CompactIndex == INDEX_NONE)
+			{
+				CompactIndex = OutVertices.Add(ClusterSums[Corner] / ClusterCounts[Corner]);
+			}
+			Corner = CompactIndex;
+		}
+
+		FTriIndices SimplifiedTriangle;
+		SimplifiedTriangle.v0 = Corners[0];
+		SimplifiedTriangle.v1 = Corners[1];
+		SimplifiedTriangle.v2 = Corners[2];
+		OutIndices.Add(SimplifiedTriangle);
+		OutMaterialIndices.Add(MaterialIndices[TriangleIndex]);
+	}
+}
+
+// Simplifies the mesh with the given maximum error. If the simplified mesh has more than MaxTriangles triangles (unless 0), the error is
+// doubled until it fits or until the mesh would collapse completely.
+void SimplifyMesh(TArray<FVector3f>& Vertices, TArray<FTriIndices>& Indices, TArray<uint16>& MaterialIndices, float MaxError, int32 MaxTriangles)
+{
+	float Error = FMath::Max(MaxError, UE_KINDA_SMALL_NUMBER);
+
+	TArray<FVector3f> SimplifiedVertices;
+	TArray<FTriIndices> SimplifiedIndices;
+	TArray<uint16> SimplifiedMaterialIndices;
+	ClusterVertices(Vertices, Indices, MaterialIndices, Error, SimplifiedVertices, SimplifiedIndices, SimplifiedMaterialIndices);
+
+	TArray<FVector3f> CoarserVertices;
+	TArray<FTriIndices> CoarserIndices;
+	TArray<uint16> CoarserMaterialIndices;
+	while (MaxTriangles > 0 && SimplifiedIndices.Num() > MaxTriangles)
+	{
+		Error *= 2.0f;
+		ClusterVertices(Vertices, Indices, MaterialIndices, Error, CoarserVertices, CoarserIndices, CoarserMaterialIndices);
+		if (CoarserIndices.IsEmpty())
+		{
+			break;
+		}
+
+		Swap(SimplifiedVertices, CoarserVertices);
+		Swap(SimplifiedIndices, CoarserIndices);
+		Swap(SimplifiedMaterialIndices, CoarserMaterialIndices);
+	}
+
+	Vertices = MoveTemp(SimplifiedVertices);
+	Indices = MoveTemp(SimplifiedIndices);
+	MaterialIndices = MoveTemp(SimplifiedMaterialIndices);
+}
+
+} // namespace
+
+namespace Vitruvio
+{
+
+FCollisionData CreateCollisionData(const FMeshDescription& MeshDescription, const FGeneratedCollisionSettings& Settings)
+{
+	SCOPE_CYCLE_COUNTER(STAT_Vitruvio_CreateCollision);
+
+	FCollisionData CollisionData;
+	CollisionData.CollisionType = Settings.CollisionType;
+
+	if (Settings.CollisionType == EGeneratedCollisionType::None)
+	{
+		return CollisionData;
+	}
+
+	TArray<FVector3f> Vertices;
+	TArray<FTriIndices> Indices;
+	TArray<uint16> MaterialIndices;
+	GetTriangleMesh(MeshDescription, Vertices, Indices, MaterialIndices);
+
+	if (Indices.IsEmpty())
+	{
+		return CollisionData;
+	}
+
+	switch (Settings.CollisionType)
+	{
+	case EGeneratedCollisionType::ComplexAsSimple:
+		CollisionData.Vertices = MoveTemp(Vertices);
+		CollisionData.Indices = MoveTemp(Indices);
+		CollisionData.MaterialIndices = MoveTemp(MaterialIndices);
+		break;
+	case EGeneratedCollisionType::SimplifiedMesh:
+		SimplifyMesh(Vertices, Indices, MaterialIndices, Settings.MaxSimplificationError, Settings.MaxSimplifiedTriangles);
+		CollisionData.Vertices = MoveTemp(Vertices);
+		CollisionData.Indices = MoveTemp(Indices);
+		CollisionData.MaterialIndices = MoveTemp(MaterialIndices);
+		break;
+	case EGeneratedCollisionType::BoundingBox:
+		CollisionData.Boxes.Add(GetPaddedBox(FBox3f(Vertices)));
+		break;
+	case EGeneratedCollisionType::PartBoxes:
+		for (const FCollisionPart& Part : GetConnectedParts(Vertices, Indices, FMath::Max(1, Settings.MaxElements)))
+		{
+			CollisionData.Boxes.Add(GetPaddedBox(Part.Bounds));
+		}
+		break;
+	case EGeneratedCollisionType::ConvexHulls:
+		for (const FCollisionPart& Part : GetConnectedParts(Vertices, Indices, FMath::Max(1, Settings.MaxElements)))
+		{
+			CollisionData.ConvexHulls.Add(GetConvexHullPoints(Part));
+		}
+		break;
+	default:
+		break;
+	}
+
+	return CollisionData;
+}
+
+} // namespace Vitruvio
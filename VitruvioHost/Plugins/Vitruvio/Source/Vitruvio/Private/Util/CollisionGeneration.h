@@ -0,0 +1,34 @@
+/* Copyright 2024 Esri
+ *
+ * Licensed under the Apache License Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "GeneratedCollision.h"
+#include "VitruvioMesh.h"
+
+namespace Vitruvio
+{
+
+/**
+ * Creates the collision data for the given mesh description according to the collision settings.
+ *
+ * Does not touch any UObjects and is therefore safe to be called from worker threads.
+ *
+ * @param MeshDescription	The mesh description of the generated mesh
+ * @param Settings			The collision settings which define which kind of collision is created
+ */
+FCollisionData CreateCollisionData(const FMeshDescription& MeshDescription, const FGeneratedCollisionSettings& Settings);
+
+} // namespace Vitruvio
@@ -21,6 +21,7 @@
 #include "HAL/PlatformFileManager.h"
 #include "Runtime/ImageCore/Public/ImageCore.h"
 #include "VitruvioModule.h"
+#include "VitruvioStats.h"
 #include "VitruvioTypes.h"
 #include "Async/Async.h"
 #include "UObject/Package.h"
@@ -170,6 +171,12 @@ UMaterialInterface* GetMaterialByBlendMode(EBlendMode Mode, UMaterialInterface*
 	}
 }
 
+SIZE_T GetTextureMemorySize(const Vitruvio::FTextureData& TextureData)
+{
+	const UTexture2D* Texture = TextureData.Texture;
+	return Texture ? CalculateImageBytes(Texture->GetSizeX(), Texture->GetSizeY(), 0, Texture->GetPixelFormat()) : 0;
+}
+
 class FLoadTextureTask
 {
 	TPromise<Vitruvio::FTextureData> Promise;
@@ -209,13 +216,21 @@ public:
 
 	void DoTask(ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
 	{
-		QUICK_SCOPE_CYCLE_COUNTER(STAT_MaterialConversion_LoadTexture);
+		SCOPE_CYCLE_COUNTER(STAT_Vitruvio_LoadTexture);
 		FTaskTagScope Scope(ETaskTag::EParallelRenderingThread);
 		Vitruvio::FTextureData TextureData = VitruvioModule::Get().DecodeTexture(Outer, ImagePath, TextureKey);
 		{
 			FScopeLock CacheLock(&CacheCriticalSection);
 
+			// The same texture might have been loaded by another property in the meantime since looking it up and dispatching this task is not
+			// atomic, the replaced entry must not be counted twice
+			if (const Vitruvio::FTextureData* Replaced = Cache.Find(ImagePath))
+			{
+				DEC_MEMORY_STAT_BY(STAT_Vitruvio_TextureCacheMemory, GetTextureMemorySize(*Replaced));
+			}
+
 			Cache.Add(ImagePath, TextureData);
+			INC_MEMORY_STAT_BY(STAT_Vitruvio_TextureCacheMemory, GetTextureMemorySize(TextureData));
 		}
 
 		Promise.SetValue(TextureData);
@@ -233,6 +248,8 @@ UMaterialInstanceDynamic* GameThread_CreateMaterialInstance(UObject* Outer, cons
 {
 	check(IsInGameThread());
 
+	SCOPE_CYCLE_COUNTER(STAT_Vitruvio_CreateMaterial);
+
 	TMap<FString, FGraphEventRef> TexturePropertyTasks;
 	TMap<FString, TFuture<FTextureData>> TextureProperties;
 
@@ -256,6 +273,7 @@ UMaterialInstanceDynamic* GameThread_CreateMaterialInstance(UObject* Outer, cons
 				{
 					// If the timestamp on the filesystem is newer than our cached version we have to evict it from the cache and reload the texture
 					// because it has changed
+					DEC_MEMORY_STAT_BY(STAT_Vitruvio_TextureCacheMemory, GetTextureMemorySize(*Cached));
 					TextureCache.Remove(*TextureCache.FindKey(*Cached));
 				}
 				else
@@ -0,0 +1,520 @@
+/* Copyright 2024 Esri
+ *
+ * Licensed under the Apache License Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "PolygonValidation.h"
+
+namespace
+{
+using namespace Vitruvio;
+
+// Minimum squared length of the cross product of two edges for a triangle to not be considered degenerate
+constexpr double DegenerateAreaThreshold = 0.0001;
+
+// Relative error bound of the 2D orientation determinant evaluated in double precision (see Shewchuk, "Adaptive Precision Floating-Point
+// Arithmetic and Fast Robust Geometric Predicates")
+constexpr double OrientationErrorBound = 3.3306690738754716e-16;
+
+int32 FindInvalidIndex(const TArray<int32>& Indices, int32 NumVertices)
+{
+	for (const int32 Index : Indices)
+	{
+		if (Index < 0 || Index >= NumVertices)
+		{
+			return Index;
+		}
+	}
+	return INDEX_NONE;
+}
+
+// Returns the vertex which is farthest away from the first vertex of the given ring
+FVector GetFarthestVertex(const TArray<int32>& Indices, const TArray<FVector>& Vertices)
+{
+	const FVector& First = Vertices[Indices[0]];
+
+	FVector Farthest = First;
+	double MaxDistanceSquared = 0.0;
+	for (const int32 Index : Indices)
+	{
+		const double DistanceSquared = FVector::DistSquared(First, Vertices[Index]);
+		if (DistanceSquared > MaxDistanceSquared)
+		{
+			MaxDistanceSquared = DistanceSquared;
+			Farthest = Vertices[Index];
+		}
+	}
+	return Farthest;
+}
+
+// A ring has a non degenerate area if there is a vertex which is not collinear to the first and the farthest vertex
+bool HasNonDegenerateArea(const TArray<int32>& Indices, const TArray<FVector>& Vertices)
+{
+	if (Indices.Num() < 3)
+	{
+		return false;
+	}
+
+	const FVector& First = Vertices[Indices[0]];
+	const FVector Axis = GetFarthestVertex(Indices, Vertices) - First;
+	for (const int32 Index : Indices)
+	{
+		if (FVector::CrossProduct(Vertices[Index] - First, Axis).SizeSquared() >= DegenerateAreaThreshold)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+FVector GetRingNormal(const TArray<int32>& Indices, const TArray<FVector>& Vertices)
+{
+	// Newell's method works for concave and slightly non planar rings
+	FVector Normal = FVector::ZeroVector;
+	for (int32 Index = 0; Index < Indices.Num(); ++Index)
+	{
+		const FVector& Current = Vertices[Indices[Index]];
+		const FVector& Next = Vertices[Indices[(Index + 1) % Indices.Num()]];
+		Normal.X += (Current.Y - Next.Y) * (Current.Z + Next.Z);
+		Normal.Y += (Current.Z - Next.Z) * (Current.X + Next.X);
+		Normal.Z += (Current.X - Next.X) * (Current.Y + Next.Y);
+	}
+
+	if (Normal.SizeSquared() >= DegenerateAreaThreshold)
+	{
+		return Normal;
+	}
+
+	// Self overlapping rings can have a vanishing Newell normal, fall back to the largest spanned triangle
+	const FVector& First = Vertices[Indices[0]];
+	const FVector Axis = GetFarthestVertex(Indices, Vertices) - First;
+	for (const int32 Index : Indices)
+	{
+		const FVector Cross = FVector::CrossProduct(Vertices[Index] - First, Axis);
+		if (Cross.SizeSquared() > Normal.SizeSquared())
+		{
+			Normal = Cross;
+		}
+	}
+	return Normal;
+}
+
+// Projects points onto the coordinate plane which is closest to the plane given by the normal
+struct FPlaneProjection
+{
+	int32 AxisX = 0;
+	int32 AxisY = 1;
+
+	explicit FPlaneProjection(const FVector& Normal)
+	{
+		const FVector AbsNormal = Normal.GetAbs();
+		if (AbsNormal.X >= AbsNormal.Y && AbsNormal.X >= AbsNormal.Z)
+		{
+			AxisX = 1;
+			AxisY = 2;
+		}
+		else if (AbsNormal.Y >= AbsNormal.Z)
+		{
+			AxisX = 2;
+			AxisY = 0;
+		}
+	}
+
+	FVector2D Project(const FVector& Vertex) const
+	{
+		return FVector2D(Vertex[AxisX], Vertex[AxisY]);
+	}
+};
+
+// Returns 1 if C lies to the left of the line through A and B, -1 if it lies to the right and 0 if the points are collinear or if the sign
+// can not be determined reliably in double precision
+int32 Orient2D(const FVector2D& A, const FVector2D& B, const FVector2D& C)
+{
+	const double DetLeft = (A.X - C.X) * (B.Y - C.Y);
+	const double DetRight = (A.Y - C.Y) * (B.X - C.X);
+	const double Det = DetLeft - DetRight;
+	const double ErrorBound = OrientationErrorBound * (FMath::Abs(DetLeft) + FMath::Abs(DetRight));
+	if (Det > ErrorBound)
+	{
+		return 1;
+	}
+	if (Det < -ErrorBound)
+	{
+		return -1;
+	}
+	return 0;
+}
+
+bool IsOnSegment(const FVector2D& Start, const FVector2D& End, const FVector2D& Point)
+{
+	return Point.X >= FMath::Min(Start.X, End.X) && Point.X <= FMath::Max(Start.X, End.X) && Point.Y >= FMath::Min(Start.Y, End.Y) &&
+		   Point.Y <= FMath::Max(Start.Y, End.Y);
+}
+
+// Returns true if the segments cross or touch each other
+bool SegmentsIntersect(const FVector2D& A, const FVector2D& B, const FVector2D& C, const FVector2D& D)
+{
+	const int32 OrientationC = Orient2D(A, B, C);
+	const int32 OrientationD = Orient2D(A, B, D);
+	const int32 OrientationA = Orient2D(C, D, A);
+	const int32 OrientationB = Orient2D(C, D, B);
+
+	if (OrientationC * OrientationD < 0 && OrientationA * OrientationB < 0)
+	{
+		return true;
+	}
+
+	return (OrientationC == 0 && IsOnSegment(A, B, C)) || (OrientationD == 0 && IsOnSegment(A, B, D)) ||
+		   (OrientationA == 0 && IsOnSegment(C, D, A)) || (OrientationB == 0 && IsOnSegment(C, D, B));
+}
+
+bool PointInRing2D(const FVector2D& Point, const TArray<FVector2D>& Ring)
+{
+	bool bIsInside = false;
+	for (int32 Index = 0; Index < Ring.Num(); ++Index)
+	{
+		const FVector2D& Current = Ring[Index];
+		const FVector2D& Next = Ring[(Index + 1) % Ring.Num()];
+		if (Current.Y < Point.Y && Next.Y >= Point.Y || Next.Y < Point.Y && Current.Y >= Point.Y)
+		{
+			if (Current.X + (Point.Y - Current.Y) / (Next.Y - Current.Y) * (Next.X - Current.X) < Point.X)
+			{
+				bIsInside = !bIsInside;
+			}
+		}
+	}
+	return bIsInside;
+}
+
+// A face boundary (ring 0) or one of its holes (ring 1..n) projected to 2D with consecutive duplicate vertices removed
+struct FRing
+{
+	TArray<FVector2D> Points;
+	TArray<int32> VertexIndices;
+	FBox2D Bounds = FBox2D(ForceInit);
+};
+
+struct FRingSegment
+{
+	int32 RingIndex;
+	int32 SegmentIndex;
+	FBox2D Bounds;
+};
+
+class FFaceValidator
+{
+	const FInitialShapePolygon& Polygon;
+	const int32 FaceIndex;
+	const bool bStopAtFirstIssue;
+	FPolygonValidationResult& Result;
+
+	TArray<FRing> Rings;
+
+	// Returns false if validation should stop
+	bool AddIssue(EPolygonIssueType Type, int32 RingIndex, int32 VertexIndex = INDEX_NONE)
+	{
+		Result.Issues.Add({Type, FaceIndex, RingIndex - 1, VertexIndex});
+		return !bStopAtFirstIssue;
+	}
+
+	const TArray<int32>& GetRingIndices(int32 RingIndex) const
+	{
+		const FInitialShapeFace& Face = Polygon.Faces[FaceIndex];
+		return RingIndex == 0 ? Face.Indices : Face.Holes[RingIndex - 1].Indices;
+	}
+
+	bool AreAdjacent(const FRingSegment& A, const FRingSegment& B) const
+	{
+		if (A.RingIndex != B.RingIndex)
+		{
+			return false;
+		}
+		const int32 NumSegments = Rings[A.RingIndex].Points.Num();
+		const int32 Distance = FMath::Abs(A.SegmentIndex - B.SegmentIndex);
+		return Distance <= 1 || Distance == NumSegments - 1;
+	}
+
+	bool CheckRings(const FPlaneProjection& Projection, TBitArray<>& ValidRings)
+	{
+		const int32 NumRings = Polygon.Faces[FaceIndex].Holes.Num() + 1;
+		Rings.SetNum(NumRings);
+		ValidRings.Init(false, NumRings);
+
+		for (int32 RingIndex = 0; RingIndex < NumRings; ++RingIndex)
+		{
+			const TArray<int32>& Indices = GetRingIndices(RingIndex);
+
+			const int32 InvalidIndex = FindInvalidIndex(Indices, Polygon.Vertices.Num());
+			if (InvalidIndex != INDEX_NONE)
+			{
+				if (!AddIssue(EPolygonIssueType::InvalidIndex, RingIndex, InvalidIndex))
+				{
+					return false;
+				}
+				continue;
+			}
+
+			if (Indices.Num() < 3)
+			{
+				if (!AddIssue(EPolygonIssueType::TooFewVertices, RingIndex))
+				{
+					return false;
+				}
+				continue;
+			}
+
+			if (!HasNonDegenerateArea(Indices, Polygon.Vertices))
+			{
+				if (!AddIssue(EPolygonIssueType::DegenerateArea, RingIndex))
+				{
+					return false;
+				}
+				continue;
+			}
+
+			if (RingIndex == 0)
+			{
+				Result.bHasValidGeometry = true;
+			}
+
+			FRing& Ring = Rings[RingIndex];
+			TSet<int32> UsedIndices;
+			UsedIndices.Reserve(Indices.Num());
+			for (int32 Index = 0; Index < Indices.Num(); ++Index)
+			{
+				const int32 VertexIndex = Indices[Index];
+				const int32 NextVertexIndex = Indices[(Index + 1) % Indices.Num()];
+
+				bool bAlreadyUsed = false;
+				UsedIndices.Add(VertexIndex, &bAlreadyUsed);
+				if (bAlreadyUsed || Polygon.Vertices[VertexIndex].Equals(Polygon.Vertices[NextVertexIndex], KINDA_SMALL_NUMBER))
+				{
+					if (!AddIssue(EPolygonIssueType::DuplicateVertex, RingIndex, VertexIndex))
+					{
+						return false;
+					}
+					continue;
+				}
+
+				const FVector2D Point = Projection.Project(Polygon.Vertices[VertexIndex]);
+				Ring.Points.Add(Point);
+				Ring.VertexIndices.Add(VertexIndex);
+				Ring.Bounds += Point;
+			}
+
+			ValidRings[RingIndex] = Ring.Points.Num() >= 3;
+		}
+
+		return true;
+	}
+
+	bool CheckIntersections(TBitArray<>& ValidRings)
+	{
+		TArray<FRingSegment> Segments;
+		for (int32 RingIndex = 0; RingIndex < Rings.Num(); ++RingIndex)
+		{
+			if (!ValidRings[RingIndex])
+			{
+				continue;
+			}
+
+			const TArray<FVector2D>& Points = Rings[RingIndex].Points;
+			for (int32 SegmentIndex = 0; SegmentIndex < Points.Num(); ++SegmentIndex)
+			{
+				const FVector2D& Start = Points[SegmentIndex];
+				const FVector2D& End = Points[(SegmentIndex + 1) % Points.Num()];
+				Segments.Add({RingIndex, SegmentIndex, FBox2D(Start.ComponentMin(End), Start.ComponentMax(End))});
+			}
+		}
+
+		Segments.Sort([](const FRingSegment& A, const FRingSegment& B) { return A.Bounds.Min.X < B.Bounds.Min.X; });
+
+		// Sweep along the x axis and only test segments with overlapping bounds. Only the first intersection of every ring is reported.
+		TBitArray<> IntersectingRings(false, Rings.Num());
+		TArray<const FRingSegment*> Active;
+		for (const FRingSegment& Current : Segments)
+		{
+			Active.RemoveAllSwap([&Current](const FRingSegment* Other) { return Other->Bounds.Max.X < Current.Bounds.Min.X; }, EAllowShrinking::No);
+
+			for (const FRingSegment* Other : Active)
+			{
+				if (Other->Bounds.Max.Y < Current.Bounds.Min.Y || Other->Bounds.Min.Y > Current.Bounds.Max.Y || AreAdjacent(Current, *Other))
+				{
+					continue;
+				}
+
+				const TArray<FVector2D>& CurrentPoints = Rings[Current.RingIndex].Points;
+				const TArray<FVector2D>& OtherPoints = Rings[Other->RingIndex].Points;
+				if (!SegmentsIntersect(CurrentPoints[Current.SegmentIndex], CurrentPoints[(Current.SegmentIndex + 1) % CurrentPoints.Num()],
+									   OtherPoints[Other->SegmentIndex], OtherPoints[(Other->SegmentIndex + 1) % OtherPoints.Num()]))
+				{
+					continue;
+				}
+
+				// Intersections between the face boundary and a hole are reported for the hole
+				const FRingSegment& Reported = Current.RingIndex >= Other->RingIndex ? Current : *Other;
+				if (!IntersectingRings[Reported.RingIndex])
+				{
+					IntersectingRings[Reported.RingIndex] = true;
+					const int32 VertexIndex = Rings[Reported.RingIndex].VertexIndices[Reported.SegmentIndex];
+					if (!AddIssue(EPolygonIssueType::SelfIntersection, Reported.RingIndex, VertexIndex))
+					{
+						return false;
+					}
+				}
+			}
+
+			Active.Add(&Current);
+		}
+
+		// Nesting can not be determined reliably for intersecting holes
+		for (int32 RingIndex = 1; RingIndex < Rings.Num(); ++RingIndex)
+		{
+			if (IntersectingRings[RingIndex])
+			{
+				ValidRings[RingIndex] = false;
+			}
+		}
+
+		return true;
+	}
+
+	bool CheckHoleNesting(const TBitArray<>& ValidRings)
+	{
+		if (!ValidRings[0])
+		{
+			return true;
+		}
+
+		const FRing& FaceRing = Rings[0];
+		for (int32 HoleRingIndex = 1; HoleRingIndex < Rings.Num(); ++HoleRingIndex)
+		{
+			if (!ValidRings[HoleRingIndex])
+			{
+				continue;
+			}
+
+			// Without any intersections a single point is enough to decide whether a hole is inside of another ring
+			const FRing& HoleRing = Rings[HoleRingIndex];
+			const FVector2D& Point = HoleRing.Points[0];
+			bool bIsNested = FaceRing.Bounds.IsInside(HoleRing.Bounds) && PointInRing2D(Point, FaceRing.Points);
+
+			for (int32 OtherRingIndex = 1; bIsNested && OtherRingIndex < Rings.Num(); ++OtherRingIndex)
+			{
+				const FRing& OtherRing = Rings[OtherRingIndex];
+				if (OtherRingIndex != HoleRingIndex && ValidRings[OtherRingIndex] && OtherRing.Bounds.IsInside(Point) &&
+					PointInRing2D(Point, OtherRing.Points))
+				{
+					bIsNested = false;
+				}
+			}
+
+			if (!bIsNested && !AddIssue(EPolygonIssueType::InvalidHoleNesting, HoleRingIndex, HoleRing.VertexIndices[0]))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+public:
+	FFaceValidator(const FInitialShapePolygon& Polygon, int32 FaceIndex, bool bStopAtFirstIssue, FPolygonValidationResult& Result)
+		: Polygon(Polygon), FaceIndex(FaceIndex), bStopAtFirstIssue(bStopAtFirstIssue), Result(Result)
+	{
+	}
+
+	// Returns false if validation should stop
+	bool Validate()
+	{
+		const TArray<int32>& FaceIndices = Polygon.Faces[FaceIndex].Indices;
+		const bool bHasValidFaceIndices = FaceIndices.Num() >= 3 && FindInvalidIndex(FaceIndices, Polygon.Vertices.Num()) == INDEX_NONE;
+		const FPlaneProjection Projection(bHasValidFaceIndices ? GetRingNormal(FaceIndices, Polygon.Vertices) : FVector::UpVector);
+
+		TBitArray<> ValidRings;
+		return CheckRings(Projection, ValidRings) && CheckIntersections(ValidRings) && CheckHoleNesting(ValidRings);
+	}
+};
+
+} // namespace
+
+namespace Vitruvio
+{
+
+FString FPolygonIssue::ToString() const
+{
+	FString Description;
+	switch (Type)
+	{
+	case EPolygonIssueType::InvalidIndex:
+		Description = TEXT("Invalid vertex index");
+		break;
+	case EPolygonIssueType::TooFewVertices:
+		Description = TEXT("Less than 3 vertices");
+		break;
+	case EPolygonIssueType::DegenerateArea:
+		Description = TEXT("Degenerate area");
+		break;
+	case EPolygonIssueType::DuplicateVertex:
+		Description = TEXT("Duplicate vertex");
+		break;
+	case EPolygonIssueType::SelfIntersection:
+		Description = TEXT("Self intersection");
+		break;
+	case EPolygonIssueType::InvalidHoleNesting:
+		Description = TEXT("Hole is not inside of its face");
+		break;
+	}
+
+	FString Location = FString::Printf(TEXT("face %d"), FaceIndex);
+	if (HoleIndex != INDEX_NONE)
+	{
+		Location += FString::Printf(TEXT(", hole %d"), HoleIndex);
+	}
+	if (VertexIndex != INDEX_NONE)
+	{
+		Location += FString::Printf(TEXT(", vertex %d"), VertexIndex);
+	}
+
+	return FString::Printf(TEXT("%s (%s)"), *Description, *Location);
+}
+
+bool HasValidGeometry(const FInitialShapePolygon& Polygon)
+{
+	for (const FInitialShapeFace& Face : Polygon.Faces)
+	{
+		if (FindInvalidIndex(Face.Indices, Polygon.Vertices.Num()) == INDEX_NONE && HasNonDegenerateArea(Face.Indices, Polygon.Vertices))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+FPolygonValidationResult ValidatePolygon(const FInitialShapePolygon& Polygon, bool bStopAtFirstIssue)
+{
+	FPolygonValidationResult Result;
+	for (int32 FaceIndex = 0; FaceIndex < Polygon.Faces.Num(); ++FaceIndex)
+	{
+		FFaceValidator Validator(Polygon, FaceIndex, bStopAtFirstIssue, Result);
+		if (!Validator.Validate())
+		{
+			// Stopped early, make sure the validity does not depend on the order of the issues
+			Result.bHasValidGeometry = HasValidGeometry(Polygon);
+			break;
+		}
+	}
+	return Result;
+}
+
+} // namespace Vitruvio
@@ -0,0 +1,74 @@
+/* Copyright 2024 Esri
+ *
+ * Licensed under the Apache License Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "InitialShape.h"
+
+namespace Vitruvio
+{
+
+enum class EPolygonIssueType : uint8
+{
+	InvalidIndex,
+	TooFewVertices,
+	DegenerateArea,
+	DuplicateVertex,
+	SelfIntersection,
+	InvalidHoleNesting
+};
+
+struct FPolygonIssue
+{
+	EPolygonIssueType Type;
+
+	int32 FaceIndex = INDEX_NONE;
+
+	// Index of the hole inside of the face or INDEX_NONE if the issue concerns the face boundary
+	int32 HoleIndex = INDEX_NONE;
+
+	// Index into the polygon vertices of the offending vertex or INDEX_NONE if the issue does not concern a single vertex
+	int32 VertexIndex = INDEX_NONE;
+
+	FString ToString() const;
+};
+
+struct FPolygonValidationResult
+{
+	// True if at least one face has a non degenerate area and can therefore be generated
+	bool bHasValidGeometry = false;
+
+	TArray<FPolygonIssue> Issues;
+};
+
+/**
+ * Checks whether at least one face of the given polygon has a non degenerate area. Returns as soon as a valid face has been found.
+ *
+ * @param Polygon	The polygon to check
+ */
+bool HasValidGeometry(const FInitialShapePolygon& Polygon);
+
+/**
+ * Validates all faces and holes of the given polygon. Checks for invalid indices, degenerate areas, duplicate vertices, self intersections
+ * (including intersections between a face and its holes) and holes which are not nested inside of their face.
+ *
+ * Faces are projected onto the plane best fitting their boundary, so this works for non planar polygons as long as they are not folded.
+ *
+ * @param Polygon			The polygon to validate
+ * @param bStopAtFirstIssue	Whether to return as soon as the first issue has been found
+ */
+FPolygonValidationResult ValidatePolygon(const FInitialShapePolygon& Polygon, bool bStopAtFirstIssue = false);
+
+} // namespace Vitruvio
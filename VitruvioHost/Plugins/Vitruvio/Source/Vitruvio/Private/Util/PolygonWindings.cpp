@@ -52,72 +52,154 @@ uint32 GetTypeHash(const FWindingEdge& Edge)
 	return HashCombine(Hash, Edge.Index1);
 }
 
-void ColorEdges(FWindingEdge& Edge, TSortedMap<int32, TArray<FWindingEdge>>& EdgeMap, TSet<FWindingEdge>& Visited, int Color)
+void ColorEdges(FWindingEdge& StartEdge, TMap<int32, TArray<FWindingEdge>>& EdgeMap, TSet<FWindingEdge>& Visited, int Color)
 {
-	if (Visited.Contains(Edge))
-	{
-		return;
-	}
+	// Use an explicit work stack instead of recursion since large footprints can have tens of thousands of connected edges
+	TArray<FWindingEdge*> Stack;
+	Stack.Push(&StartEdge);
 
-	Edge.Color = Color;
-	Visited.Add(Edge);
-	for (FWindingEdge& Connected : EdgeMap[Edge.Index0])
+	while (Stack.Num() > 0)
 	{
-		ColorEdges(Connected, EdgeMap, Visited, Color);
+		FWindingEdge* Edge = Stack.Pop(EAllowShrinking::No);
+
+		bool bAlreadyVisited = false;
+		Visited.Add(*Edge, &bAlreadyVisited);
+		if (bAlreadyVisited)
+		{
+			continue;
+		}
+
+		Edge->Color = Color;
+		for (const int32 VertexIndex : {Edge->Index0, Edge->Index1})
+		{
+			if (TArray<FWindingEdge>* ConnectedEdges = EdgeMap.Find(VertexIndex))
+			{
+				for (FWindingEdge& Connected : *ConnectedEdges)
+				{
+					if (!Visited.Contains(Connected))
+					{
+						Stack.Push(&Connected);
+					}
+				}
+			}
+		}
 	}
-	for (FWindingEdge& Connected : EdgeMap[Edge.Index1])
+}
+
+FBox2D GetBounds2D(const TArray<int32>& Indices, const TArray<FVector>& Vertices)
+{
+	FBox2D Bounds(ForceInit);
+	for (const int32 Index : Indices)
 	{
-		ColorEdges(Connected, EdgeMap, Visited, Color);
+		Bounds += FVector2D(Vertices[Index].X, Vertices[Index].Y);
 	}
+	return Bounds;
+}
+
+bool IsBoundsInside2D(const FBox2D& Inner, const FBox2D& Outer)
+{
+	return Inner.Min.X >= Outer.Min.X - KINDA_SMALL_NUMBER && Inner.Min.Y >= Outer.Min.Y - KINDA_SMALL_NUMBER &&
+		   Inner.Max.X <= Outer.Max.X + KINDA_SMALL_NUMBER && Inner.Max.Y <= Outer.Max.Y + KINDA_SMALL_NUMBER;
 }
 
-bool PointInPolygon2D(const FVector& Point, const TArray<int32>& PolygonIndices, const TArray<FVector>& PolygonVertices)
+TBitArray<> PointsInPolygon2D(const TArray<FVector>& Points, const TArray<int32>& PolygonIndices, const TArray<FVector>& PolygonVertices)
 {
+	TBitArray<> IsInside(false, Points.Num());
 	if (PolygonIndices.Num() < 3)
 	{
-		return false;
+		return IsInside;
 	}
 
-	bool bIsInside = false;
+	// Test all points in a single pass over the polygon edges
 	for (int Index = 0; Index < PolygonIndices.Num(); Index++)
 	{
 		const FVector& Current = PolygonVertices[PolygonIndices[Index]];
 		const FVector& Next = PolygonVertices[PolygonIndices[Index + 1 >= PolygonIndices.Num() ? 0 : Index + 1]];
-		if (Current.Y < Point.Y && Next.Y >= Point.Y || Next.Y < Point.Y && Current.Y >= Point.Y)
+		const double EdgeMinY = FMath::Min(Current.Y, Next.Y);
+		const double EdgeMaxY = FMath::Max(Current.Y, Next.Y);
+
+		for (int32 PointIndex = 0; PointIndex < Points.Num(); ++PointIndex)
 		{
-			if (Current.X + (Point.Y - Current.Y) / (Next.Y - Current.Y) * (Next.X - Current.X) < Point.X)
+			const FVector& Point = Points[PointIndex];
+			if (Point.Y < EdgeMinY || Point.Y > EdgeMaxY)
+			{
+				continue;
+			}
+
+			if (Current.Y < Point.Y && Next.Y >= Point.Y || Next.Y < Point.Y && Current.Y >= Point.Y)
 			{
-				bIsInside = !bIsInside;
+				if (Current.X + (Point.Y - Current.Y) / (Next.Y - Current.Y) * (Next.X - Current.X) < Point.X)
+				{
+					IsInside[PointIndex] = !IsInside[PointIndex];
+				}
 			}
 		}
 	}
 
-	return bIsInside;
+	return IsInside;
 }
 
-bool IsInsideOf2D(const TArray<int32>& FaceA, const TArray<int32>& FaceB, const TArray<FVector>& Vertices)
+struct FSegment2D
 {
-	if (FaceB.Num() == 1)
+	FVector Start;
+	FVector End;
+	FBox2D Bounds;
+};
+
+TArray<FSegment2D> GetSegments2D(const TArray<int32>& Face, const TArray<FVector>& Vertices, const FBox2D& Region)
+{
+	// Only consecutive indices form a segment (the closing segment is not tested) and segments outside of the region can not intersect
+	TArray<FSegment2D> Segments;
+	for (int Index = 0; Index < Face.Num() - 1; Index++)
 	{
-		return false;
+		const FVector& Start = Vertices[Face[Index]];
+		const FVector& End = Vertices[Face[Index + 1]];
+		FBox2D Bounds(FVector2D(FMath::Min(Start.X, End.X), FMath::Min(Start.Y, End.Y)), FVector2D(FMath::Max(Start.X, End.X), FMath::Max(Start.Y, End.Y)));
+		if (Bounds.Intersect(Region))
+		{
+			Segments.Add({Start, End, Bounds});
+		}
 	}
 
-	for (int IndexA = 0; IndexA < FaceA.Num() - 1; IndexA++)
+	Segments.Sort([](const FSegment2D& A, const FSegment2D& B) { return A.Bounds.Min.X < B.Bounds.Min.X; });
+	return Segments;
+}
+
+bool AnySegmentsIntersect2D(const TArray<FSegment2D>& SegmentsA, const TArray<FSegment2D>& SegmentsB)
+{
+	// Sweep along the x axis (both arrays are sorted by their minimum x) and only test segments with overlapping bounds
+	TArray<const FSegment2D*> ActiveA;
+	TArray<const FSegment2D*> ActiveB;
+	int32 IndexA = 0;
+	int32 IndexB = 0;
+	while (IndexA < SegmentsA.Num() || IndexB < SegmentsB.Num())
 	{
-		for (int IndexB = 0; IndexB < FaceB.Num() - 1; IndexB++)
+		const bool bTakeA = IndexB >= SegmentsB.Num() || (IndexA < SegmentsA.Num() && SegmentsA[IndexA].Bounds.Min.X <= SegmentsB[IndexB].Bounds.Min.X);
+		const FSegment2D& Current = bTakeA ? SegmentsA[IndexA++] : SegmentsB[IndexB++];
+
+		TArray<const FSegment2D*>& Others = bTakeA ? ActiveB : ActiveA;
+		Others.RemoveAllSwap([&Current](const FSegment2D* Other) { return Other->Bounds.Max.X < Current.Bounds.Min.X; }, EAllowShrinking::No);
+
+		for (const FSegment2D* Other : Others)
 		{
+			if (Other->Bounds.Max.Y < Current.Bounds.Min.Y || Other->Bounds.Min.Y > Current.Bounds.Max.Y)
+			{
+				continue;
+			}
+
+			const FSegment2D& SegmentA = bTakeA ? Current : *Other;
+			const FSegment2D& SegmentB = bTakeA ? *Other : Current;
 			FVector Intersection;
-			const bool Intersected =
-				FMath::SegmentIntersection2D(FVector(Vertices[FaceA[IndexA]]), FVector(Vertices[FaceA[IndexA + 1]]), FVector(Vertices[FaceB[IndexB]]),
-											 FVector(Vertices[FaceB[IndexB + 1]]), Intersection);
-			if (Intersected)
+			if (FMath::SegmentIntersection2D(SegmentA.Start, SegmentA.End, SegmentB.Start, SegmentB.End, Intersection))
 			{
-				return false;
+				return true;
 			}
 		}
+
+		(bTakeA ? ActiveA : ActiveB).Add(&Current);
 	}
 
-	return PointInPolygon2D(Vertices[FaceA[0]], FaceB, Vertices);
+	return false;
 }
 
 } // namespace
@@ -151,17 +233,22 @@ FInitialShapePolygon GetPolygon(const TArray<FVector>& InVertices, const TArray<
 	}
 
 	// Color connected edges
-	TSortedMap<int32, TArray<FWindingEdge>> EdgeMap;
+	TMap<int32, TArray<FWindingEdge>> EdgeMap;
 	for (const FWindingEdge& Edge : Edges)
 	{
 		EdgeMap.FindOrAdd(Edge.Index0).Add(Edge);
 	}
 
+	TArray<int32> SortedEdgeKeys;
+	EdgeMap.GenerateKeyArray(SortedEdgeKeys);
+	SortedEdgeKeys.Sort();
+
 	TSet<FWindingEdge> Visited;
+	Visited.Reserve(Edges.Num());
 	int CurrentColor = 0;
-	for (auto& KeyValue : EdgeMap)
+	for (const int32 Key : SortedEdgeKeys)
 	{
-		for (FWindingEdge& Edge : KeyValue.Value)
+		for (FWindingEdge& Edge : EdgeMap[Key])
 		{
 			if (!Visited.Contains(Edge))
 			{
@@ -171,15 +258,20 @@ FInitialShapePolygon GetPolygon(const TArray<FVector>& InVertices, const TArray<
 	}
 
 	// Remove opposite edges to only keep the outside of either a face or a hole
-	TSortedMap<int32, FWindingEdge> WindingEdgeMap;
-	for (auto& KeyValue : EdgeMap)
+	TMap<int32, FWindingEdge> WindingEdgeMap;
+	TArray<int32> WindingStartIndices;
+	for (const int32 Key : SortedEdgeKeys)
 	{
-		for (const FWindingEdge& Current : KeyValue.Value)
+		for (const FWindingEdge& Current : EdgeMap[Key])
 		{
 			const FWindingEdge Opposite(Current.Index1, Current.Index0, Current.Color);
 			if (!Edges.Contains(Opposite))
 			{
 				// Note that at this point there should not be multiple edges connected to a single vertex
+				if (!WindingEdgeMap.Contains(Current.Index0))
+				{
+					WindingStartIndices.Add(Current.Index0);
+				}
 				WindingEdgeMap.Add(Current.Index0, Current);
 			}
 		}
@@ -187,14 +279,17 @@ FInitialShapePolygon GetPolygon(const TArray<FVector>& InVertices, const TArray<
 
 	// Organize the remaining edges in the list so that the vertices will meet up to form a continuous outline of either a face or a hole
 	TArray<FWinding> Windings;
+	int32 NextStartIndex = 0;
 	while (WindingEdgeMap.Num() > 0)
 	{
 		TArray<int32> WindingIndices;
 
-		// Get and remove first edge
-		auto EdgeIter = WindingEdgeMap.CreateIterator();
-		const FWindingEdge FirstEdge = EdgeIter.Value();
-		EdgeIter.RemoveCurrent();
+		// Get and remove the remaining edge with the lowest start vertex
+		while (!WindingEdgeMap.Contains(WindingStartIndices[NextStartIndex]))
+		{
+			NextStartIndex++;
+		}
+		const FWindingEdge FirstEdge = WindingEdgeMap.FindAndRemoveChecked(WindingStartIndices[NextStartIndex]);
 
 		WindingIndices.Add(FirstEdge.Index0);
 		int NextIndex = FirstEdge.Index1;
@@ -210,29 +305,77 @@ FInitialShapePolygon GetPolygon(const TArray<FVector>& InVertices, const TArray<
 		Windings.Add({WindingIndices, FirstEdge.Color});
 	}
 
-	// Find the relation between the faces
-	TMap<int32, int32> InsideOf;
-	for (int32 IndexA = 0; IndexA < Windings.Num(); IndexA++)
+	// Find the relation between the faces. There is no possible relation if they are not connected and a winding can only be inside of
+	// another if its bounds are contained in the bounds of the other one.
+	TArray<FBox2D> WindingBounds;
+	TMap<int32, TArray<int32>> WindingsByColor;
+	for (int32 WindingIndex = 0; WindingIndex < Windings.Num(); WindingIndex++)
 	{
-		for (int32 IndexB = IndexA + 1; IndexB < Windings.Num(); IndexB++)
+		WindingBounds.Add(GetBounds2D(Windings[WindingIndex].Indices, InVertices));
+		WindingsByColor.FindOrAdd(Windings[WindingIndex].Color).Add(WindingIndex);
+	}
+
+	TSet<TPair<int32, int32>> IsInside;
+	for (const auto& ColorWindings : WindingsByColor)
+	{
+		for (const int32 OuterIndex : ColorWindings.Value)
 		{
-			// No possible relation if they are not connected
-			if (Windings[IndexA].Color != Windings[IndexB].Color)
+			const TArray<int32>& Outer = Windings[OuterIndex].Indices;
+			if (Outer.Num() == 1)
 			{
 				continue;
 			}
 
-			if (IsInsideOf2D(Windings[IndexA].Indices, Windings[IndexB].Indices, InVertices))
+			TArray<int32> Candidates;
+			TArray<FVector> CandidatePoints;
+			for (const int32 InnerIndex : ColorWindings.Value)
 			{
-				InsideOf.Add(IndexA, IndexB);
+				if (InnerIndex != OuterIndex && IsBoundsInside2D(WindingBounds[InnerIndex], WindingBounds[OuterIndex]))
+				{
+					Candidates.Add(InnerIndex);
+					CandidatePoints.Add(InVertices[Windings[InnerIndex].Indices[0]]);
+				}
 			}
-			else if (IsInsideOf2D(Windings[IndexB].Indices, Windings[IndexA].Indices, InVertices))
+
+			if (Candidates.IsEmpty())
 			{
-				InsideOf.Add(IndexB, IndexA);
+				continue;
+			}
+
+			const TBitArray<> CandidatesInside = PointsInPolygon2D(CandidatePoints, Outer, InVertices);
+			for (int32 CandidateIndex = 0; CandidateIndex < Candidates.Num(); ++CandidateIndex)
+			{
+				if (!CandidatesInside[CandidateIndex])
+				{
+					continue;
+				}
+
+				const int32 InnerIndex = Candidates[CandidateIndex];
+				const TArray<FSegment2D> InnerSegments = GetSegments2D(Windings[InnerIndex].Indices, InVertices, WindingBounds[OuterIndex]);
+				const TArray<FSegment2D> OuterSegments = GetSegments2D(Outer, InVertices, WindingBounds[InnerIndex]);
+				if (!AnySegmentsIntersect2D(InnerSegments, OuterSegments))
+				{
+					IsInside.Add({InnerIndex, OuterIndex});
+				}
 			}
 		}
 	}
 
+	// A winding which is inside of multiple others belongs to the enclosing winding with the highest index
+	TMap<int32, int32> InsideOf;
+	for (const TPair<int32, int32>& Relation : IsInside)
+	{
+		const int32 InnerIndex = Relation.Key;
+		const int32 OuterIndex = Relation.Value;
+		if (OuterIndex < InnerIndex && IsInside.Contains({OuterIndex, InnerIndex}))
+		{
+			continue;
+		}
+
+		int32& InsideOfIndex = InsideOf.FindOrAdd(InnerIndex, OuterIndex);
+		InsideOfIndex = FMath::Max(InsideOfIndex, OuterIndex);
+	}
+
 	TSet<int32> HoleSet;
 	TMap<int32, FInitialShapeFace> FaceMap;
 	for (int32 FaceIndex = 0; FaceIndex < Windings.Num(); ++FaceIndex)
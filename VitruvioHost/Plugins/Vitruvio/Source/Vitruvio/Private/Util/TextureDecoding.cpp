@@ -14,6 +14,7 @@
  */
 
 #include "TextureDecoding.h"
+#include "VitruvioStats.h"
 #include "Engine/TextureDefines.h"
 #include "HAL/PlatformFileManager.h"
 #include "Engine/Texture2D.h"
@@ -123,6 +124,8 @@ EPixelFormat GetUnrealPixelFormat(EPRTPixelFormat PRTPixelFormat)
 FTextureData DecodeTexture(UObject* Outer, const FString& Key, const FString& Path, const FTextureMetadata& TextureMetadata,
 						   std::unique_ptr<uint8_t[]> Buffer, size_t BufferSize)
 {
+	SCOPE_CYCLE_COUNTER(STAT_Vitruvio_DecodeTexture);
+
 	EPixelFormat UnrealPixelFormat = GetUnrealPixelFormat(TextureMetadata.PixelFormat);
 	check(UnrealPixelFormat != EPixelFormat::PF_Unknown);
 
@@ -0,0 +1,102 @@
+/* Copyright 2024 Esri
+ *
+ * Licensed under the Apache License Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+namespace Vitruvio
+{
+
+// Spatial hash grid used to find vertices which are equal within a tolerance. The cell size is equal to the tolerance, so all
+// candidates for a match are located in the same or one of the directly neighbouring cells.
+class FVertexHashGrid
+{
+	struct FCell
+	{
+		int64 X;
+		int64 Y;
+		int64 Z;
+
+		friend bool operator==(const FCell& A, const FCell& B)
+		{
+			return A.X == B.X && A.Y == B.Y && A.Z == B.Z;
+		}
+
+		friend uint32 GetTypeHash(const FCell& Cell)
+		{
+			return HashCombine(HashCombine(GetTypeHash(Cell.X), GetTypeHash(Cell.Y)), GetTypeHash(Cell.Z));
+		}
+	};
+
+	double Tolerance;
+	TMap<FCell, TArray<int32, TInlineAllocator<1>>> Cells;
+
+	FCell GetCell(const FVector& Vertex) const
+	{
+		return {FMath::FloorToInt64(Vertex.X / Tolerance), FMath::FloorToInt64(Vertex.Y / Tolerance), FMath::FloorToInt64(Vertex.Z / Tolerance)};
+	}
+
+public:
+	explicit FVertexHashGrid(int32 NumVertices, double Tolerance = KINDA_SMALL_NUMBER) : Tolerance(Tolerance)
+	{
+		Cells.Reserve(NumVertices);
+	}
+
+	// Returns the lowest index of all vertices which are equal to the given vertex or INDEX_NONE
+	int32 Find(const FVector& Vertex, const TArray<FVector>& Vertices) const
+	{
+		const FCell Cell = GetCell(Vertex);
+
+		int32 FoundIndex = INDEX_NONE;
+		for (int64 X = Cell.X - 1; X <= Cell.X + 1; ++X)
+		{
+			for (int64 Y = Cell.Y - 1; Y <= Cell.Y + 1; ++Y)
+			{
+				for (int64 Z = Cell.Z - 1; Z <= Cell.Z + 1; ++Z)
+				{
+					const TArray<int32, TInlineAllocator<1>>* Candidates = Cells.Find({X, Y, Z});
+					if (!Candidates)
+					{
+						continue;
+					}
+
+					// Candidates are sorted by index, so the first match is the lowest one in this cell
+					for (const int32 Candidate : *Candidates)
+					{
+						if (FoundIndex != INDEX_NONE && Candidate > FoundIndex)
+						{
+							break;
+						}
+						if (Vertex.Equals(Vertices[Candidate], Tolerance))
+						{
+							FoundIndex = Candidate;
+							break;
+						}
+					}
+				}
+			}
+		}
+
+		return FoundIndex;
+	}
+
+	void Add(const FVector& Vertex, int32 Index)
+	{
+		Cells.FindOrAdd(GetCell(Vertex)).Add(Index);
+	}
+};
+
+} // namespace Vitruvio
@@ -15,10 +15,58 @@
 
 #include "VitruvioBatchActor.h"
 
+#include "Algo/Count.h"
+#include "Algo/StableSort.h"
 #include "AttributeConversion.h"
+#include "Async/Async.h"
+#include "Engine/World.h"
 #include "Materials/Material.h"
 #include "Runtime/CoreUObject/Public/UObject/ConstructorHelpers.h"
 #include "GenerateCompletedCallbackProxy.h"
+#include "VitruvioStats.h"
+
+namespace
+{
+
+uint64 GetTileInputHash(const UTile* Tile, const FGeneratedCollisionSettings& CollisionSettings)
+{
+	TArray<uint64> ComponentHashes;
+	for (const UVitruvioComponent* VitruvioComponent : Tile->VitruvioComponents)
+	{
+		if (VitruvioComponent->GetRpk())
+		{
+			FXxHash64Builder ComponentBuilder;
+			const uint64 GenerateInputHash = VitruvioComponent->GetGenerateInputHash();
+			const FVector Location = VitruvioComponent->GetOwner()->GetTransform().GetLocation();
+			ComponentBuilder.Update(&GenerateInputHash, sizeof(GenerateInputHash));
+			ComponentBuilder.Update(&Location, sizeof(Location));
+			ComponentHashes.Add(ComponentBuilder.Finalize().Hash);
+		}
+	}
+
+	// The order of the components of a tile is not stable between sessions
+	ComponentHashes.Sort();
+
+	FXxHash64Builder Builder;
+	Vitruvio::AppendStringHash(Builder, CollisionSettings.ToCacheKey());
+	Builder.Update(ComponentHashes.GetData(), ComponentHashes.Num() * sizeof(uint64));
+	return Builder.Finalize().Hash;
+}
+
+TArray<URulePackage*> GetRulePackages(const UTile* Tile)
+{
+	TArray<URulePackage*> RulePackages;
+	for (const UVitruvioComponent* VitruvioComponent : Tile->VitruvioComponents)
+	{
+		if (URulePackage* RulePackage = VitruvioComponent->GetRpk())
+		{
+			RulePackages.AddUnique(RulePackage);
+		}
+	}
+	return RulePackages;
+}
+
+} // namespace
 
 void UTile::MarkForGenerate(UVitruvioComponent* VitruvioComponent, UGenerateCompletedCallbackProxy* CallbackProxy)
 {
@@ -42,6 +90,7 @@ void UTile::Add(UVitruvioComponent* VitruvioComponent)
 void UTile::Remove(UVitruvioComponent* VitruvioComponent)
 {
 	VitruvioComponents.Remove(VitruvioComponent);
+	ShapeReportStatistics.Remove(VitruvioComponent);
 }
 
 bool UTile::Contains(UVitruvioComponent* VitruvioComponent) const
@@ -66,7 +115,7 @@ TTuple<TArray<FInitialShape>, TArray<UVitruvioComponent*>> UTile::GetInitialShap
 		FInitialShape InitialShape;
 		InitialShape.Offset = VitruvioComponent->GetOwner()->GetTransform().GetLocation();
 		InitialShape.Polygon = VitruvioComponent->InitialShape->GetPolygon();
-		InitialShape.Attributes = Vitruvio::CreateAttributeMap(VitruvioComponent->GetAttributes());
+		InitialShape.Attributes = VitruvioComponent->GetAttributeMap();
 		InitialShape.RandomSeed = VitruvioComponent->GetRandomSeed();
 		InitialShape.RulePackage = VitruvioComponent->GetRpk();
 
@@ -213,14 +262,331 @@ FIntPoint AVitruvioBatchActor::GetPosition(const UVitruvioComponent* VitruvioCom
 	return FIntPoint {PositionX, PositionY};
 }
 
+UGeneratedModelStaticMeshComponent* AVitruvioBatchActor::GetOrCreateModelComponent(UTile* Tile)
+{
+	if (Tile->GeneratedModelComponent)
+	{
+		return Tile->GeneratedModelComponent;
+	}
+
+	const FString TileName = FString::FromInt(NumModelComponents++);
+	UGeneratedModelStaticMeshComponent* VitruvioModelComponent = NewObject<UGeneratedModelStaticMeshComponent>(RootComponent,
+		FName(TEXT("GeneratedModel") + TileName), RF_Transient | RF_TextExportTransient | RF_DuplicateTransient);
+	VitruvioModelComponent->CreationMethod = EComponentCreationMethod::Instance;
+	RootComponent->GetOwner()->AddOwnedComponent(VitruvioModelComponent);
+	VitruvioModelComponent->AttachToComponent(RootComponent, FAttachmentTransformRules::KeepRelativeTransform);
+	VitruvioModelComponent->OnComponentCreated();
+	VitruvioModelComponent->RegisterComponent();
+
+	Tile->GeneratedModelComponent = VitruvioModelComponent;
+	return VitruvioModelComponent;
+}
+
+double AVitruvioBatchActor::GetDistanceToTile(const UTile* Tile, const FVector& Location) const
+{
+	const FVector2D Min(static_cast<double>(Tile->Location.X) * GridDimension.X, static_cast<double>(Tile->Location.Y) * GridDimension.Y);
+	const FBox2D TileBounds(Min, Min + FVector2D(GridDimension.X, GridDimension.Y));
+	return FMath::Sqrt(TileBounds.ComputeSquaredDistanceToPoint(FVector2D(Location)));
+}
+
+void AVitruvioBatchActor::UpdateTileStreaming()
+{
+	if (!bEnableTileStreaming)
+	{
+		for (const auto& [Point, Tile] : Grid.Tiles)
+		{
+			if (Tile->bStreamedOut)
+			{
+				StreamInTile(Tile);
+			}
+		}
+		return;
+	}
+
+	const TArray<FVector>& StreamingSources = StreamingSourcesOverride ? *StreamingSourcesOverride : GetWorld()->ViewLocationsRenderedLastFrame;
+
+	// Without any viewer (eg. before the first frame has been rendered) we can not decide which tiles are needed
+	if (StreamingSources.IsEmpty())
+	{
+		return;
+	}
+
+	const double UnloadRadius = StreamingLoadRadius + StreamingHysteresis;
+	for (const auto& [Point, Tile] : Grid.Tiles)
+	{
+		double MinDistance = TNumericLimits<double>::Max();
+		for (const FVector& StreamingSource : StreamingSources)
+		{
+			MinDistance = FMath::Min(MinDistance, GetDistanceToTile(Tile, StreamingSource));
+		}
+
+		if (Tile->bStreamedOut && MinDistance <= StreamingLoadRadius)
+		{
+			StreamInTile(Tile);
+		}
+		else if (!Tile->bStreamedOut && MinDistance > UnloadRadius)
+		{
+			StreamOutTile(Tile);
+		}
+	}
+}
+
+void AVitruvioBatchActor::StreamOutTile(UTile* Tile)
+{
+	// A pending generate of the tile is kept, its result is cached once it arrives, see ProcessGenerateQueue
+	if (Tile->GeneratedModelComponent)
+	{
+		TArray<USceneComponent*> InstanceSceneComponents;
+		Tile->GeneratedModelComponent->GetChildrenComponents(true, InstanceSceneComponents);
+		for (USceneComponent* InstanceComponent : InstanceSceneComponents)
+		{
+			InstanceComponent->DestroyComponent(true);
+		}
+
+		Tile->GeneratedModelComponent->DestroyComponent(true);
+		Tile->GeneratedModelComponent = nullptr;
+	}
+
+	if (Tile->GeneratedResult && !Tile->bMarkedForGenerate)
+	{
+		CacheTileResult(Tile->Location, MoveTemp(Tile->GeneratedResult));
+	}
+	Tile->GeneratedResult.Reset();
+
+	Tile->bStreamedOut = true;
+}
+
+void AVitruvioBatchActor::StreamInTile(UTile* Tile)
+{
+	Tile->bStreamedOut = false;
+
+	// The model of a tile which is still generating is built once its result arrives
+	if (Tile->bIsGenerating)
+	{
+		return;
+	}
+
+	TSharedPtr<FPersistedGenerateResult> CachedResult;
+	if (CachedTileResults.RemoveAndCopyValue(Tile->Location, CachedResult))
+	{
+		CachedTileResultOrder.Remove(Tile->Location);
+	}
+
+	// Tiles which have been changed while being streamed out are still marked and will be generated again by ProcessTiles
+	if (CachedResult && !Tile->bMarkedForGenerate)
+	{
+		// Kept by the tile, so that it can be cached again once the tile is streamed out
+		Tile->GeneratedResult = CachedResult;
+		GetOrCreateModelComponent(Tile);
+		RestoreTile(Tile, *CachedResult, GetRulePackages(Tile));
+	}
+	else
+	{
+		Tile->MarkForGenerate(nullptr);
+	}
+}
+
+void AVitruvioBatchActor::CacheTileResult(const FIntPoint& Location, TSharedPtr<FPersistedGenerateResult> Result)
+{
+	CachedTileResultOrder.Remove(Location);
+	CachedTileResultOrder.Add(Location);
+	CachedTileResults.Add(Location, MoveTemp(Result));
+
+	while (CachedTileResultOrder.Num() > MaxCachedTileResults)
+	{
+		CachedTileResults.Remove(CachedTileResultOrder[0]);
+		CachedTileResultOrder.RemoveAt(0, 1, EAllowShrinking::No);
+	}
+}
+
+void AVitruvioBatchActor::ClearTileResultCache()
+{
+	CachedTileResults.Empty();
+	CachedTileResultOrder.Empty();
+}
+
+void AVitruvioBatchActor::RestoreTile(UTile* Tile, const FPersistedGenerateResult& PersistedResult, const TArray<URulePackage*>& RulePackages)
+{
+	const FBatchGenerateResult::FTokenPtr Token = MakeShared<FGenerateToken>();
+	Tile->GenerateToken = Token;
+	Tile->bIsGenerating = true;
+
+	// clang-format off
+	Vitruvio::RestoreGenerateResultAsync(PersistedResult, RulePackages, CollisionSettings).Next([this, Tile, Token](const TOptional<FGenerateResultDescription>& Result)
+	{
+		FScopeLock Lock(&Token->Lock);
+
+		if (Token->IsInvalid())
+		{
+			return;
+		}
+
+		Tile->GenerateToken.Reset();
+
+		if (Result.IsSet())
+		{
+			FScopeLock GenerateQueueLock(&ProcessQueueCriticalSection);
+			GenerateQueue.Enqueue({Result.GetValue(), Tile, {}});
+			INC_DWORD_STAT(STAT_Vitruvio_GenerateQueueDepth);
+			return;
+		}
+
+		// The persisted result could not be read, generate the tile instead
+		AsyncTask(ENamedThreads::GameThread, [WeakThis = TWeakObjectPtr<AVitruvioBatchActor>(this), WeakTile = TWeakObjectPtr<UTile>(Tile)]()
+		{
+			if (WeakThis.IsValid() && WeakTile.IsValid())
+			{
+				WeakThis->PersistedTileResults.Remove(WeakTile->Location);
+				WeakTile->bIsGenerating = false;
+				WeakTile->MarkForGenerate(nullptr);
+			}
+		});
+	});
+	// clang-format on
+}
+
+void AVitruvioBatchActor::SetStreamingSources(const TArray<FVector>& Locations)
+{
+	StreamingSourcesOverride = Locations;
+}
+
+void AVitruvioBatchActor::ClearStreamingSources()
+{
+	StreamingSourcesOverride.Reset();
+}
+
+int32 AVitruvioBatchActor::GetNumResidentTiles() const
+{
+	int32 NumResidentTiles = 0;
+	for (const auto& [Point, Tile] : Grid.Tiles)
+	{
+		if (!Tile->bStreamedOut)
+		{
+			++NumResidentTiles;
+		}
+	}
+	return NumResidentTiles;
+}
+
+int32 AVitruvioBatchActor::GetNumTiles() const
+{
+	return Grid.Tiles.Num();
+}
+
+TArray<FIntPoint> AVitruvioBatchActor::GetTilesWithoutModel() const
+{
+	TArray<FIntPoint> TilesWithoutModel;
+	for (const auto& [Point, Tile] : Grid.Tiles)
+	{
+		if (Tile->bStreamedOut || Tile->bIsGenerating || Tile->bMarkedForGenerate)
+		{
+			continue;
+		}
+
+		// A model may consist of instances only
+		const UGeneratedModelStaticMeshComponent* ModelComponent = Tile->GeneratedModelComponent;
+		if (!ModelComponent || (!ModelComponent->GetStaticMesh() && ModelComponent->GetNumChildrenComponents() == 0))
+		{
+			TilesWithoutModel.Add(Point);
+		}
+	}
+	return TilesWithoutModel;
+}
+
+TArray<FIntPoint> AVitruvioBatchActor::GetFailedTiles() const
+{
+	TArray<FIntPoint> FailedTiles;
+	for (const auto& [Point, Tile] : Grid.Tiles)
+	{
+		if (Tile->bGenerateFailed)
+		{
+			FailedTiles.Add(Point);
+		}
+	}
+	return FailedTiles;
+}
+
+TMap<FString, FReportStatistics> AVitruvioBatchActor::GetTileReportStatistics(const FIntPoint& Location) const
+{
+	const UTile* const* Tile = Grid.Tiles.Find(Location);
+	return Tile ? (*Tile)->ReportStatistics : TMap<FString, FReportStatistics>();
+}
+
+TMap<FString, FReportStatistics> AVitruvioBatchActor::GetComponentReportStatistics(const UVitruvioComponent* VitruvioComponent) const
+{
+	const UTile* const* Tile = Grid.TilesByComponent.Find(VitruvioComponent);
+	const TMap<FString, FReportStatistics>* ReportStatistics = Tile ? (*Tile)->ShapeReportStatistics.Find(VitruvioComponent) : nullptr;
+	return ReportStatistics ? *ReportStatistics : TMap<FString, FReportStatistics>();
+}
+
+TMap<FString, FReportStatistics> AVitruvioBatchActor::GetReportStatistics() const
+{
+	TMap<FString, FReportStatistics> ReportStatistics;
+	for (const auto& [Point, Tile] : Grid.Tiles)
+	{
+		Vitruvio::MergeReportStatistics(ReportStatistics, Tile->ReportStatistics);
+	}
+	return ReportStatistics;
+}
+
 void AVitruvioBatchActor::ProcessTiles()
 {
-	for (UTile* Tile : Grid.GetTilesMarkedForGenerate())
+	TArray<UTile*> MarkedTiles = Grid.GetTilesMarkedForGenerate();
+	if (MarkedTiles.IsEmpty())
+	{
+		return;
+	}
+
+	// After opening a level all tiles are marked at once, the tiles closest to the viewers are generated first
+	const TArray<FVector>& ViewLocations = StreamingSourcesOverride ? *StreamingSourcesOverride : GetWorld()->ViewLocationsRenderedLastFrame;
+	if (!ViewLocations.IsEmpty())
 	{
-		// Initialize and cleanup the model component
-		UGeneratedModelStaticMeshComponent* VitruvioModelComponent = Tile->GeneratedModelComponent;
-		if (VitruvioModelComponent)
+		TMap<const UTile*, double> TileDistances;
+		for (const UTile* Tile : MarkedTiles)
 		{
+			double MinDistance = TNumericLimits<double>::Max();
+			for (const FVector& ViewLocation : ViewLocations)
+			{
+				MinDistance = FMath::Min(MinDistance, GetDistanceToTile(Tile, ViewLocation));
+			}
+			TileDistances.Add(Tile, MinDistance);
+		}
+		Algo::StableSort(MarkedTiles, [&TileDistances](const UTile* A, const UTile* B) { return TileDistances[A] < TileDistances[B]; });
+	}
+
+	int32 NumGeneratingTiles = 0;
+	for (const auto& [Point, Tile] : Grid.Tiles)
+	{
+		NumGeneratingTiles += Tile->bIsGenerating ? 1 : 0;
+	}
+	const int32 MaxGeneratingTiles = FMath::Max(1, VitruvioModule::Get().GetNumWorkerThreads());
+
+	for (UTile* Tile : MarkedTiles)
+	{
+		// Streamed out tiles stay marked and are generated once they are streamed in again, unless all tiles have been requested
+		if (Tile->bStreamedOut && !GenerateAllCallbackProxy)
+		{
+			continue;
+		}
+
+		// The remaining tiles stay marked until a generating tile has completed
+		if (!Tile->bIsGenerating && NumGeneratingTiles >= MaxGeneratingTiles)
+		{
+			break;
+		}
+		NumGeneratingTiles += Tile->bIsGenerating ? 0 : 1;
+
+		Tile->UnmarkForGenerate();
+		Tile->GeneratedResult.Reset();
+		if (CachedTileResults.Remove(Tile->Location) > 0)
+		{
+			CachedTileResultOrder.Remove(Tile->Location);
+		}
+
+		// Initialize and cleanup the model component, streamed out tiles only cache their result
+		if (!Tile->bStreamedOut)
+		{
+			UGeneratedModelStaticMeshComponent* VitruvioModelComponent = GetOrCreateModelComponent(Tile);
 			VitruvioModelComponent->SetStaticMesh(nullptr);
 
 			// Cleanup old hierarchical instances
@@ -231,19 +597,6 @@ void AVitruvioBatchActor::ProcessTiles()
 				InstanceComponent->DestroyComponent(true);
 			}
 		}
-		else
-		{
-			const FString TileName = FString::FromInt(NumModelComponents++);
-			VitruvioModelComponent = NewObject<UGeneratedModelStaticMeshComponent>(RootComponent, FName(TEXT("GeneratedModel") + TileName),
-																			   RF_Transient | RF_TextExportTransient | RF_DuplicateTransient);
-			VitruvioModelComponent->CreationMethod = EComponentCreationMethod::Instance;
-			RootComponent->GetOwner()->AddOwnedComponent(VitruvioModelComponent);
-			VitruvioModelComponent->AttachToComponent(RootComponent, FAttachmentTransformRules::KeepRelativeTransform);
-			VitruvioModelComponent->OnComponentCreated();
-			VitruvioModelComponent->RegisterComponent();
-
-			Tile->GeneratedModelComponent = VitruvioModelComponent;
-		}
 
 		// Generate model
 		auto [InitialShapes, InitialShapeVitruvioComponents] = Tile->GetInitialShapes();
@@ -253,15 +606,33 @@ void AVitruvioBatchActor::ProcessTiles()
 			{
 				Tile->GenerateToken->Invalidate();
 			}
+
+			if (bPersistGeneratedModels)
+			{
+				const FPersistedGenerateResult* PersistedResult = PersistedTileResults.Find(Tile->Location);
+				if (PersistedResult && PersistedResult->InputHash == GetTileInputHash(Tile, CollisionSettings))
+				{
+					RestoreTile(Tile, *PersistedResult, GetRulePackages(Tile));
+					continue;
+				}
+			}
 			
-			FBatchGenerateResult GenerateResult = VitruvioModule::Get().BatchGenerateAsync(MoveTemp(InitialShapes));
+			FBatchGenerateResult GenerateResult = VitruvioModule::Get().BatchGenerateAsync(MoveTemp(InitialShapes), CollisionSettings);
 			
 			Tile->GenerateToken = GenerateResult.Token;
 			Tile->bIsGenerating = true;
 		
+			const bool bSerializeResult = bPersistGeneratedModels || bEnableTileStreaming;
 			// clang-format off
-			GenerateResult.Result.Next([this, Tile, InitialShapeVitruvioComponents](const FBatchGenerateResult::ResultType& Result)
+			GenerateResult.Result.Next([this, Tile, InitialShapeVitruvioComponents, bSerializeResult](const FBatchGenerateResult::ResultType& Result)
 			{
+				// Serialize outside of the lock, which is also taken by the game thread to invalidate the result
+				TOptional<FPersistedGenerateResult> PersistedResult;
+				if (bSerializeResult && !Result.Token->IsInvalid())
+				{
+					PersistedResult = Vitruvio::PersistGenerateResult(Result.Value, 0);
+				}
+
 				FScopeLock Lock(&Result.Token->Lock);
 
 				if (Result.Token->IsInvalid())
@@ -272,13 +643,16 @@ void AVitruvioBatchActor::ProcessTiles()
 				Tile->GenerateToken.Reset();
 
 				FScopeLock GenerateQueueLock(&ProcessQueueCriticalSection);
-				GenerateQueue.Enqueue({Result.Value, Tile, InitialShapeVitruvioComponents});
+				GenerateQueue.Enqueue({Result.Value, Tile, InitialShapeVitruvioComponents, MoveTemp(PersistedResult)});
+				INC_DWORD_STAT(STAT_Vitruvio_GenerateQueueDepth);
 			});
 			// clang-format on
 		}
+		else
+		{
+			PersistedTileResults.Remove(Tile->Location);
+		}
 	}
-
-	Grid.UnmarkForGenerate();
 }
 
 void AVitruvioBatchActor::ProcessGenerateQueue()
@@ -289,17 +663,98 @@ void AVitruvioBatchActor::ProcessGenerateQueue()
 	{
 		FBatchGenerateQueueItem Item;
 		GenerateQueue.Dequeue(Item);
+		DEC_DWORD_STAT(STAT_Vitruvio_GenerateQueueDepth);
 
 		ProcessQueueCriticalSection.Unlock();
 
+		SCOPE_CYCLE_COUNTER(STAT_Vitruvio_ProcessGenerateQueue);
+
+		// A failed generate returns an empty result which can neither be matched to the components nor be persisted. Shapes whose Rule
+		// Package could not be loaded have no evaluated attributes, the tile only fails if none of its shapes has been generated.
+		const TArray<FAttributeMapPtr>& EvaluatedAttributes = Item.GenerateResultDescription.EvaluatedAttributes;
+		const int32 NumFailedShapes = Algo::CountIf(EvaluatedAttributes, [](const FAttributeMapPtr& AttributeMap) { return !AttributeMap; });
+		Item.Tile->bGenerateFailed = EvaluatedAttributes.Num() != Item.VitruvioComponents.Num() || NumFailedShapes == EvaluatedAttributes.Num();
+		if (Item.Tile->bGenerateFailed)
+		{
+			UE_LOG(LogUnrealPrt, Error, TEXT("Generate of tile (%d, %d) with %d initial shapes failed"), Item.Tile->Location.X,
+				   Item.Tile->Location.Y, Item.VitruvioComponents.Num())
+
+			Item.Tile->ReportStatistics.Reset();
+			Item.Tile->ShapeReportStatistics.Reset();
+			Item.Tile->GeneratedResult.Reset();
+			PersistedTileResults.Remove(Item.Tile->Location);
+
+			NotifyTileGenerated(Item.Tile);
+			NotifyIfAllGenerated();
+			return;
+		}
+
+		// A partial result is not kept, the failed shapes would otherwise be missing until the tile changes
+		if (NumFailedShapes > 0)
+		{
+			UE_LOG(LogUnrealPrt, Warning, TEXT("Generate of %d of %d initial shapes of tile (%d, %d) failed"), NumFailedShapes,
+				   Item.VitruvioComponents.Num(), Item.Tile->Location.X, Item.Tile->Location.Y)
+
+			Item.Tile->GeneratedResult.Reset();
+			PersistedTileResults.Remove(Item.Tile->Location);
+		}
+
 		for (int ComponentIndex = 0; ComponentIndex < Item.VitruvioComponents.Num(); ++ComponentIndex)
 		{
+			// Failed shapes keep their previous attributes
+			if (!EvaluatedAttributes[ComponentIndex])
+			{
+				continue;
+			}
+
 			UVitruvioComponent* VitruvioComponent = Item.VitruvioComponents[ComponentIndex];
-			Item.GenerateResultDescription.EvaluatedAttributes[ComponentIndex]->UpdateUnrealAttributeMap(VitruvioComponent->Attributes, VitruvioComponent);
+			EvaluatedAttributes[ComponentIndex]->UpdateUnrealAttributeMap(VitruvioComponent->Attributes, VitruvioComponent);
 			VitruvioComponent->NotifyAttributesChanged();
 		}
 
-		UGeneratedModelStaticMeshComponent* VitruvioModelComponent = Item.Tile->GeneratedModelComponent;
+		// A result is outdated if the tile has been changed in the meantime, it is then replaced by the pending result
+		if (Item.PersistedResult.IsSet() && NumFailedShapes == 0 && !Item.Tile->bMarkedForGenerate && !Item.Tile->GenerateToken)
+		{
+			// Hashed after the evaluated attributes have been applied since these are stored with the level as well
+			Item.PersistedResult->InputHash = GetTileInputHash(Item.Tile, CollisionSettings);
+			if (bPersistGeneratedModels)
+			{
+				PersistedTileResults.Add(Item.Tile->Location, MoveTemp(Item.PersistedResult.GetValue()));
+			}
+			else if (bEnableTileStreaming)
+			{
+				// Persisted results are restored from the level instead, see ProcessTiles
+				Item.Tile->GeneratedResult = MakeShared<FPersistedGenerateResult>(MoveTemp(Item.PersistedResult.GetValue()));
+			}
+		}
+
+		Item.Tile->ReportStatistics = Item.GenerateResultDescription.ReportStatistics;
+		Item.Tile->ShapeReportStatistics.Reset();
+		const TArray<TMap<FString, FReportStatistics>>& ShapeReportStatistics = Item.GenerateResultDescription.ShapeReportStatistics;
+		if (ShapeReportStatistics.Num() == Item.VitruvioComponents.Num())
+		{
+			for (int32 ComponentIndex = 0; ComponentIndex < Item.VitruvioComponents.Num(); ++ComponentIndex)
+			{
+				Item.Tile->ShapeReportStatistics.Add(Item.VitruvioComponents[ComponentIndex], ShapeReportStatistics[ComponentIndex]);
+			}
+		}
+
+		// The tile has been streamed out after its result arrived or has been generated while being streamed out, only keep its result to
+		// restore the tile later
+		if (Item.Tile->bStreamedOut)
+		{
+			if (Item.Tile->GeneratedResult && !Item.Tile->bMarkedForGenerate)
+			{
+				CacheTileResult(Item.Tile->Location, MoveTemp(Item.Tile->GeneratedResult));
+			}
+			Item.Tile->GeneratedResult.Reset();
+
+			NotifyTileGenerated(Item.Tile);
+			NotifyIfAllGenerated();
+			return;
+		}
+
+		UGeneratedModelStaticMeshComponent* VitruvioModelComponent = GetOrCreateModelComponent(Item.Tile);
 
 		const FConvertedGenerateResult ConvertedResult = BuildGenerateResult(Item.GenerateResultDescription,
 	VitruvioModule::Get().GetMaterialCache(), VitruvioModule::Get().GetTextureCache(),
@@ -307,8 +762,9 @@ void AVitruvioBatchActor::ProcessGenerateQueue()
 
 		if (ConvertedResult.ShapeMesh)
 		{
-			VitruvioModelComponent->SetStaticMesh(ConvertedResult.ShapeMesh->GetStaticMesh());
+			// Set before the mesh, which recreates the physics state after which the collision data is released again
 			VitruvioModelComponent->SetCollisionData(ConvertedResult.ShapeMesh->GetCollisionData());
+			VitruvioModelComponent->SetStaticMesh(ConvertedResult.ShapeMesh->GetStaticMesh());
 			
 			// Reset Material replacements
 			for (int32 MaterialIndex = 0; MaterialIndex < VitruvioModelComponent->GetNumMaterials(); ++MaterialIndex)
@@ -328,6 +784,7 @@ void AVitruvioBatchActor::ProcessGenerateQueue()
 		}
 
 		TMap<FString, int32> NameMap;
+		// All components of a tile are merged, instances are therefore only identified by their (unique) position
 		TSet<FInstance> Replaced = ApplyInstanceReplacements(VitruvioModelComponent, ConvertedResult.Instances, InstanceReplacement, NameMap);
 		for (const FInstance& Instance : ConvertedResult.Instances)
 		{
@@ -340,8 +797,8 @@ void AVitruvioBatchActor::ProcessGenerateQueue()
 			auto InstancedComponent = NewObject<UGeneratedModelHISMComponent>(VitruvioModelComponent, FName(UniqueName),
 																			  RF_Transient | RF_TextExportTransient | RF_DuplicateTransient);
 			const TArray<FTransform>& Transforms = Instance.Transforms;
-			InstancedComponent->SetStaticMesh(Instance.InstanceMesh->GetStaticMesh());
 			InstancedComponent->SetCollisionData(Instance.InstanceMesh->GetCollisionData());
+			InstancedComponent->SetStaticMesh(Instance.InstanceMesh->GetStaticMesh());
 			InstancedComponent->SetMeshIdentifier(Instance.InstanceMesh->GetIdentifier());
 			
 			// Add all instance transforms
@@ -364,26 +821,37 @@ void AVitruvioBatchActor::ProcessGenerateQueue()
 			InstancedComponent->RegisterComponent();
 		}
 
-		for (auto& [VitruvioComponent, CallbackProxy] : Item.Tile->CallbackProxies)
-		{
-			CallbackProxy->OnGenerateCompletedBlueprint.Broadcast();
-			CallbackProxy->OnGenerateCompleted.Broadcast();
-			CallbackProxy->SetReadyToDestroy();
-		}
-
-		Item.Tile->CallbackProxies.Empty();
-		Item.Tile->bIsGenerating = false;
+		NotifyTileGenerated(Item.Tile);
 	}
 	else
 	{
 		ProcessQueueCriticalSection.Unlock();
 	}
 
+	NotifyIfAllGenerated();
+}
+
+void AVitruvioBatchActor::NotifyTileGenerated(UTile* Tile)
+{
+	for (auto& [VitruvioComponent, CallbackProxy] : Tile->CallbackProxies)
+	{
+		CallbackProxy->OnGenerateCompletedBlueprint.Broadcast();
+		CallbackProxy->OnGenerateCompleted.Broadcast();
+		CallbackProxy->SetReadyToDestroy();
+	}
+
+	Tile->CallbackProxies.Empty();
+	Tile->bIsGenerating = false;
+}
+
+void AVitruvioBatchActor::NotifyIfAllGenerated()
+{
 	if (GenerateAllCallbackProxy)
 	{
 		TArray<UTile*> Tiles;
 		Grid.Tiles.GenerateValueArray(Tiles);
-		bool bAllGenerated = Algo::NoneOf(Tiles, [](const UTile* Tile) { return Tile->bIsGenerating; });
+		// Marked tiles have not been generated yet, eg. because the number of generating tiles is limited
+		bool bAllGenerated = Algo::NoneOf(Tiles, [](const UTile* Tile) { return Tile->bIsGenerating || Tile->bMarkedForGenerate; });
 		if (bAllGenerated)
 		{
 			GenerateAllCallbackProxy->OnGenerateCompleted.Broadcast();
@@ -394,6 +862,7 @@ void AVitruvioBatchActor::ProcessGenerateQueue()
 
 void AVitruvioBatchActor::Tick(float DeltaSeconds)
 {
+	UpdateTileStreaming();
 	ProcessTiles();
 	ProcessGenerateQueue();
 }
@@ -413,6 +882,7 @@ void AVitruvioBatchActor::UnregisterVitruvioComponent(UVitruvioComponent* Vitruv
 void AVitruvioBatchActor::UnregisterAllVitruvioComponents()
 {
 	Grid.Clear();
+	ClearTileResultCache();
 	VitruvioComponents.Empty();
 }
 
@@ -463,9 +933,28 @@ void AVitruvioBatchActor::PostEditChangeProperty(FPropertyChangedEvent& Property
 		PropertyChangedEvent.MemberProperty->GetFName() == GET_MEMBER_NAME_CHECKED(AVitruvioBatchActor, GridDimension))
 	{
 		Grid.Clear();
+		ClearTileResultCache();
+		PersistedTileResults.Empty();
 		Grid.RegisterAll(VitruvioComponents, this);
 	}
 
+	if (PropertyChangedEvent.Property &&
+		PropertyChangedEvent.Property->GetFName() == GET_MEMBER_NAME_CHECKED(AVitruvioBatchActor, bPersistGeneratedModels))
+	{
+		// Regenerate so that the current models are persisted
+		PersistedTileResults.Empty();
+		if (bPersistGeneratedModels)
+		{
+			GenerateAll();
+		}
+	}
+
+	if (PropertyChangedEvent.MemberProperty &&
+		PropertyChangedEvent.MemberProperty->GetFName() == GET_MEMBER_NAME_CHECKED(AVitruvioBatchActor, CollisionSettings))
+	{
+		GenerateAll();
+	}
+
 	if (!PropertyChangedEvent.Property)
 	{
 		return;
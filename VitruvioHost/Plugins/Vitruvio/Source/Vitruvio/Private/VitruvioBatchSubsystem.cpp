@@ -116,18 +116,7 @@ void UVitruvioBatchSubsystem::Initialize(FSubsystemCollectionBase& Collection)
 	});
 #endif
 
-	for (TActorIterator<AActor> It(GetWorld()); It; ++It)
-	{
-		AActor* Actor = *It;
-
-		if (UVitruvioComponent* VitruvioComponent = Actor->FindComponentByClass<UVitruvioComponent>())
-		{
-			if (VitruvioComponent->IsBatchGenerated())
-			{
-				RegisterVitruvioComponent(VitruvioComponent);
-			}
-		}
-	}
+	// Batch generated components register themselves when they are initialized, walking all actors of the world here is not necessary
 }
 
 void UVitruvioBatchSubsystem::Deinitialize()
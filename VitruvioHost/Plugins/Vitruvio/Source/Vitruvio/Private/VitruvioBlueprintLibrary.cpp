@@ -16,8 +16,20 @@
 #include "VitruvioBlueprintLibrary.h"
 
 #include "Engine/StaticMeshActor.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
 #include "VitruvioActor.h"
 #include "VitruvioBatchActor.h"
+#include "VitruvioBatchSubsystem.h"
+
+namespace
+{
+bool SaveToProjectFile(const FString& Content, const FString& FilePath)
+{
+	const FString AbsolutePath = FPaths::IsRelative(FilePath) ? FPaths::Combine(FPaths::ProjectDir(), FilePath) : FilePath;
+	return FFileHelper::SaveStringToFile(Content, *AbsolutePath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM);
+}
+} // namespace
 
 TArray<AActor*> UVitruvioBlueprintLibrary::GetVitruvioActorsInHierarchy(AActor* Root)
 {
@@ -88,3 +100,25 @@ bool UVitruvioBlueprintLibrary::CanConvertToVitruvioActor(AActor* Actor)
 
 	return false;
 }
+
+TMap<FString, FReportStatistics> UVitruvioBlueprintLibrary::GetBatchReportStatistics(UObject* WorldContextObject)
+{
+	const UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull);
+	UVitruvioBatchSubsystem* VitruvioBatchSubsystem = World ? World->GetSubsystem<UVitruvioBatchSubsystem>() : nullptr;
+	if (!VitruvioBatchSubsystem || !VitruvioBatchSubsystem->HasRegisteredVitruvioComponents())
+	{
+		return {};
+	}
+
+	return VitruvioBatchSubsystem->GetBatchActor()->GetReportStatistics();
+}
+
+bool UVitruvioBlueprintLibrary::ExportReportStatisticsToCsv(const TMap<FString, FReportStatistics>& ReportStatistics, const FString& FilePath)
+{
+	return SaveToProjectFile(Vitruvio::ReportStatisticsToCsv(ReportStatistics), FilePath);
+}
+
+bool UVitruvioBlueprintLibrary::ExportReportStatisticsToJson(const TMap<FString, FReportStatistics>& ReportStatistics, const FString& FilePath)
+{
+	return SaveToProjectFile(Vitruvio::ReportStatisticsToJson(ReportStatistics), FilePath);
+}
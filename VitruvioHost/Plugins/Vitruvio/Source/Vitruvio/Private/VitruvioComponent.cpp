@@ -21,14 +21,18 @@
 #include "GeneratedModelStaticMeshComponent.h"
 #include "UnrealCallbacks.h"
 #include "VitruvioModule.h"
+#include "VitruvioStats.h"
 #include "VitruvioTypes.h"
 
 #include "Algo/Transform.h"
+#include "Async/Async.h"
+#include "Async/ParallelFor.h"
 #include "Components/HierarchicalInstancedStaticMeshComponent.h"
 #include "Components/SplineComponent.h"
 #include "Engine/CollisionProfile.h"
 #include "PRTUtils.h"
 #include "VitruvioBatchSubsystem.h"
+#include "VitruvioLoadSubsystem.h"
 #include "PhysicsEngine/BodySetup.h"
 #include "UObject/ConstructorHelpers.h"
 #include "Engine/World.h"
@@ -140,6 +144,7 @@ void SetAttribute(UVitruvioComponent* VitruvioComponent, const TMap<FString, URu
 	}
 
 	TAttribute->bUserSet = true;
+	VitruvioComponent->MarkAttributesChanged();
 
 	if (bEvaluateAttributes || bGenerateModel)
 	{
@@ -167,78 +172,83 @@ void EvaluateAndSetAttribute(UVitruvioComponent* VitruvioComponent, TMap<FString
 	}
 }
 
-void EvaluateAndSetAttributes(UVitruvioComponent* VitruvioComponent, const TMap<FString, FString>& NewAttributes, bool bGenerateModel,
-							  UGenerateCompletedCallbackProxy* CallbackProxy)
+void ApplyAttributeValues(UVitruvioComponent* VitruvioComponent, const TMap<FString, FString>& NewAttributes)
 {
-	VitruvioComponent->Initialize();
-
-	if (!VitruvioComponent->GetAttributesReady())
-	{
-		UGenerateCompletedCallbackProxy* Proxy = NewObject<UGenerateCompletedCallbackProxy>();
-		Proxy->OnAttributesEvaluated.AddLambda([=]() { EvaluateAndSetAttributes(VitruvioComponent, NewAttributes, bGenerateModel, CallbackProxy); });
-		Proxy->RegisterWithGameInstance(VitruvioComponent);
-		VitruvioComponent->EvaluateRuleAttributes(bGenerateModel, Proxy);
-	}
-	else
+	for (const auto& KeyValues : NewAttributes)
 	{
-		for (const auto& KeyValues : NewAttributes)
+		const FString& Value = KeyValues.Value;
+		const FString& Key = KeyValues.Key;
+
+		URuleAttribute* const* AttributeResult = VitruvioComponent->GetAttributes().Find(Key);
+		if (!AttributeResult)
 		{
-			const FString& Value = KeyValues.Value;
-			const FString& Key = KeyValues.Key;
+			continue;
+		}
+
+		URuleAttribute const* Attribute = *AttributeResult;
 
-			URuleAttribute* const* AttributeResult = VitruvioComponent->GetAttributes().Find(Key);
-			if (!AttributeResult)
+		if (Cast<UFloatAttribute>(Attribute))
+		{
+			SetAttribute<UFloatAttribute, double>(VitruvioComponent, VitruvioComponent->GetAttributes(), Key, FCString::Atof(*Value), false,
+												  false, nullptr);
+		}
+		else if (Cast<UBoolAttribute>(Attribute))
+		{
+			SetAttribute<UBoolAttribute, bool>(VitruvioComponent, VitruvioComponent->GetAttributes(), Key, ToBool(Value), false, false, nullptr);
+		}
+		else if (Cast<UStringAttribute>(Attribute))
+		{
+			SetAttribute<UStringAttribute, FString>(VitruvioComponent, VitruvioComponent->GetAttributes(), Key, Value, false, false, nullptr);
+		}
+		else if (Cast<UArrayAttribute>(Attribute))
+		{
+			FString ArrayValue = Value;
+			if (Value.StartsWith(TEXT("[")) && Value.EndsWith(TEXT("]")))
 			{
-				continue;
+				ArrayValue = Value.LeftChop(1).RightChop(1);
 			}
 
-			URuleAttribute const* Attribute = *AttributeResult;
+			TArray<FString> StringValues;
+			ArrayValue.ParseIntoArray(StringValues, TEXT(","));
 
-			if (Cast<UFloatAttribute>(Attribute))
+			if (Cast<UFloatArrayAttribute>(Attribute))
 			{
-				SetAttribute<UFloatAttribute, double>(VitruvioComponent, VitruvioComponent->GetAttributes(), Key, FCString::Atof(*Value), false,
-													  false, nullptr);
+				TArray<double> DoubleValues;
+				Algo::Transform(StringValues, DoubleValues, [](const auto& In) { return FCString::Atof(*In); });
+				SetAttribute<UFloatArrayAttribute, TArray<double>>(VitruvioComponent, VitruvioComponent->GetAttributes(), Key, DoubleValues,
+																   false, false, nullptr);
 			}
-			else if (Cast<UBoolAttribute>(Attribute))
+			else if (Cast<UBoolArrayAttribute>(Attribute))
 			{
-				SetAttribute<UBoolAttribute, bool>(VitruvioComponent, VitruvioComponent->GetAttributes(), Key, ToBool(Value), false, false, nullptr);
+				TArray<bool> BoolValues;
+				Algo::Transform(StringValues, BoolValues, [](const auto& In) { return ToBool(In); });
+				SetAttribute<UBoolArrayAttribute, TArray<bool>>(VitruvioComponent, VitruvioComponent->GetAttributes(), Key, BoolValues, false,
+																false, nullptr);
 			}
-			else if (Cast<UStringAttribute>(Attribute))
+			else
 			{
-				SetAttribute<UStringAttribute, FString>(VitruvioComponent, VitruvioComponent->GetAttributes(), Key, Value, false, false, nullptr);
+				SetAttribute<UStringArrayAttribute, TArray<FString>>(VitruvioComponent, VitruvioComponent->GetAttributes(), Key, StringValues,
+																	 false, false, nullptr);
 			}
-			else if (Cast<UArrayAttribute>(Attribute))
-			{
-				FString ArrayValue = Value;
-				if (Value.StartsWith(TEXT("[")) && Value.EndsWith(TEXT("]")))
-				{
-					ArrayValue = Value.LeftChop(1).RightChop(1);
-				}
+		}
+	}
+}
 
-				TArray<FString> StringValues;
-				ArrayValue.ParseIntoArray(StringValues, TEXT(","));
+void EvaluateAndSetAttributes(UVitruvioComponent* VitruvioComponent, const TMap<FString, FString>& NewAttributes, bool bGenerateModel,
+							  UGenerateCompletedCallbackProxy* CallbackProxy)
+{
+	VitruvioComponent->Initialize();
 
-				if (Cast<UFloatArrayAttribute>(Attribute))
-				{
-					TArray<double> DoubleValues;
-					Algo::Transform(StringValues, DoubleValues, [](const auto& In) { return FCString::Atof(*In); });
-					SetAttribute<UFloatArrayAttribute, TArray<double>>(VitruvioComponent, VitruvioComponent->GetAttributes(), Key, DoubleValues,
-																	   false, false, nullptr);
-				}
-				else if (Cast<UBoolArrayAttribute>(Attribute))
-				{
-					TArray<bool> BoolValues;
-					Algo::Transform(StringValues, BoolValues, [](const auto& In) { return ToBool(In); });
-					SetAttribute<UBoolArrayAttribute, TArray<bool>>(VitruvioComponent, VitruvioComponent->GetAttributes(), Key, BoolValues, false,
-																	false, nullptr);
-				}
-				else
-				{
-					SetAttribute<UStringArrayAttribute, TArray<FString>>(VitruvioComponent, VitruvioComponent->GetAttributes(), Key, StringValues,
-																		 false, false, nullptr);
-				}
-			}
-		}
+	if (!VitruvioComponent->GetAttributesReady())
+	{
+		UGenerateCompletedCallbackProxy* Proxy = NewObject<UGenerateCompletedCallbackProxy>();
+		Proxy->OnAttributesEvaluated.AddLambda([=]() { EvaluateAndSetAttributes(VitruvioComponent, NewAttributes, bGenerateModel, CallbackProxy); });
+		Proxy->RegisterWithGameInstance(VitruvioComponent);
+		VitruvioComponent->EvaluateRuleAttributes(bGenerateModel, Proxy);
+	}
+	else
+	{
+		ApplyAttributeValues(VitruvioComponent, NewAttributes);
 
 		VitruvioComponent->EvaluateRuleAttributes(bGenerateModel, CallbackProxy);
 	}
@@ -292,6 +302,16 @@ bool IsRelevantObject(UVitruvioComponent* VitruvioComponent, UObject* Object)
 }
 #endif
 
+// Minimum number of transforms of a single instance before replacement sampling is distributed over multiple threads
+constexpr int32 MinParallelReplacementTransforms = 1024;
+
+// Transform location quantized to millimeters, stable across runs and machines and independent of the order of the instances
+FIntVector GetQuantizedLocation(const FTransform& Transform)
+{
+	const FVector Location = Transform.GetLocation() * 10.0;
+	return FIntVector(FMath::RoundToInt32(Location.X), FMath::RoundToInt32(Location.Y), FMath::RoundToInt32(Location.Z));
+}
+
 } // namespace
 
 UVitruvioComponent::FOnHierarchyChanged UVitruvioComponent::OnHierarchyChanged;
@@ -324,8 +344,79 @@ void ApplyMaterialReplacements(UStaticMeshComponent* StaticMeshComponent, const
 	}
 }
 
+void SampleInstanceReplacements(const FInstanceReplacement& InstanceReplacement, const TArray<FTransform>& Transforms, uint32 InstanceSeed,
+								bool bForceSingleThread, TArray<int32>& OutOptionIndices, TArray<FTransform>& OutTransforms)
+{
+	TArray<float> CumulativeProbabilities;
+	float CumulativeProbability = 0.0f;
+	for (const FReplacementOption& ReplacementOption : InstanceReplacement.Replacements)
+	{
+		CumulativeProbability += ReplacementOption.Frequency;
+		CumulativeProbabilities.Add(CumulativeProbability);
+	}
+
+	auto RandomVector = [](FRandomStream& RandomStream, const FVector& Min, const FVector& Max) {
+		double RandX = RandomStream.FRandRange(Min[0], Max[0]);
+		double RandY = RandomStream.FRandRange(Min[1], Max[1]);
+		double RandZ = RandomStream.FRandRange(Min[2], Max[2]);
+		return FVector{RandX, RandY, RandZ};
+	};
+
+	// Every transform samples from its own stream, so the result neither depends on the order nor on the number of threads. Co-located
+	// transforms are told apart by the number of preceding transforms at the same location.
+	const int32 NumTransforms = Transforms.Num();
+	TArray<uint32> TransformSeeds;
+	TransformSeeds.SetNumUninitialized(NumTransforms);
+	TMap<FIntVector, int32> NumOccurrences;
+	NumOccurrences.Reserve(NumTransforms);
+	for (int32 TransformIndex = 0; TransformIndex < NumTransforms; ++TransformIndex)
+	{
+		const FIntVector QuantizedLocation = GetQuantizedLocation(Transforms[TransformIndex]);
+		const int32 Occurrence = NumOccurrences.FindOrAdd(QuantizedLocation)++;
+		const uint32 LocationSeed = HashCombine(InstanceSeed, GetTypeHash(QuantizedLocation));
+		TransformSeeds[TransformIndex] = Occurrence == 0 ? LocationSeed : HashCombine(LocationSeed, GetTypeHash(Occurrence));
+	}
+
+	OutOptionIndices.SetNumUninitialized(NumTransforms);
+	OutTransforms.SetNumUninitialized(NumTransforms);
+
+	ParallelFor(NumTransforms, [&](int32 TransformIndex)
+	{
+		const FTransform& Transform = Transforms[TransformIndex];
+		FRandomStream RandomStream(static_cast<int32>(TransformSeeds[TransformIndex]));
+
+		const float RandomProbability = RandomStream.FRandRange(0.0f, CumulativeProbability);
+		const int OptionIndex = Algo::LowerBound(CumulativeProbabilities, RandomProbability);
+
+		const FReplacementOption& ReplacementOption = InstanceReplacement.Replacements[OptionIndex];
+		FTransform ModifiedTransform = Transform;
+		if (ReplacementOption.bRandomScale)
+		{
+			if (ReplacementOption.bUniformScale)
+			{
+				const double RandScale = RandomStream.FRandRange(ReplacementOption.UniformMinScale, ReplacementOption.UniformMaxScale);
+				ModifiedTransform.SetScale3D({RandScale, RandScale, RandScale});
+			}
+			else
+			{
+				ModifiedTransform.SetScale3D(RandomVector(RandomStream, ReplacementOption.MinScale, ReplacementOption.MaxScale));
+			}
+		}
+
+		if (ReplacementOption.bRandomRotation)
+		{
+			ModifiedTransform.SetRotation(
+				FQuat::MakeFromEuler(RandomVector(RandomStream, ReplacementOption.MinRotation, ReplacementOption.MaxRotation)));
+		}
+
+		OutOptionIndices[TransformIndex] = OptionIndex;
+		OutTransforms[TransformIndex] = ModifiedTransform;
+	}, bForceSingleThread ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None);
+}
+
 TSet<FInstance> ApplyInstanceReplacements(UGeneratedModelStaticMeshComponent* GeneratedModelComponent, 
-											  const TArray<FInstance>& Instances, UInstanceReplacementAsset* Replacement, TMap<FString, int32>& NameMap)
+											  const TArray<FInstance>& Instances, UInstanceReplacementAsset* Replacement, TMap<FString, int32>& NameMap,
+											  int32 RandomSeed)
 {
 	TSet<FInstance> Replaced;
 	if (!Replacement)
@@ -351,13 +442,8 @@ TSet<FInstance> ApplyInstanceReplacements(UGeneratedModelStaticMeshComponent* Ge
 
 			TArray<UGeneratedModelHISMComponent*> InstancedComponents;
 
-			TArray<float> CumulativeProbabilities;
-			float CumulativeProbability = 0.0f;
 			for (const FReplacementOption& ReplacementOption : InstanceReplacement->Replacements)
 			{
-				CumulativeProbability += ReplacementOption.Frequency;
-				CumulativeProbabilities.Add(CumulativeProbability);
-
 				FString UniqueName = UniqueComponentName(ReplacementOption.Mesh->GetName(), NameMap);
 				auto InstancedComponent = NewObject<UGeneratedModelHISMComponent>(GeneratedModelComponent, FName(UniqueName),
 																				  RF_Transient | RF_TextExportTransient | RF_DuplicateTransient);
@@ -376,46 +462,27 @@ TSet<FInstance> ApplyInstanceReplacements(UGeneratedModelStaticMeshComponent* Ge
 				InstancedComponent->RegisterComponent();
 			}
 
-			auto RandomVector = [](const FVector& Min, const FVector& Max) {
-				double RandX = FMath::RandRange(Min[0], Max[0]);
-				double RandY = FMath::RandRange(Min[1], Max[1]);
-				double RandZ = FMath::RandRange(Min[2], Max[2]);
-				return FVector{RandX, RandY, RandZ};
-			};
-
-			TMap<int, TArray<FTransform>>  ModifiedTransforms;
-			for (const FTransform& Transform : Instance.Transforms)
-			{
-				const float RandomProbability = FMath::RandRange(0.0f, CumulativeProbability);
-				const int ComponentIndex = Algo::LowerBound(CumulativeProbabilities, RandomProbability);
-
-				const FReplacementOption& ReplacementOption = InstanceReplacement->Replacements[ComponentIndex];
-				FTransform ModifiedTransform = Transform;
-				if (ReplacementOption.bRandomScale)
-				{
-					if (ReplacementOption.bUniformScale)
-					{
-						const double RandScale = FMath::RandRange(ReplacementOption.UniformMinScale, ReplacementOption.UniformMaxScale);
-						ModifiedTransform.SetScale3D({RandScale, RandScale, RandScale});
-					}
-					else
-					{
-						ModifiedTransform.SetScale3D(RandomVector(ReplacementOption.MinScale, ReplacementOption.MaxScale));
-					}
-				}
+			const uint32 InstanceSeed = HashCombine(GetTypeHash(RandomSeed), GetTypeHash(Instance.InstanceMesh->GetIdentifier()));
 
-				if (ReplacementOption.bRandomRotation)
-				{
-					ModifiedTransform.SetRotation(FQuat::MakeFromEuler(RandomVector(ReplacementOption.MinRotation, ReplacementOption.MaxRotation)));
-				}
+			const int32 NumTransforms = Instance.Transforms.Num();
+			TArray<int32> ComponentIndices;
+			TArray<FTransform> ModifiedTransforms;
+			SampleInstanceReplacements(*InstanceReplacement, Instance.Transforms, InstanceSeed, NumTransforms < MinParallelReplacementTransforms,
+									   ComponentIndices, ModifiedTransforms);
 
-				ModifiedTransforms.FindOrAdd(ComponentIndex).Add(ModifiedTransform);
-				
+			TArray<TArray<FTransform>> TransformsByComponent;
+			TransformsByComponent.SetNum(InstancedComponents.Num());
+			for (int32 TransformIndex = 0; TransformIndex < NumTransforms; ++TransformIndex)
+			{
+				TransformsByComponent[ComponentIndices[TransformIndex]].Add(ModifiedTransforms[TransformIndex]);
 			}
 
-			for (const auto& [ComponentIndex, Transforms] : ModifiedTransforms)
+			for (int32 ComponentIndex = 0; ComponentIndex < InstancedComponents.Num(); ++ComponentIndex)
 			{
-				InstancedComponents[ComponentIndex]->AddInstances(Transforms, false);
+				if (!TransformsByComponent[ComponentIndex].IsEmpty())
+				{
+					InstancedComponents[ComponentIndex]->AddInstances(TransformsByComponent[ComponentIndex], false);
+				}
 			}
 
 			Replaced.Add(Instance);
@@ -523,6 +590,7 @@ void UVitruvioComponent::SetRpk(URulePackage* RulePackage, bool bEvaluateAttribu
 	this->Rpk = RulePackage;
 
 	Attributes.Empty();
+	MarkAttributesChanged();
 	bAttributesReady = false;
 	bNotifyAttributeChange = true;
 
@@ -680,6 +748,23 @@ const TMap<FString, FReport>& UVitruvioComponent::GetReports() const
 	return Reports;
 }
 
+TMap<FString, FReportStatistics> UVitruvioComponent::GetReportStatistics() const
+{
+	// The reports of batch generated shapes are kept by the tile they have been generated with
+	if (bBatchGenerate && GetWorld())
+	{
+		if (UVitruvioBatchSubsystem* BatchGenerateSubsystem = GetWorld()->GetSubsystem<UVitruvioBatchSubsystem>())
+		{
+			return BatchGenerateSubsystem->GetBatchActor()->GetComponentReportStatistics(this);
+		}
+		return {};
+	}
+
+	TMap<FString, FReportStatistics> ReportStatistics;
+	Vitruvio::AddReports(ReportStatistics, Reports);
+	return ReportStatistics;
+}
+
 void UVitruvioComponent::SetInitialShapeVisible(bool bVisible)
 {
 	InitialShapeSceneComponent->SetVisibility(bVisible, false);
@@ -762,10 +847,80 @@ void UVitruvioComponent::Initialize()
 		UVitruvioBatchSubsystem* BatchGenerateSubsystem = GetWorld()->GetSubsystem<UVitruvioBatchSubsystem>();
 		BatchGenerateSubsystem->RegisterVitruvioComponent(this);
 	}
-	else
+	else if (!RestorePersistedGenerateResult())
+	{
+		// After opening a level all components are initialized in the same frame, their PRT calls are therefore throttled
+		UVitruvioLoadSubsystem* LoadSubsystem = GetWorld() ? GetWorld()->GetSubsystem<UVitruvioLoadSubsystem>() : nullptr;
+		if (LoadSubsystem && HasValidInputData())
+		{
+			LoadSubsystem->Schedule(this, GenerateAutomatically);
+		}
+		else
+		{
+			EvaluateRuleAttributes(GenerateAutomatically);
+		}
+	}
+}
+
+uint64 UVitruvioComponent::GetPersistedGenerateInputHash() const
+{
+	FXxHash64Builder Builder;
+	const uint64 GenerateInputHash = GetGenerateInputHash();
+	Builder.Update(&GenerateInputHash, sizeof(GenerateInputHash));
+
+	// Collision is computed while generating and therefore part of the persisted result
+	Vitruvio::AppendStringHash(Builder, CollisionSettings.ToCacheKey());
+	return Builder.Finalize().Hash;
+}
+
+bool UVitruvioComponent::RestorePersistedGenerateResult()
+{
+	if (!bPersistGeneratedModel || !bAttributesReady || !HasValidInputData() || !PersistedGenerateResult.IsValid())
+	{
+		return false;
+	}
+
+	if (PersistedGenerateResult.InputHash != GetPersistedGenerateInputHash())
 	{
-		EvaluateRuleAttributes(GenerateAutomatically);
+		PersistedGenerateResult = {};
+		return false;
 	}
+
+	const FGenerateResult::FTokenPtr Token = MakeShared<FGenerateToken>();
+	GenerateToken = Token;
+
+	// clang-format off
+	Vitruvio::RestoreGenerateResultAsync(PersistedGenerateResult, {Rpk}, CollisionSettings).Next([this, Token](const TOptional<FGenerateResultDescription>& Result)
+	{
+		FScopeLock Lock(&Token->Lock);
+
+		if (Token->IsInvalid())
+		{
+			return;
+		}
+
+		GenerateToken.Reset();
+
+		if (Result.IsSet())
+		{
+			GenerateQueue.Enqueue({Result.GetValue(), FGenerateOptions(), nullptr});
+			INC_DWORD_STAT(STAT_Vitruvio_GenerateQueueDepth);
+			return;
+		}
+
+		// The persisted result could not be read, evaluate and generate as if nothing had been persisted
+		AsyncTask(ENamedThreads::GameThread, [WeakThis = TWeakObjectPtr<UVitruvioComponent>(this)]()
+		{
+			if (WeakThis.IsValid())
+			{
+				WeakThis->PersistedGenerateResult = {};
+				WeakThis->EvaluateRuleAttributes(true);
+			}
+		});
+	});
+	// clang-format on
+
+	return true;
 }
 
 void UVitruvioComponent::ProcessGenerateQueue()
@@ -778,13 +933,26 @@ void UVitruvioComponent::ProcessGenerateQueue()
 	if (bBatchGenerate)
 	{
 		RemoveGeneratedMeshes();
-		GenerateQueue.Empty();
+		while (GenerateQueue.Pop())
+		{
+			DEC_DWORD_STAT(STAT_Vitruvio_GenerateQueueDepth);
+		}
 		return;
 	}
+
+	SCOPE_CYCLE_COUNTER(STAT_Vitruvio_ProcessGenerateQueue);
 		
 	// Get from queue and build meshes
 	FGenerateQueueItem Result;
 	GenerateQueue.Dequeue(Result);
+	DEC_DWORD_STAT(STAT_Vitruvio_GenerateQueueDepth);
+
+	// Previews only show the merged model of the shape, the meshes of its instances are not built
+	if (Result.GenerateOptions.bSkipInstances)
+	{
+		Result.GenerateResultDescription.Instances.Reset();
+		Result.GenerateResultDescription.InstanceMeshes.Reset();
+	}
 
 	FConvertedGenerateResult ConvertedResult = BuildGenerateResult(Result.GenerateResultDescription,
 VitruvioModule::Get().GetMaterialCache(), VitruvioModule::Get().GetTextureCache(),
@@ -792,6 +960,11 @@ VitruvioModule::Get().GetMaterialCache(), VitruvioModule::Get().GetTextureCache(
 
 	Reports = ConvertedResult.Reports;
 
+	if (Result.PersistedResult.IsSet())
+	{
+		PersistedGenerateResult = MoveTemp(Result.PersistedResult.GetValue());
+	}
+
 	QUICK_SCOPE_CYCLE_COUNTER(STAT_VitruvioActor_CreateModelActors);
 
 	UGeneratedModelStaticMeshComponent* VitruvioModelComponent = nullptr;
@@ -831,8 +1004,9 @@ VitruvioModule::Get().GetMaterialCache(), VitruvioModule::Get().GetTextureCache(
 
 	if (ConvertedResult.ShapeMesh)
 	{
-		VitruvioModelComponent->SetStaticMesh(ConvertedResult.ShapeMesh->GetStaticMesh());
+		// Set before the mesh, which recreates the physics state after which the collision data is released again
 		VitruvioModelComponent->SetCollisionData(ConvertedResult.ShapeMesh->GetCollisionData());
+		VitruvioModelComponent->SetStaticMesh(ConvertedResult.ShapeMesh->GetStaticMesh());
 
 		// Reset Material replacements
 		for (int32 MaterialIndex = 0; MaterialIndex < VitruvioModelComponent->GetNumMaterials(); ++MaterialIndex)
@@ -856,7 +1030,7 @@ VitruvioModule::Get().GetMaterialCache(), VitruvioModule::Get().GetTextureCache(
 
 	if (!Result.GenerateOptions.bIgnoreInstanceReplacements)
 	{
-		Replaced = ApplyInstanceReplacements(VitruvioModelComponent, ConvertedResult.Instances, InstanceReplacement, NameMap);
+		Replaced = ApplyInstanceReplacements(VitruvioModelComponent, ConvertedResult.Instances, InstanceReplacement, NameMap, RandomSeed);
 	}
 
 	for (const FInstance& Instance : ConvertedResult.Instances)
@@ -870,8 +1044,8 @@ VitruvioModule::Get().GetMaterialCache(), VitruvioModule::Get().GetTextureCache(
 		auto InstancedComponent = NewObject<UGeneratedModelHISMComponent>(VitruvioModelComponent, FName(UniqueName),
 																		  RF_Transient | RF_TextExportTransient | RF_DuplicateTransient);
 		const TArray<FTransform>& Transforms = Instance.Transforms;
-		InstancedComponent->SetStaticMesh(Instance.InstanceMesh->GetStaticMesh());
 		InstancedComponent->SetCollisionData(Instance.InstanceMesh->GetCollisionData());
+		InstancedComponent->SetStaticMesh(Instance.InstanceMesh->GetStaticMesh());
 		InstancedComponent->SetMeshIdentifier(Instance.InstanceMesh->GetIdentifier());
 
 		// Add all instance transforms
@@ -902,9 +1076,16 @@ VitruvioModule::Get().GetMaterialCache(), VitruvioModule::Get().GetTextureCache(
 	OnHierarchyChanged.Broadcast(this);
 
 	bHasGeneratedModel = true;
+	bHasPreviewModel = Result.GenerateOptions.IsPreview();
 
 	SetInitialShapeVisible(!HideAfterGeneration);
 
+	// The model components have been registered, the model is visible from now on
+	if (UVitruvioLoadSubsystem* LoadSubsystem = GetWorld() ? GetWorld()->GetSubsystem<UVitruvioLoadSubsystem>() : nullptr)
+	{
+		LoadSubsystem->NotifyModelRegistered(this);
+	}
+
 	if (Result.CallbackProxy)
 	{
 		Result.CallbackProxy->OnGenerateCompletedBlueprint.Broadcast();
@@ -920,6 +1101,7 @@ void UVitruvioComponent::ProcessAttributesEvaluationQueue()
 	{
 		FAttributesEvaluationQueueItem AttributesEvaluation;
 		AttributesEvaluationQueue.Dequeue(AttributesEvaluation);
+		DEC_DWORD_STAT(STAT_Vitruvio_AttributesQueueDepth);
 
 		AttributesEvaluation.AttributeMap->UpdateUnrealAttributeMap(Attributes, this);
 
@@ -935,7 +1117,7 @@ void UVitruvioComponent::ProcessAttributesEvaluationQueue()
 
 		if (AttributesEvaluation.bForceRegenerate)
 		{
-			Generate(AttributesEvaluation.CallbackProxy);
+			Generate(AttributesEvaluation.CallbackProxy, AttributesEvaluation.GenerateOptions);
 		}
 		else if (AttributesEvaluation.CallbackProxy)
 		{
@@ -953,6 +1135,7 @@ void UVitruvioComponent::TickComponent(float DeltaTime, ELevelTick TickType, FAc
 
 	ProcessGenerateQueue();
 	ProcessAttributesEvaluationQueue();
+	ProcessGenerateRequest();
 
 	if (bNotifyAttributeChange)
 	{
@@ -985,6 +1168,7 @@ void UVitruvioComponent::RemoveGeneratedMeshes()
 	}
 
 	bHasGeneratedModel = false;
+	bHasPreviewModel = false;
 	SetInitialShapeVisible(true);
 
 	if (bBatchGenerate)
@@ -1003,6 +1187,16 @@ bool UVitruvioComponent::HasGeneratedModel() const
 	return bHasGeneratedModel;
 }
 
+bool UVitruvioComponent::HasPreviewModel() const
+{
+	return bHasGeneratedModel && bHasPreviewModel;
+}
+
+bool UVitruvioComponent::HasPendingPrtCalls() const
+{
+	return GenerateToken.IsValid() || EvalAttributesInvalidationToken.IsValid() || PendingGenerateRequest.IsSet();
+}
+
 UGeneratedModelStaticMeshComponent* UVitruvioComponent::GetGeneratedModelComponent() const
 {
 	if (!InitialShapeSceneComponent)
@@ -1058,8 +1252,31 @@ FString UVitruvioComponent::GetMaterialIdentifier(const UMaterialInterface* Sour
 	return {};
 }
 
+void UVitruvioComponent::OnRegister()
+{
+	Super::OnRegister();
+
+	// Registered before the first tick, so that the Rule Package can already be preloaded
+	if (UVitruvioLoadSubsystem* LoadSubsystem = GetWorld() ? GetWorld()->GetSubsystem<UVitruvioLoadSubsystem>() : nullptr)
+	{
+		LoadSubsystem->RegisterVitruvioComponent(this);
+	}
+}
+
+void UVitruvioComponent::OnUnregister()
+{
+	if (UVitruvioLoadSubsystem* LoadSubsystem = GetWorld() ? GetWorld()->GetSubsystem<UVitruvioLoadSubsystem>() : nullptr)
+	{
+		LoadSubsystem->UnregisterVitruvioComponent(this);
+	}
+
+	Super::OnUnregister();
+}
+
 void UVitruvioComponent::OnComponentDestroyed(bool bDestroyingHierarchy)
 {
+	PendingGenerateRequest.Reset();
+
 	if (GenerateToken)
 	{
 		GenerateToken->Invalidate();
@@ -1105,14 +1322,32 @@ void UVitruvioComponent::Generate(UGenerateCompletedCallbackProxy* CallbackProxy
 
 	if (InitialShape)
 	{
-		FGenerateResult GenerateResult =
-			VitruvioModule::Get().GenerateAsync({ FVector::ZeroVector, InitialShape->GetPolygon(), Vitruvio::CreateAttributeMap(Attributes), RandomSeed, Rpk});
+		FGeneratedCollisionSettings GenerateCollisionSettings = CollisionSettings;
+		if (GenerateOptions.bSkipCollision)
+		{
+			GenerateCollisionSettings.CollisionType = EGeneratedCollisionType::None;
+		}
+
+		// Results generated without collision would be restored without collision as well
+		const bool bPersistResult = bPersistGeneratedModel && !GenerateOptions.bSkipCollision;
+		const uint64 PersistedInputHash = bPersistResult ? GetPersistedGenerateInputHash() : 0;
+
+		// Duplicated actors share their result instead of generating the same model again
+		FGenerateResult GenerateResult = VitruvioModule::Get().GenerateSharedAsync(CreateInitialShape(), CreateGenerateResultKey(GenerateCollisionSettings),
+																				   GenerateCollisionSettings);
 
 		GenerateToken = GenerateResult.Token;
 
 		// clang-format off
-		GenerateResult.Result.Next([this, CallbackProxy, GenerateOptions](const FGenerateResult::ResultType& Result)
+		GenerateResult.Result.Next([this, CallbackProxy, GenerateOptions, bPersistResult, PersistedInputHash](const FGenerateResult::ResultType& Result)
 		{
+			// Serialize outside of the lock, which is also taken by the game thread to invalidate the result
+			TOptional<FPersistedGenerateResult> PersistedResult;
+			if (bPersistResult && !Result.Token->IsInvalid())
+			{
+				PersistedResult = Vitruvio::PersistGenerateResult(Result.Value, PersistedInputHash);
+			}
+
 			FScopeLock Lock(&Result.Token->Lock);
 
 			if (Result.Token->IsInvalid())
@@ -1121,7 +1356,8 @@ void UVitruvioComponent::Generate(UGenerateCompletedCallbackProxy* CallbackProxy
 			}
 
 			GenerateToken.Reset();
-			GenerateQueue.Enqueue({Result.Value, GenerateOptions, CallbackProxy});
+			GenerateQueue.Enqueue({Result.Value, GenerateOptions, CallbackProxy, MoveTemp(PersistedResult)});
+			INC_DWORD_STAT(STAT_Vitruvio_GenerateQueueDepth);
 		});
 		// clang-format on
 	}
@@ -1146,6 +1382,9 @@ void UVitruvioComponent::PostUndoRedo()
 		PropertyChangeDelegate = FCoreUObjectDelegates::OnObjectPropertyChanged.AddUObject(this, &UVitruvioComponent::OnPropertyChanged);
 	}
 
+	// The transaction might have restored previous attribute values
+	MarkAttributesChanged();
+
 	Generate();
 }
 
@@ -1192,6 +1431,7 @@ void UVitruvioComponent::OnPropertyChanged(UObject* Object, FPropertyChangedEven
 		if (PropertyChangedEvent.Property->GetFName() == GET_MEMBER_NAME_CHECKED(UVitruvioComponent, Rpk))
 		{
 			Attributes.Empty();
+			MarkAttributesChanged();
 			bAttributesReady = false;
 			bComponentPropertyChanged = true;
 			bNotifyAttributeChange = true;
@@ -1213,6 +1453,13 @@ void UVitruvioComponent::OnPropertyChanged(UObject* Object, FPropertyChangedEven
 			bComponentPropertyChanged = true;
 		}
 
+		if (PropertyChangedEvent.Property->GetFName() == GET_MEMBER_NAME_CHECKED(UVitruvioComponent, bPersistGeneratedModel))
+		{
+			// Regenerate so that the current model is persisted
+			PersistedGenerateResult = {};
+			bComponentPropertyChanged |= bPersistGeneratedModel;
+		}
+
 		if (PropertyChangedEvent.Property->GetFName() == GET_MEMBER_NAME_CHECKED(UVitruvioComponent, MaterialReplacement))
 		{
 			bComponentPropertyChanged = true;
@@ -1222,6 +1469,12 @@ void UVitruvioComponent::OnPropertyChanged(UObject* Object, FPropertyChangedEven
 		{
 			bComponentPropertyChanged = true;
 		}
+
+		if (PropertyChangedEvent.MemberProperty &&
+			PropertyChangedEvent.MemberProperty->GetFName() == GET_MEMBER_NAME_CHECKED(UVitruvioComponent, CollisionSettings))
+		{
+			bComponentPropertyChanged = true;
+		}
 	}
 
 	// If an object was changed via an undo command, the PropertyChangedEvent.Property is null
@@ -1229,6 +1482,10 @@ void UVitruvioComponent::OnPropertyChanged(UObject* Object, FPropertyChangedEven
 	// This is suboptimal, since it can also happen during undo commands on irrelevant properties of that object. Might be improved later...
 	const bool bIsSplinePropertyUndo = Object->IsA(USplineComponent::StaticClass()) && PropertyChangedEvent.Property == nullptr;
 	const bool bIsAttributeUndo = Object->IsA(URuleAttribute::StaticClass()) && PropertyChangedEvent.Property == nullptr;
+	if (bIsAttributeUndo)
+	{
+		MarkAttributesChanged();
+	}
 
 	const bool bRelevantProperty =
 		InitialShape != nullptr && (bIsSplinePropertyUndo || InitialShape->IsRelevantProperty(Object, PropertyChangedEvent));
@@ -1245,22 +1502,24 @@ void UVitruvioComponent::OnPropertyChanged(UObject* Object, FPropertyChangedEven
 
 	const bool bGenerateComponent = bAttributesReady && GenerateAutomatically && (bRecreateInitialShape || bComponentPropertyChanged);
 	const bool bGenerateBatch = bBatchGenerate && (bRecreateInitialShape || bComponentPropertyChanged);
+	const bool bInteractive = PropertyChangedEvent.ChangeType == EPropertyChangeType::Interactive;
 
 	if (bGenerateComponent || bGenerateBatch)
 	{
-		Generate();
+		RequestGenerate(false, true, bInteractive);
 	}
 
 	if (!bBatchGenerate)
 	{
 		if (!HasValidInputData())
 		{
+			PendingGenerateRequest.Reset();
 			RemoveGeneratedMeshes();
 		}
 
 		if (HasValidInputData() && (!bAttributesReady || bIsAttributeUndo))
 		{
-			EvaluateRuleAttributes(true);
+			RequestGenerate(true, true, bInteractive);
 		}
 	}
 }
@@ -1295,7 +1554,8 @@ void UVitruvioComponent::SetInitialShapeType(const TSubclassOf<UInitialShape>& T
 
 #endif // WITH_EDITOR
 
-void UVitruvioComponent::EvaluateRuleAttributes(bool ForceRegenerate, UGenerateCompletedCallbackProxy* CallbackProxy)
+void UVitruvioComponent::EvaluateRuleAttributes(bool ForceRegenerate, UGenerateCompletedCallbackProxy* CallbackProxy,
+											   const FGenerateOptions& GenerateOptions)
 {
 	Initialize();
 
@@ -1315,12 +1575,15 @@ void UVitruvioComponent::EvaluateRuleAttributes(bool ForceRegenerate, UGenerateC
 
 	bAttributesReady = false;
 
+	// Attributes are evaluated after their values have been changed, eg. in the details panel
+	MarkAttributesChanged();
+
 	FAttributeMapResult AttributesResult =
-		VitruvioModule::Get().EvaluateRuleAttributesAsync({ FVector::ZeroVector, InitialShape->GetPolygon(), Vitruvio::CreateAttributeMap(Attributes), RandomSeed, Rpk});
+		VitruvioModule::Get().EvaluateRuleAttributesAsync(CreateInitialShape());
 
 	EvalAttributesInvalidationToken = AttributesResult.Token;
 
-	AttributesResult.Result.Next([this, CallbackProxy, ForceRegenerate](const FAttributeMapResult::ResultType& Result) {
+	AttributesResult.Result.Next([this, CallbackProxy, ForceRegenerate, GenerateOptions](const FAttributeMapResult::ResultType& Result) {
 		FScopeLock Lock(&Result.Token->Lock);
 
 		if (Result.Token->IsInvalid())
@@ -1329,8 +1592,132 @@ void UVitruvioComponent::EvaluateRuleAttributes(bool ForceRegenerate, UGenerateC
 		}
 
 		EvalAttributesInvalidationToken.Reset();
-		AttributesEvaluationQueue.Enqueue({Result.Value, ForceRegenerate, CallbackProxy});
+		AttributesEvaluationQueue.Enqueue({Result.Value, ForceRegenerate, CallbackProxy, GenerateOptions});
+		INC_DWORD_STAT(STAT_Vitruvio_AttributesQueueDepth);
+	});
+}
+
+void UVitruvioComponent::RequestGenerate(bool bEvaluateAttributes, bool bGenerateModel, bool bInteractive)
+{
+	if (bEvaluateAttributes)
+	{
+		MarkAttributesChanged();
+	}
+
+	FGenerateRequest& Request = PendingGenerateRequest.IsSet() ? PendingGenerateRequest.GetValue() : PendingGenerateRequest.Emplace();
+	Request.bEvaluateAttributes |= bEvaluateAttributes;
+	Request.bGenerateModel |= bGenerateModel;
+	// Only the latest request decides about the detail, the final change of an interaction therefore always generates the complete model
+	Request.bInteractive = bInteractive;
+	Request.DueTime = FPlatformTime::Seconds() + RegenerateDelay;
+}
+
+void UVitruvioComponent::ProcessGenerateRequest()
+{
+	if (!PendingGenerateRequest.IsSet() || FPlatformTime::Seconds() < PendingGenerateRequest->DueTime)
+	{
+		return;
+	}
+
+	// The ongoing call is not discarded since PRT can not abort it anyway, the request is executed as soon as its result has arrived
+	if (GenerateToken.IsValid() || EvalAttributesInvalidationToken.IsValid())
+	{
+		return;
+	}
+
+	const FGenerateRequest Request = PendingGenerateRequest.GetValue();
+	PendingGenerateRequest.Reset();
+
+	// Interactive requests reduce the model to what is cheap to build on the game thread, the final change generates the complete model
+	FGenerateOptions GenerateOptions;
+	GenerateOptions.bSkipCollision = Request.bInteractive;
+	GenerateOptions.bSkipInstances = Request.bInteractive;
+	GenerateOptions.bIgnoreMaterialReplacements = Request.bInteractive;
+	GenerateOptions.bIgnoreInstanceReplacements = Request.bInteractive;
+
+	if (Request.bEvaluateAttributes)
+	{
+		EvaluateRuleAttributes(Request.bGenerateModel, nullptr, GenerateOptions);
+	}
+	else if (Request.bGenerateModel)
+	{
+		Generate(nullptr, GenerateOptions);
+	}
+}
+
+void UVitruvioComponent::SetAttributeValues(const TMap<FString, FString>& NewAttributes)
+{
+	ApplyAttributeValues(this, NewAttributes);
+}
+
+void UVitruvioComponent::ApplyEvaluatedAttributes(const FAttributeMapPtr& AttributeMap)
+{
+	if (EvalAttributesInvalidationToken)
+	{
+		EvalAttributesInvalidationToken->Invalidate();
+		EvalAttributesInvalidationToken.Reset();
+	}
+
+	AttributeMap->UpdateUnrealAttributeMap(Attributes, this);
+
+	bAttributesReady = true;
+	bNotifyAttributeChange = true;
+
+	OnAttributesEvaluated.Broadcast();
+}
+
+FInitialShape UVitruvioComponent::CreateInitialShape() const
+{
+	return {FVector::ZeroVector, InitialShape->GetPolygon(), GetAttributeMap(), RandomSeed, Rpk};
+}
+
+AttributeMapSPtr UVitruvioComponent::GetAttributeMap() const
+{
+	// Only user set attributes are passed to PRT, applying evaluated attributes therefore does not outdate the map
+	if (!CachedAttributeMap || CachedAttributeMapGeneration != AttributesGeneration)
+	{
+		CachedAttributeMap = Vitruvio::CreateAttributeMap(Attributes);
+		CachedAttributeMapGeneration = AttributesGeneration;
+	}
+	return CachedAttributeMap;
+}
+
+FGenerateResultKey UVitruvioComponent::CreateGenerateResultKey(const FGeneratedCollisionSettings& GenerateCollisionSettings) const
+{
+	TArray<TPair<FString, FString>> AttributeValues;
+	AttributeValues.Reserve(Attributes.Num());
+	for (const auto& [AttributeName, Attribute] : Attributes)
+	{
+		AttributeValues.Emplace(AttributeName, Attribute ? Attribute->GetValueAsString() : FString());
+	}
+	AttributeValues.Sort([](const TPair<FString, FString>& A, const TPair<FString, FString>& B) {
+		return A.Key.Compare(B.Key, ESearchCase::CaseSensitive) < 0;
 	});
+
+	return FGenerateResultKey(Rpk, InitialShape->GetPolygon(), MoveTemp(AttributeValues), RandomSeed, GenerateCollisionSettings);
+}
+
+uint64 UVitruvioComponent::GetGenerateInputHash() const
+{
+	FXxHash64Builder Builder;
+	const uint64 RulePackageHash = Rpk ? Rpk->GetDataHash() : 0;
+	const uint64 PolygonHash = InitialShape ? Vitruvio::GetPolygonHash(InitialShape->GetPolygon()) : 0;
+	Builder.Update(&RulePackageHash, sizeof(RulePackageHash));
+	Builder.Update(&PolygonHash, sizeof(PolygonHash));
+
+	// Attribute values are case sensitive, so are their hashes
+	TArray<FString> AttributeNames;
+	Attributes.GenerateKeyArray(AttributeNames);
+	AttributeNames.Sort();
+	for (const FString& AttributeName : AttributeNames)
+	{
+		URuleAttribute* Attribute = Attributes[AttributeName];
+		Vitruvio::AppendStringHash(Builder, AttributeName);
+		Vitruvio::AppendStringHash(Builder, Attribute ? Attribute->GetValueAsString() : FString());
+	}
+
+	Builder.Update(&RandomSeed, sizeof(RandomSeed));
+	return Builder.Finalize().Hash;
 }
 
 void UVitruvioComponent::InitializeInitialShapeComponent()
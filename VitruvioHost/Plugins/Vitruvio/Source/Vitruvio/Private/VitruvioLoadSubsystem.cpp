@@ -0,0 +1,393 @@
+/* Copyright 2024 Esri
+ *
+ * Licensed under the Apache License Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "VitruvioLoadSubsystem.h"
+
+#include "Algo/StableSort.h"
+#include "Async/Async.h"
+#include "Engine/World.h"
+#include "VitruvioComponent.h"
+#include "VitruvioStats.h"
+
+namespace
+{
+// Larger groups need fewer PRT calls but delay the first visible models since a group is only generated after all of it has been evaluated
+constexpr int32 MaxComponentsPerEvaluation = 32;
+} // namespace
+
+UVitruvioLoadSubsystem::FOnLoadStarted UVitruvioLoadSubsystem::OnLoadStarted;
+UVitruvioLoadSubsystem::FOnLoadProgress UVitruvioLoadSubsystem::OnLoadProgress;
+UVitruvioLoadSubsystem::FOnLoadCompleted UVitruvioLoadSubsystem::OnLoadCompleted;
+
+void UVitruvioLoadSubsystem::Deinitialize()
+{
+	if (bLoading)
+	{
+		Cancel();
+	}
+
+	Super::Deinitialize();
+}
+
+void UVitruvioLoadSubsystem::OnWorldComponentsUpdated(UWorld& World)
+{
+	Super::OnWorldComponentsUpdated(World);
+
+	// Components are only initialized on their first tick, until then the Rule Packages can already be loaded in the background
+	PreloadRulePackages();
+}
+
+TStatId UVitruvioLoadSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UVitruvioLoadSubsystem, STATGROUP_Tickables);
+}
+
+void UVitruvioLoadSubsystem::Schedule(UVitruvioComponent* VitruvioComponent, bool bGenerateModel)
+{
+	if (!bLoading)
+	{
+		bLoading = true;
+		NumCompleted = 0;
+		NumTotal = 0;
+		PeakInFlightRequests = GetNumInFlightRequests();
+		LoadStartTime = FPlatformTime::Seconds();
+		TimeToFirstVisibleModel = -1.0;
+
+		OnLoadStarted.Broadcast(this);
+	}
+
+	PendingComponents.Add({VitruvioComponent, bGenerateModel});
+	++NumTotal;
+}
+
+void UVitruvioLoadSubsystem::Cancel()
+{
+	if (!bLoading)
+	{
+		return;
+	}
+
+	CompleteComponents(PendingComponents.Num() + EvaluatedComponents.Num());
+	PendingComponents.Empty();
+	EvaluatedComponents.Empty();
+
+	// Generates which have already been started complete on their own, evaluations of this load are only applied
+	GeneratingComponents.Empty();
+	++LoadId;
+
+	SET_DWORD_STAT(STAT_Vitruvio_PendingLoadComponents, 0);
+
+	FinishLoad(true);
+}
+
+void UVitruvioLoadSubsystem::RegisterVitruvioComponent(UVitruvioComponent* VitruvioComponent)
+{
+	RegisteredComponents.Add(VitruvioComponent);
+}
+
+void UVitruvioLoadSubsystem::UnregisterVitruvioComponent(UVitruvioComponent* VitruvioComponent)
+{
+	RegisteredComponents.Remove(VitruvioComponent);
+}
+
+void UVitruvioLoadSubsystem::PreloadRulePackages()
+{
+	TMap<URulePackage*, int32> NumComponentsByRpk;
+	for (const UVitruvioComponent* VitruvioComponent : RegisteredComponents)
+	{
+		URulePackage* RulePackage = VitruvioComponent->GetRpk();
+		if (RulePackage && !PreloadedRulePackages.Contains(RulePackage))
+		{
+			++NumComponentsByRpk.FindOrAdd(RulePackage);
+		}
+	}
+
+	if (NumComponentsByRpk.IsEmpty())
+	{
+		return;
+	}
+
+	NumComponentsByRpk.ValueSort([](int32 A, int32 B) { return A > B; });
+
+	TArray<URulePackage*> RulePackages;
+	NumComponentsByRpk.GenerateKeyArray(RulePackages);
+
+	// Loading fails while PRT is not initialized yet, the Rule Packages are then loaded once they are used
+	if (!VitruvioModule::Get().PreloadRulePackagesAsync(RulePackages))
+	{
+		return;
+	}
+
+	for (URulePackage* RulePackage : RulePackages)
+	{
+		PreloadedRulePackages.Add(RulePackage);
+	}
+
+	UE_LOG(LogVitruvioComponent, Log, TEXT("Preloading %d Rule Packages used by Vitruvio components"), RulePackages.Num());
+}
+
+void UVitruvioLoadSubsystem::NotifyModelRegistered(const UVitruvioComponent* VitruvioComponent)
+{
+	if (bLoading && TimeToFirstVisibleModel < 0.0)
+	{
+		TimeToFirstVisibleModel = FPlatformTime::Seconds() - LoadStartTime;
+	}
+}
+
+void UVitruvioLoadSubsystem::SetMaxInFlightRequests(int32 MaxRequests)
+{
+	MaxInFlightRequests = FMath::Max(0, MaxRequests);
+}
+
+int32 UVitruvioLoadSubsystem::GetMaxInFlightRequests() const
+{
+	return MaxInFlightRequests > 0 ? MaxInFlightRequests : FMath::Max(1, VitruvioModule::Get().GetNumWorkerThreads());
+}
+
+void UVitruvioLoadSubsystem::Tick(float DeltaTime)
+{
+	if (!bLoading)
+	{
+		return;
+	}
+
+	UpdateGeneratingComponents();
+
+	// Components which have already been evaluated are generated first so that models become visible as early as possible
+	StartGenerates();
+	StartEvaluations();
+
+	PeakInFlightRequests = FMath::Max(PeakInFlightRequests, GetNumInFlightRequests());
+	SET_DWORD_STAT(STAT_Vitruvio_PendingLoadComponents, PendingComponents.Num() + EvaluatedComponents.Num());
+
+	if (PendingComponents.IsEmpty() && EvaluatedComponents.IsEmpty() && GeneratingComponents.IsEmpty() && NumEvaluateRequestsInFlight == 0)
+	{
+		FinishLoad(false);
+	}
+}
+
+void UVitruvioLoadSubsystem::UpdateGeneratingComponents()
+{
+	int32 NumGenerated = 0;
+	for (int32 Index = GeneratingComponents.Num() - 1; Index >= 0; --Index)
+	{
+		const UVitruvioComponent* VitruvioComponent = GeneratingComponents[Index].Get();
+		if (!VitruvioComponent || !VitruvioComponent->HasPendingPrtCalls())
+		{
+			GeneratingComponents.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+			++NumGenerated;
+		}
+	}
+
+	CompleteComponents(NumGenerated);
+}
+
+void UVitruvioLoadSubsystem::StartGenerates()
+{
+	const int32 MaxRequests = GetMaxInFlightRequests();
+
+	int32 NumStarted = 0;
+	int32 NumSkipped = 0;
+	while (NumStarted + NumSkipped < EvaluatedComponents.Num() && GetNumInFlightRequests() < MaxRequests)
+	{
+		UVitruvioComponent* VitruvioComponent = EvaluatedComponents[NumStarted + NumSkipped].VitruvioComponent.Get();
+		if (!VitruvioComponent || !VitruvioComponent->HasValidInputData())
+		{
+			++NumSkipped;
+			continue;
+		}
+
+		VitruvioComponent->Generate();
+		GeneratingComponents.Add(VitruvioComponent);
+		++NumStarted;
+	}
+
+	EvaluatedComponents.RemoveAt(0, NumStarted + NumSkipped, EAllowShrinking::No);
+	CompleteComponents(NumSkipped);
+}
+
+void UVitruvioLoadSubsystem::StartEvaluations()
+{
+	const int32 MaxRequests = GetMaxInFlightRequests();
+	if (PendingComponents.IsEmpty() || GetNumInFlightRequests() >= MaxRequests)
+	{
+		return;
+	}
+
+	SortPendingComponents();
+
+	int32 NumSkipped = 0;
+	while (!PendingComponents.IsEmpty() && GetNumInFlightRequests() < MaxRequests)
+	{
+		// The highest priority component decides the Rule Package of the next evaluation
+		TArray<FScheduledComponent> Group;
+		TArray<FInitialShape> InitialShapes;
+		TArray<FScheduledComponent> Remaining;
+		Remaining.Reserve(PendingComponents.Num());
+
+		URulePackage* RulePackage = nullptr;
+		for (FScheduledComponent& ScheduledComponent : PendingComponents)
+		{
+			// Components which have been changed in the meantime have started their own evaluation
+			UVitruvioComponent* VitruvioComponent = ScheduledComponent.VitruvioComponent.Get();
+			if (!VitruvioComponent || !VitruvioComponent->HasValidInputData() || VitruvioComponent->HasPendingPrtCalls())
+			{
+				++NumSkipped;
+				continue;
+			}
+
+			if (!RulePackage)
+			{
+				RulePackage = VitruvioComponent->GetRpk();
+			}
+
+			if (Group.Num() < MaxComponentsPerEvaluation && VitruvioComponent->GetRpk() == RulePackage)
+			{
+				InitialShapes.Add(VitruvioComponent->CreateInitialShape());
+				Group.Add(MoveTemp(ScheduledComponent));
+			}
+			else
+			{
+				Remaining.Add(MoveTemp(ScheduledComponent));
+			}
+		}
+		PendingComponents = MoveTemp(Remaining);
+
+		if (Group.IsEmpty())
+		{
+			break;
+		}
+
+		++NumEvaluateRequestsInFlight;
+		FBatchAttributeMapResult AttributesResult = VitruvioModule::Get().BatchEvaluateRuleAttributesAsync(MoveTemp(InitialShapes));
+
+		// clang-format off
+		AttributesResult.Result.Next([WeakThis = TWeakObjectPtr<UVitruvioLoadSubsystem>(this), Group = MoveTemp(Group), EvaluationLoadId = LoadId]
+			(const FBatchAttributeMapResult::ResultType& Result)
+		{
+			AsyncTask(ENamedThreads::GameThread, [WeakThis, Group, EvaluationLoadId, AttributeMaps = Result.Value]()
+			{
+				if (WeakThis.IsValid())
+				{
+					WeakThis->CompleteEvaluation(Group, AttributeMaps, EvaluationLoadId);
+				}
+			});
+		});
+		// clang-format on
+	}
+
+	CompleteComponents(NumSkipped);
+}
+
+void UVitruvioLoadSubsystem::SortPendingComponents()
+{
+	const TArray<FVector>& ViewLocations = GetWorld()->ViewLocationsRenderedLastFrame;
+
+	for (FScheduledComponent& ScheduledComponent : PendingComponents)
+	{
+		const UVitruvioComponent* VitruvioComponent = ScheduledComponent.VitruvioComponent.Get();
+		const AActor* Owner = VitruvioComponent ? VitruvioComponent->GetOwner() : nullptr;
+		if (!Owner)
+		{
+			continue;
+		}
+
+#if WITH_EDITOR
+		ScheduledComponent.bSelected = Owner->IsSelected();
+#endif
+
+		// Without any viewer (eg. before the first frame has been rendered) the components keep the order in which they have been scheduled
+		ScheduledComponent.DistanceSquared = ViewLocations.IsEmpty() ? 0.0 : TNumericLimits<double>::Max();
+		for (const FVector& ViewLocation : ViewLocations)
+		{
+			ScheduledComponent.DistanceSquared = FMath::Min(ScheduledComponent.DistanceSquared, FVector::DistSquared(ViewLocation, Owner->GetActorLocation()));
+		}
+	}
+
+	Algo::StableSort(PendingComponents, [](const FScheduledComponent& A, const FScheduledComponent& B) {
+		if (A.bSelected != B.bSelected)
+		{
+			return A.bSelected;
+		}
+		return A.DistanceSquared < B.DistanceSquared;
+	});
+}
+
+void UVitruvioLoadSubsystem::CompleteEvaluation(const TArray<FScheduledComponent>& Components, const TArray<FAttributeMapPtr>& AttributeMaps,
+												uint32 EvaluationLoadId)
+{
+	--NumEvaluateRequestsInFlight;
+
+	const bool bCancelled = EvaluationLoadId != LoadId;
+
+	int32 NumFailed = 0;
+	for (int32 ComponentIndex = 0; ComponentIndex < Components.Num(); ++ComponentIndex)
+	{
+		// The evaluation is outdated if the component has been changed in the meantime
+		UVitruvioComponent* VitruvioComponent = Components[ComponentIndex].VitruvioComponent.Get();
+		if (!VitruvioComponent || VitruvioComponent->HasPendingPrtCalls() || !AttributeMaps.IsValidIndex(ComponentIndex) ||
+			!AttributeMaps[ComponentIndex])
+		{
+			++NumFailed;
+			continue;
+		}
+
+		VitruvioComponent->ApplyEvaluatedAttributes(AttributeMaps[ComponentIndex]);
+
+		if (bCancelled)
+		{
+			continue;
+		}
+
+		if (Components[ComponentIndex].bGenerateModel)
+		{
+			EvaluatedComponents.Add(Components[ComponentIndex]);
+		}
+		else
+		{
+			CompleteComponents(1);
+		}
+	}
+
+	if (!bCancelled)
+	{
+		CompleteComponents(NumFailed);
+	}
+}
+
+void UVitruvioLoadSubsystem::CompleteComponents(int32 Num)
+{
+	if (Num <= 0)
+	{
+		return;
+	}
+
+	NumCompleted += Num;
+
+	OnLoadProgress.Broadcast(this, NumCompleted, NumTotal);
+}
+
+void UVitruvioLoadSubsystem::FinishLoad(bool bCancelled)
+{
+	bLoading = false;
+
+	UE_LOG(LogVitruvioComponent, Log,
+		   TEXT("%s loading %d Vitruvio components after %.2f s (first visible model after %.2f s, at most %d PRT calls in flight)"),
+		   bCancelled ? TEXT("Cancelled") : TEXT("Finished"), NumTotal, FPlatformTime::Seconds() - LoadStartTime, TimeToFirstVisibleModel,
+		   PeakInFlightRequests);
+
+	OnLoadCompleted.Broadcast(this, bCancelled);
+}
@@ -18,8 +18,10 @@
 #include "Materials/Material.h"
 #include "StaticMeshAttributes.h"
 #include "VitruvioModule.h"
+#include "VitruvioStats.h"
 #include "PhysicsEngine/BodySetup.h"
 #include "Engine/CollisionProfile.h"
+#include "GeneratedCollisionMesh.h"
 #include "UObject/Package.h"
 
 namespace
@@ -39,12 +41,42 @@ FString MakeUniqueMaterialName(FString Name, TMap<FString, int32>& UniqueMateria
 	return Name;
 }
 
-void InitializeBodySetup(UBodySetup* BodySetup)
+void InitializeBodySetup(UBodySetup* BodySetup, const FCollisionData& CollisionData)
 {
 	BodySetup->DefaultInstance.SetCollisionProfileName(UCollisionProfile::BlockAll_ProfileName);
-	BodySetup->CollisionTraceFlag = ECollisionTraceFlag::CTF_UseComplexAsSimple;
 	BodySetup->bDoubleSidedGeometry = true;
 	BodySetup->bMeshCollideAll = true;
+
+	if (CollisionData.HasSimpleCollision() || CollisionData.CollisionType == EGeneratedCollisionType::None)
+	{
+		// Simple shapes only, an empty aggregate geometry results in a mesh without any collision
+		BodySetup->CollisionTraceFlag = ECollisionTraceFlag::CTF_UseSimpleAsComplex;
+
+		for (const FBox3f& Box : CollisionData.Boxes)
+		{
+			const FVector3f Size = Box.GetSize();
+			FKBoxElem BoxElem(Size.X, Size.Y, Size.Z);
+			BoxElem.Center = FVector(Box.GetCenter());
+			BodySetup->AggGeom.BoxElems.Add(BoxElem);
+		}
+
+		for (const TArray<FVector3f>& ConvexHull : CollisionData.ConvexHulls)
+		{
+			FKConvexElem ConvexElem;
+			ConvexElem.VertexData.Reserve(ConvexHull.Num());
+			for (const FVector3f& Point : ConvexHull)
+			{
+				ConvexElem.VertexData.Add(FVector(Point));
+			}
+			ConvexElem.UpdateElemBox();
+			BodySetup->AggGeom.ConvexElems.Add(ConvexElem);
+		}
+	}
+	else
+	{
+		BodySetup->CollisionTraceFlag = ECollisionTraceFlag::CTF_UseComplexAsSimple;
+	}
+
 	BodySetup->InvalidatePhysicsData();
 	BodySetup->CreatePhysicsMeshes();
 }
@@ -73,11 +105,21 @@ UMaterialInstanceDynamic* CacheMaterial(UMaterial* OpaqueParent, UMaterial* Mask
 																		   TranslucentParent, MaterialAttributes, TextureCache);
 
 	MaterialCache.Add(MaterialAttributes, Material);
+	INC_MEMORY_STAT_BY(STAT_Vitruvio_MaterialCacheMemory, Material->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal));
 	MaterialIdentifiers.Add(Material, MaterialIdentifier);
 
 	return Material;
 }
 
+SIZE_T FVitruvioMesh::GetAllocatedSize() const
+{
+	// Position per vertex and normal, tangent, binormal sign, color and 8 uv channels per vertex instance
+	constexpr SIZE_T VertexInstanceSize = 2 * sizeof(FVector3f) + sizeof(float) + sizeof(FVector4f) + 8 * sizeof(FVector2f);
+	return MeshDescription.Vertices().Num() * sizeof(FVector3f) + MeshDescription.VertexInstances().Num() * VertexInstanceSize +
+		   MeshDescription.Triangles().Num() * 3 * sizeof(FVertexInstanceID) + (CollisionData ? CollisionData->GetAllocatedSize() : 0) +
+		   Materials.GetAllocatedSize();
+}
+
 FVitruvioMesh::~FVitruvioMesh()
 {
 	if (IsEngineExitRequested())
@@ -99,9 +141,17 @@ void FVitruvioMesh::Build(const FString& Name, TMap<Vitruvio::FMaterialAttribute
 
 	if (StaticMesh)
 	{
+		// Meshes shared by several components are only built once, but every component needs the identifiers of their materials
+		for (const Vitruvio::FMaterialAttributeContainer& MaterialAttributes : Materials)
+		{
+			CacheMaterial(OpaqueParent, MaskedParent, TranslucentParent, TextureCache, MaterialCache, MaterialAttributes, UniqueMaterialNames,
+						  UniqueMaterialIdentifiers, StaticMesh);
+		}
 		return;
 	}
 
+	SCOPE_CYCLE_COUNTER(STAT_Vitruvio_BuildStaticMesh);
+
 	FString MeshName = Name.Replace(TEXT("."), TEXT(""));
 	const FName StaticMeshName = MakeUniqueObjectName(nullptr, UStaticMesh::StaticClass(), FName(MeshName));
 	StaticMesh = NewObject<UStaticMesh>(GetTransientPackage(), StaticMeshName, RF_Transient | RF_DuplicateTransient | RF_TextExportTransient);
@@ -111,14 +161,6 @@ void FVitruvioMesh::Build(const FString& Name, TMap<Vitruvio::FMaterialAttribute
 
 	FStaticMeshAttributes MeshAttributes(MeshDescription);
 
-	TArray<FVector3f> Vertices;
-	auto VertexPositions = MeshAttributes.GetVertexPositions();
-	for (int32 VertexIndex = 0; VertexIndex < VertexPositions.GetNumElements(); ++VertexIndex)
-	{
-		Vertices.Add(VertexPositions[FVertexID(VertexIndex)]);
-	}
-
-	TArray<FTriIndices> Indices;
 	const auto PolygonGroups = MeshDescription.PolygonGroups();
 	size_t MaterialIndex = 0;
 
@@ -132,25 +174,6 @@ void FVitruvioMesh::Build(const FString& Name, TMap<Vitruvio::FMaterialAttribute
 		MaterialSlots.Add(Material, SlotName);
 
 		++MaterialIndex;
-
-		// cache collision data
-		for (FPolygonID PolygonID : MeshDescription.GetPolygonGroupPolygonIDs(PolygonGroupId))
-		{
-			for (FTriangleID TriangleID : MeshDescription.GetPolygonTriangles(PolygonID))
-			{
-				auto TriangleVertexInstances = MeshDescription.GetTriangleVertexInstances(TriangleID);
-
-				auto VertexID0 = MeshDescription.GetVertexInstanceVertex(TriangleVertexInstances[0]);
-				auto VertexID1 = MeshDescription.GetVertexInstanceVertex(TriangleVertexInstances[1]);
-				auto VertexID2 = MeshDescription.GetVertexInstanceVertex(TriangleVertexInstances[2]);
-
-				FTriIndices TriIndex;
-				TriIndex.v0 = VertexID0.GetValue();
-				TriIndex.v1 = VertexID1.GetValue();
-				TriIndex.v2 = VertexID2.GetValue();
-				Indices.Add(TriIndex);
-			}
-		}
 	}
 
 	TArray<const FMeshDescription*> MeshDescriptionPtrs;
@@ -161,9 +184,25 @@ void FVitruvioMesh::Build(const FString& Name, TMap<Vitruvio::FMaterialAttribute
 	Params.bFastBuild = true;
 	Params.bAllowCpuAccess = true;
 	StaticMesh->BuildFromMeshDescriptions(MeshDescriptionPtrs, Params);
-	CollisionData = {Indices, Vertices};
-	
-	UBodySetup* BodySetup = NewObject<UBodySetup>(StaticMesh, NAME_None, RF_Transient | RF_DuplicateTransient | RF_TextExportTransient | RF_Transactional);
-	InitializeBodySetup(BodySetup);
+
+	// The collision data has already been created on the worker thread which created this mesh, see Vitruvio::CreateCollisionData
+	UObject* CollisionOuter = StaticMesh;
+	UGeneratedCollisionMesh* CollisionMesh = nullptr;
+	if (CollisionData->CollisionType == EGeneratedCollisionType::SimplifiedMesh)
+	{
+		// Cook the complex collision from the simplified triangles instead of the render data of the static mesh
+		CollisionMesh = NewObject<UGeneratedCollisionMesh>(StaticMesh, NAME_None, RF_Transient);
+		CollisionMesh->SetCollisionData(CollisionData);
+		CollisionOuter = CollisionMesh;
+	}
+
+	UBodySetup* BodySetup = NewObject<UBodySetup>(CollisionOuter, NAME_None, RF_Transient | RF_DuplicateTransient | RF_TextExportTransient | RF_Transactional);
+	InitializeBodySetup(BodySetup, *CollisionData);
+
+	// The cooked geometry is owned by the body setup, the cooking input does not need to be kept alive anymore
+	if (CollisionMesh && BodySetup->bCreatedPhysicsMeshes && !BodySetup->bFailedToCreatePhysicsMeshes)
+	{
+		CollisionMesh->ReleaseCollisionData();
+	}
 	StaticMesh->SetBodySetup(BodySetup);
 }
\ No newline at end of file
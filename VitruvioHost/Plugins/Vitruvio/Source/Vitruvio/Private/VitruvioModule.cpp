@@ -21,13 +21,18 @@
 #include "PRTUtils.h"
 #include "TextureDecoding.h"
 #include "UnrealCallbacks.h"
+#include "VitruvioStats.h"
 
+#include "Util/CacheEviction.h"
 #include "Util/PolygonWindings.h"
 
 #include "Async/Async.h"
+#include "Async/ParallelFor.h"
+#include "Async/TaskGraphInterfaces.h"
 #include "HAL/FileManager.h"
 #include "HAL/PlatformFileManager.h"
 #include "Interfaces/IPluginManager.h"
+#include "Misc/ScopeExit.h"
 #include "Modules/ModuleManager.h"
 
 #include "UObject/UObjectBaseUtility.h"
@@ -36,15 +41,41 @@
 
 DEFINE_LOG_CATEGORY(LogUnrealPrt);
 
+DEFINE_STAT(STAT_Vitruvio_LoadResolveMap);
+DEFINE_STAT(STAT_Vitruvio_EvaluateAttributes);
+DEFINE_STAT(STAT_Vitruvio_Generate);
+DEFINE_STAT(STAT_Vitruvio_BatchGenerate);
+DEFINE_STAT(STAT_Vitruvio_ConvertMesh);
+DEFINE_STAT(STAT_Vitruvio_CreateVitruvioMesh);
+DEFINE_STAT(STAT_Vitruvio_CreateCollision);
+DEFINE_STAT(STAT_Vitruvio_BuildStaticMesh);
+DEFINE_STAT(STAT_Vitruvio_CreateMaterial);
+DEFINE_STAT(STAT_Vitruvio_LoadTexture);
+DEFINE_STAT(STAT_Vitruvio_DecodeTexture);
+DEFINE_STAT(STAT_Vitruvio_ProcessGenerateQueue);
+
+DEFINE_STAT(STAT_Vitruvio_MeshCacheMemory);
+DEFINE_STAT(STAT_Vitruvio_MaterialCacheMemory);
+DEFINE_STAT(STAT_Vitruvio_TextureCacheMemory);
+DEFINE_STAT(STAT_Vitruvio_ResolveMapCacheMemory);
+DEFINE_STAT(STAT_Vitruvio_GenerateResultCacheEntries);
+
+DEFINE_STAT(STAT_Vitruvio_InFlightGenerates);
+DEFINE_STAT(STAT_Vitruvio_InFlightEvaluations);
+DEFINE_STAT(STAT_Vitruvio_LoadingRpks);
+DEFINE_STAT(STAT_Vitruvio_GenerateQueueDepth);
+DEFINE_STAT(STAT_Vitruvio_AttributesQueueDepth);
+DEFINE_STAT(STAT_Vitruvio_PendingLoadComponents);
+
 #define CHECK_PRT_INITIALIZED()                                                                                                                      \
-    if (!Initialized)                                                                                                                                \
+    if (!CanGenerate())                                                                                                                              \
     {                                                                                                                                                \
         UE_LOG(LogUnrealPrt, Warning, TEXT("PRT not initialized"))                                                                                   \
         return {};                                                                                                                                   \
     }
 
 #define CHECK_PRT_INITIALIZED_ASYNC(RESULT_CLASS, TOKEN_VAR)                                                                                         \
-    if (!Initialized)                                                                                                                                \
+    if (!CanGenerate())                                                                                                                              \
     {                                                                                                                                                \
         UE_LOG(LogUnrealPrt, Warning, TEXT("PRT not initialized"))                                                                                   \
         TPromise<RESULT_CLASS::ResultType> Result;                                                                                                   \
@@ -55,28 +86,33 @@ DEFINE_LOG_CATEGORY(LogUnrealPrt);
 namespace
 {
 constexpr const wchar_t* ATTRIBUTE_EVAL_ENCODER_ID = L"com.esri.prt.core.AttributeEvalEncoder";
+constexpr const wchar_t* CGA_REPORT_ENCODER_ID = L"com.esri.prt.core.CGAReportEncoder";
 
-struct FStartRuleInfo
+// The initial shapes of a batch which use the same Rule Package
+struct FRulePackageBatch
 {
-	ResolveMapSPtr ResolveMap;
-	FString RuleFile;
-	FString StartRule;
-	RuleFileInfoPtr RuleFileInfo;
+	URulePackage* RulePackage = nullptr;
+	TArray<FInitialShape> InitialShapes;
+	// Index of every initial shape in the whole batch
+	TArray<int32> BatchIndices;
+
+	FLoadedRulePackagePtr LoadedRulePackage;
+	TArray<InitialShapeBuilderUPtr> InitialShapeBuilders;
+	InitialShapeUPtrVector EvaluateInitialShapes;
 };
 
 class FLoadResolveMapTask
 {
 	TLazyObjectPtr<URulePackage> LazyRulePackagePtr;
-	TPromise<ResolveMapSPtr> Promise;
-	TMap<TLazyObjectPtr<URulePackage>, ResolveMapSPtr>& ResolveMapCache;
-	FCriticalSection& LoadResolveMapLock;
+	TUniqueFunction<void(const FLoadedRulePackagePtr&)> OnLoaded;
 	FString RpkFolder;
+	prt::Cache* Cache;
+	FGenerateBackendPtr Backend;
 
 public:
-	FLoadResolveMapTask(TPromise<ResolveMapSPtr>&& InPromise, const FString RpkFolder, const TLazyObjectPtr<URulePackage> LazyRulePackagePtr,
-						TMap<TLazyObjectPtr<URulePackage>, ResolveMapSPtr>& ResolveMapCache, FCriticalSection& LoadResolveMapLock)
-		: LazyRulePackagePtr(LazyRulePackagePtr), Promise(MoveTemp(InPromise)), ResolveMapCache(ResolveMapCache),
-		  LoadResolveMapLock(LoadResolveMapLock), RpkFolder(RpkFolder)
+	FLoadResolveMapTask(const FString RpkFolder, const TLazyObjectPtr<URulePackage> LazyRulePackagePtr, prt::Cache* Cache,
+						const FGenerateBackendPtr& Backend, TUniqueFunction<void(const FLoadedRulePackagePtr&)>&& InOnLoaded)
+		: LazyRulePackagePtr(LazyRulePackagePtr), OnLoaded(MoveTemp(InOnLoaded)), RpkFolder(RpkFolder), Cache(Cache), Backend(Backend)
 	{
 	}
 
@@ -96,11 +132,39 @@ public:
 
 	static ESubsequentsMode::Type GetSubsequentsMode()
 	{
-		return ESubsequentsMode::TrackSubsequents;
+		return ESubsequentsMode::FireAndForget;
 	}
 
 	void DoTask(ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
 	{
+		SCOPE_CYCLE_COUNTER(STAT_Vitruvio_LoadResolveMap);
+
+		// A failed load is reported as nullptr to everyone waiting for it
+		OnLoaded(Backend ? LoadWithBackend() : LoadResolveMap());
+	}
+
+private:
+	FLoadedRulePackagePtr LoadWithBackend() const
+	{
+		// The backend keeps its own state, only the fact that the Rule Package has been loaded is cached
+		URulePackage* RulePackage = LazyRulePackagePtr.Get();
+		if (!RulePackage || !Backend->LoadRulePackage(RulePackage))
+		{
+			UE_LOG(LogUnrealPrt, Error, TEXT("Generate backend could not load Rule Package %s"), *LazyRulePackagePtr.ToSoftObjectPath().ToString())
+			return {};
+		}
+
+		return MakeShared<const FLoadedRulePackage, ESPMode::ThreadSafe>();
+	}
+
+	FLoadedRulePackagePtr LoadResolveMap() const
+	{
+		if (!LazyRulePackagePtr.IsValid())
+		{
+			UE_LOG(LogUnrealPrt, Error, TEXT("Rule Package %s is not loaded"), *LazyRulePackagePtr.ToSoftObjectPath().ToString())
+			return {};
+		}
+
 		const FString UriPath = LazyRulePackagePtr->GetPathName();
 
 		// Create rpk on disk for PRT
@@ -114,29 +178,48 @@ public:
 		PlatformFile.CreateDirectoryTree(*RpkFolderPath);
 
 		IFileHandle* RpkHandle = PlatformFile.OpenWrite(*RpkFilePath);
-		if (RpkHandle)
+		if (!RpkHandle)
 		{
-			// Write file to disk
-			RpkHandle->Write(LazyRulePackagePtr->Data.GetData(), LazyRulePackagePtr->Data.Num());
-			RpkHandle->Flush();
-			delete RpkHandle;
+			UE_LOG(LogUnrealPrt, Error, TEXT("Could not write Rule Package to %s"), *RpkFilePath)
+			return {};
+		}
 
-			// Create rpk
-			const std::wstring AbsoluteRpkPath(TCHAR_TO_WCHAR(*FPaths::ConvertRelativePathToFull(RpkFilePath)));
+		// Write file to disk
+		RpkHandle->Write(LazyRulePackagePtr->Data.GetData(), LazyRulePackagePtr->Data.Num());
+		RpkHandle->Flush();
+		delete RpkHandle;
 
-			const std::wstring RpkFileUri = prtu::toFileURI(AbsoluteRpkPath);
-			prt::Status Status;
-			const ResolveMapSPtr ResolveMapPtr(prt::createResolveMap(RpkFileUri.c_str(), nullptr, &Status), PRTDestroyer());
-			{
-				FScopeLock Lock(&LoadResolveMapLock);
-				ResolveMapCache.Add(LazyRulePackagePtr, ResolveMapPtr);
-				Promise.SetValue(ResolveMapPtr);
-			}
+		// Create rpk
+		const std::wstring AbsoluteRpkPath(TCHAR_TO_WCHAR(*FPaths::ConvertRelativePathToFull(RpkFilePath)));
+
+		const std::wstring RpkFileUri = prtu::toFileURI(AbsoluteRpkPath);
+		prt::Status Status = prt::STATUS_UNSPECIFIED_ERROR;
+		const ResolveMapSPtr ResolveMapPtr(prt::createResolveMap(RpkFileUri.c_str(), nullptr, &Status), PRTDestroyer());
+		if (!ResolveMapPtr || Status != prt::STATUS_OK)
+		{
+			UE_LOG(LogUnrealPrt, Error, TEXT("Could not create resolve map for %s: %hs"), *UriPath, prt::getStatusDescription(Status))
+			return {};
+		}
+
+		// The rule file info and start rule are created once here instead of by every evaluate and generate call
+		const std::wstring RuleFile = ResolveMapPtr->findCGBKey();
+		const wchar_t* RuleFileUri = ResolveMapPtr->getString(RuleFile.c_str());
+		if (!RuleFileUri)
+		{
+			UE_LOG(LogUnrealPrt, Error, TEXT("Rule Package %s does not contain a rule file"), *UriPath)
+			return {};
 		}
-		else
+
+		Status = prt::STATUS_UNSPECIFIED_ERROR;
+		const RuleFileInfoPtr RuleFileInfo = prt_make_shared<const prt::RuleFileInfo>(prt::createRuleFileInfo(RuleFileUri, Cache, &Status));
+		if (!RuleFileInfo || Status != prt::STATUS_OK)
 		{
-			Promise.SetValue(nullptr);
+			UE_LOG(LogUnrealPrt, Error, TEXT("could not get rule file info from rule file %s: %hs"), RuleFileUri, prt::getStatusDescription(Status))
+			return {};
 		}
+
+		return MakeShared<const FLoadedRulePackage, ESPMode::ThreadSafe>(
+			FLoadedRulePackage{ResolveMapPtr, RuleFileInfo, RuleFile, prtu::detectStartRule(RuleFileInfo)});
 	}
 };
 
@@ -219,30 +302,50 @@ void SetInitialShapeGeometry(const InitialShapeBuilderUPtr& InitialShapeBuilder,
 	}
 }
 
-AttributeMapUPtr EvaluateRuleAttributes(const std::wstring& RuleFile, const std::wstring& StartRule, 
-										const ResolveMapSPtr& ResolveMapPtr, const FInitialShape& InitialShape, prt::Cache* Cache)
+TArray<AttributeMapUPtr> EvaluateRuleAttributes(const std::wstring& RuleFile, const std::wstring& StartRule,
+	const ResolveMapSPtr& ResolveMapPtr, const TArray<const FInitialShape*>& InitialShapes, prt::Cache* Cache)
 {
-	TArray<AttributeMapBuilderUPtr> AttributeMapBuilders;
-	AttributeMapBuilders.Add(AttributeMapBuilderUPtr(prt::AttributeMapBuilder::create()));
-	UnrealCallbacks UnrealCallbacks(AttributeMapBuilders);
+	SCOPE_CYCLE_COUNTER(STAT_Vitruvio_EvaluateAttributes);
 
-	InitialShapeBuilderUPtr InitialShapeBuilder(prt::InitialShapeBuilder::create());
+	TArray<AttributeMapBuilderUPtr> AttributeMapBuilders;
+	InitialShapeUPtrVector InitialShapeUPtrs;
+	InitialShapeNOPtrVector InitialShapePtrs;
+	for (const FInitialShape* InitialShape : InitialShapes)
+	{
+		AttributeMapBuilders.Add(AttributeMapBuilderUPtr(prt::AttributeMapBuilder::create()));
 
-	SetInitialShapeGeometry(InitialShapeBuilder, InitialShape);
+		InitialShapeBuilderUPtr InitialShapeBuilder(prt::InitialShapeBuilder::create());
+		SetInitialShapeGeometry(InitialShapeBuilder, *InitialShape);
+		InitialShapeBuilder->setAttributes(RuleFile.c_str(), StartRule.c_str(), InitialShape->RandomSeed, L"", InitialShape->Attributes.get(),
+			ResolveMapPtr.get());
 
-	InitialShapeBuilder->setAttributes(RuleFile.c_str(), StartRule.c_str(), InitialShape.RandomSeed, L"", InitialShape.Attributes.get(), ResolveMapPtr.get());
+		InitialShapeUPtr Shape(InitialShapeBuilder->createInitialShapeAndReset());
+		InitialShapePtrs.push_back(Shape.get());
+		InitialShapeUPtrs.push_back(std::move(Shape));
+	}
 
-	const InitialShapeUPtr Shape(InitialShapeBuilder->createInitialShapeAndReset());
-	const InitialShapeNOPtrVector InitialShapes = {Shape.get()};
+	UnrealCallbacks UnrealCallbacks(AttributeMapBuilders);
 
 	const std::vector<const wchar_t*> EncoderIds = {ATTRIBUTE_EVAL_ENCODER_ID};
 	const AttributeMapUPtr AttributeEncodeOptions = prtu::createValidatedOptions(ATTRIBUTE_EVAL_ENCODER_ID);
 	const AttributeMapNOPtrVector EncoderOptions = {AttributeEncodeOptions.get()};
 
-	generate(InitialShapes.data(), InitialShapes.size(), nullptr, EncoderIds.data(), EncoderIds.size(), EncoderOptions.data(), &UnrealCallbacks,
-				  Cache, nullptr);
+	generate(InitialShapePtrs.data(), InitialShapePtrs.size(), nullptr, EncoderIds.data(), EncoderIds.size(), EncoderOptions.data(),
+		&UnrealCallbacks, Cache, nullptr);
 
-	return AttributeMapUPtr(AttributeMapBuilders[0]->createAttributeMap());
+	TArray<AttributeMapUPtr> AttributeMaps;
+	for (const AttributeMapBuilderUPtr& AttributeMapBuilder : AttributeMapBuilders)
+	{
+		AttributeMaps.Add(AttributeMapUPtr(AttributeMapBuilder->createAttributeMap()));
+	}
+	return AttributeMaps;
+}
+
+AttributeMapUPtr EvaluateRuleAttributes(const std::wstring& RuleFile, const std::wstring& StartRule, 
+										const ResolveMapSPtr& ResolveMapPtr, const FInitialShape& InitialShape, prt::Cache* Cache)
+{
+	TArray<AttributeMapUPtr> AttributeMaps = EvaluateRuleAttributes(RuleFile, StartRule, ResolveMapPtr, {&InitialShape}, Cache);
+	return MoveTemp(AttributeMaps[0]);
 }
 
 void CleanupTempRpkFolder()
@@ -328,6 +431,7 @@ void VitruvioModule::InitializePrt()
 
 	const FString TempDir(WCHAR_TO_TCHAR(prtu::temp_directory_path().c_str()));
 	RpkFolder = FPaths::CreateTempFilename(*TempDir, TEXT("Vitruvio_"), TEXT(""));
+	RpkFolderUri = WCHAR_TO_TCHAR(prtu::toFileURI(TCHAR_TO_WCHAR(*FPaths::ConvertRelativePathToFull(RpkFolder))).c_str());
 }
 
 void VitruvioModule::StartupModule()
@@ -341,6 +445,68 @@ void VitruvioModule::StartupModule()
 	InitializePrt();
 }
 
+bool VitruvioModule::InitializeForCommandlet()
+{
+	check(IsInGameThread());
+
+	if (!Initialized && !PrtLibrary)
+	{
+		InitializePrt();
+	}
+
+	return Initialized;
+}
+
+void VitruvioModule::SetMaxWorkerThreads(int32 NumThreads)
+{
+	MaxWorkerThreads.Set(FMath::Max(0, NumThreads));
+}
+
+int32 VitruvioModule::GetNumWorkerThreads() const
+{
+	const int32 MaxThreads = MaxWorkerThreads.GetValue();
+	return MaxThreads > 0 ? FMath::Min(MaxThreads, FPlatformMisc::NumberOfCores()) : FPlatformMisc::NumberOfCores();
+}
+
+void VitruvioModule::SetGenerateBackend(const FGenerateBackendPtr& Backend)
+{
+	ensureMsgf(!IsGenerating() && !IsLoadingRpks() && LoadAttributesCounter.GetValue() == 0,
+			   TEXT("The generate backend must not be changed while calls are in flight"));
+
+	{
+		FScopeLock Lock(&GenerateBackendLock);
+		GenerateBackend = Backend;
+	}
+
+	// The loaded Rule Packages belong to the previous backend
+	TArray<FLoadedRulePackagePtr> EvictedRulePackages;
+	{
+		FWriteScopeLock WriteLock(ResolveMapCacheLock);
+		for (const auto& [LazyRulePackagePtr, Entry] : ResolveMapCache)
+		{
+			EvictedRulePackages.Add(Entry.LoadedRulePackage);
+		}
+		ResolveMapCache.Empty();
+		SET_MEMORY_STAT(STAT_Vitruvio_ResolveMapCacheMemory, 0);
+	}
+
+	for (const FLoadedRulePackagePtr& EvictedRulePackage : EvictedRulePackages)
+	{
+		FlushPrtCache(EvictedRulePackage);
+	}
+}
+
+FGenerateBackendPtr VitruvioModule::GetGenerateBackend() const
+{
+	FScopeLock Lock(&GenerateBackendLock);
+	return GenerateBackend;
+}
+
+bool VitruvioModule::CanGenerate() const
+{
+	return Initialized || GetGenerateBackend().IsValid();
+}
+
 void VitruvioModule::ShutdownModule()
 {
 	if (!Initialized)
@@ -378,6 +544,8 @@ void VitruvioModule::ShutdownModule()
 
 Vitruvio::FTextureData VitruvioModule::DecodeTexture(UObject* Outer, const FString& Path, const FString& Key) const
 {
+	TRACE_CPUPROFILER_EVENT_SCOPE(VitruvioModule::DecodeTexture);
+
 	const prt::AttributeMap* TextureMetadataAttributeMap = prt::createTextureMetadata(*Path, PrtCache.get());
 	Vitruvio::FTextureMetadata TextureMetadata = Vitruvio::ParseTextureMetadata(TextureMetadataAttributeMap);
 
@@ -389,21 +557,21 @@ Vitruvio::FTextureData VitruvioModule::DecodeTexture(UObject* Outer, const FStri
 	return Vitruvio::DecodeTexture(Outer, Key, Path, TextureMetadata, std::move(Buffer), BufferSize);
 }
 
-FBatchGenerateResult VitruvioModule::BatchGenerateAsync(TArray<FInitialShape> InitialShapes) const
+FBatchGenerateResult VitruvioModule::BatchGenerateAsync(TArray<FInitialShape> InitialShapes, FGeneratedCollisionSettings CollisionSettings) const
 {
     const FBatchGenerateResult::FTokenPtr Token = MakeShared<FGenerateToken>();
     	
 	CHECK_PRT_INITIALIZED_ASYNC(FBatchGenerateResult, Token)
 
-	FBatchGenerateResult::FFutureType ResultFuture = Async(EAsyncExecution::Thread, [this, Token, InitialShapes = MoveTemp(InitialShapes)]() mutable {
-		FGenerateResultDescription Result = BatchGenerate(MoveTemp(InitialShapes));
+	FBatchGenerateResult::FFutureType ResultFuture = Async(EAsyncExecution::Thread, [this, Token, InitialShapes = MoveTemp(InitialShapes), CollisionSettings]() mutable {
+		FGenerateResultDescription Result = BatchGenerate(MoveTemp(InitialShapes), CollisionSettings);
 		return FBatchGenerateResult::ResultType { Token, MoveTemp(Result) };
 	});
 
 	return FBatchGenerateResult { MoveTemp(ResultFuture), Token };
 }
 
-FGenerateResultDescription VitruvioModule::BatchGenerate(TArray<FInitialShape> InitialShapes) const
+FGenerateResultDescription VitruvioModule::BatchGenerate(TArray<FInitialShape> InitialShapes, const FGeneratedCollisionSettings& CollisionSettings) const
 {
 	if (InitialShapes.IsEmpty())
 	{
@@ -412,74 +580,200 @@ FGenerateResultDescription VitruvioModule::BatchGenerate(TArray<FInitialShape> I
 	
 	CHECK_PRT_INITIALIZED()
 
+	SCOPE_CYCLE_COUNTER(STAT_Vitruvio_BatchGenerate);
+
+	const FGenerateBackendPtr Backend = GetGenerateBackend();
+
 	GenerateCallsCounter.Add(InitialShapes.Num());
+	INC_DWORD_STAT_BY(STAT_Vitruvio_InFlightGenerates, InitialShapes.Num());
 
-	TMap<URulePackage*, TArray<FInitialShape>> RulePackages;
-	for (FInitialShape& InitialShape : InitialShapes)
+	// Released on every exit, also if PRT fails, since waiting for idle relies on the in-flight counters
+	const int32 NumGenerateCalls = InitialShapes.Num();
+	ON_SCOPE_EXIT
 	{
-		RulePackages.FindOrAdd(InitialShape.RulePackage).Add(MoveTemp(InitialShape));
-	}
+		CompleteGenerateCalls(NumGenerateCalls);
+	};
 
-	TArray<TTuple<TFuture<ResolveMapSPtr>, TArray<FInitialShape>>> ResolveMapFutures;
-	for (auto& [RulePackage, InitialShapesByRpk] : RulePackages)
+	// Group the initial shapes by Rule Package, the results are returned in the original order of the initial shapes though
+	TArray<FRulePackageBatch> RulePackageBatches;
 	{
-		ResolveMapFutures.Add(MakeTuple(LoadResolveMapAsync(RulePackage), MoveTemp(InitialShapesByRpk)));
+		TMap<URulePackage*, int32> RulePackageBatchIndices;
+		for (int32 BatchIndex = 0; BatchIndex < InitialShapes.Num(); ++BatchIndex)
+		{
+			FInitialShape& InitialShape = InitialShapes[BatchIndex];
+
+			int32* RulePackageBatchIndex = RulePackageBatchIndices.Find(InitialShape.RulePackage);
+			if (!RulePackageBatchIndex)
+			{
+				RulePackageBatchIndex = &RulePackageBatchIndices.Add(InitialShape.RulePackage, RulePackageBatches.AddDefaulted());
+				RulePackageBatches[*RulePackageBatchIndex].RulePackage = InitialShape.RulePackage;
+			}
+
+			FRulePackageBatch& RulePackageBatch = RulePackageBatches[*RulePackageBatchIndex];
+			RulePackageBatch.InitialShapes.Add(MoveTemp(InitialShape));
+			RulePackageBatch.BatchIndices.Add(BatchIndex);
+		}
 	}
 
-	TArray<TTuple<FStartRuleInfo, TArray<FInitialShape>>> RuleInfoInitialShapes;
-	for (auto& [ResolveMapFuture, InitialShapesByRpk] : ResolveMapFutures)
+	// All resolve maps are requested before waiting for the first one so that they are loaded in parallel
+	TArray<TFuture<FLoadedRulePackagePtr>> ResolveMapFutures;
+	for (const FRulePackageBatch& RulePackageBatch : RulePackageBatches)
 	{
-		const ResolveMapSPtr ResolveMap = ResolveMapFuture.Get();
+		ResolveMapFutures.Add(LoadResolveMapAsync(RulePackageBatch.RulePackage));
+	}
 
-		const std::wstring RuleFile = ResolveMap->findCGBKey();
-		const wchar_t* RuleFileUri = ResolveMap->getString(RuleFile.c_str());
+	const double LoadResolveMapStartTime = FPlatformTime::Seconds();
 
-		const RuleFileInfoPtr RuleFileInfo = prt_make_shared<const prt::RuleFileInfo>(prt::createRuleFileInfo(RuleFileUri));
-		const std::wstring StartRule = prtu::detectStartRule(RuleFileInfo);
-		
-		FStartRuleInfo StartRuleInfo { ResolveMap, RuleFile.c_str(), StartRule.c_str(), RuleFileInfo };
+	for (int32 RulePackageBatchIndex = 0; RulePackageBatchIndex < RulePackageBatches.Num(); ++RulePackageBatchIndex)
+	{
+		FRulePackageBatch& RulePackageBatch = RulePackageBatches[RulePackageBatchIndex];
+		RulePackageBatch.LoadedRulePackage = ResolveMapFutures[RulePackageBatchIndex].Get();
+		if (!RulePackageBatch.LoadedRulePackage)
+		{
+			UE_LOG(LogUnrealPrt, Error, TEXT("Could not load Rule Package, skipping generate of %d of %d initial shapes in batch"),
+				   RulePackageBatch.InitialShapes.Num(), InitialShapes.Num())
+		}
+	}
 
-		RuleInfoInitialShapes.Add(MakeTuple(StartRuleInfo, MoveTemp(InitialShapesByRpk)));
+	// The shapes of a Rule Package which could not be loaded are left without result, the results of the others keep their batch index
+	RulePackageBatches.RemoveAll([](const FRulePackageBatch& RulePackageBatch) { return !RulePackageBatch.LoadedRulePackage; });
+	if (RulePackageBatches.IsEmpty())
+	{
+		UE_LOG(LogUnrealPrt, Error, TEXT("Could not load any Rule Package, batch generate of %d initial shapes failed"), InitialShapes.Num())
+		return {};
 	}
+
+	// The initial shapes of different Rule Packages are independent of each other and are therefore created concurrently
+	ParallelFor(Backend ? 0 : RulePackageBatches.Num(), [&RulePackageBatches](int32 RulePackageBatchIndex)
+	{
+		FRulePackageBatch& RulePackageBatch = RulePackageBatches[RulePackageBatchIndex];
+		const FLoadedRulePackage& LoadedRulePackage = *RulePackageBatch.LoadedRulePackage;
+
+		for (const FInitialShape& InitialShape : RulePackageBatch.InitialShapes)
+		{
+			InitialShapeBuilderUPtr InitialShapeBuilder(prt::InitialShapeBuilder::create());
+			SetInitialShapeGeometry(InitialShapeBuilder, InitialShape);
+			InitialShapeBuilder->setAttributes(LoadedRulePackage.RuleFile.c_str(), LoadedRulePackage.StartRule.c_str(), InitialShape.RandomSeed, L"",
+				InitialShape.Attributes.get(), LoadedRulePackage.ResolveMap.get());
+			RulePackageBatch.EvaluateInitialShapes.push_back(InitialShapeUPtr(InitialShapeBuilder->createInitialShape()));
+			RulePackageBatch.InitialShapeBuilders.Add(MoveTemp(InitialShapeBuilder));
+		}
+	});
+
+	const double LoadResolveMapTime = FPlatformTime::Seconds() - LoadResolveMapStartTime;
 	
-	auto ForeachInitialShape = [&RuleInfoInitialShapes](auto Fun)
+	auto ForeachInitialShape = [&RulePackageBatches](auto Fun)
 	{
 		int InitialShapeIndex = 0;
-		for (auto& [StartRuleInfo, InitialShapesByRpk] : RuleInfoInitialShapes)
+		for (FRulePackageBatch& RulePackageBatch : RulePackageBatches)
 		{
-			for (const FInitialShape& InitialShape : InitialShapesByRpk)
+			for (int32 ShapeIndex = 0; ShapeIndex < RulePackageBatch.InitialShapes.Num(); ++ShapeIndex)
 			{
-				Fun(InitialShapeIndex, InitialShape, StartRuleInfo);
+				Fun(InitialShapeIndex, RulePackageBatch.BatchIndices[ShapeIndex], RulePackageBatch.InitialShapes[ShapeIndex],
+					*RulePackageBatch.LoadedRulePackage);
 
 				InitialShapeIndex++;
 			}
 		}
 	};
 	
+	// The initial shapes are generated by a single PRT call which distributes the shapes of all Rule Packages to the shared worker threads
 	TArray<InitialShapeBuilderUPtr> InitialShapeBuilders;
 	InitialShapeUPtrVector InitialShapeUPtrs;
 	InitialShapeNOPtrVector InitialShapePtrs;
+	for (FRulePackageBatch& RulePackageBatch : RulePackageBatches)
+	{
+		InitialShapeBuilders.Append(MoveTemp(RulePackageBatch.InitialShapeBuilders));
+		for (InitialShapeUPtr& Shape : RulePackageBatch.EvaluateInitialShapes)
+		{
+			InitialShapePtrs.push_back(Shape.get());
+			InitialShapeUPtrs.push_back(std::move(Shape));
+		}
+	}
 
-	ForeachInitialShape([&InitialShapeBuilders, &InitialShapeUPtrs, &InitialShapePtrs]
-		(int32 InitialShapeIndex, const FInitialShape& InitialShape, const FStartRuleInfo& StartRuleInfo)
+	// Hand out the most expensive shapes to the PRT worker threads first and only reserve as many threads as the shapes can keep busy
+	TArray<double> GenerateCosts;
+	TArray<int32> GenerateBatchIndices;
+	TMap<URulePackage*, double> GeometryCostsByRpk;
+	TMap<URulePackage*, double> GenerateCostsByRpk;
+	for (const FRulePackageBatch& RulePackageBatch : RulePackageBatches)
 	{
-		InitialShapeBuilderUPtr InitialShapeBuilder(prt::InitialShapeBuilder::create());
-		SetInitialShapeGeometry(InitialShapeBuilder, InitialShape);
-		InitialShapeBuilder->setAttributes(*StartRuleInfo.RuleFile, *StartRuleInfo.StartRule, InitialShape.RandomSeed, L"",
-			InitialShape.Attributes.get(), StartRuleInfo.ResolveMap.get());
-		InitialShapeUPtr Shape(InitialShapeBuilder->createInitialShape());
-		InitialShapePtrs.push_back(Shape.get());
-		InitialShapeUPtrs.push_back(std::move(Shape));
+		GenerateBatchIndices.Append(RulePackageBatch.BatchIndices);
+		for (const FInitialShape& InitialShape : RulePackageBatch.InitialShapes)
+		{
+			const double GeometryCost = Vitruvio::EstimateGeometryCost(InitialShape.Polygon);
+			const double GenerateCost = GeometryCost * GenerateCostModel.GetSecondsPerCost(InitialShape.RulePackage);
+			GenerateCosts.Add(GenerateCost);
+			GeometryCostsByRpk.FindOrAdd(InitialShape.RulePackage) += GeometryCost;
+			GenerateCostsByRpk.FindOrAdd(InitialShape.RulePackage) += GenerateCost;
+		}
+	}
 
-		InitialShapeBuilders.Add(MoveTemp(InitialShapeBuilder));
-	});
+	// Shapes with equal costs are generated in the order of the batch, independent of the grouping by Rule Package
+	const TArray<int32> GenerateOrder = Vitruvio::GetLongestFirstOrder(GenerateCosts, GenerateBatchIndices);
+	TArray<int32> GeneratePositions;
+	GeneratePositions.SetNumUninitialized(GenerateOrder.Num());
+	for (int32 Position = 0; Position < GenerateOrder.Num(); ++Position)
+	{
+		GeneratePositions[GenerateOrder[Position]] = Position;
+	}
+
+	auto InGenerateOrder = [&GenerateOrder](const InitialShapeNOPtrVector& Shapes)
+	{
+		InitialShapeNOPtrVector OrderedShapes;
+		OrderedShapes.reserve(Shapes.size());
+		for (const int32 InitialShapeIndex : GenerateOrder)
+		{
+			OrderedShapes.push_back(Shapes[InitialShapeIndex]);
+		}
+		return OrderedShapes;
+	};
+
+	const int32 MaxWorkerThreadsBudget = GetNumWorkerThreads();
+	const Vitruvio::FScopedWorkerThreads WorkerThreads(WorkerThreadBudget, Vitruvio::GetUsefulWorkerThreads(GenerateCosts, MaxWorkerThreadsBudget),
+		MaxWorkerThreadsBudget);
+
+	// A generate backend gets the initial shapes in the same order as PRT
+	TArray<const FInitialShape*> OrderedInitialShapes;
+	if (Backend)
+	{
+		OrderedInitialShapes.SetNumZeroed(GenerateOrder.Num());
+		ForeachInitialShape([&OrderedInitialShapes, &GeneratePositions]
+			(int32 InitialShapeIndex, int32 BatchIndex, const FInitialShape& InitialShape, const FLoadedRulePackage& LoadedRulePackage)
+		{
+			OrderedInitialShapes[GeneratePositions[InitialShapeIndex]] = &InitialShape;
+		});
+	}
 
 	TArray<FAttributeMapPtr> EvaluatedAttributes;
+	EvaluatedAttributes.SetNum(InitialShapes.Num());
 	
 	// Evaluate attributes
+	const double EvaluateAttributesStartTime = FPlatformTime::Seconds();
+	if (Backend)
 	{
+		SCOPE_CYCLE_COUNTER(STAT_Vitruvio_EvaluateAttributes);
+
+		const TArray<FAttributeMapPtr> OrderedAttributes = Backend->EvaluateAttributes(OrderedInitialShapes);
+		if (OrderedAttributes.Num() != OrderedInitialShapes.Num())
+		{
+			UE_LOG(LogUnrealPrt, Error, TEXT("Generate backend evaluated %d of %d initial shapes"), OrderedAttributes.Num(),
+				   OrderedInitialShapes.Num())
+			return {};
+		}
+
+		ForeachInitialShape([&OrderedAttributes, &EvaluatedAttributes, &GeneratePositions]
+			(int32 InitialShapeIndex, int32 BatchIndex, const FInitialShape& InitialShape, const FLoadedRulePackage& LoadedRulePackage)
+		{
+			EvaluatedAttributes[BatchIndex] = OrderedAttributes[GeneratePositions[InitialShapeIndex]];
+		});
+	}
+	else
+	{
+		SCOPE_CYCLE_COUNTER(STAT_Vitruvio_EvaluateAttributes);
+
 		TArray<AttributeMapBuilderUPtr> EvaluateAttributeMapBuilders;
-		for (int32 InitialShapeIndex = 0; InitialShapeIndex < InitialShapes.Num(); ++InitialShapeIndex)
+		for (int32 InitialShapeIndex = 0; InitialShapeIndex < GenerateOrder.Num(); ++InitialShapeIndex)
 		{
 			EvaluateAttributeMapBuilders.Add(AttributeMapBuilderUPtr(prt::AttributeMapBuilder::create()));
 		}
@@ -490,10 +784,12 @@ FGenerateResultDescription VitruvioModule::BatchGenerate(TArray<FInitialShape> I
 		const AttributeMapNOPtrVector EncoderOptions = {AttributeEncodeOptions.get()};
 
 		AttributeMapBuilderUPtr GenerateOptionsBuilder(prt::AttributeMapBuilder::create());
-		GenerateOptionsBuilder->setInt(L"numberWorkerThreads", FPlatformMisc::NumberOfCores());
+		GenerateOptionsBuilder->setInt(L"numberWorkerThreads", WorkerThreads.Num());
 		const AttributeMapUPtr GenerateOptions(GenerateOptionsBuilder->createAttributeMapAndReset());
 
-		prt::Status GenerateStatus = generate(InitialShapePtrs.data(), InitialShapePtrs.size(), nullptr, EncoderIds.data(),
+		// The attribute map builders are indexed by the position of the initial shapes in the generate call
+		const InitialShapeNOPtrVector OrderedInitialShapePtrs = InGenerateOrder(InitialShapePtrs);
+		prt::Status GenerateStatus = generate(OrderedInitialShapePtrs.data(), OrderedInitialShapePtrs.size(), nullptr, EncoderIds.data(),
 			EncoderIds.size(), EncoderOptions.data(), OutputHandler.Get(),
 					  PrtCache.get(), nullptr, GenerateOptions.get());
 
@@ -503,29 +799,41 @@ FGenerateResultDescription VitruvioModule::BatchGenerate(TArray<FInitialShape> I
 			return {};
 		}
 		
-		ForeachInitialShape([&EvaluateAttributeMapBuilders, &EvaluatedAttributes]
-			(int32 InitialShapeIndex, const FInitialShape& InitialShape, const FStartRuleInfo& StartRuleInfo)
+		ForeachInitialShape([&EvaluateAttributeMapBuilders, &EvaluatedAttributes, &GeneratePositions]
+			(int32 InitialShapeIndex, int32 BatchIndex, const FInitialShape& InitialShape, const FLoadedRulePackage& LoadedRulePackage)
 		{
-			const FAttributeMapPtr AttributeMap = MakeShared<FAttributeMap>(
-				AttributeMapUPtr(EvaluateAttributeMapBuilders[InitialShapeIndex]->createAttributeMapAndReset()),
-				StartRuleInfo.RuleFileInfo);
-			EvaluatedAttributes.Add(AttributeMap);
+			EvaluatedAttributes[BatchIndex] = MakeShared<FAttributeMap>(
+				AttributeMapUPtr(EvaluateAttributeMapBuilders[GeneratePositions[InitialShapeIndex]]->createAttributeMapAndReset()),
+				LoadedRulePackage.RuleFileInfo);
 		});
 	}
+	const double EvaluateAttributesTime = FPlatformTime::Seconds() - EvaluateAttributesStartTime;
 
 	// Generate
-	TArray<AttributeMapBuilderUPtr> GenerateAttributeMapBuilders;
-	TSharedPtr<UnrealCallbacks> GenerateOutputHandler(new UnrealCallbacks(GenerateAttributeMapBuilders));
+	const double GenerateStartTime = FPlatformTime::Seconds();
+	FGenerateResultDescription Result;
+	if (Backend)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_Vitruvio_Generate);
+
+		Result = Backend->Generate(OrderedInitialShapes, WorkerThreads.Num());
+	}
+	else
 	{
+		SCOPE_CYCLE_COUNTER(STAT_Vitruvio_Generate);
+
+		TArray<AttributeMapBuilderUPtr> GenerateAttributeMapBuilders;
+		TSharedPtr<UnrealCallbacks> GenerateOutputHandler(new UnrealCallbacks(GenerateAttributeMapBuilders, CollisionSettings));
+
 		InitialShapeUPtrs.clear();
 		InitialShapePtrs.clear();
 
 		ForeachInitialShape([&InitialShapeBuilders, &EvaluatedAttributes, &InitialShapePtrs, &InitialShapeUPtrs]
-			(int32 InitialShapeIndex, const FInitialShape& InitialShape, const FStartRuleInfo& StartRuleInfo)
+			(int32 InitialShapeIndex, int32 BatchIndex, const FInitialShape& InitialShape, const FLoadedRulePackage& LoadedRulePackage)
 		{
 			const InitialShapeBuilderUPtr& InitialShapeBuilder = InitialShapeBuilders[InitialShapeIndex];
-			InitialShapeBuilder->setAttributes(*StartRuleInfo.RuleFile, *StartRuleInfo.StartRule, InitialShape.RandomSeed, L"",
-				EvaluatedAttributes[InitialShapeIndex]->AttributeMap.get(), StartRuleInfo.ResolveMap.get());
+			InitialShapeBuilder->setAttributes(LoadedRulePackage.RuleFile.c_str(), LoadedRulePackage.StartRule.c_str(), InitialShape.RandomSeed, L"",
+				EvaluatedAttributes[BatchIndex]->AttributeMap.get(), LoadedRulePackage.ResolveMap.get());
 			InitialShapeUPtr Shape(InitialShapeBuilder->createInitialShapeAndReset());
 			InitialShapePtrs.push_back(Shape.get());
 			InitialShapeUPtrs.push_back(std::move(Shape));
@@ -533,15 +841,18 @@ FGenerateResultDescription VitruvioModule::BatchGenerate(TArray<FInitialShape> I
 		
 	    AttributeMapBuilderUPtr AttributeMapBuilder(prt::AttributeMapBuilder::create());
 
-	    const std::vector UnrealEncoderIds = { UNREAL_GEOMETRY_ENCODER_ID };
+		// The geometry encoder reports once per initial shape without its index, the report encoder calls back with the index of the shape
+	    const std::vector UnrealEncoderIds = { UNREAL_GEOMETRY_ENCODER_ID, CGA_REPORT_ENCODER_ID };
 	    const AttributeMapUPtr UnrealEncoderOptions(prtu::createValidatedOptions(UNREAL_GEOMETRY_ENCODER_ID));
-	    const AttributeMapNOPtrVector GenerateEncoderOptions = {UnrealEncoderOptions.get()};
+		const AttributeMapUPtr ReportEncoderOptions(prtu::createValidatedOptions(CGA_REPORT_ENCODER_ID));
+	    const AttributeMapNOPtrVector GenerateEncoderOptions = {UnrealEncoderOptions.get(), ReportEncoderOptions.get()};
 
 		AttributeMapBuilderUPtr GenerateOptionsBuilder(prt::AttributeMapBuilder::create());
-		GenerateOptionsBuilder->setInt(L"numberWorkerThreads", FPlatformMisc::NumberOfCores());
+		GenerateOptionsBuilder->setInt(L"numberWorkerThreads", WorkerThreads.Num());
 		const AttributeMapUPtr GenerateOptions(GenerateOptionsBuilder->createAttributeMapAndReset());
 
-	    prt::Status GenerateStatus = generate(InitialShapePtrs.data(), InitialShapePtrs.size(), nullptr,
+		const InitialShapeNOPtrVector OrderedInitialShapePtrs = InGenerateOrder(InitialShapePtrs);
+	    prt::Status GenerateStatus = generate(OrderedInitialShapePtrs.data(), OrderedInitialShapePtrs.size(), nullptr,
 			UnrealEncoderIds.data(), UnrealEncoderIds.size(), GenerateEncoderOptions.data(), GenerateOutputHandler.Get(),
 			PrtCache.get(), nullptr, GenerateOptions.get());
 
@@ -550,56 +861,143 @@ FGenerateResultDescription VitruvioModule::BatchGenerate(TArray<FInitialShape> I
     		UE_LOG(LogUnrealPrt, Error, TEXT("PRT generate failed: %hs"), prt::getStatusDescription(GenerateStatus))
     		return {};
 	    }
+
+		Result = FGenerateResultDescription{GenerateOutputHandler->GetGeneratedModel(), GenerateOutputHandler->GetInstances(),
+			GenerateOutputHandler->GetInstanceMeshes(), GenerateOutputHandler->GetInstanceNames()};
+		Result.ShapeReportStatistics = GenerateOutputHandler->GetShapeReportStatistics(GenerateOrder.Num());
 	}
+	const double GenerateTime = FPlatformTime::Seconds() - GenerateStartTime;
 
-	CHECK_PRT_INITIALIZED()
+	// The reports are returned in generate order and are aggregated here, on the generate thread, instead of by the caller. Shapes which have
+	// not been generated keep empty statistics.
+	Result.ReportStatistics.Reset();
+	if (Result.ShapeReportStatistics.Num() == GenerateOrder.Num())
+	{
+		TArray<TMap<FString, FReportStatistics>> OrderedReportStatistics = MoveTemp(Result.ShapeReportStatistics);
+		Result.ShapeReportStatistics.SetNum(InitialShapes.Num());
+		ForeachInitialShape([&OrderedReportStatistics, &Result, &GeneratePositions]
+			(int32 InitialShapeIndex, int32 BatchIndex, const FInitialShape& InitialShape, const FLoadedRulePackage& LoadedRulePackage)
+		{
+			Result.ShapeReportStatistics[BatchIndex] = MoveTemp(OrderedReportStatistics[GeneratePositions[InitialShapeIndex]]);
+		});
 
-	GenerateCallsCounter.Subtract(InitialShapes.Num());
+		for (const TMap<FString, FReportStatistics>& ShapeReportStatistics : Result.ShapeReportStatistics)
+		{
+			Vitruvio::MergeReportStatistics(Result.ReportStatistics, ShapeReportStatistics);
+		}
+	}
+	else
+	{
+		Result.ShapeReportStatistics.Reset();
+	}
 
-	NotifyGenerateCompleted();
-    
-    return FGenerateResultDescription { GenerateOutputHandler->GetGeneratedModel(), GenerateOutputHandler->GetInstances(),
-    	GenerateOutputHandler->GetInstanceMeshes(), GenerateOutputHandler->GetInstanceNames(), {}, EvaluatedAttributes };
+	// The time of the whole call is distributed to the rule packages by their estimated share of the cost
+	double TotalGenerateCost = 0.0;
+	for (const auto& [RulePackage, GenerateCost] : GenerateCostsByRpk)
+	{
+		TotalGenerateCost += GenerateCost;
+	}
+	for (const auto& [RulePackage, GeometryCost] : GeometryCostsByRpk)
+	{
+		const double ThreadSeconds = GenerateTime * WorkerThreads.Num() * GenerateCostsByRpk[RulePackage] / TotalGenerateCost;
+		GenerateCostModel.Observe(RulePackage, GeometryCost, ThreadSeconds);
+	}
+
+	CHECK_PRT_INITIALIZED()
+
+	Result.EvaluatedAttributes = MoveTemp(EvaluatedAttributes);
+	Result.LoadResolveMapTime = LoadResolveMapTime;
+	Result.EvaluateAttributesTime = EvaluateAttributesTime;
+	Result.GenerateTime = GenerateTime;
+	return Result;
 }
 
 
-FGenerateResult VitruvioModule::GenerateAsync(FInitialShape InitialShape) const
+FGenerateResult VitruvioModule::GenerateAsync(FInitialShape InitialShape, FGeneratedCollisionSettings CollisionSettings) const
 {
 	const FGenerateResult::FTokenPtr Token = MakeShared<FGenerateToken>();
 
 	CHECK_PRT_INITIALIZED_ASYNC(FGenerateResult, Token)
 
-	FGenerateResult::FFutureType ResultFuture = Async(EAsyncExecution::Thread, [this, Token, InitialShape = MoveTemp(InitialShape)]() mutable {
-		FGenerateResultDescription Result = Generate(MoveTemp(InitialShape));
+	FGenerateResult::FFutureType ResultFuture = Async(EAsyncExecution::Thread, [this, Token, InitialShape = MoveTemp(InitialShape), CollisionSettings]() mutable {
+		FGenerateResultDescription Result = Generate(MoveTemp(InitialShape), CollisionSettings);
 		return FGenerateResult::ResultType{Token, MoveTemp(Result)};
 	});
 
 	return FGenerateResult{MoveTemp(ResultFuture), Token};
 }
 
-FGenerateResultDescription VitruvioModule::Generate(const FInitialShape& InitialShape) const
+FGenerateResult VitruvioModule::GenerateSharedAsync(FInitialShape InitialShape, const FGenerateResultKey& Key,
+												   FGeneratedCollisionSettings CollisionSettings) const
+{
+	const FGenerateResult::FTokenPtr Token = MakeShared<FGenerateToken>();
+
+	CHECK_PRT_INITIALIZED_ASYNC(FGenerateResult, Token)
+
+	// clang-format off
+	TFuture<FGenerateResultCache::FGenerateResultPtr> SharedResult = GenerateResultCache.GetOrGenerateAsync(Key,
+		[this, InitialShape = MoveTemp(InitialShape), CollisionSettings]()
+	{
+		return MakeShared<const FGenerateResultDescription, ESPMode::ThreadSafe>(Generate(InitialShape, CollisionSettings));
+	});
+
+	// Every request has its own token so that invalidating one of them does not discard the result of the others
+	FGenerateResult::FFutureType ResultFuture = SharedResult.Next([Token](const FGenerateResultCache::FGenerateResultPtr& Result)
+	{
+		return FGenerateResult::ResultType{Token, Result ? *Result : FGenerateResultDescription{}};
+	});
+	// clang-format on
+
+	return FGenerateResult{MoveTemp(ResultFuture), Token};
+}
+
+FGenerateResultDescription VitruvioModule::Generate(const FInitialShape& InitialShape, const FGeneratedCollisionSettings& CollisionSettings) const
 {
 	CHECK_PRT_INITIALIZED()
 
 	GenerateCallsCounter.Increment();
+	INC_DWORD_STAT(STAT_Vitruvio_InFlightGenerates);
 
-	const InitialShapeBuilderUPtr InitialShapeBuilder(prt::InitialShapeBuilder::create());
-	SetInitialShapeGeometry(InitialShapeBuilder, InitialShape);
+	ON_SCOPE_EXIT
+	{
+		CompleteGenerateCalls(1);
+	};
+
+	const FGenerateBackendPtr Backend = GetGenerateBackend();
+
+	const double LoadResolveMapStartTime = FPlatformTime::Seconds();
+	const FLoadedRulePackagePtr LoadedRulePackage = LoadResolveMapAsync(InitialShape.RulePackage).Get();
+	const double LoadResolveMapTime = FPlatformTime::Seconds() - LoadResolveMapStartTime;
 
-	const ResolveMapSPtr ResolveMap = LoadResolveMapAsync(InitialShape.RulePackage).Get();
+	if (!LoadedRulePackage)
+	{
+		UE_LOG(LogUnrealPrt, Error, TEXT("Could not load Rule Package, generate failed"))
+		return {};
+	}
 
-	const std::wstring RuleFile = ResolveMap->findCGBKey();
-	const wchar_t* RuleFileUri = ResolveMap->getString(RuleFile.c_str());
+	if (Backend)
+	{
+		const Vitruvio::FScopedWorkerThreads WorkerThreads(WorkerThreadBudget, 1, GetNumWorkerThreads());
 
-	const RuleFileInfoPtr StartRuleInfo = prt_make_shared<const prt::RuleFileInfo>(prt::createRuleFileInfo(RuleFileUri));
-	const std::wstring StartRule = prtu::detectStartRule(StartRuleInfo);
+		const double GenerateStartTime = FPlatformTime::Seconds();
+		FGenerateResultDescription Result;
+		{
+			SCOPE_CYCLE_COUNTER(STAT_Vitruvio_Generate);
+			Result = Backend->Generate({&InitialShape}, WorkerThreads.Num());
+		}
+		Result.LoadResolveMapTime = LoadResolveMapTime;
+		Result.GenerateTime = FPlatformTime::Seconds() - GenerateStartTime;
+		return Result;
+	}
 
-	InitialShapeBuilder->setAttributes(RuleFile.c_str(), StartRule.c_str(),
-		InitialShape.RandomSeed, L"", InitialShape.Attributes.get(), ResolveMap.get());
+	const InitialShapeBuilderUPtr InitialShapeBuilder(prt::InitialShapeBuilder::create());
+	SetInitialShapeGeometry(InitialShapeBuilder, InitialShape);
+	InitialShapeBuilder->setAttributes(LoadedRulePackage->RuleFile.c_str(), LoadedRulePackage->StartRule.c_str(),
+		InitialShape.RandomSeed, L"", InitialShape.Attributes.get(), LoadedRulePackage->ResolveMap.get());
 
 	TArray<AttributeMapBuilderUPtr> AttributeMapBuilders;
 	AttributeMapBuilders.Add(AttributeMapBuilderUPtr(prt::AttributeMapBuilder::create()));
-	const TSharedPtr<UnrealCallbacks> OutputHandler(new UnrealCallbacks(AttributeMapBuilders));
+	const TSharedPtr<UnrealCallbacks> OutputHandler(new UnrealCallbacks(AttributeMapBuilders, CollisionSettings));
 
 	const InitialShapeUPtr Shape(InitialShapeBuilder->createInitialShapeAndReset());
 
@@ -609,8 +1007,20 @@ FGenerateResultDescription VitruvioModule::Generate(const FInitialShape& Initial
 
 	InitialShapeNOPtrVector Shapes = {Shape.get()};
 
-	const prt::Status GenerateStatus = prt::generate(Shapes.data(), Shapes.size(), nullptr, EncoderIds.data(), EncoderIds.size(),
-													 EncoderOptions.data(), OutputHandler.Get(), PrtCache.get(), nullptr);
+	// A single initial shape is generated by a single worker thread
+	const Vitruvio::FScopedWorkerThreads WorkerThreads(WorkerThreadBudget, 1, GetNumWorkerThreads());
+	AttributeMapBuilderUPtr GenerateOptionsBuilder(prt::AttributeMapBuilder::create());
+	GenerateOptionsBuilder->setInt(L"numberWorkerThreads", WorkerThreads.Num());
+	const AttributeMapUPtr GenerateOptions(GenerateOptionsBuilder->createAttributeMapAndReset());
+
+	const double GenerateStartTime = FPlatformTime::Seconds();
+	prt::Status GenerateStatus;
+	{
+		SCOPE_CYCLE_COUNTER(STAT_Vitruvio_Generate);
+		GenerateStatus = prt::generate(Shapes.data(), Shapes.size(), nullptr, EncoderIds.data(), EncoderIds.size(), EncoderOptions.data(),
+									   OutputHandler.Get(), PrtCache.get(), nullptr, GenerateOptions.get());
+	}
+	const double GenerateTime = FPlatformTime::Seconds() - GenerateStartTime;
 
 	if (GenerateStatus != prt::STATUS_OK)
 	{
@@ -618,13 +1028,17 @@ FGenerateResultDescription VitruvioModule::Generate(const FInitialShape& Initial
 		return {};
 	}
 
+	GenerateCostModel.Observe(InitialShape.RulePackage, Vitruvio::EstimateGeometryCost(InitialShape.Polygon), GenerateTime);
+
 	CHECK_PRT_INITIALIZED()
-	
-	GenerateCallsCounter.Decrement();
-	NotifyGenerateCompleted();
+
+	// A single initial shape reports once, its statistics are therefore those of its reports
+	TMap<FString, FReportStatistics> ReportStatistics;
+	Vitruvio::AddReports(ReportStatistics, OutputHandler->GetReports());
 
 	return FGenerateResultDescription{ OutputHandler->GetGeneratedModel(), OutputHandler->GetInstances(), OutputHandler->GetInstanceMeshes(),
-									  OutputHandler->GetInstanceNames(), OutputHandler->GetReports()};
+									  OutputHandler->GetInstanceNames(), OutputHandler->GetReports(), MoveTemp(ReportStatistics), {}, {},
+									  LoadResolveMapTime, 0.0, GenerateTime};
 }
 
 FAttributeMapResult VitruvioModule::EvaluateRuleAttributesAsync(FInitialShape InitialShape) const
@@ -634,50 +1048,206 @@ FAttributeMapResult VitruvioModule::EvaluateRuleAttributesAsync(FInitialShape In
 	CHECK_PRT_INITIALIZED_ASYNC(FAttributeMapResult, InvalidationToken)
 
 	LoadAttributesCounter.Increment();
+	INC_DWORD_STAT(STAT_Vitruvio_InFlightEvaluations);
 
 	FAttributeMapResult::FFutureType AttributeMapPtrFuture = Async(EAsyncExecution::Thread, [this, InvalidationToken, InitialShape = MoveTemp(InitialShape)]() mutable {
-		const ResolveMapSPtr ResolveMap = LoadResolveMapAsync(InitialShape.RulePackage).Get();
-
-		const std::wstring RuleFile = ResolveMap->findCGBKey();
-		const wchar_t* RuleFileUri = ResolveMap->getString(RuleFile.c_str());
-
-		const RuleFileInfoPtr StartRuleInfo = prt_make_shared<const prt::RuleFileInfo>(prt::createRuleFileInfo(RuleFileUri));
-		const std::wstring StartRule = prtu::detectStartRule(StartRuleInfo);
+		ON_SCOPE_EXIT
+		{
+			CompleteEvaluation();
+		};
 
-		prt::Status InfoStatus;
-		RuleFileInfoUPtr RuleInfo(prt::createRuleFileInfo(RuleFileUri, PrtCache.get(), &InfoStatus));
-		if (!RuleInfo || InfoStatus != prt::STATUS_OK)
+		const FLoadedRulePackagePtr LoadedRulePackage = LoadResolveMapAsync(InitialShape.RulePackage).Get();
+		if (!LoadedRulePackage)
 		{
-			UE_LOG(LogUnrealPrt, Error, TEXT("could not get rule file info from rule file %s"), RuleFileUri)
-			return FAttributeMapResult::ResultType{
-				InvalidationToken,
-				nullptr,
-			};
+			UE_LOG(LogUnrealPrt, Error, TEXT("Could not load Rule Package, attribute evaluation failed"))
+			return FAttributeMapResult::ResultType{InvalidationToken, nullptr};
 		}
 
-		AttributeMapUPtr DefaultAttributeMap(EvaluateRuleAttributes(RuleFile.c_str(),
-			StartRule.c_str(), ResolveMap, InitialShape, PrtCache.get()));
+		if (const FGenerateBackendPtr Backend = GetGenerateBackend())
+		{
+			TArray<FAttributeMapPtr> AttributeMaps = Backend->EvaluateAttributes({&InitialShape});
+			return FAttributeMapResult::ResultType{InvalidationToken, AttributeMaps.IsEmpty() ? nullptr : AttributeMaps[0]};
+		}
 
-		LoadAttributesCounter.Decrement();
+		AttributeMapUPtr DefaultAttributeMap(EvaluateRuleAttributes(LoadedRulePackage->RuleFile, LoadedRulePackage->StartRule,
+			LoadedRulePackage->ResolveMap, InitialShape, PrtCache.get()));
 
-		if (!Initialized)
+		if (!CanGenerate())
 		{
 			return FAttributeMapResult::ResultType{InvalidationToken, nullptr};
 		}
 
-		const TSharedPtr<FAttributeMap> AttributeMap = MakeShared<FAttributeMap>(std::move(DefaultAttributeMap), std::move(RuleInfo));
+		const TSharedPtr<FAttributeMap> AttributeMap = MakeShared<FAttributeMap>(std::move(DefaultAttributeMap), LoadedRulePackage->RuleFileInfo);
 		return FAttributeMapResult::ResultType{InvalidationToken, AttributeMap};
 	});
 
 	return {MoveTemp(AttributeMapPtrFuture), InvalidationToken};
 }
 
+FBatchAttributeMapResult VitruvioModule::BatchEvaluateRuleAttributesAsync(TArray<FInitialShape> InitialShapes) const
+{
+	FBatchAttributeMapResult::FTokenPtr InvalidationToken = MakeShared<FEvalAttributesToken>();
+
+	CHECK_PRT_INITIALIZED_ASYNC(FBatchAttributeMapResult, InvalidationToken)
+
+	LoadAttributesCounter.Increment();
+	INC_DWORD_STAT(STAT_Vitruvio_InFlightEvaluations);
+
+	FBatchAttributeMapResult::FFutureType AttributeMapsFuture = Async(EAsyncExecution::Thread, [this, InvalidationToken, InitialShapes = MoveTemp(InitialShapes)]() {
+		ON_SCOPE_EXIT
+		{
+			CompleteEvaluation();
+		};
+
+		TArray<FAttributeMapPtr> AttributeMaps;
+		AttributeMaps.SetNum(InitialShapes.Num());
+
+		// The attributes of all initial shapes with the same rule package are evaluated in a single PRT call
+		TMap<URulePackage*, TArray<int32>> InitialShapeIndicesByRpk;
+		for (int32 InitialShapeIndex = 0; InitialShapeIndex < InitialShapes.Num(); ++InitialShapeIndex)
+		{
+			InitialShapeIndicesByRpk.FindOrAdd(InitialShapes[InitialShapeIndex].RulePackage).Add(InitialShapeIndex);
+		}
+
+		for (const auto& [RulePackage, InitialShapeIndices] : InitialShapeIndicesByRpk)
+		{
+			const FLoadedRulePackagePtr LoadedRulePackage = LoadResolveMapAsync(RulePackage).Get();
+			if (!LoadedRulePackage)
+			{
+				UE_LOG(LogUnrealPrt, Error, TEXT("Could not load Rule Package, skipping attribute evaluation of %d initial shapes"),
+					   InitialShapeIndices.Num())
+				continue;
+			}
+
+			TArray<const FInitialShape*> InitialShapesByRpk;
+			for (const int32 InitialShapeIndex : InitialShapeIndices)
+			{
+				InitialShapesByRpk.Add(&InitialShapes[InitialShapeIndex]);
+			}
+
+			if (const FGenerateBackendPtr Backend = GetGenerateBackend())
+			{
+				const TArray<FAttributeMapPtr> EvaluatedAttributes = Backend->EvaluateAttributes(InitialShapesByRpk);
+				for (int32 Index = 0; Index < FMath::Min(InitialShapeIndices.Num(), EvaluatedAttributes.Num()); ++Index)
+				{
+					AttributeMaps[InitialShapeIndices[Index]] = EvaluatedAttributes[Index];
+				}
+				continue;
+			}
+
+			TArray<AttributeMapUPtr> EvaluatedAttributes = EvaluateRuleAttributes(LoadedRulePackage->RuleFile, LoadedRulePackage->StartRule,
+				LoadedRulePackage->ResolveMap, InitialShapesByRpk, PrtCache.get());
+			for (int32 Index = 0; Index < InitialShapeIndices.Num(); ++Index)
+			{
+				AttributeMaps[InitialShapeIndices[Index]] = MakeShared<FAttributeMap>(std::move(EvaluatedAttributes[Index]),
+					LoadedRulePackage->RuleFileInfo);
+			}
+		}
+
+		if (!CanGenerate())
+		{
+			return FBatchAttributeMapResult::ResultType{InvalidationToken, {}};
+		}
+
+		return FBatchAttributeMapResult::ResultType{InvalidationToken, MoveTemp(AttributeMaps)};
+	});
+
+	return {MoveTemp(AttributeMapsFuture), InvalidationToken};
+}
+
 void VitruvioModule::EvictFromResolveMapCache(URulePackage* RulePackage)
 {
 	const TLazyObjectPtr<URulePackage> LazyRulePackagePtr(RulePackage);
-	FScopeLock Lock(&LoadResolveMapLock);
-	ResolveMapCache.Remove(LazyRulePackagePtr);
-	PrtCache->flushAll();
+
+	FLoadedRulePackagePtr EvictedRulePackage;
+	{
+		FWriteScopeLock WriteLock(ResolveMapCacheLock);
+		EvictedRulePackage = RemoveFromResolveMapCache(LazyRulePackagePtr);
+	}
+	FlushPrtCache(EvictedRulePackage);
+}
+
+void VitruvioModule::SetResolveMapCacheBudget(int64 BudgetBytes)
+{
+	TArray<FLoadedRulePackagePtr> EvictedRulePackages;
+	{
+		FWriteScopeLock WriteLock(ResolveMapCacheLock);
+		ResolveMapCacheBudget = BudgetBytes;
+		TrimResolveMapCache(EvictedRulePackages);
+	}
+
+	for (const FLoadedRulePackagePtr& EvictedRulePackage : EvictedRulePackages)
+	{
+		FlushPrtCache(EvictedRulePackage);
+	}
+}
+
+void VitruvioModule::TrimResolveMapCache(TArray<FLoadedRulePackagePtr>& EvictedRulePackages) const
+{
+	if (ResolveMapCacheBudget <= 0)
+	{
+		return;
+	}
+
+	// No cache hit can stamp LastAccess concurrently since the lock is held for writing
+	TArray<TLazyObjectPtr<URulePackage>> RulePackages;
+	TArray<Vitruvio::FCacheEntryUsage> Usages;
+	RulePackages.Reserve(ResolveMapCache.Num());
+	Usages.Reserve(ResolveMapCache.Num());
+	for (const auto& [LazyRulePackagePtr, Entry] : ResolveMapCache)
+	{
+		// Rule Packages referenced outside of the cache are used by an ongoing generate or attribute evaluation call
+		RulePackages.Add(LazyRulePackagePtr);
+		Usages.Add({Entry.LastAccess, Entry.Size, Entry.LoadedRulePackage.GetSharedReferenceCount() > 1});
+	}
+
+	// The most recently used resolve map is always kept since it has just been requested
+	for (const int32 EvictedIndex : Vitruvio::SelectEntriesToEvict(Usages, ResolveMapCacheBudget))
+	{
+		EvictedRulePackages.Add(RemoveFromResolveMapCache(RulePackages[EvictedIndex]));
+	}
+}
+
+FLoadedRulePackagePtr VitruvioModule::RemoveFromResolveMapCache(const TLazyObjectPtr<URulePackage>& LazyRulePackagePtr) const
+{
+	FResolveMapCacheEntry Entry;
+	if (!ResolveMapCache.RemoveAndCopyValue(LazyRulePackagePtr, Entry))
+	{
+		return {};
+	}
+
+	DEC_MEMORY_STAT_BY(STAT_Vitruvio_ResolveMapCacheMemory, Entry.Size);
+	return Entry.LoadedRulePackage;
+}
+
+void VitruvioModule::FlushPrtCache(const FLoadedRulePackagePtr& LoadedRulePackage) const
+{
+	if (!LoadedRulePackage || !LoadedRulePackage->ResolveMap)
+	{
+		return;
+	}
+
+	const ResolveMapSPtr& ResolveMap = LoadedRulePackage->ResolveMap;
+
+	// PRT caches geometry, textures and rule files by their URI. Only the entries resolved by this resolve map are flushed, the cached data
+	// of all other rule packages stays valid.
+	size_t NumKeys = 0;
+	const wchar_t* const* Keys = ResolveMap->getKeys(&NumKeys);
+	for (size_t KeyIndex = 0; KeyIndex < NumKeys; ++KeyIndex)
+	{
+		if (const wchar_t* Uri = ResolveMap->getString(Keys[KeyIndex]))
+		{
+			PrtCache->flushEntry(Uri);
+		}
+	}
+}
+
+void VitruvioModule::EmptyMaterialCache()
+{
+	check(IsInGameThread());
+
+	MaterialCache.Empty();
+	SET_MEMORY_STAT(STAT_Vitruvio_MaterialCacheMemory, 0);
 }
 
 void VitruvioModule::RegisterMesh(UStaticMesh* StaticMesh)
@@ -692,12 +1262,87 @@ void VitruvioModule::UnregisterMesh(UStaticMesh* StaticMesh)
 	RegisteredMeshes.Remove(StaticMesh);
 }
 
+void VitruvioModule::NotifyTaskCompleted() const
+{
+	CompletedTasksCounter.Increment();
+	TaskCompletedEvent->Trigger();
+}
+
+bool VitruvioModule::WaitUntilIdle(double StallTimeoutSeconds, TFunction<void(int32)> OnProgress) const
+{
+	// Wake up at least this often to keep a progress dialog responsive even if no task completes
+	constexpr uint32 MaxWaitMilliseconds = 100;
+
+	// Results are delivered to the game thread using tasks, so they need to be processed while the game thread is blocked. If we are called
+	// from a game thread task (or from a task processed by an outer WaitUntilIdle) processing them again would trip the recursion guard of
+	// the task graph. The counters are released on worker threads, so waiting still completes and the results are processed afterwards.
+	const bool bProcessGameThreadTasks = IsInGameThread() && !FTaskGraphInterface::Get().IsThreadProcessingTasks(ENamedThreads::GameThread);
+
+	int32 LastCompletedTasks = CompletedTasksCounter.GetValue();
+	double LastProgressTime = FPlatformTime::Seconds();
+	while (IsGenerating() || IsLoadingRpks() || LoadAttributesCounter.GetValue() > 0)
+	{
+		if (bProcessGameThreadTasks)
+		{
+			FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+		}
+
+		if (OnProgress)
+		{
+			OnProgress(GenerateCallsCounter.GetValue());
+		}
+
+		const double CurrentTime = FPlatformTime::Seconds();
+		const int32 CompletedTasks = CompletedTasksCounter.GetValue();
+		if (CompletedTasks != LastCompletedTasks)
+		{
+			LastCompletedTasks = CompletedTasks;
+			LastProgressTime = CurrentTime;
+		}
+
+		uint32 WaitMilliseconds = MaxWaitMilliseconds;
+		if (StallTimeoutSeconds >= 0.0)
+		{
+			const double RemainingSeconds = StallTimeoutSeconds - (CurrentTime - LastProgressTime);
+			if (RemainingSeconds <= 0.0)
+			{
+				return false;
+			}
+			WaitMilliseconds = FMath::Min(WaitMilliseconds, static_cast<uint32>(FMath::CeilToInt(RemainingSeconds * 1000.0)));
+		}
+
+		TaskCompletedEvent->Wait(WaitMilliseconds);
+	}
+
+	return true;
+}
+
+bool VitruvioModule::WaitForTaskCompleted(uint32 TimeoutMilliseconds) const
+{
+	return TaskCompletedEvent->Wait(TimeoutMilliseconds);
+}
+
+void VitruvioModule::CompleteGenerateCalls(int32 NumGenerateCalls) const
+{
+	GenerateCallsCounter.Subtract(NumGenerateCalls);
+	DEC_DWORD_STAT_BY(STAT_Vitruvio_InFlightGenerates, NumGenerateCalls);
+	NotifyTaskCompleted();
+	NotifyGenerateCompleted();
+}
+
+void VitruvioModule::CompleteEvaluation() const
+{
+	LoadAttributesCounter.Decrement();
+	DEC_DWORD_STAT(STAT_Vitruvio_InFlightEvaluations);
+	NotifyTaskCompleted();
+}
+
 void VitruvioModule::NotifyGenerateCompleted() const
 {
 	const int GenerateCalls = GenerateCallsCounter.GetValue();
 	
 	AsyncTask(ENamedThreads::GameThread, [this, GenerateCalls]() {
-		if (!Initialized)
+		if (!CanGenerate())
 		{
 			return;
 		}
@@ -706,34 +1351,29 @@ void VitruvioModule::NotifyGenerateCompleted() const
 
 		if (GenerateCalls == 0)
 		{
-			TArray<FLogMessage> Messages = LogHandler->PopMessages();
-
-			int Warnings = 0;
-			int Errors = 0;
-
-			for (const FLogMessage& Message : Messages)
+			// The totals come from the message counts since the captured messages are bounded. There is no log handler if a generate backend
+			// is used without PRT.
+			FLogMessageCounts MessageCounts;
+			TArray<FLogMessage> Messages;
+			if (LogHandler)
 			{
-				if (Message.Level == prt::LOG_WARNING)
-				{
-					Warnings++;
-				}
-				else if (Message.Level == prt::LOG_ERROR || Message.Level == prt::LOG_FATAL)
-				{
-					Errors++;
-				}
+				Messages = LogHandler->PopMessages(&MessageCounts);
 			}
 
-			OnAllGenerateCompleted.Broadcast(Warnings, Errors);
+			const int Warnings = MessageCounts[prt::LOG_WARNING];
+			const int Errors = MessageCounts[prt::LOG_ERROR] + MessageCounts[prt::LOG_FATAL];
+
+			OnAllGenerateCompleted.Broadcast(Warnings, Errors, Messages);
 		}
 	});
 }
 
-TFuture<ResolveMapSPtr> VitruvioModule::LoadResolveMapAsync(URulePackage* const RulePackage) const
+TFuture<FLoadedRulePackagePtr> VitruvioModule::LoadResolveMapAsync(URulePackage* const RulePackage) const
 {
-	TPromise<ResolveMapSPtr> Promise;
-	TFuture<ResolveMapSPtr> Future = Promise.GetFuture();
+	TPromise<FLoadedRulePackagePtr> Promise;
+	TFuture<FLoadedRulePackagePtr> Future = Promise.GetFuture();
 
-	if (!Initialized)
+	if (!CanGenerate())
 	{
 		Promise.SetValue({});
 		return Future;
@@ -741,60 +1381,114 @@ TFuture<ResolveMapSPtr> VitruvioModule::LoadResolveMapAsync(URulePackage* const
 
 	const TLazyObjectPtr<URulePackage> LazyRulePackagePtr(RulePackage);
 
-	// Check if has already been cached
+	// Cache hits only take the read lock so that concurrent requests for cached resolve maps do not serialize
 	{
-		FScopeLock Lock(&LoadResolveMapLock);
-		const auto CachedResolveMap = ResolveMapCache.Find(LazyRulePackagePtr);
-		if (CachedResolveMap)
+		FReadScopeLock ReadLock(ResolveMapCacheLock);
+		if (const FResolveMapCacheEntry* CachedResolveMap = ResolveMapCache.Find(LazyRulePackagePtr))
 		{
-			Promise.SetValue(*CachedResolveMap);
+			FPlatformAtomics::AtomicStore(&CachedResolveMap->LastAccess, ResolveMapAccessCounter.Increment());
+			Promise.SetValue(CachedResolveMap->LoadedRulePackage);
 			return Future;
 		}
 	}
 
-	// Check if a task is already running for loading the specified resolve map
-	FGraphEventRef* ScheduledTaskEvent;
+	bool bStartLoading = false;
 	{
-		FScopeLock Lock(&LoadResolveMapLock);
-		ScheduledTaskEvent = ResolveMapEventGraphRefCache.Find(LazyRulePackagePtr);
+		FWriteScopeLock WriteLock(ResolveMapCacheLock);
+
+		// The resolve map might have been loaded in the meantime
+		if (const FResolveMapCacheEntry* CachedResolveMap = ResolveMapCache.Find(LazyRulePackagePtr))
+		{
+			CachedResolveMap->LastAccess = ResolveMapAccessCounter.Increment();
+			Promise.SetValue(CachedResolveMap->LoadedRulePackage);
+			return Future;
+		}
+
+		// Only the first request starts loading, all later requests wait for the same load
+		TArray<TPromise<FLoadedRulePackagePtr>>* Waiters = PendingResolveMapLoads.Find(LazyRulePackagePtr);
+		if (!Waiters)
+		{
+			bStartLoading = true;
+			Waiters = &PendingResolveMapLoads.Add(LazyRulePackagePtr);
+		}
+		Waiters->Add(MoveTemp(Promise));
 	}
-	if (ScheduledTaskEvent)
+
+	if (bStartLoading)
 	{
-		// Add task which only fetches the result from the cache once the actual loading has finished
-		FGraphEventArray Prerequisites;
-		Prerequisites.Add(*ScheduledTaskEvent);
-		TGraphTask<TAsyncGraphTask<ResolveMapSPtr>>::CreateTask(&Prerequisites)
-			.ConstructAndDispatchWhenReady(
-				[this, LazyRulePackagePtr]() {
-					FScopeLock Lock(&LoadResolveMapLock);
-					return ResolveMapCache[LazyRulePackagePtr];
-				},
-				MoveTemp(Promise), ENamedThreads::AnyThread);
+		RpkLoadingTasksCounter.Increment();
+		INC_DWORD_STAT(STAT_Vitruvio_LoadingRpks);
+
+		// Task which does the actual resolve map loading which might take a long time
+		TGraphTask<FLoadResolveMapTask>::CreateTask().ConstructAndDispatchWhenReady(
+			RpkFolder, LazyRulePackagePtr, PrtCache.get(), GetGenerateBackend(),
+			[this, LazyRulePackagePtr](const FLoadedRulePackagePtr& LoadedRulePackage)
+			{
+				CompleteResolveMapLoad(LazyRulePackagePtr, LoadedRulePackage);
+			});
 	}
-	else
+
+	return Future;
+}
+
+TFuture<bool> VitruvioModule::LoadRulePackageAsync(URulePackage* RulePackage) const
+{
+	return LoadResolveMapAsync(RulePackage).Next([](const FLoadedRulePackagePtr& LoadedRulePackage) { return LoadedRulePackage.IsValid(); });
+}
+
+bool VitruvioModule::PreloadRulePackagesAsync(const TArray<URulePackage*>& RulePackages) const
+{
+	if (!CanGenerate())
 	{
-		RpkLoadingTasksCounter.Increment();
+		return false;
+	}
+
+	// Loading also creates the rule file info and detects the start rule, both are cached together with the resolve map
+	for (URulePackage* RulePackage : RulePackages)
+	{
+		LoadResolveMapAsync(RulePackage);
+	}
+	return true;
+}
 
-		FGraphEventRef LoadTask;
+void VitruvioModule::CompleteResolveMapLoad(const TLazyObjectPtr<URulePackage>& LazyRulePackagePtr,
+											const FLoadedRulePackagePtr& LoadedRulePackage) const
+{
+	TArray<TPromise<FLoadedRulePackagePtr>> Waiters;
+	TArray<FLoadedRulePackagePtr> EvictedRulePackages;
+	{
+		FWriteScopeLock WriteLock(ResolveMapCacheLock);
+
+		if (TArray<TPromise<FLoadedRulePackagePtr>>* PendingWaiters = PendingResolveMapLoads.Find(LazyRulePackagePtr))
 		{
-			FScopeLock Lock(&LoadResolveMapLock);
-			// Task which does the actual resolve map loading which might take a long time
-			LoadTask = TGraphTask<FLoadResolveMapTask>::CreateTask().ConstructAndDispatchWhenReady(MoveTemp(Promise), RpkFolder, LazyRulePackagePtr,
-																								   ResolveMapCache, LoadResolveMapLock);
-			ResolveMapEventGraphRefCache.Add(LazyRulePackagePtr, LoadTask);
+			Waiters = MoveTemp(*PendingWaiters);
+			PendingResolveMapLoads.Remove(LazyRulePackagePtr);
 		}
 
-		// Task which removes the event from the cache once finished
-		FFunctionGraphTask::CreateAndDispatchWhenReady(
-			[this, LazyRulePackagePtr]() {
-				FScopeLock Lock(&LoadResolveMapLock);
-				RpkLoadingTasksCounter.Decrement();
-				ResolveMapEventGraphRefCache.Remove(LazyRulePackagePtr);
-			},
-			TStatId(), LoadTask, ENamedThreads::AnyThread);
+		// Failed loads are not cached so that the next request tries again
+		if (LoadedRulePackage)
+		{
+			const int64 Size = LazyRulePackagePtr.IsValid() ? LazyRulePackagePtr->Data.Num() : 0;
+			ResolveMapCache.Add(LazyRulePackagePtr, FResolveMapCacheEntry{LoadedRulePackage, Size, ResolveMapAccessCounter.Increment()});
+			INC_MEMORY_STAT_BY(STAT_Vitruvio_ResolveMapCacheMemory, Size);
+			TrimResolveMapCache(EvictedRulePackages);
+		}
 	}
 
-	return Future;
+	// Waiters are completed outside of the lock since their continuations might request resolve maps themselves
+	for (TPromise<FLoadedRulePackagePtr>& Waiter : Waiters)
+	{
+		Waiter.SetValue(LoadedRulePackage);
+	}
+
+	for (const FLoadedRulePackagePtr& EvictedRulePackage : EvictedRulePackages)
+	{
+		FlushPrtCache(EvictedRulePackage);
+	}
+
+	RpkLoadingTasksCounter.Decrement();
+	DEC_DWORD_STAT(STAT_Vitruvio_LoadingRpks);
+	NotifyTaskCompleted();
 }
 
 #undef LOCTEXT_NAMESPACE
@@ -15,6 +15,8 @@
 
 #include "VitruvioTypes.h"
 
+#include "AttributeNames.h"
+
 #include "Runtime/Core/Public/Containers/UnrealString.h"
 #include "Runtime/Core/Public/Templates/TypeHash.h"
 
@@ -48,6 +50,30 @@ const TMap<FString, EMaterialPropertyType> KeyToTypeMap = {
 };
 // clang-format on
 
+struct FMaterialKeyIds
+{
+	TMap<int32, EMaterialPropertyType> KeyIdToType;
+	int32 DiffuseMapId = INDEX_NONE;
+};
+
+// Material keys are looked up by their interned ids, which avoids converting and hashing every key of every material. The types are keyed
+// by the case-insensitive ids, which matches keys the same way as the FString keys of KeyToTypeMap.
+const FMaterialKeyIds& GetMaterialKeyIds()
+{
+	static const FMaterialKeyIds MaterialKeyIds = []() {
+		Vitruvio::FAttributeNameTable& AttributeNameTable = Vitruvio::FAttributeNameTable::Get();
+
+		FMaterialKeyIds Result;
+		for (const TPair<FString, EMaterialPropertyType>& KeyAndType : KeyToTypeMap)
+		{
+			Result.KeyIdToType.Add(AttributeNameTable.FindOrAdd(KeyAndType.Key).CaseInsensitiveId, KeyAndType.Value);
+		}
+		Result.DiffuseMapId = AttributeNameTable.FindOrAdd(L"diffuseMap").Id;
+		return Result;
+	}();
+	return MaterialKeyIds;
+}
+
 FString FirstValidTextureUri(const prt::AttributeMap* MaterialAttributes, wchar_t const* Key)
 {
 	size_t ValuesCount = 0;
@@ -97,22 +123,27 @@ namespace Vitruvio
 {
 FMaterialAttributeContainer::FMaterialAttributeContainer(const prt::AttributeMap* AttributeMap)
 {
+	FAttributeNameTable& AttributeNameTable = FAttributeNameTable::Get();
+	const FMaterialKeyIds& MaterialKeyIds = GetMaterialKeyIds();
+
 	size_t KeyCount = 0;
 	wchar_t const* const* Keys = AttributeMap->getKeys(&KeyCount);
 	for (size_t KeyIndex = 0; KeyIndex < KeyCount; KeyIndex++)
 	{
 		const wchar_t* Key = Keys[KeyIndex];
-		const FString KeyString(Key);
+		const FAttributeName& KeyName = AttributeNameTable.FindOrAdd(Key);
 
-		if (!KeyToTypeMap.Contains(KeyString))
+		const EMaterialPropertyType* Type = MaterialKeyIds.KeyIdToType.Find(KeyName.CaseInsensitiveId);
+		if (!Type)
 		{
 			continue;
 		}
-		const EMaterialPropertyType Type = KeyToTypeMap[KeyString];
-		switch (Type)
+
+		const FString& KeyString = KeyName.Name;
+		switch (*Type)
 		{
 		case EMaterialPropertyType::Texture:
-			if (KeyString.Equals(TEXT("diffuseMap")))
+			if (KeyName.Id == MaterialKeyIds.DiffuseMapId)
 			{
 				FString ColorMapUri = GetTextureUriFromIdx(AttributeMap, Key, 0);
 				FString DirtMapUri = GetTextureUriFromIdx(AttributeMap, Key, 1);
@@ -0,0 +1,95 @@
+/* Copyright 2024 Esri
+ *
+ * Licensed under the Apache License Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Kismet/BlueprintAsyncActionBase.h"
+
+#include "BatchGenerateCallbackProxy.generated.h"
+
+class UVitruvioComponent;
+
+/** The attributes which are set on a single VitruvioComponent by SetAttributesForComponents. */
+USTRUCT(BlueprintType)
+struct FVitruvioComponentAttributes
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vitruvio")
+	UVitruvioComponent* VitruvioComponent = nullptr;
+
+	/** The attributes to be set, see UGenerateCompletedCallbackProxy::SetAttributes for the value format. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vitruvio")
+	TMap<FString, FString> Attributes;
+};
+
+UCLASS()
+class VITRUVIO_API UBatchGenerateCallbackProxy final : public UBlueprintAsyncActionBase
+{
+	GENERATED_BODY()
+
+public:
+	DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FComponentCompletedDynDelegate, UVitruvioComponent*, VitruvioComponent, int32, NumCompleted,
+												   int32, NumTotal);
+	DECLARE_MULTICAST_DELEGATE_ThreeParams(FComponentCompletedDelegate, UVitruvioComponent*, int32, int32);
+	DECLARE_DYNAMIC_MULTICAST_DELEGATE(FCompletedDynDelegate);
+	DECLARE_MULTICAST_DELEGATE(FCompletedDelegate);
+
+	/** Called after the attributes have been evaluated for all components. */
+	UPROPERTY(BlueprintAssignable, meta = (DisplayName = "Attributes Evaluated"), Category = "Vitruvio")
+	FCompletedDynDelegate OnAttributesEvaluatedBlueprint;
+	FCompletedDelegate OnAttributesEvaluated;
+
+	/** Called for every component as soon as its model has been generated, together with the progress of the whole batch. */
+	UPROPERTY(BlueprintAssignable, meta = (DisplayName = "Component Completed"), Category = "Vitruvio")
+	FComponentCompletedDynDelegate OnComponentCompletedBlueprint;
+	FComponentCompletedDelegate OnComponentCompleted;
+
+	/** Called after all components have been processed. Note that it is not guaranteed that this callback is ever called. */
+	UPROPERTY(BlueprintAssignable, meta = (DisplayName = "Completed"), Category = "Vitruvio")
+	FCompletedDynDelegate OnCompletedBlueprint;
+	FCompletedDelegate OnCompleted;
+
+	/**
+	 * Sets the given attributes on many VitruvioComponents at once. Instead of evaluating the attributes of every component separately, the
+	 * attributes of all components are evaluated together with a single PRT call per Rule Package. Afterwards all models are generated
+	 * (batch generated components are merged into their tiles). Components without valid input data (see HasValidInputData) are skipped.
+	 *
+	 * @param WorldContextObject
+	 * @param ComponentAttributes The components and the attributes to be set on them.
+	 * @param bGenerateModels Whether the models should be generated after the attributes have been set.
+	 * @returns a callback proxy used to register for progress and completion events.
+	 */
+	UFUNCTION(BlueprintCallable, meta = (BlueprintInternalUseOnly = true, WorldContext = "WorldContextObject"), Category = "Vitruvio")
+	static UBatchGenerateCallbackProxy* SetAttributesForComponents(UObject* WorldContextObject,
+																   const TArray<FVitruvioComponentAttributes>& ComponentAttributes,
+																   bool bGenerateModels = true);
+
+private:
+	UPROPERTY()
+	TArray<TWeakObjectPtr<UVitruvioComponent>> VitruvioComponents;
+
+	TArray<TMap<FString, FString>> Attributes;
+
+	bool bShouldGenerateModels = true;
+	int32 NumCompleted = 0;
+
+	void EvaluateAttributes(const TArray<UVitruvioComponent*>& Components, TFunction<void()> OnEvaluated);
+	void SetAttributesAndEvaluate();
+	void GenerateModels();
+	void CompleteComponent(UVitruvioComponent* VitruvioComponent);
+	void Complete();
+};
@@ -2,37 +2,78 @@
 
 #include "VitruvioMesh.h"
 
+#include "Engine/StaticMesh.h"
 #include "Interfaces/Interface_CollisionDataProvider.h"
+#include "PhysicsEngine/BodySetup.h"
 
 class VITRUVIO_API FCustomCollisionDataProvider : public IInterface_CollisionDataProvider
 {
 	virtual bool GetPhysicsTriMeshData(FTriMeshCollisionData* TriCollisionData, bool InUseAllTriData) override
 	{
-		if (!CollisionData.IsValid())
+		return CopyTriMeshData(CollisionData, TriCollisionData);
+	}
+
+	virtual bool ContainsPhysicsTriMeshData(bool InUseAllTriData) const override
+	{
+		return CollisionData && CollisionData->IsValid();
+	}
+
+public:
+	/**
+	 * Fills the cooking input from the given shared collision data. The cooking input has to own its arrays, so the (precomputed) arrays
+	 * are copied. Providers release their collision data once it has been cooked, so this happens at most once per cook.
+	 *
+	 * @param CollisionData		The collision data to copy from, may be null
+	 * @param TriCollisionData	The cooking input to fill
+	 */
+	static bool CopyTriMeshData(const FCollisionDataPtr& CollisionData, FTriMeshCollisionData* TriCollisionData)
+	{
+		if (!CollisionData || !CollisionData->IsValid())
 		{
 			return false;
 		}
 
-		TriCollisionData->Indices = CollisionData.Indices;
-		TArray<uint16> MaterialIndices;
-		MaterialIndices.SetNumZeroed(CollisionData.Indices.Num());
-		TriCollisionData->MaterialIndices = MaterialIndices;
-		TriCollisionData->Vertices = CollisionData.Vertices;
+		TriCollisionData->Indices = CollisionData->Indices;
+		TriCollisionData->MaterialIndices = CollisionData->MaterialIndices;
+		TriCollisionData->Vertices = CollisionData->Vertices;
 		TriCollisionData->bFlipNormals = true;
 		return true;
 	}
 
-	virtual bool ContainsPhysicsTriMeshData(bool InUseAllTriData) const override
+	void SetCollisionData(FCollisionDataPtr InCollisionData)
 	{
-		return CollisionData.IsValid();
+		CollisionData = MoveTemp(InCollisionData);
 	}
 
-public:
-	void SetCollisionData(const FCollisionData& InCollisionData)
+	/**
+	 * Releases the reference to the collision data, eg. once cooking succeeded and the CPU-side data is no longer needed.
+	 */
+	void ReleaseCollisionData()
+	{
+		CollisionData.Reset();
+	}
+
+	/**
+	 * Releases the reference to the collision data if the body setup of the given mesh has been cooked successfully. Components use the
+	 * cooked geometry of their mesh from then on.
+	 */
+	void ReleaseCollisionDataIfCooked(const UStaticMesh* StaticMesh)
+	{
+		const UBodySetup* BodySetup = StaticMesh ? StaticMesh->GetBodySetup() : nullptr;
+		if (BodySetup && BodySetup->bCreatedPhysicsMeshes && !BodySetup->bFailedToCreatePhysicsMeshes)
+		{
+			ReleaseCollisionData();
+		}
+	}
+
+	/**
+	 * @return whether a reference to the collision data is held.
+	 */
+	bool HasCollisionData() const
 	{
-		CollisionData = InCollisionData;
+		return CollisionData.IsValid();
 	}
 
 private:
-	FCollisionData CollisionData;
-};
\ No newline at end of file
+	FCollisionDataPtr CollisionData;
+};
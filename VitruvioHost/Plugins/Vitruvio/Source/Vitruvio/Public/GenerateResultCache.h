@@ -0,0 +1,108 @@
+/* Copyright 2024 Esri
+ *
+ * Licensed under the Apache License Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GeneratedCollision.h"
+#include "InitialShape.h"
+#include "UObject/ObjectKey.h"
+
+class URulePackage;
+struct FGenerateResultDescription;
+
+/**
+ * Identifies a generate result by everything it depends on. The polygon of an initial shape is defined relative to its actor, therefore
+ * duplicated or copy pasted actors share the same key regardless of where they are placed.
+ */
+struct FGenerateResultKey
+{
+	FGenerateResultKey() = default;
+	VITRUVIO_API FGenerateResultKey(URulePackage* RulePackage, const FInitialShapePolygon& Polygon, TArray<TPair<FString, FString>> Attributes,
+									int32 RandomSeed, const FGeneratedCollisionSettings& CollisionSettings);
+
+	/**
+	 * \brief Compares all inputs. Unlike FString comparisons, attribute values are compared case sensitive.
+	 */
+	VITRUVIO_API bool Equals(const FGenerateResultKey& Other) const;
+
+	friend bool operator==(const FGenerateResultKey& Lhs, const FGenerateResultKey& Rhs)
+	{
+		return Lhs.Equals(Rhs);
+	}
+
+	friend uint32 GetTypeHash(const FGenerateResultKey& Key)
+	{
+		return Key.Hash;
+	}
+
+private:
+	TObjectKey<URulePackage> RulePackage;
+	uint64 RulePackageDataHash = 0;
+	FInitialShapePolygon Polygon;
+	// Attribute names and values sorted by name
+	TArray<TPair<FString, FString>> Attributes;
+	int32 RandomSeed = 0;
+	FString CollisionKey;
+
+	uint32 Hash = 0;
+};
+
+/**
+ * Keeps the most recently generated results in memory and makes identical generate requests which are in flight at the same time wait for
+ * a single PRT call. The meshes of a shared result are shared as well and therefore only built once.
+ */
+class FGenerateResultCache
+{
+public:
+	using FGenerateResultPtr = TSharedPtr<const FGenerateResultDescription, ESPMode::ThreadSafe>;
+
+	/**
+	 * \brief Returns the cached result for the given key. Otherwise Generate is called on a new thread, unless a request with the same key is
+	 * already in flight in which case its result is shared.
+	 *
+	 * \return a future which is set to the result or to null if generating failed.
+	 */
+	VITRUVIO_API TFuture<FGenerateResultPtr> GetOrGenerateAsync(const FGenerateResultKey& Key, TUniqueFunction<FGenerateResultPtr()> Generate);
+
+	/**
+	 * \brief Limits the number of cached results. Once the limit is exceeded the least recently used results are evicted.
+	 *
+	 * \param NumEntries the maximum number of results or 0 to disable caching. Identical requests in flight are shared either way.
+	 */
+	VITRUVIO_API void SetMaxEntries(int32 NumEntries);
+
+	VITRUVIO_API void Empty();
+
+private:
+	struct FEntry
+	{
+		FGenerateResultPtr Result;
+		int64 LastAccess = 0;
+	};
+
+	FCriticalSection CacheCriticalSection;
+
+	TMap<FGenerateResultKey, FEntry> Cache;
+	TMap<FGenerateResultKey, TArray<TPromise<FGenerateResultPtr>>> PendingResults;
+	int64 AccessCounter = 0;
+	int32 MaxEntries = 256;
+
+	void CompleteResult(const FGenerateResultKey& Key, const FGenerateResultPtr& Result);
+
+	// Requires CacheCriticalSection to be held
+	void Trim();
+};
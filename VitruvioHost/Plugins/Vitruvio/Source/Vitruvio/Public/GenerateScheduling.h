@@ -0,0 +1,134 @@
+/* Copyright 2024 Esri
+ *
+ * Licensed under the Apache License Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "InitialShape.h"
+#include "UObject/ObjectKey.h"
+
+class URulePackage;
+
+namespace Vitruvio
+{
+/**
+ * \brief Estimates the relative cost of generating the given initial shape from its footprint area and vertex count. The estimate does not
+ * depend on the rule package, see FGenerateCostModel.
+ */
+VITRUVIO_API double EstimateGeometryCost(const FInitialShapePolygon& Polygon);
+
+/**
+ * \brief Returns the indices of the given costs ordered from the most to the least expensive. PRT hands out the initial shapes of a generate
+ * call to its worker threads in order, starting with the most expensive shapes (longest processing time first) keeps all threads busy
+ * until the end instead of waiting for a single expensive shape which has been started last.
+ *
+ * \param ShapeIndices break ties between equal costs, the shape with the lower index comes first. Defaults to the index of the cost.
+ */
+VITRUVIO_API TArray<int32> GetLongestFirstOrder(const TArray<double>& Costs, const TArray<int32>& ShapeIndices = {});
+
+/**
+ * \brief Returns the number of worker threads which can be used efficiently for the given costs. The makespan of a generate call can never
+ * be shorter than its most expensive shape, threads beyond the total cost divided by the maximum cost therefore do not finish any earlier.
+ */
+VITRUVIO_API int32 GetUsefulWorkerThreads(const TArray<double>& Costs, int32 MaxThreads);
+
+/**
+ * \brief Learns the generate time per unit of geometry cost for every rule package from previous generate calls. Thread safe.
+ */
+class VITRUVIO_API FGenerateCostModel
+{
+public:
+	/**
+	 * \return the generate time in seconds on a single thread per unit of geometry cost (see EstimateGeometryCost) of the given rule
+	 * package. Rule packages which have not been observed yet use the average of all observed rule packages.
+	 */
+	double GetSecondsPerCost(const URulePackage* RulePackage) const;
+
+	/**
+	 * \brief Records the time spent generating shapes of the given rule package with the given total geometry cost.
+	 */
+	void Observe(const URulePackage* RulePackage, double GeometryCost, double Seconds);
+
+private:
+	mutable FCriticalSection Lock;
+	TMap<TObjectKey<URulePackage>, double> SecondsPerCost;
+};
+
+/**
+ * \brief The number of PRT worker threads shared by all concurrent generate calls so that concurrent tiles do not each use all cores.
+ */
+class VITRUVIO_API FWorkerThreadBudget
+{
+public:
+	/**
+	 * \brief Reserves worker threads for a generate call. Blocks while the whole budget is in use, waiting calls are served in the order
+	 * they have called Acquire. Every call gets at least one thread and at most its fair share of the budget, which also counts the
+	 * waiting calls.
+	 *
+	 * \param Requested the number of threads the generate call can use efficiently.
+	 * \param Budget the total number of threads shared by all generate calls.
+	 * \return the number of reserved threads which have to be released again after the generate call.
+	 */
+	int32 Acquire(int32 Requested, int32 Budget);
+	void Release(int32 NumThreads);
+
+	/**
+	 * \return the number of calls which are waiting in Acquire.
+	 */
+	int32 GetNumWaiting() const;
+
+private:
+	// Wakes up the first waiting call, which checks again whether a thread is available. The lock has to be held.
+	void WakeUpFirstWaiting();
+
+	mutable FCriticalSection Lock;
+	int32 NumThreadsInUse = 0;
+	// Calls which hold or wait for threads
+	int32 NumActiveRequests = 0;
+
+	// Waiting calls in the order they have called Acquire
+	TArray<FEvent*> Waiters;
+};
+
+/**
+ * \brief Reserves worker threads from a FWorkerThreadBudget for the lifetime of this object.
+ */
+class FScopedWorkerThreads
+{
+public:
+	FScopedWorkerThreads(FWorkerThreadBudget& Budget, int32 Requested, int32 MaxThreads) : WorkerThreadBudget(Budget)
+	{
+		NumThreads = WorkerThreadBudget.Acquire(Requested, MaxThreads);
+	}
+
+	~FScopedWorkerThreads()
+	{
+		WorkerThreadBudget.Release(NumThreads);
+	}
+
+	FScopedWorkerThreads(const FScopedWorkerThreads&) = delete;
+	FScopedWorkerThreads& operator=(const FScopedWorkerThreads&) = delete;
+
+	int32 Num() const
+	{
+		return NumThreads;
+	}
+
+private:
+	FWorkerThreadBudget& WorkerThreadBudget;
+	int32 NumThreads = 0;
+};
+} // namespace Vitruvio
@@ -0,0 +1,90 @@
+/* Copyright 2024 Esri
+ *
+ * Licensed under the Apache License Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "GeneratedCollision.generated.h"
+
+UENUM(BlueprintType, DisplayName = "Vitruvio Collision Type")
+enum class EGeneratedCollisionType : uint8
+{
+	/** Uses every triangle of the generated mesh for collision. */
+	ComplexAsSimple UMETA(DisplayName = "Complex as Simple"),
+	/** Generated meshes do not have any collision. */
+	None,
+	/** A single box enclosing the whole generated mesh. */
+	BoundingBox UMETA(DisplayName = "Bounding Box"),
+	/** One box per connected part of the generated mesh. */
+	PartBoxes UMETA(DisplayName = "Part Boxes"),
+	/** One convex hull per connected part of the generated mesh. */
+	ConvexHulls UMETA(DisplayName = "Convex Hulls"),
+	/**
+	 * A decimated version of the generated mesh which deviates at most by the maximum simplification error, unless the maximum number of
+	 * triangles requires a coarser simplification.
+	 */
+	SimplifiedMesh UMETA(DisplayName = "Simplified Mesh")
+};
+
+USTRUCT(BlueprintType, DisplayName = "Vitruvio Collision Settings")
+struct VITRUVIO_API FGeneratedCollisionSettings
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vitruvio")
+	EGeneratedCollisionType CollisionType = EGeneratedCollisionType::ComplexAsSimple;
+
+	/**
+	 * The maximum number of boxes or convex hulls per mesh. If there are more parts, neighbouring parts are merged, preferring the merges which
+	 * add the least volume.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vitruvio",
+		meta = (EditCondition = "CollisionType == EGeneratedCollisionType::PartBoxes || CollisionType == EGeneratedCollisionType::ConvexHulls",
+			EditConditionHides, ClampMin = 1, ClampMax = 256))
+	int32 MaxElements = 16;
+
+	/** The maximum distance in cm by which the simplified collision mesh may deviate from the generated mesh. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vitruvio",
+		meta = (EditCondition = "CollisionType == EGeneratedCollisionType::SimplifiedMesh", EditConditionHides, ClampMin = 1, Units = "cm"))
+	float MaxSimplificationError = 25.0f;
+
+	/**
+	 * The maximum number of triangles of the simplified collision mesh. The simplification error is increased until the mesh fits, 0 means
+	 * no limit.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vitruvio",
+		meta = (EditCondition = "CollisionType == EGeneratedCollisionType::SimplifiedMesh", EditConditionHides, ClampMin = 0))
+	int32 MaxSimplifiedTriangles = 4096;
+
+	/**
+	 * \return a string which uniquely identifies these settings, used to distinguish cached meshes with different collision.
+	 */
+	FString ToCacheKey() const
+	{
+		return FString::Printf(TEXT("%d:%d:%g:%d"), static_cast<int32>(CollisionType), MaxElements, MaxSimplificationError, MaxSimplifiedTriangles);
+	}
+
+	friend bool operator==(const FGeneratedCollisionSettings& Lhs, const FGeneratedCollisionSettings& Rhs)
+	{
+		return Lhs.CollisionType == Rhs.CollisionType && Lhs.MaxElements == Rhs.MaxElements &&
+			   Lhs.MaxSimplificationError == Rhs.MaxSimplificationError && Lhs.MaxSimplifiedTriangles == Rhs.MaxSimplifiedTriangles;
+	}
+
+	friend bool operator!=(const FGeneratedCollisionSettings& Lhs, const FGeneratedCollisionSettings& Rhs)
+	{
+		return !(Lhs == Rhs);
+	}
+};
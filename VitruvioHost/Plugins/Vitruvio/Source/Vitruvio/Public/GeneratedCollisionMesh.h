@@ -0,0 +1,57 @@
+/* Copyright 2024 Esri
+ *
+ * Licensed under the Apache License Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CustomCollisionProvider.h"
+#include "Interfaces/Interface_CollisionDataProvider.h"
+#include "VitruvioMesh.h"
+
+#include "GeneratedCollisionMesh.generated.h"
+
+/**
+ * Provides the triangles of a collision mesh which differs from the render mesh (eg. a simplified mesh) for cooking. Used as the outer of
+ * the body setup of such meshes.
+ */
+UCLASS(Transient)
+class VITRUVIO_API UGeneratedCollisionMesh : public UObject, public IInterface_CollisionDataProvider
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool GetPhysicsTriMeshData(FTriMeshCollisionData* TriCollisionData, bool InUseAllTriData) override
+	{
+		return FCustomCollisionDataProvider::CopyTriMeshData(CollisionData, TriCollisionData);
+	}
+
+	virtual bool ContainsPhysicsTriMeshData(bool InUseAllTriData) const override
+	{
+		return CollisionData && CollisionData->IsValid();
+	}
+
+	void SetCollisionData(FCollisionDataPtr InCollisionData)
+	{
+		CollisionData = MoveTemp(InCollisionData);
+	}
+
+	void ReleaseCollisionData()
+	{
+		CollisionData.Reset();
+	}
+
+private:
+	FCollisionDataPtr CollisionData;
+};
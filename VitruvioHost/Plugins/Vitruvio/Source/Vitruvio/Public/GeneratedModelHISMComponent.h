@@ -37,6 +37,15 @@ public:
 		MeshIdentifier = NewMeshIdentifier;
 	}
 
+protected:
+	virtual void OnCreatePhysicsState() override
+	{
+		Super::OnCreatePhysicsState();
+
+		// The body setup of generated meshes is cooked when they are built, only keep the collision data if cooking failed
+		ReleaseCollisionDataIfCooked(GetStaticMesh());
+	}
+
 private:
 	FString MeshIdentifier;
 };
\ No newline at end of file
@@ -25,4 +25,13 @@ UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
 class VITRUVIO_API UGeneratedModelStaticMeshComponent : public UStaticMeshComponent, public FCustomCollisionDataProvider
 {
 	GENERATED_BODY()
+
+protected:
+	virtual void OnCreatePhysicsState() override
+	{
+		Super::OnCreatePhysicsState();
+
+		// The body setup of generated meshes is cooked when they are built, only keep the collision data if cooking failed
+		ReleaseCollisionDataIfCooked(GetStaticMesh());
+	}
 };
\ No newline at end of file
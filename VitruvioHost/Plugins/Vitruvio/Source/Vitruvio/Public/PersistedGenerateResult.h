@@ -0,0 +1,91 @@
+/* Copyright 2024 Esri
+ *
+ * Licensed under the Apache License Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Hash/xxhash.h"
+#include "VitruvioModule.h"
+
+#include "PersistedGenerateResult.generated.h"
+
+/**
+ * A generate result which is stored with the level so that loading the level does not have to generate it again. The result is only
+ * restored if the hash of the inputs it has been generated from still matches the current inputs.
+ */
+USTRUCT()
+struct VITRUVIO_API FPersistedGenerateResult
+{
+	GENERATED_BODY()
+
+	/** 64 bit hash of the inputs, a collision would restore a wrong model without any error. */
+	UPROPERTY()
+	uint64 InputHash = 0;
+
+	/** Whether materials of the result reference textures inside a Rule Package, which then has to be loaded before restoring. */
+	UPROPERTY()
+	bool bUsesRulePackageTextures = false;
+
+	UPROPERTY()
+	TArray<uint8> Data;
+
+	bool IsValid() const
+	{
+		return !Data.IsEmpty();
+	}
+};
+
+namespace Vitruvio
+{
+
+/**
+ * \brief Hashes the vertices, faces, holes and texture coordinates of the given polygon.
+ */
+VITRUVIO_API uint64 GetPolygonHash(const FInitialShapePolygon& Polygon);
+
+/**
+ * \brief Appends the length and the characters of the given string to the given hash, the hash is therefore case sensitive.
+ */
+VITRUVIO_API void AppendStringHash(FXxHash64Builder& Builder, const FString& String);
+
+/**
+ * \brief Serializes the generated model, instance meshes, instance transforms, materials and reports of the given result. Paths of textures
+ * inside Rule Packages are stored independent of the session specific Rule Package folder.
+ *
+ * \param Result the generate result to persist.
+ * \param InputHash the hash of all inputs the result has been generated from.
+ */
+VITRUVIO_API FPersistedGenerateResult PersistGenerateResult(const FGenerateResultDescription& Result, uint64 InputHash);
+
+/**
+ * \brief Deserializes a result created by PersistGenerateResult. Instance meshes are shared with other results through the mesh cache.
+ *
+ * \return false if the data is corrupt or has been written by an incompatible version.
+ */
+VITRUVIO_API bool RestoreGenerateResult(const FPersistedGenerateResult& PersistedResult, const FGeneratedCollisionSettings& CollisionSettings,
+										FGenerateResultDescription& OutResult);
+
+/**
+ * \brief Restores the given result on a worker thread without calling PRT generate. The Rule Packages are only loaded if the result uses
+ * textures inside them, restoring then starts once all of them have been loaded without blocking a thread while waiting.
+ *
+ * \return a future which is set to the restored result or to an empty optional if restoring failed.
+ */
+VITRUVIO_API TFuture<TOptional<FGenerateResultDescription>> RestoreGenerateResultAsync(FPersistedGenerateResult PersistedResult,
+																					   const TArray<URulePackage*>& RulePackages,
+																					   const FGeneratedCollisionSettings& CollisionSettings);
+
+} // namespace Vitruvio
@@ -46,4 +46,82 @@ struct VITRUVIO_API FReport
 
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Vitruvio")
 	FString Value;
+
+	/** The native value of Float and Int reports. Bool reports are 1 if true and 0 otherwise. String reports have no numeric value. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Vitruvio")
+	double NumericValue = 0.0;
+
+	bool IsNumeric() const
+	{
+		return Type == EReportPrimitiveType::Float || Type == EReportPrimitiveType::Int || Type == EReportPrimitiveType::Bool;
+	}
+};
+
+/**
+ * Aggregated values of all reports with the same name, eg. of all shapes of a batch tile. The sum of Bool reports is the number of true
+ * values, String reports are only counted. Sum, Min, Max and the mean only cover the numeric reports.
+ */
+USTRUCT(BlueprintType, DisplayName = "Vitruvio Report Statistics")
+struct VITRUVIO_API FReportStatistics
+{
+	GENERATED_USTRUCT_BODY();
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Vitruvio")
+	FString Name;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Vitruvio")
+	EReportPrimitiveType Type = EReportPrimitiveType::None;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Vitruvio")
+	int32 Count = 0;
+
+	/** The number of numeric reports, a report may be emitted as String by some shapes and as a number by others. */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Vitruvio")
+	int32 NumericCount = 0;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Vitruvio")
+	double Sum = 0.0;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Vitruvio")
+	double Min = 0.0;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Vitruvio")
+	double Max = 0.0;
+
+	void Add(const FReport& Report);
+	void Merge(const FReportStatistics& Other);
+	bool IsNumeric() const;
+
+	double GetMean() const
+	{
+		return NumericCount > 0 ? Sum / NumericCount : 0.0;
+	}
 };
+
+namespace Vitruvio
+{
+/**
+ * \brief Adds the reports of a single generated shape to the given statistics.
+ */
+VITRUVIO_API void AddReports(TMap<FString, FReportStatistics>& Statistics, const TMap<FString, FReport>& Reports);
+
+/**
+ * \brief Adds a single report, eg. reported by a CGA report operation of a shape, to the given statistics.
+ */
+VITRUVIO_API void AddReport(TMap<FString, FReportStatistics>& Statistics, const FReport& Report);
+
+/**
+ * \brief Merges already aggregated statistics, eg. of several tiles, into the given statistics.
+ */
+VITRUVIO_API void MergeReportStatistics(TMap<FString, FReportStatistics>& Statistics, const TMap<FString, FReportStatistics>& Other);
+
+/**
+ * \brief Formats the statistics as CSV with one row per report name, sorted by name.
+ */
+VITRUVIO_API FString ReportStatisticsToCsv(const TMap<FString, FReportStatistics>& Statistics);
+
+/**
+ * \brief Formats the statistics as a JSON array with one object per report name, sorted by name.
+ */
+VITRUVIO_API FString ReportStatisticsToJson(const TMap<FString, FReportStatistics>& Statistics);
+} // namespace Vitruvio
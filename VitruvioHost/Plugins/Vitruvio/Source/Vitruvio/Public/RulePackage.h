@@ -16,6 +16,8 @@
 #pragma once
 
 #include "Containers/Array.h"
+#include "Hash/xxhash.h"
+#include "Misc/Optional.h"
 #include "UObject/Object.h"
 #include "UObject/ObjectSaveContext.h"
 
@@ -32,6 +34,23 @@ public:
 	UPROPERTY()
 	FString SourcePath;
 
+	/** Replaces the content of this Rule Package, eg. after it has been reimported. */
+	void SetData(TArray<uint8> NewData)
+	{
+		Data = MoveTemp(NewData);
+		DataHash.Reset();
+	}
+
+	/** Returns a hash of the content of this Rule Package. The hash is computed on first use and cached until the content changes. */
+	uint64 GetDataHash() const
+	{
+		if (!DataHash)
+		{
+			DataHash = FXxHash64::HashBuffer(Data.GetData(), Data.Num()).Hash;
+		}
+		return *DataHash;
+	}
+
 	virtual void PreSave(FObjectPreSaveContext SaveContext) override
 	{
 		Super::PreSave(SaveContext);
@@ -56,6 +75,7 @@ public:
 			Data.Empty(NewArrayNum);
 			Data.AddUninitialized(NewArrayNum);
 			Ar.Serialize(Data.GetData(), NewArrayNum);
+			DataHash.Reset();
 		}
 		else if (Ar.IsSaving())
 		{
@@ -64,4 +84,7 @@ public:
 			Ar.Serialize(Data.GetData(), ArrayNum);
 		}
 	}
+
+private:
+	mutable TOptional<uint64> DataHash;
 };
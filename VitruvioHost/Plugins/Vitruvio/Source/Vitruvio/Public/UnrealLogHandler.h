@@ -20,25 +20,82 @@
 #include "Windows/WindowsCriticalSection.h"
 #include "Containers/Array.h"
 #include "Containers/UnrealString.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "HAL/ThreadSafeCounter64.h"
+#include "Templates/Atomic.h"
 
 struct FLogMessage
 {
 	FString Message;
 	prt::LogLevel Level;
+	// Order in which the messages have been captured across all threads
+	uint64 Sequence = 0;
+};
+
+struct FLogMessageCounts
+{
+	int32 Counts[prt::LOG_FATAL + 1] = {};
+
+	int32 operator[](prt::LogLevel Level) const
+	{
+		return Level <= prt::LOG_FATAL ? Counts[Level] : 0;
+	}
 };
 
 class UnrealLogHandler final : public prt::LogHandler
 {
+	// Messages are distributed over multiple shards (by thread) to reduce lock contention between the PRT worker threads
+	static constexpr int32 NumShards = 8;
+
+	struct FMessageShard
+	{
+		FCriticalSection Lock;
+		TArray<FLogMessage> Messages;
+		int32 Head = 0;
+	};
 
-	TArray<FLogMessage> Messages;
-	FCriticalSection MessageLock;
+	FMessageShard Shards[NumShards];
+	int32 ShardCapacity;
+
+	TAtomic<prt::LogLevel> MinCaptureLevel;
+
+	FThreadSafeCounter MessageCounts[prt::LOG_FATAL + 1];
+	FThreadSafeCounter DroppedMessages;
+	FThreadSafeCounter64 NextSequence;
 
 public:
-	UnrealLogHandler() = default;
+	/**
+	 * \param MinCaptureLevel the minimum level of messages which are captured and returned by PopMessages. Does not affect console output.
+	 * \param Capacity the maximum number of captured messages. If exceeded, the oldest messages are overwritten.
+	 */
+	explicit UnrealLogHandler(prt::LogLevel MinCaptureLevel = prt::LOG_WARNING, int32 Capacity = 4096);
 
 	virtual ~UnrealLogHandler() = default;
 
-	TArray<FLogMessage> PopMessages();
+	/**
+	 * \brief Returns and removes all captured messages in the order in which they have been captured and resets the message counts.
+	 *
+	 * \param OutCounts if set, receives the number of messages per level since the last call, including messages which were not captured.
+	 */
+	TArray<FLogMessage> PopMessages(FLogMessageCounts* OutCounts = nullptr);
+
+	void SetMinCaptureLevel(prt::LogLevel Level)
+	{
+		MinCaptureLevel = Level;
+	}
+
+	prt::LogLevel GetMinCaptureLevel() const
+	{
+		return MinCaptureLevel;
+	}
+
+	/**
+	 * \return the number of captured messages which have been overwritten because the capacity was exceeded.
+	 */
+	int32 GetNumDroppedMessages() const
+	{
+		return DroppedMessages.GetValue();
+	}
 
 	void handleLogEvent(const wchar_t* msg, prt::LogLevel level) override;
 	const prt::LogLevel* getLevels(size_t* count) override;
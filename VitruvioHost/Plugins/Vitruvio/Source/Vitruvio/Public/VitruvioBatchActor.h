@@ -17,6 +17,7 @@
 
 #include "CoreMinimal.h"
 
+#include "PersistedGenerateResult.h"
 #include "VitruvioModule.h"
 #include "GenerateCompletedCallbackProxy.h"
 
@@ -38,6 +39,27 @@ public:
 	bool bMarkedForGenerate;
 	bool bIsGenerating;
 
+	/** Whether the generated model of this tile has been released because it is too far away from all viewers. */
+	UPROPERTY(BlueprintReadOnly, VisibleAnywhere, Category = "Vitruvio")
+	bool bStreamedOut = false;
+
+	/**
+	 * Whether the last generate of this tile has failed for all of its shapes, eg. because their Rule Package could not be loaded. The tile
+	 * has no model then. If only some Rule Packages could not be loaded, the shapes of the other Rule Packages are still generated.
+	 */
+	UPROPERTY(BlueprintReadOnly, VisibleAnywhere, Category = "Vitruvio")
+	bool bGenerateFailed = false;
+
+	// Serialized result of the last generate, cached when the tile is streamed out to restore it without generating again. Only kept if tile
+	// streaming is enabled and the result is not already persisted with the level.
+	TSharedPtr<FPersistedGenerateResult> GeneratedResult;
+
+	// Reports of all shapes of the last generated model aggregated by name
+	TMap<FString, FReportStatistics> ReportStatistics;
+
+	// Reports of the last generated model aggregated by name for every shape of this tile
+	TMap<const UVitruvioComponent*, TMap<FString, FReportStatistics>> ShapeReportStatistics;
+
 	UPROPERTY()
 	TMap<UVitruvioComponent*, UGenerateCompletedCallbackProxy*> CallbackProxies;
 
@@ -84,6 +106,9 @@ struct FBatchGenerateQueueItem
 	FGenerateResultDescription GenerateResultDescription;
 	UTile* Tile;
 	TArray<UVitruvioComponent*> VitruvioComponents;
+	// Set if the result should be stored with the level or kept for tile streaming, the input hash is only known once the evaluated
+	// attributes have been applied
+	TOptional<FPersistedGenerateResult> PersistedResult;
 };
 
 UCLASS(NotBlueprintable, NotPlaceable)
@@ -95,10 +120,37 @@ public:
 	UPROPERTY(EditAnywhere, Category = "Vitruvio")
 	FIntVector2 GridDimension = {50000, 50000};
 
+	/** Collision created for all batch generated models and their instances. */
+	UPROPERTY(EditAnywhere, DisplayName = "Collision", Category = "Vitruvio")
+	FGeneratedCollisionSettings CollisionSettings;
+
 #if WITH_EDITORONLY_DATA
 	UPROPERTY(EditAnywhere, Category = "Vitruvio")
 	bool bDebugVisualizeGrid = false;
 #endif
+
+	/** Only keep the generated models of tiles close to the viewers resident. */
+	UPROPERTY(EditAnywhere, Category = "Vitruvio Streaming")
+	bool bEnableTileStreaming = false;
+
+	/** Tiles closer than this distance to any viewer are generated or restored from the result cache. */
+	UPROPERTY(EditAnywhere, Category = "Vitruvio Streaming", meta = (EditCondition = "bEnableTileStreaming", ClampMin = 0, Units = "cm"))
+	double StreamingLoadRadius = 200000.0;
+
+	/** Additional distance beyond the load radius before a tile is released, prevents tiles at the border from being reloaded repeatedly. */
+	UPROPERTY(EditAnywhere, Category = "Vitruvio Streaming", meta = (EditCondition = "bEnableTileStreaming", ClampMin = 0, Units = "cm"))
+	double StreamingHysteresis = 50000.0;
+
+	/** Maximum number of released tiles whose serialized generate results are kept to restore them without generating again. */
+	UPROPERTY(EditAnywhere, Category = "Vitruvio Streaming", meta = (EditCondition = "bEnableTileStreaming", ClampMin = 0))
+	int32 MaxCachedTileResults = 16;
+
+	/**
+	 * Stores the generated models of all tiles with the level. Loading the level then restores the tiles without generating them again as
+	 * long as none of their components has changed. Increases the size of the level.
+	 */
+	UPROPERTY(EditAnywhere, AdvancedDisplay, Category = "Vitruvio")
+	bool bPersistGeneratedModels = false;
 	
 private:
 	UPROPERTY(Transient)
@@ -115,6 +167,16 @@ private:
 	UPROPERTY(Transient)
 	TSet<UVitruvioComponent*> VitruvioComponents;
 
+	// Serialized generate results of streamed out tiles, least recently streamed out first
+	TMap<FIntPoint, TSharedPtr<FPersistedGenerateResult>> CachedTileResults;
+	TArray<FIntPoint> CachedTileResultOrder;
+
+	// Generated models of all tiles if bPersistGeneratedModels is set
+	UPROPERTY()
+	TMap<FIntPoint, FPersistedGenerateResult> PersistedTileResults;
+
+	TOptional<TArray<FVector>> StreamingSourcesOverride;
+
 	/** Default parent material for opaque geometry. */
 	UPROPERTY(EditAnywhere, DisplayName = "Opaque Parent", Category = "Vitruvio Default Materials")
 	UMaterial* OpaqueParent;
@@ -145,9 +207,56 @@ public:
 	TSet<UVitruvioComponent*> GetVitruvioComponents();
 
 	void Generate(UVitruvioComponent* VitruvioComponent, UGenerateCompletedCallbackProxy* CallbackProxy = nullptr);
+
+	/**
+	 * Generates all tiles. Streamed out tiles are generated as well and their results are cached until they are streamed in again, the
+	 * callback is only called once every tile has been generated.
+	 */
 	void GenerateAll(UGenerateCompletedCallbackProxy* CallbackProxy = nullptr);
 	
 	FIntPoint GetPosition(const UVitruvioComponent* VitruvioComponent) const;
+
+	/**
+	 * Overrides the viewer locations used for tile streaming, eg. for scripted camera paths or headless sessions. By default the view
+	 * locations rendered in the last frame are used.
+	 */
+	void SetStreamingSources(const TArray<FVector>& Locations);
+	void ClearStreamingSources();
+
+	/**
+	 * \return the number of tiles which are not streamed out.
+	 */
+	int32 GetNumResidentTiles() const;
+
+	/**
+	 * \return the number of tiles which contain at least one registered component.
+	 */
+	int32 GetNumTiles() const;
+
+	/**
+	 * \return the locations of all resident tiles which are neither generating nor have a generated model, eg. because generation failed.
+	 */
+	TArray<FIntPoint> GetTilesWithoutModel() const;
+
+	/**
+	 * \return the locations of all tiles whose last generate has failed.
+	 */
+	TArray<FIntPoint> GetFailedTiles() const;
+
+	/**
+	 * \return the reports of all shapes of the tile at the given location aggregated by name.
+	 */
+	TMap<FString, FReportStatistics> GetTileReportStatistics(const FIntPoint& Location) const;
+
+	/**
+	 * \return the reports of the shape of the given component aggregated by name.
+	 */
+	TMap<FString, FReportStatistics> GetComponentReportStatistics(const UVitruvioComponent* VitruvioComponent) const;
+
+	/**
+	 * \return the reports of all shapes of all tiles aggregated by name.
+	 */
+	TMap<FString, FReportStatistics> GetReportStatistics() const;
 	
 #if WITH_EDITOR
 	virtual bool CanDeleteSelectedActor(FText& OutReason) const override;
@@ -172,6 +281,18 @@ public:
 private:
 	void ProcessTiles();
 	void ProcessGenerateQueue();
+	void NotifyTileGenerated(UTile* Tile);
+	void NotifyIfAllGenerated();
+
+	UGeneratedModelStaticMeshComponent* GetOrCreateModelComponent(UTile* Tile);
+	double GetDistanceToTile(const UTile* Tile, const FVector& Location) const;
+
+	void UpdateTileStreaming();
+	void StreamOutTile(UTile* Tile);
+	void StreamInTile(UTile* Tile);
+	void CacheTileResult(const FIntPoint& Location, TSharedPtr<FPersistedGenerateResult> Result);
+	void ClearTileResultCache();
+	void RestoreTile(UTile* Tile, const FPersistedGenerateResult& PersistedResult, const TArray<URulePackage*>& RulePackages);
 
 	FCriticalSection ProcessQueueCriticalSection;
 
@@ -17,6 +17,7 @@
 
 #include "CoreMinimal.h"
 #include "Kismet/BlueprintFunctionLibrary.h"
+#include "Report.h"
 #include "RulePackage.h"
 #include "VitruvioActor.h"
 
@@ -57,4 +58,34 @@ public:
 	 */
 	UFUNCTION(BlueprintCallable, Category = "Vitruvio")
 	static VITRUVIO_API bool CanConvertToVitruvioActor(AActor* Actor);
+
+	/**
+	 * Returns the reports of all batch generated VitruvioComponents in the world aggregated by name. The reports are aggregated per tile
+	 * while generating, see also UVitruvioComponent::GetReportStatistics for the reports of a single component.
+	 *
+	 * @param WorldContextObject
+	 * @return the aggregated reports of all batch generated models.
+	 */
+	UFUNCTION(BlueprintCallable, meta = (WorldContext = "WorldContextObject"), Category = "Vitruvio")
+	static VITRUVIO_API TMap<FString, FReportStatistics> GetBatchReportStatistics(UObject* WorldContextObject);
+
+	/**
+	 * Writes the given report statistics to a CSV file with one row per report name.
+	 *
+	 * @param ReportStatistics the aggregated reports to export.
+	 * @param FilePath the path of the CSV file, relative paths are relative to the project directory.
+	 * @return whether the file has been written successfully.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Vitruvio")
+	static VITRUVIO_API bool ExportReportStatisticsToCsv(const TMap<FString, FReportStatistics>& ReportStatistics, const FString& FilePath);
+
+	/**
+	 * Writes the given report statistics to a JSON file containing an array with one object per report name.
+	 *
+	 * @param ReportStatistics the aggregated reports to export.
+	 * @param FilePath the path of the JSON file, relative paths are relative to the project directory.
+	 * @return whether the file has been written successfully.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Vitruvio")
+	static VITRUVIO_API bool ExportReportStatisticsToJson(const TMap<FString, FReportStatistics>& ReportStatistics, const FString& FilePath);
 };
\ No newline at end of file
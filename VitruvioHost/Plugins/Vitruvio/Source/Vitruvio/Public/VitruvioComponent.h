@@ -25,6 +25,7 @@
 #include "InitialShape.h"
 #include "InstanceReplacement.h"
 #include "MaterialReplacement.h"
+#include "PersistedGenerateResult.h"
 #include "VitruvioTypes.h"
 
 #include "VitruvioComponent.generated.h"
@@ -42,6 +43,17 @@ struct FGenerateOptions
 	bool bIgnoreMaterialReplacements = false;
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vitruvio")
 	bool bIgnoreInstanceReplacements = false;
+	/** Skips creating collision for previews which are replaced by a complete model shortly after, eg. while dragging a slider. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vitruvio")
+	bool bSkipCollision = false;
+	/** Skips creating the instanced meshes (eg. inserted assets) for previews, only the merged model of the shape is shown. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vitruvio")
+	bool bSkipInstances = false;
+
+	bool IsPreview() const
+	{
+		return bSkipCollision || bSkipInstances;
+	}
 };
 
 struct FAttributesEvaluationQueueItem
@@ -49,6 +61,16 @@ struct FAttributesEvaluationQueueItem
 	FAttributeMapPtr AttributeMap;
 	bool bForceRegenerate;
 	UGenerateCompletedCallbackProxy* CallbackProxy;
+	FGenerateOptions GenerateOptions;
+};
+
+// Changes collected until the regenerate delay of the component has passed (see UVitruvioComponent::RequestGenerate)
+struct FGenerateRequest
+{
+	bool bEvaluateAttributes = false;
+	bool bGenerateModel = false;
+	bool bInteractive = false;
+	double DueTime = 0.0;
 };
 
 struct FGenerateQueueItem
@@ -56,6 +78,8 @@ struct FGenerateQueueItem
 	FGenerateResultDescription GenerateResultDescription;
 	FGenerateOptions GenerateOptions;
 	UGenerateCompletedCallbackProxy* CallbackProxy;
+	// Set if the result should be stored with the level, serialized on the generate thread
+	TOptional<FPersistedGenerateResult> PersistedResult;
 };
 
 struct FInstance
@@ -100,8 +124,24 @@ FString UniqueComponentName(const FString& Name, TMap<FString, int32>& UsedNames
 void ApplyMaterialReplacements(UStaticMeshComponent* StaticMeshComponent, const TMap<UMaterialInterface*, FString>& MaterialIdentifiers,
 							   UMaterialReplacementAsset* Replacement);
 
+/**
+ * Samples a replacement option and a randomly scaled and rotated transform for every given instance transform. Each transform samples from its
+ * own random stream seeded by InstanceSeed, the transform location and the number of preceding transforms at the same location. The result
+ * does not depend on whether sampling is distributed over multiple threads and, up to swapping co-located transforms, not on their order.
+ *
+ * @param OutOptionIndices	The index into InstanceReplacement.Replacements of the sampled option for every transform
+ * @param OutTransforms		The modified transform for every transform
+ */
+void SampleInstanceReplacements(const FInstanceReplacement& InstanceReplacement, const TArray<FTransform>& Transforms, uint32 InstanceSeed,
+								bool bForceSingleThread, TArray<int32>& OutOptionIndices, TArray<FTransform>& OutTransforms);
+
+/**
+ * Replaces the given instances according to the replacement asset. Replacement options, scales and rotations are sampled deterministically
+ * from the random seed, the instance mesh identifier and the position of each instance.
+ */
 TSet<FInstance> ApplyInstanceReplacements(UGeneratedModelStaticMeshComponent* GeneratedModelComponent, 
-											  const TArray<FInstance>& Instances, UInstanceReplacementAsset* Replacement, TMap<FString, int32>& NameMap);
+											  const TArray<FInstance>& Instances, UInstanceReplacementAsset* Replacement, TMap<FString, int32>& NameMap,
+											  int32 RandomSeed = 0);
 
 UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
 class VITRUVIO_API UVitruvioComponent : public UActorComponent
@@ -116,6 +156,7 @@ class VITRUVIO_API UVitruvioComponent : public UActorComponent
 
 	bool bIsGenerating = false;
 	bool bHasGeneratedModel = false;
+	bool bHasPreviewModel = false;
 
 	bool bNotifyAttributeChange = false;
 
@@ -132,6 +173,26 @@ public:
 		meta = (EditCondition = "!bBatchGenerate", EditConditionHides))
 	bool HideAfterGeneration = false;
 
+	/**
+	 * Changes in the editor are collected for this time before the model is generated again. Dragging a slider or a spline point therefore
+	 * only generates the latest state instead of every intermediate step.
+	 */
+	UPROPERTY(EditAnywhere, AdvancedDisplay, DisplayName = "Regenerate Delay", Category = "Vitruvio", meta = (ClampMin = 0, Units = "s"))
+	float RegenerateDelay = 0.15f;
+
+	/** Collision created for the generated model and its instances. The collision is computed on the generate worker thread. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, DisplayName = "Collision", Category = "Vitruvio",
+		meta = (EditCondition = "!bBatchGenerate", EditConditionHides))
+	FGeneratedCollisionSettings CollisionSettings;
+
+	/**
+	 * Stores the generated model with the level. Loading the level then restores the model without generating it again as long as the Rule
+	 * Package, initial shape, attributes, random seed and collision settings have not changed. Increases the size of the level.
+	 */
+	UPROPERTY(EditAnywhere, AdvancedDisplay, DisplayName = "Persist Generated Model", Category = "Vitruvio",
+		meta = (EditCondition = "!bBatchGenerate", EditConditionHides))
+	bool bPersistGeneratedModel = false;
+
 	/** Default parent material for opaque geometry. */
 	UPROPERTY(EditAnywhere, DisplayName = "Opaque Parent", Category = "Vitruvio Default Materials",
 		meta = (EditCondition = "!bBatchGenerate", EditConditionHides))
@@ -379,6 +440,13 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Vitruvio")
 	const TMap<FString, FReport>& GetReports() const;
 
+	/**
+	 * Returns the reports created during generation aggregated by name, see FReportStatistics. Batch generated components aggregate every
+	 * report operation of their shape.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Vitruvio")
+	TMap<FString, FReportStatistics> GetReportStatistics() const;
+
 	/** Sets the visibility of the initial shape component. */
 	UFUNCTION(BlueprintCallable, Category = "Vitruvio")
 	void SetInitialShapeVisible(bool bVisible);
@@ -404,6 +472,12 @@ public:
 	/* Returns whether this component has a generated model */
 	bool HasGeneratedModel() const;
 
+	/* Returns whether the generated model is a preview with reduced detail, which is replaced once the interaction has ended */
+	bool HasPreviewModel() const;
+
+	/* Returns whether this component is waiting for an ongoing or requested generate or attribute evaluation call */
+	bool HasPendingPrtCalls() const;
+
 	/* Returns the generated model component */
 	UGeneratedModelStaticMeshComponent* GetGeneratedModelComponent() const;
 
@@ -417,8 +491,53 @@ public:
 	 * Evaluate rule attributes.
 	 *
 	 * @param ForceRegenerate Whether to force regenerate even if generate automatically is set to false
+	 * @param GenerateOptions The options used for generating the model after the evaluation
+	 */
+	void EvaluateRuleAttributes(bool ForceRegenerate = false, UGenerateCompletedCallbackProxy* CallbackProxy = nullptr,
+								const FGenerateOptions& GenerateOptions = {});
+
+	/**
+	 * Requests to evaluate the attributes and/or generate the model once RegenerateDelay has passed without further requests. All requests
+	 * within the delay are merged into one which uses the state of the component at the time it is executed (latest wins). A request waits
+	 * for the ongoing generate or attribute evaluation to complete instead of discarding its result.
+	 *
+	 * @param bEvaluateAttributes Whether the attributes have to be evaluated first
+	 * @param bGenerateModel Whether the model should be generated
+	 * @param bInteractive Whether the change is part of an ongoing interaction (eg. dragging a slider). Interactive requests generate a
+	 * preview without collision, instanced meshes and replacements, see HasPreviewModel.
+	 */
+	void RequestGenerate(bool bEvaluateAttributes, bool bGenerateModel, bool bInteractive = false);
+
+	/**
+	 * Sets the values of the given attributes without evaluating the attributes or generating a model. Only attributes which already exist
+	 * are set, so the attributes should be ready (see GetAttributesReady). Used to change many components before evaluating them together.
+	 *
+	 * @param NewAttributes The attributes to be set (see SetAttributes for the value format).
+	 */
+	void SetAttributeValues(const TMap<FString, FString>& NewAttributes);
+
+	/**
+	 * Applies attributes which have been evaluated outside of this component, eg. in a batch together with other components. An ongoing
+	 * attribute evaluation of this component is discarded.
+	 *
+	 * @param AttributeMap The evaluated attributes.
 	 */
-	void EvaluateRuleAttributes(bool ForceRegenerate = false, UGenerateCompletedCallbackProxy* CallbackProxy = nullptr);
+	void ApplyEvaluatedAttributes(const FAttributeMapPtr& AttributeMap);
+
+	/* Returns the initial shape including the current attributes used for generation. Requires HasValidInputData. */
+	FInitialShape CreateInitialShape() const;
+
+	/* Returns the PRT attribute map of the current attributes. The map is only rebuilt after the attributes have changed. */
+	AttributeMapSPtr GetAttributeMap() const;
+
+	/* Has to be called after attribute values have been modified directly so that the next generate call uses the new values. */
+	void MarkAttributesChanged()
+	{
+		++AttributesGeneration;
+	}
+
+	/* Returns a hash of the Rule Package, initial shape, attributes and random seed used for generation. */
+	uint64 GetGenerateInputHash() const;
 
 	/* Returns whether the initial shape type can be changed */
 	bool CanChangeInitialShapeType() const
@@ -450,6 +569,8 @@ public:
 
 	void LoadInitialShape();
 
+	virtual void OnRegister() override;
+	virtual void OnUnregister() override;
 	virtual void OnComponentDestroyed(bool bDestroyingHierarchy) override;
 
 	void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
@@ -497,6 +618,17 @@ private:
 	FGenerateResult::FTokenPtr GenerateToken;
 	FAttributeMapResult::FTokenPtr EvalAttributesInvalidationToken;
 
+	TOptional<FGenerateRequest> PendingGenerateRequest;
+
+	// Incremented whenever the attributes might have changed, the cached attribute map is rebuilt once it is outdated
+	uint32 AttributesGeneration = 0;
+	mutable uint32 CachedAttributeMapGeneration = 0;
+	mutable AttributeMapSPtr CachedAttributeMap;
+
+	/** The last generated model if bPersistGeneratedModel is set. */
+	UPROPERTY()
+	FPersistedGenerateResult PersistedGenerateResult;
+
 	bool HasGeneratedMesh = false;
 
 	// Note that these are only unique per VitruvioComponent
@@ -510,6 +642,12 @@ private:
 
 	void ProcessGenerateQueue();
 	void ProcessAttributesEvaluationQueue();
+	void ProcessGenerateRequest();
+
+	uint64 GetPersistedGenerateInputHash() const;
+	bool RestorePersistedGenerateResult();
+
+	FGenerateResultKey CreateGenerateResultKey(const FGeneratedCollisionSettings& GenerateCollisionSettings) const;
 
 #if WITH_EDITOR
 	FDelegateHandle PropertyChangeDelegate;
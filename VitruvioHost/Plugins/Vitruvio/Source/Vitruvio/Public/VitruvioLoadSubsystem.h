@@ -0,0 +1,177 @@
+/* Copyright 2024 Esri
+ *
+ * Licensed under the Apache License Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "VitruvioModule.h"
+
+#include "VitruvioLoadSubsystem.generated.h"
+
+class UVitruvioComponent;
+
+/**
+ * Schedules the initial attribute evaluation and generation of VitruvioComponents. Components are initialized on their first tick, which
+ * after opening a level happens for all components in the same frame. Instead of every component starting its own PRT calls at once, the
+ * components are started in the order of their priority (selected actors first, then by distance to the viewers) with a bounded number
+ * of PRT calls in flight. Components sharing a Rule Package are evaluated together in a single PRT call. The Rule Packages used in the
+ * world are preloaded in the background as soon as the world has been opened, see PreloadRulePackages.
+ */
+UCLASS()
+class VITRUVIO_API UVitruvioLoadSubsystem final : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	DECLARE_MULTICAST_DELEGATE_OneParam(FOnLoadStarted, UVitruvioLoadSubsystem*);
+	DECLARE_MULTICAST_DELEGATE_ThreeParams(FOnLoadProgress, UVitruvioLoadSubsystem*, int32, int32);
+	DECLARE_MULTICAST_DELEGATE_TwoParams(FOnLoadCompleted, UVitruvioLoadSubsystem*, bool);
+
+	/** Called when the first component is scheduled while no load is in progress, eg. after opening a level. */
+	static FOnLoadStarted OnLoadStarted;
+
+	/** Called with the number of completed and the total number of scheduled components whenever a component has been completed. */
+	static FOnLoadProgress OnLoadProgress;
+
+	/** Called once all scheduled components have been completed or the load has been cancelled. */
+	static FOnLoadCompleted OnLoadCompleted;
+
+	virtual void Deinitialize() override;
+	virtual void OnWorldComponentsUpdated(UWorld& World) override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	virtual bool IsTickableInEditor() const override
+	{
+		return true;
+	}
+
+	/**
+	 * Schedules the attribute evaluation and, if bGenerateModel is set, the generation of the given component.
+	 */
+	void Schedule(UVitruvioComponent* VitruvioComponent, bool bGenerateModel);
+
+	/**
+	 * Drops all components which have not been started yet. Ongoing PRT calls can not be aborted, their components are evaluated but not
+	 * generated. Cancelled components are generated again as soon as they are changed.
+	 */
+	void Cancel();
+
+	/**
+	 * Called by components when they are registered with or unregistered from the world. Only registered components are considered by
+	 * PreloadRulePackages, which therefore does not need to iterate all actors of the world.
+	 */
+	void RegisterVitruvioComponent(UVitruvioComponent* VitruvioComponent);
+	void UnregisterVitruvioComponent(UVitruvioComponent* VitruvioComponent);
+
+	/**
+	 * Loads the Rule Packages of all registered VitruvioComponents (including batch generated ones) in the background, so that their
+	 * resolve maps and rule file info are ready before the components are initialized. Rule Packages used by more components are loaded
+	 * first. Rule Packages which have already been preloaded for this world are skipped.
+	 */
+	void PreloadRulePackages();
+
+	/**
+	 * Called by components once their generated model has been registered with the world, which makes it visible.
+	 */
+	void NotifyModelRegistered(const UVitruvioComponent* VitruvioComponent);
+
+	/**
+	 * Sets the maximum number of evaluate and generate calls started by this subsystem which are in flight at once. A value of 0 uses the
+	 * number of PRT worker threads.
+	 */
+	void SetMaxInFlightRequests(int32 MaxRequests);
+	int32 GetMaxInFlightRequests() const;
+
+	bool IsLoading() const
+	{
+		return bLoading;
+	}
+
+	int32 GetNumCompleted() const
+	{
+		return NumCompleted;
+	}
+
+	int32 GetNumTotal() const
+	{
+		return NumTotal;
+	}
+
+	/** Returns the highest number of PRT calls which have been in flight at once during the current or last load. */
+	int32 GetPeakInFlightRequests() const
+	{
+		return PeakInFlightRequests;
+	}
+
+	/**
+	 * Returns the time in seconds from the start of the current or last load until the first generated model has been registered with the
+	 * world, or -1. This includes building the meshes on the game thread and not only the PRT calls.
+	 */
+	double GetTimeToFirstVisibleModel() const
+	{
+		return TimeToFirstVisibleModel;
+	}
+
+private:
+	struct FScheduledComponent
+	{
+		TWeakObjectPtr<UVitruvioComponent> VitruvioComponent;
+		bool bGenerateModel = false;
+
+		// Sort keys, updated before the pending components are sorted
+		bool bSelected = false;
+		double DistanceSquared = 0.0;
+	};
+
+	// Waiting for their attributes to be evaluated
+	TArray<FScheduledComponent> PendingComponents;
+	// Evaluated and waiting for a free slot to generate, in the order of their priority
+	TArray<FScheduledComponent> EvaluatedComponents;
+	TArray<TWeakObjectPtr<UVitruvioComponent>> GeneratingComponents;
+
+	UPROPERTY()
+	TSet<UVitruvioComponent*> RegisteredComponents;
+
+	TSet<TObjectKey<URulePackage>> PreloadedRulePackages;
+
+	int32 NumEvaluateRequestsInFlight = 0;
+	int32 MaxInFlightRequests = 0;
+
+	bool bLoading = false;
+	// Incremented on cancel, evaluations of a cancelled load do not generate anymore
+	uint32 LoadId = 0;
+
+	int32 NumCompleted = 0;
+	int32 NumTotal = 0;
+	int32 PeakInFlightRequests = 0;
+	double LoadStartTime = 0.0;
+	double TimeToFirstVisibleModel = -1.0;
+
+	int32 GetNumInFlightRequests() const
+	{
+		return NumEvaluateRequestsInFlight + GeneratingComponents.Num();
+	}
+
+	void UpdateGeneratingComponents();
+	void StartGenerates();
+	void StartEvaluations();
+	void SortPendingComponents();
+	void CompleteEvaluation(const TArray<FScheduledComponent>& Components, const TArray<FAttributeMapPtr>& AttributeMaps, uint32 EvaluationLoadId);
+	void CompleteComponents(int32 Num);
+	void FinishLoad(bool bCancelled);
+};
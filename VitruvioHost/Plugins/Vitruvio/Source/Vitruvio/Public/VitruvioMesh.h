@@ -15,6 +15,7 @@
 
 #pragma once
 
+#include "GeneratedCollision.h"
 #include "MeshDescription.h"
 #include "VitruvioTypes.h"
 #include "Runtime/PhysicsCore/Public/Interface_CollisionDataProviderCore.h"
@@ -28,15 +29,44 @@ UMaterialInstanceDynamic* CacheMaterial(UMaterial* OpaqueParent, UMaterial* Mask
 
 struct FCollisionData
 {
+	EGeneratedCollisionType CollisionType = EGeneratedCollisionType::ComplexAsSimple;
+
+	// Triangle mesh used for complex collision
 	TArray<FTriIndices> Indices;
 	TArray<FVector3f> Vertices;
 
+	// Material index per triangle (the index of the polygon group the triangle belongs to), precomputed for cooking
+	TArray<uint16> MaterialIndices;
+
+	// Simple collision shapes which are used instead of the triangle mesh
+	TArray<FBox3f> Boxes;
+	TArray<TArray<FVector3f>> ConvexHulls;
+
 	bool IsValid() const
 	{
 		return Indices.Num() > 0 && Vertices.Num() > 0;
 	}
+
+	bool HasSimpleCollision() const
+	{
+		return Boxes.Num() > 0 || ConvexHulls.Num() > 0;
+	}
+
+	SIZE_T GetAllocatedSize() const
+	{
+		SIZE_T Size = Indices.GetAllocatedSize() + Vertices.GetAllocatedSize() + MaterialIndices.GetAllocatedSize() + Boxes.GetAllocatedSize() +
+					  ConvexHulls.GetAllocatedSize();
+		for (const TArray<FVector3f>& ConvexHull : ConvexHulls)
+		{
+			Size += ConvexHull.GetAllocatedSize();
+		}
+		return Size;
+	}
 };
 
+// Collision data is immutable once created and shared between the mesh, its components and the cooking input providers
+using FCollisionDataPtr = TSharedPtr<const FCollisionData, ESPMode::ThreadSafe>;
+
 class FVitruvioMesh
 {
 	FString Identifier;
@@ -45,12 +75,13 @@ class FVitruvioMesh
 	TArray<Vitruvio::FMaterialAttributeContainer> Materials;
 
 	UStaticMesh* StaticMesh;
-	FCollisionData CollisionData;
+	FCollisionDataPtr CollisionData;
 
 public:
 	FVitruvioMesh(const FString& Identifier, const FMeshDescription& MeshDescription,
-				  const TArray<Vitruvio::FMaterialAttributeContainer>& Materials)
-		: Identifier(Identifier), MeshDescription(MeshDescription), Materials(Materials), StaticMesh(nullptr)
+				  const TArray<Vitruvio::FMaterialAttributeContainer>& Materials, FCollisionData CollisionData = {})
+		: Identifier(Identifier), MeshDescription(MeshDescription), Materials(Materials), StaticMesh(nullptr),
+		  CollisionData(MakeShared<const FCollisionData, ESPMode::ThreadSafe>(MoveTemp(CollisionData)))
 	{
 	}
 
@@ -66,16 +97,26 @@ public:
 		return Materials;
 	}
 
+	const FMeshDescription& GetMeshDescription() const
+	{
+		return MeshDescription;
+	}
+
 	UStaticMesh* GetStaticMesh() const
 	{
 		return StaticMesh;
 	}
 
-	const FCollisionData& GetCollisionData() const
+	const FCollisionDataPtr& GetCollisionData() const
 	{
 		return CollisionData;
 	}
 
+	/**
+	 * \return an estimate of the memory in bytes used by the mesh description and collision data.
+	 */
+	SIZE_T GetAllocatedSize() const;
+
 	void Build(const FString& Name, TMap<Vitruvio::FMaterialAttributeContainer, TObjectPtr<UMaterialInstanceDynamic>>& MaterialCache,
 			   TMap<FString, Vitruvio::FTextureData>& TextureCache, TMap<UMaterialInterface*, FString>& MaterialIdentifiers,
 			   TMap<FString, int32>& UniqueMaterialNames, UMaterial* OpaqueParent, UMaterial* MaskedParent, UMaterial* TranslucentParent);
@@ -16,6 +16,9 @@
 #pragma once
 
 #include "AttributeMap.h"
+#include "GenerateResultCache.h"
+#include "GenerateScheduling.h"
+#include "GeneratedCollision.h"
 #include "InitialShape.h"
 #include "MeshCache.h"
 #include "PRTTypes.h"
@@ -25,8 +28,11 @@
 #include "prt/Object.h"
 
 #include "Engine/StaticMesh.h"
+#include "HAL/Event.h"
 #include "HAL/ThreadSafeCounter.h"
+#include "HAL/ThreadSafeCounter64.h"
 #include "HAL/ThreadSafeBool.h"
+#include "Misc/ScopeRWLock.h"
 #include "Modules/ModuleManager.h"
 
 #include "UnrealLogHandler.h"
@@ -46,8 +52,18 @@ struct FGenerateResultDescription
 	TMap<FString, FString> InstanceNames;
 	
 	TMap<FString, FReport> Reports;
+	// Reports aggregated over all generated shapes, computed on the generate thread
+	TMap<FString, FReportStatistics> ReportStatistics;
+	// Reports of the CGA report operations aggregated per initial shape, in the same order as EvaluatedAttributes
+	TArray<TMap<FString, FReportStatistics>> ShapeReportStatistics;
 
+	// Evaluated attributes in the order of the initial shapes of a batch generate, null for shapes whose Rule Package could not be loaded
 	TArray<FAttributeMapPtr> EvaluatedAttributes;
+
+	// Wall clock time in seconds spent in the individual stages of this generate request
+	double LoadResolveMapTime = 0.0;
+	double EvaluateAttributesTime = 0.0;
+	double GenerateTime = 0.0;
 };
 
 class FInvalidationToken
@@ -96,11 +112,14 @@ public:
 	FTokenPtr Token;
 };
 
+// Attribute maps are immutable and shared by all generate calls of a component, see UVitruvioComponent::GetAttributeMap
+using AttributeMapSPtr = std::shared_ptr<const prt::AttributeMap>;
+
 struct FInitialShape
 {
 	FVector Offset;
 	FInitialShapePolygon Polygon;
-	AttributeMapUPtr Attributes;
+	AttributeMapSPtr Attributes;
 	int32 RandomSeed = 0;
 	URulePackage* RulePackage = nullptr;
 };
@@ -108,6 +127,53 @@ struct FInitialShape
 using FGenerateResult = TResult<FGenerateResultDescription, FGenerateToken>;
 using FBatchGenerateResult = TResult<FGenerateResultDescription, FGenerateToken>;
 using FAttributeMapResult = TResult<FAttributeMapPtr, FEvalAttributesToken>;
+using FBatchAttributeMapResult = TResult<TArray<FAttributeMapPtr>, FEvalAttributesToken>;
+
+// A loaded Rule Package together with the rule file info and start rule of its rule file. Every evaluate and generate call needs them, they are
+// therefore created once when the Rule Package is loaded and cached with it.
+struct FLoadedRulePackage
+{
+	ResolveMapSPtr ResolveMap;
+	RuleFileInfoPtr RuleFileInfo;
+	std::wstring RuleFile;
+	std::wstring StartRule;
+};
+
+using FLoadedRulePackagePtr = TSharedPtr<const FLoadedRulePackage, ESPMode::ThreadSafe>;
+
+/**
+ * \brief Replaces the PRT calls of VitruvioModule, eg. by a mock generator in automation tests. Loading, caching, scheduling and the in-flight
+ * counters of the module stay the same. All functions are called on worker threads, also concurrently.
+ */
+class IGenerateBackend
+{
+public:
+	virtual ~IGenerateBackend() = default;
+
+	/**
+	 * \brief Loads the given Rule Package. Concurrent requests for the same Rule Package share a single load.
+	 *
+	 * \return whether loading succeeded.
+	 */
+	virtual bool LoadRulePackage(URulePackage* RulePackage) = 0;
+
+	/**
+	 * \brief Evaluates the attributes of the given initial shapes, whose Rule Packages have been loaded.
+	 *
+	 * \return the evaluated attributes in the order of the given initial shapes. An entry is null if its evaluation failed.
+	 */
+	virtual TArray<FAttributeMapPtr> EvaluateAttributes(const TArray<const FInitialShape*>& InitialShapes) = 0;
+
+	/**
+	 * \brief Generates the models of the given initial shapes, whose Rule Packages have been loaded.
+	 *
+	 * \param NumWorkerThreads the number of worker threads reserved for this call.
+	 * \return the generated models. The ShapeReportStatistics are in the order of the given initial shapes and are aggregated by the caller.
+	 */
+	virtual FGenerateResultDescription Generate(const TArray<const FInitialShape*>& InitialShapes, int32 NumWorkerThreads) = 0;
+};
+
+using FGenerateBackendPtr = TSharedPtr<IGenerateBackend, ESPMode::ThreadSafe>;
 
 class VitruvioModule final : public IModuleInterface, public FGCObject
 {
@@ -126,34 +192,52 @@ public:
 	 * \brief Asynchronously evaluates the attributes and generates the models for all given InitialShapes.
 	 *
 	 * \param InitialShapes
+	 * \param CollisionSettings defines the collision created for all generated meshes (on the worker thread).
 	 * \return the generated UStaticMesh.
 	 */
-	VITRUVIO_API FBatchGenerateResult BatchGenerateAsync(TArray<FInitialShape> InitialShapes) const;
+	VITRUVIO_API FBatchGenerateResult BatchGenerateAsync(TArray<FInitialShape> InitialShapes, FGeneratedCollisionSettings CollisionSettings = {}) const;
 
 	/**
-	 * \brief Generate the models with the given InitialShapes.
+	 * \brief Generate the models with the given InitialShapes. Initial shapes whose Rule Package can not be loaded are skipped, the
+	 * initial shapes of all other Rule Packages are still generated.
 	 *
 	 * \param InitialShapes
-	 * \return the generated UStaticMesh.
+	 * \param CollisionSettings defines the collision created for all generated meshes.
+	 * \return the generated UStaticMesh. Skipped initial shapes have no evaluated attributes, the result is empty if no initial shape
+	 * has been generated.
 	 */
-	VITRUVIO_API FGenerateResultDescription BatchGenerate(TArray<FInitialShape> InitialShapes) const;
+	VITRUVIO_API FGenerateResultDescription BatchGenerate(TArray<FInitialShape> InitialShapes,
+		const FGeneratedCollisionSettings& CollisionSettings = {}) const;
 
 	/**
 	 * \brief Asynchronously generate the models with the given InitialShape, RulePackage and Attributes.
 	 *
 	 * \param InitialShape
+	 * \param CollisionSettings defines the collision created for all generated meshes (on the worker thread).
 	 * \return the generated UStaticMesh.
 	 */
-	VITRUVIO_API FGenerateResult GenerateAsync(FInitialShape InitialShape) const;
+	VITRUVIO_API FGenerateResult GenerateAsync(FInitialShape InitialShape, FGeneratedCollisionSettings CollisionSettings = {}) const;
 
+	/**
+	 * \brief Like GenerateAsync, but shares the result with all requests for the same key, eg. of duplicated or copy pasted actors. Cached
+	 * results are returned immediately and identical requests which are in flight at the same time wait for a single PRT call.
+	 *
+	 * \param InitialShape
+	 * \param Key identifies the result, has to be created from the same inputs as the InitialShape and the CollisionSettings.
+	 * \param CollisionSettings defines the collision created for all generated meshes (on the worker thread).
+	 * \return the generated UStaticMesh.
+	 */
+	VITRUVIO_API FGenerateResult GenerateSharedAsync(FInitialShape InitialShape, const FGenerateResultKey& Key,
+													 FGeneratedCollisionSettings CollisionSettings = {}) const;
 
 	/**
 	 * \brief Generate the models with the given InitialShape, RulePackage and Attributes.
 	 *
 	 * \param InitialShape
+	 * \param CollisionSettings defines the collision created for all generated meshes.
 	 * \return the generated UStaticMesh.
 	 */
-	VITRUVIO_API FGenerateResultDescription Generate(const FInitialShape& InitialShape) const;
+	VITRUVIO_API FGenerateResultDescription Generate(const FInitialShape& InitialShape, const FGeneratedCollisionSettings& CollisionSettings = {}) const;
 
 	/**
 	 * \brief Asynchronously evaluates attributes for the given initial shape and rule package.
@@ -163,6 +247,14 @@ public:
 	 */
 	VITRUVIO_API FAttributeMapResult EvaluateRuleAttributesAsync(FInitialShape InitialShape) const;
 
+	/**
+	 * \brief Asynchronously evaluates the attributes of all given initial shapes with a single PRT call per rule package.
+	 *
+	 * \param InitialShapes
+	 * \return the evaluated attributes in the order of the given initial shapes. An entry is null if its evaluation failed.
+	 */
+	VITRUVIO_API FBatchAttributeMapResult BatchEvaluateRuleAttributesAsync(TArray<FInitialShape> InitialShapes) const;
+
 	/**
 	 * \return whether PRT is initialized meaning installed and ready to use. Before initialization generation is not possible and will
 	 * immediately return without results.
@@ -172,6 +264,43 @@ public:
 		return Initialized;
 	}
 
+	/**
+	 * \brief Initializes PRT if this has not already happened on startup. Vitruvio is not started for commandlets by default, commandlets
+	 * which generate models (eg. UVitruvioGenerateCommandlet) have to call this before any generate call.
+	 *
+	 * \return whether PRT is initialized.
+	 */
+	VITRUVIO_API bool InitializeForCommandlet();
+
+	/**
+	 * \brief Replaces PRT by the given backend for all following evaluate and generate calls, eg. by a mock generator in automation tests.
+	 * Must only be called while no calls are in flight. Loaded Rule Packages are evicted since they belong to the previous backend.
+	 *
+	 * \param Backend the backend to use or null to use PRT again.
+	 */
+	VITRUVIO_API void SetGenerateBackend(const FGenerateBackendPtr& Backend);
+
+	/**
+	 * \brief Limits the number of worker threads PRT uses for all concurrent generate calls together, eg. to stay within the CPU budget of a
+	 * build machine. Generate calls wait while all worker threads are in use.
+	 *
+	 * \param NumThreads the maximum number of worker threads or a value <= 0 to use all cores.
+	 */
+	VITRUVIO_API void SetMaxWorkerThreads(int32 NumThreads);
+
+	/**
+	 * \return the number of worker threads shared by all concurrent generate calls.
+	 */
+	VITRUVIO_API int32 GetNumWorkerThreads() const;
+
+	/**
+	 * \brief Limits the memory used by cached resolve maps. Once the budget is exceeded the least recently used resolve maps which are not
+	 * used by an ongoing call are evicted together with their PRT cache entries. The memory of a resolve map is estimated by its RPK size.
+	 *
+	 * \param BudgetBytes the maximum memory or a value <= 0 for an unbounded cache.
+	 */
+	VITRUVIO_API void SetResolveMapCacheBudget(int64 BudgetBytes);
+
 	/**
 	 * \return true if currently at least one generate call ongoing.
 	 */
@@ -196,6 +325,52 @@ public:
 		return RpkLoadingTasksCounter.GetValue() > 0;
 	}
 
+	/**
+	 * \brief Loads the given Rule Package in the background if it is not loaded yet. Loading also extracts the Rule Package for PRT, which
+	 * is required to decode the textures it contains.
+	 *
+	 * \return a future which is set to true once the Rule Package has been loaded or to false if loading failed.
+	 */
+	VITRUVIO_API TFuture<bool> LoadRulePackageAsync(URulePackage* RulePackage) const;
+
+	/**
+	 * \brief Loads the given Rule Packages in the background together with their rule file info and start rule, so that the first evaluate
+	 * and generate calls do not have to wait for them. Loads are started in the given order.
+	 *
+	 * \param RulePackages the Rule Packages to preload, ordered by their priority.
+	 * \return false if nothing could be loaded since neither PRT is initialized nor a generate backend has been set.
+	 */
+	VITRUVIO_API bool PreloadRulePackagesAsync(const TArray<URulePackage*>& RulePackages) const;
+
+	/**
+	 * \return the file URI of the folder to which Rule Packages are extracted for PRT. The folder changes with every session, URIs of
+	 * resources inside Rule Packages therefore must not be stored with this prefix.
+	 */
+	VITRUVIO_API const FString& GetRpkFolderUri() const
+	{
+		return RpkFolderUri;
+	}
+
+	/**
+	 * \brief Blocks the calling thread until all generate calls, RPK loading and attribute evaluation tasks have completed. Instead of
+	 * polling, the thread sleeps until one of these tasks completes. If called from the game thread, queued game thread tasks are
+	 * processed while waiting, unless the caller is itself a game thread task.
+	 *
+	 * \param StallTimeoutSeconds the maximum time to wait without any task completing or a negative value to wait indefinitely.
+	 * \param OnProgress called whenever the waiting thread wakes up with the number of remaining generate calls.
+	 * \return true if all tasks have completed or false if no task has completed within the stall timeout.
+	 */
+	VITRUVIO_API bool WaitUntilIdle(double StallTimeoutSeconds = -1.0, TFunction<void(int32)> OnProgress = nullptr) const;
+
+	/**
+	 * \brief Blocks the calling thread until a generate call, RPK loading or attribute evaluation task completes or the timeout expires.
+	 * Unlike WaitUntilIdle this allows the caller to process intermediate results (eg. by ticking the world) while waiting.
+	 *
+	 * \param TimeoutMilliseconds the maximum time to wait.
+	 * \return true if a task has completed.
+	 */
+	VITRUVIO_API bool WaitForTaskCompleted(uint32 TimeoutMilliseconds) const;
+
 	/**
 	 * \returns the cache used for materials generated by PRT.
 	 */
@@ -204,6 +379,11 @@ public:
 		return MaterialCache;
 	}
 
+	/**
+	 * \brief Removes all cached materials, eg. when the world they have been created for is torn down.
+	 */
+	VITRUVIO_API void EmptyMaterialCache();
+
 	/**
 	 * \returns the cache used for instanced meshes by PRT.
 	 */
@@ -212,6 +392,14 @@ public:
 		return MeshCache;
 	}
 
+	/**
+	 * \returns the cache of generate results shared by GenerateSharedAsync.
+	 */
+	VITRUVIO_API FGenerateResultCache& GetGenerateResultCache()
+	{
+		return GenerateResultCache;
+	}
+
 	/**
 	 * \returns the cache used for materials generated by PRT.
 	 */
@@ -232,7 +420,7 @@ public:
 
 	DECLARE_MULTICAST_DELEGATE_OneParam(FOnGenerateCompleted, int);
 
-	DECLARE_MULTICAST_DELEGATE_TwoParams(FOnAllGenerateCompleted, int, int);
+	DECLARE_MULTICAST_DELEGATE_ThreeParams(FOnAllGenerateCompleted, int, int, const TArray<FLogMessage>&);
 
 	/**
 	 * Delegate which is called after a generate call has completed.
@@ -240,7 +428,8 @@ public:
 	FOnGenerateCompleted OnGenerateCompleted;
 
 	/**
-	 * Delegate which is called after all generate calls have completed.
+	 * Delegate which is called after all generate calls have completed with the number of PRT warnings and errors and the captured PRT messages
+	 * (see UnrealLogHandler) since the previous call.
 	 */
 	FOnAllGenerateCompleted OnAllGenerateCompleted;
 
@@ -274,27 +463,71 @@ private:
 
 	TAtomic<bool> Initialized = false;
 
-	mutable TMap<TLazyObjectPtr<URulePackage>, ResolveMapSPtr> ResolveMapCache;
-	mutable TMap<TLazyObjectPtr<URulePackage>, FGraphEventRef> ResolveMapEventGraphRefCache;
+	FGenerateBackendPtr GenerateBackend;
+	mutable FCriticalSection GenerateBackendLock;
 
-	mutable FCriticalSection LoadResolveMapLock;
+	struct FResolveMapCacheEntry
+	{
+		FLoadedRulePackagePtr LoadedRulePackage;
+		// Estimated memory of the resolve map
+		int64 Size = 0;
+		// Stamped atomically by cache hits which only hold the read lock
+		mutable int64 LastAccess = 0;
+	};
+
+	// Cache hits only take ResolveMapCacheLock for reading, loads, evictions and trimming take it for writing
+	mutable TMap<TLazyObjectPtr<URulePackage>, FResolveMapCacheEntry> ResolveMapCache;
+	// Everyone who requests a resolve map which is currently being loaded waits for that same load
+	mutable TMap<TLazyObjectPtr<URulePackage>, TArray<TPromise<FLoadedRulePackagePtr>>> PendingResolveMapLoads;
+	mutable FThreadSafeCounter64 ResolveMapAccessCounter;
+	int64 ResolveMapCacheBudget = 512 * 1024 * 1024;
+
+	mutable FRWLock ResolveMapCacheLock;
 
 	mutable FThreadSafeCounter GenerateCallsCounter;
 	mutable FThreadSafeCounter RpkLoadingTasksCounter;
 	mutable FThreadSafeCounter LoadAttributesCounter;
+	mutable FThreadSafeCounter CompletedTasksCounter;
+
+	FThreadSafeCounter MaxWorkerThreads;
+	mutable Vitruvio::FWorkerThreadBudget WorkerThreadBudget;
+	mutable Vitruvio::FGenerateCostModel GenerateCostModel;
+
+	FEventRef TaskCompletedEvent;
 
 	FString RpkFolder;
+	FString RpkFolderUri;
 
 	TMap<Vitruvio::FMaterialAttributeContainer, TObjectPtr<UMaterialInstanceDynamic>> MaterialCache;
 	TMap<FString, Vitruvio::FTextureData> TextureCache;
 	FMeshCache MeshCache;
+	mutable FGenerateResultCache GenerateResultCache;
 
 	FCriticalSection RegisterMeshLock;
 	TSet<TObjectPtr<UStaticMesh>> RegisteredMeshes;
 
+	FGenerateBackendPtr GetGenerateBackend() const;
+
+	// Whether evaluate and generate calls can be served, either by PRT or by a generate backend
+	bool CanGenerate() const;
+
+	void NotifyTaskCompleted() const;
 	void NotifyGenerateCompleted() const;
 
-	TFuture<ResolveMapSPtr> LoadResolveMapAsync(URulePackage* RulePackage) const;
+	// Release the in-flight counters of finished (successful or failed) generate calls and attribute evaluations
+	void CompleteGenerateCalls(int32 NumGenerateCalls) const;
+	void CompleteEvaluation() const;
+
+	TFuture<FLoadedRulePackagePtr> LoadResolveMapAsync(URulePackage* RulePackage) const;
+
+	void CompleteResolveMapLoad(const TLazyObjectPtr<URulePackage>& LazyRulePackagePtr, const FLoadedRulePackagePtr& LoadedRulePackage) const;
+
+	// Require ResolveMapCacheLock to be held for writing. The evicted Rule Packages are returned so that their PRT cache entries can be flushed
+	// after the lock has been released.
+	void TrimResolveMapCache(TArray<FLoadedRulePackagePtr>& EvictedRulePackages) const;
+	FLoadedRulePackagePtr RemoveFromResolveMapCache(const TLazyObjectPtr<URulePackage>& LazyRulePackagePtr) const;
+
+	void FlushPrtCache(const FLoadedRulePackagePtr& LoadedRulePackage) const;
 	void InitializePrt();
 
 	VITRUVIO_API void EvictFromResolveMapCache(URulePackage* RulePackage);
@@ -0,0 +1,50 @@
+/* Copyright 2024 Esri
+ *
+ * Licensed under the Apache License Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "Stats/Stats.h"
+
+DECLARE_STATS_GROUP(TEXT("Vitruvio"), STATGROUP_Vitruvio, STATCAT_Advanced);
+
+// Pipeline stages
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Load Resolve Map"), STAT_Vitruvio_LoadResolveMap, STATGROUP_Vitruvio, VITRUVIO_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Evaluate Attributes"), STAT_Vitruvio_EvaluateAttributes, STATGROUP_Vitruvio, VITRUVIO_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Generate"), STAT_Vitruvio_Generate, STATGROUP_Vitruvio, VITRUVIO_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Batch Generate"), STAT_Vitruvio_BatchGenerate, STATGROUP_Vitruvio, VITRUVIO_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Convert Mesh"), STAT_Vitruvio_ConvertMesh, STATGROUP_Vitruvio, VITRUVIO_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Create Vitruvio Mesh"), STAT_Vitruvio_CreateVitruvioMesh, STATGROUP_Vitruvio, VITRUVIO_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Create Collision"), STAT_Vitruvio_CreateCollision, STATGROUP_Vitruvio, VITRUVIO_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Build Static Mesh"), STAT_Vitruvio_BuildStaticMesh, STATGROUP_Vitruvio, VITRUVIO_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Create Material"), STAT_Vitruvio_CreateMaterial, STATGROUP_Vitruvio, VITRUVIO_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Load Texture"), STAT_Vitruvio_LoadTexture, STATGROUP_Vitruvio, VITRUVIO_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Decode Texture"), STAT_Vitruvio_DecodeTexture, STATGROUP_Vitruvio, VITRUVIO_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Process Generate Queue"), STAT_Vitruvio_ProcessGenerateQueue, STATGROUP_Vitruvio, VITRUVIO_API);
+
+// Caches
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Mesh Cache"), STAT_Vitruvio_MeshCacheMemory, STATGROUP_Vitruvio, VITRUVIO_API);
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Material Cache"), STAT_Vitruvio_MaterialCacheMemory, STATGROUP_Vitruvio, VITRUVIO_API);
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Texture Cache"), STAT_Vitruvio_TextureCacheMemory, STATGROUP_Vitruvio, VITRUVIO_API);
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Resolve Map Cache"), STAT_Vitruvio_ResolveMapCacheMemory, STATGROUP_Vitruvio, VITRUVIO_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Generate Result Cache Entries"), STAT_Vitruvio_GenerateResultCacheEntries, STATGROUP_Vitruvio, VITRUVIO_API);
+
+// Queues and in-flight work
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("In-Flight Generates"), STAT_Vitruvio_InFlightGenerates, STATGROUP_Vitruvio, VITRUVIO_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("In-Flight Attribute Evaluations"), STAT_Vitruvio_InFlightEvaluations, STATGROUP_Vitruvio, VITRUVIO_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Loading RPKs"), STAT_Vitruvio_LoadingRpks, STATGROUP_Vitruvio, VITRUVIO_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Generate Queue Depth"), STAT_Vitruvio_GenerateQueueDepth, STATGROUP_Vitruvio, VITRUVIO_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Attributes Queue Depth"), STAT_Vitruvio_AttributesQueueDepth, STATGROUP_Vitruvio, VITRUVIO_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Pending Load Components"), STAT_Vitruvio_PendingLoadComponents, STATGROUP_Vitruvio, VITRUVIO_API);
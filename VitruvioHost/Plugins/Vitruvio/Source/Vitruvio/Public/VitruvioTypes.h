@@ -91,8 +91,16 @@ struct FMaterialAttributeContainer
 	FString BlendMode;
 	FString Name; // ignored on purpose for hash and equality
 
+	FMaterialAttributeContainer() = default;
 	explicit FMaterialAttributeContainer(const prt::AttributeMap* AttributeMap);
 
+	friend FArchive& operator<<(FArchive& Ar, FMaterialAttributeContainer& Container)
+	{
+		Ar << Container.TextureProperties << Container.ColorProperties << Container.ScalarProperties << Container.StringProperties;
+		Ar << Container.BlendMode << Container.Name;
+		return Ar;
+	}
+
 	friend bool operator==(const FMaterialAttributeContainer& Lhs, const FMaterialAttributeContainer& RHS)
 	{
 		// clang-format off
@@ -132,6 +140,12 @@ struct FInstanceCacheKey
 
 	friend uint32 GetTypeHash(const FInstanceCacheKey& Object);
 
+	friend FArchive& operator<<(FArchive& Ar, FInstanceCacheKey& Key)
+	{
+		Ar << Key.MeshId << Key.MaterialOverrides;
+		return Ar;
+	}
+
 	friend bool operator==(const FInstanceCacheKey& Lhs, const FInstanceCacheKey& RHS)
 	{
 		return Lhs.MeshId == RHS.MeshId && Lhs.MaterialOverrides == RHS.MaterialOverrides;
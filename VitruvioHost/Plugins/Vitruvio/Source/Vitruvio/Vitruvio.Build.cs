@@ -66,6 +66,7 @@ public class Vitruvio : ModuleRules
 				"SlateCore",
 				"Slate",
 				"AppFramework",
+				"Json",
 			}
 		);
 	}
@@ -0,0 +1,143 @@
+/* Copyright 2024 Esri
+ *
+ * Licensed under the Apache License Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Editor.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GeneratedModelStaticMeshComponent.h"
+#include "Misc/AutomationTest.h"
+#include "StaticMeshAttributes.h"
+#include "VitruvioComponent.h"
+#include "VitruvioCooker.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace VitruvioCookerTests
+{
+UStaticMesh* CreateTransientQuadMesh(double Size)
+{
+	FMeshDescription MeshDescription;
+	FStaticMeshAttributes Attributes(MeshDescription);
+	Attributes.Register();
+	Attributes.GetVertexInstanceUVs().SetNumChannels(1);
+
+	const FPolygonGroupID PolygonGroupId = MeshDescription.CreatePolygonGroup();
+	TArray<FVertexInstanceID> VertexInstances;
+	for (const FVector2D& Corner : {FVector2D(0.0, 0.0), FVector2D(1.0, 0.0), FVector2D(1.0, 1.0), FVector2D(0.0, 1.0)})
+	{
+		const FVertexID VertexID = MeshDescription.CreateVertex();
+		Attributes.GetVertexPositions()[VertexID] = FVector3f(FVector(Corner * Size, 0.0));
+		const FVertexInstanceID VertexInstanceID = MeshDescription.CreateVertexInstance(VertexID);
+		Attributes.GetVertexInstanceNormals()[VertexInstanceID] = FVector3f::UpVector;
+		VertexInstances.Add(VertexInstanceID);
+	}
+	MeshDescription.CreatePolygon(PolygonGroupId, VertexInstances);
+
+	TArray<const FMeshDescription*> MeshDescriptionPtrs;
+	MeshDescriptionPtrs.Emplace(&MeshDescription);
+
+	UStaticMesh* StaticMesh = NewObject<UStaticMesh>(GetTransientPackage(), NAME_None, RF_Transient);
+	UStaticMesh::FBuildMeshDescriptionsParams Params;
+	Params.bCommitMeshDescription = true;
+	Params.bFastBuild = true;
+	StaticMesh->BuildFromMeshDescriptions(MeshDescriptionPtrs, Params);
+	return StaticMesh;
+}
+
+// Creates an actor which looks like a generated Vitruvio actor to the cooker, without any rule package or generate call
+AActor* SpawnGeneratedActor(UWorld* World, UStaticMesh* Mesh, const FVector& Location)
+{
+	AActor* Actor = World->SpawnActor<AActor>(Location, FRotator::ZeroRotator);
+
+	USceneComponent* RootComponent = NewObject<USceneComponent>(Actor, TEXT("Root"));
+	Actor->SetRootComponent(RootComponent);
+	Actor->AddOwnedComponent(RootComponent);
+	Actor->AddOwnedComponent(NewObject<UVitruvioComponent>(Actor, TEXT("VitruvioComponent")));
+
+	UGeneratedModelStaticMeshComponent* ModelComponent = NewObject<UGeneratedModelStaticMeshComponent>(Actor, TEXT("GeneratedModel"));
+	ModelComponent->SetStaticMesh(Mesh);
+	Actor->AddOwnedComponent(ModelComponent);
+
+	return Actor;
+}
+} // namespace VitruvioCookerTests
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FVitruvioCookerBenchmark, "Vitruvio.Cooker.Benchmark",
+								 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FVitruvioCookerBenchmark::RunTest(const FString& Parameters)
+{
+	using namespace VitruvioCookerTests;
+
+	constexpr int32 NumActors = 1000;
+	constexpr int32 NumDistinctMeshes = 100;
+
+	UWorld* World = UWorld::CreateWorld(EWorldType::Editor, false, TEXT("VitruvioCookerBenchmark"));
+
+	// Every mesh is a separate transient object, but only NumDistinctMeshes of them have different content
+	TArray<AActor*> Actors;
+	for (int32 ActorIndex = 0; ActorIndex < NumActors; ++ActorIndex)
+	{
+		UStaticMesh* Mesh = CreateTransientQuadMesh(100.0 + ActorIndex % NumDistinctMeshes);
+		Actors.Add(SpawnGeneratedActor(World, Mesh, FVector(ActorIndex * 200.0, 0.0, 0.0)));
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+	const bool bCooked = CookVitruvioActorsUnattended(Actors, TEXT("/Temp/Vitruvio/CookerBenchmark"));
+	const double CookMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+	TestTrue(TEXT("Cooking has been performed"), bCooked);
+
+	TSet<UStaticMesh*> CookedMeshes;
+	int32 NumCookedComponents = 0;
+	for (TActorIterator<AActor> It(World); It; ++It)
+	{
+		TArray<UStaticMeshComponent*> MeshComponents;
+		It->GetComponents<UStaticMeshComponent>(MeshComponents);
+		for (const UStaticMeshComponent* MeshComponent : MeshComponents)
+		{
+			UStaticMesh* Mesh = MeshComponent->GetStaticMesh();
+			if (Mesh && Mesh->GetOutermost() != GetTransientPackage())
+			{
+				CookedMeshes.Add(Mesh);
+				++NumCookedComponents;
+			}
+		}
+	}
+
+	TestEqual(TEXT("Number of cooked components"), NumCookedComponents, NumActors);
+	TestEqual(TEXT("Meshes with identical content are cooked once"), CookedMeshes.Num(), NumDistinctMeshes);
+	for (UStaticMesh* Mesh : CookedMeshes)
+	{
+		TestTrue(TEXT("Cooked mesh is built"), Mesh->GetRenderData() && Mesh->GetRenderData()->IsInitialized());
+	}
+
+	AddInfo(FString::Printf(TEXT("Cooked %d actors into %d meshes in %.1f ms"), NumActors, CookedMeshes.Num(), CookMs));
+
+	if (GEditor)
+	{
+		GEditor->SelectNone(false, true);
+	}
+	for (UStaticMesh* Mesh : CookedMeshes)
+	{
+		Mesh->ClearFlags(RF_Public | RF_Standalone);
+		Mesh->GetOutermost()->MarkAsGarbage();
+	}
+	World->DestroyWorld(false);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
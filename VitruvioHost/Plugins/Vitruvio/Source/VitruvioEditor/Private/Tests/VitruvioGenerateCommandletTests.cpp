@@ -0,0 +1,85 @@
+/* Copyright 2024 Esri
+ *
+ * Licensed under the Apache License Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Misc/AutomationTest.h"
+#include "Misc/Paths.h"
+#include "VitruvioGenerateCommandlet.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FVitruvioGenerateCommandletParseOptionsTest, "Vitruvio.GenerateCommandlet.ParseOptions",
+								 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FVitruvioGenerateCommandletParseOptionsTest::RunTest(const FString& Parameters)
+{
+	const FVitruvioGenerateOptions Options = UVitruvioGenerateCommandlet::ParseOptions(
+		TEXT("-Map=/Game/Maps/City -Cook -CookPath=/Game/Cooked -MaxThreads=8 -Summary=Saved/Summary.json -StallTimeout=300 -unattended"));
+	TestEqual(TEXT("Map"), Options.MapName, FString(TEXT("/Game/Maps/City")));
+	TestEqual(TEXT("Cook path"), Options.CookPath, FString(TEXT("/Game/Cooked")));
+	TestEqual(TEXT("Summary path"), Options.SummaryPath, FString(TEXT("Saved/Summary.json")));
+	TestEqual(TEXT("Max threads"), Options.MaxThreads, 8);
+	TestEqual(TEXT("Stall timeout"), Options.StallTimeoutSeconds, 300.0);
+	TestTrue(TEXT("Cook"), Options.bCook);
+	TestFalse(TEXT("Save"), Options.bSave);
+
+	const FVitruvioGenerateOptions Defaults = UVitruvioGenerateCommandlet::ParseOptions(TEXT("-Map=/Game/Maps/City -Save"));
+	TestEqual(TEXT("Default cook path"), Defaults.CookPath, FString(TEXT("/Game/VitruvioCooked")));
+	TestEqual(TEXT("Default summary path"), Defaults.SummaryPath,
+			  FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Vitruvio"), TEXT("GenerateSummary.json")));
+	TestEqual(TEXT("All cores by default"), Defaults.MaxThreads, 0);
+	TestEqual(TEXT("Default stall timeout"), Defaults.StallTimeoutSeconds, 120.0);
+	TestFalse(TEXT("No cook by default"), Defaults.bCook);
+	TestTrue(TEXT("Save"), Defaults.bSave);
+
+	TestTrue(TEXT("Missing map"), UVitruvioGenerateCommandlet::ParseOptions(TEXT("-Cook")).MapName.IsEmpty());
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FVitruvioGenerateCommandletSplitThreadsTest, "Vitruvio.GenerateCommandlet.SplitThreads",
+								 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FVitruvioGenerateCommandletSplitThreadsTest::RunTest(const FString& Parameters)
+{
+	for (const int32 MaxThreads : {-1, 0, 1, 2, 7, 8, 16, 64})
+	{
+		for (const int32 NumJobs : {0, 1, 2, 3, 8, 100, 10000})
+		{
+			const FVitruvioGenerateThreadLimits Limits = UVitruvioGenerateCommandlet::SplitThreads(MaxThreads, NumJobs);
+			const FString Case = FString::Printf(TEXT("%d threads, %d jobs"), MaxThreads, NumJobs);
+
+			TestTrue(Case + TEXT(": at least one job"), Limits.MaxJobsInFlight >= 1);
+			TestTrue(Case + TEXT(": at least one worker thread"), Limits.MaxWorkerThreads >= 1);
+			TestTrue(Case + TEXT(": thread limit is not exceeded"),
+					 Limits.MaxJobsInFlight * Limits.MaxWorkerThreads <= FMath::Max(1, MaxThreads));
+			TestTrue(Case + TEXT(": no more concurrent jobs than jobs"), Limits.MaxJobsInFlight <= FMath::Max(1, NumJobs));
+		}
+	}
+
+	const FVitruvioGenerateThreadLimits SingleJob = UVitruvioGenerateCommandlet::SplitThreads(8, 1);
+	TestEqual(TEXT("A single job gets all worker threads"), SingleJob.MaxWorkerThreads, 8);
+
+	const FVitruvioGenerateThreadLimits FewJobs = UVitruvioGenerateCommandlet::SplitThreads(8, 3);
+	TestEqual(TEXT("Few jobs run concurrently"), FewJobs.MaxJobsInFlight, 3);
+	TestEqual(TEXT("Few jobs share the worker threads"), FewJobs.MaxWorkerThreads, 2);
+
+	const FVitruvioGenerateThreadLimits ManyJobs = UVitruvioGenerateCommandlet::SplitThreads(8, 1000);
+	TestEqual(TEXT("Many jobs use every thread for a job"), ManyJobs.MaxJobsInFlight, 8);
+	TestEqual(TEXT("Many jobs use a single worker thread each"), ManyJobs.MaxWorkerThreads, 1);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -74,7 +74,7 @@ void UpdateAttributeValue(UVitruvioComponent* VitruvioActor, A* Attribute, const
 {
 	Attribute->Value = Value;
 	Attribute->bUserSet = true;
-	VitruvioActor->EvaluateRuleAttributes(VitruvioActor->GenerateAutomatically);
+	VitruvioActor->RequestGenerate(true, VitruvioActor->GenerateAutomatically);
 }
 
 bool IsVitruvioComponentSelected(const TArray<TWeakObjectPtr<UObject>>& ObjectsBeingCustomized, UVitruvioComponent*& OutComponent)
@@ -248,24 +248,38 @@ TSharedPtr<SSpinBox<double>> CreateNumericInputWidget(Attr* Attribute, TSharedPt
 {
 	auto Annotation = Attribute->GetRangeAnnotation();
 
-	auto OnValueCommit = [FloatProperty](double Value, ETextCommit::Type Type) {
+	// Dragging the slider previews the values without creating a transaction for every step, the final value is set once at the end
+	TSharedRef<bool> bIsUsingSlider = MakeShared<bool>(false);
+
+	auto OnValueCommit = [FloatProperty, bIsUsingSlider](double Value, ETextCommit::Type Type) {
 		if (FloatProperty->IsValidHandle())
 		{
 			double OldValue = 0.0f;
 			FloatProperty->GetValue(OldValue);
 
-			if (!FMath::IsNearlyEqual(OldValue, Value, UE_DOUBLE_KINDA_SMALL_NUMBER))
+			if (*bIsUsingSlider || !FMath::IsNearlyEqual(OldValue, Value, UE_DOUBLE_KINDA_SMALL_NUMBER))
 			{
 				FloatProperty->SetValue(Value);
 			}
 		}
-	};	
+		*bIsUsingSlider = false;
+	};
+
+	auto OnValueChanged = [FloatProperty, bIsUsingSlider](double Value) {
+		if (*bIsUsingSlider && FloatProperty->IsValidHandle())
+		{
+			FloatProperty->SetValue(Value, EPropertyValueSetFlags::InteractiveChange | EPropertyValueSetFlags::NotTransactable);
+		}
+	};
 
 	// clang-format off
 	auto ValueWidget = SNew(SSpinBox<double>)
 		.Font(IDetailLayoutBuilder::GetDetailFont())
 		.MinValue(Annotation && Annotation->HasMin ? Annotation->Min : TOptional<double>())
 		.MaxValue(Annotation && Annotation->HasMax ? Annotation->Max : TOptional<double>())
+		.OnBeginSliderMovement_Lambda([bIsUsingSlider]() { *bIsUsingSlider = true; })
+		.OnEndSliderMovement_Lambda([OnValueCommit](double Value) { OnValueCommit(Value, ETextCommit::Default); })
+		.OnValueChanged_Lambda(OnValueChanged)
 		.OnValueCommitted_Lambda(OnValueCommit)
 		.SliderExponent(1);
 	// clang-format on
@@ -302,7 +316,7 @@ FResetToDefaultOverride ResetToDefaultOverride(URuleAttribute* Attribute, UVitru
 		FIsResetToDefaultVisible::CreateLambda([Attribute](TSharedPtr<IPropertyHandle> Property) { return Attribute->bUserSet; }),
 		FResetToDefaultHandler::CreateLambda([Attribute, VitruvioActor](TSharedPtr<IPropertyHandle> Property) {
 			Attribute->bUserSet = false;
-			VitruvioActor->EvaluateRuleAttributes(VitruvioActor->GenerateAutomatically);
+			VitruvioActor->RequestGenerate(true, VitruvioActor->GenerateAutomatically);
 		}));
 	return ResetToDefaultOverride;
 }
@@ -583,6 +597,8 @@ void OpenReplacementDialog(UVitruvioComponent* VitruvioComponent, bool bNeedsReg
 		TInstanceDialogType::OpenDialog(VitruvioComponent, OnDialogClosed, false);
 	}
 
+	// Continuing after a stall is safe since nothing below depends on the generated model. The dialog is opened by the generate callback
+	// whenever the regeneration completes and BlockUntilGenerated already logs the stalled actors.
 	VitruvioEditorModule::Get().BlockUntilGenerated();
 }
 
@@ -728,7 +744,7 @@ void FVitruvioComponentDetails::BuildAttributeEditor(IDetailLayoutBuilder& Detai
 				AttributeEntry.Value->bUserSet = false;
 			}
 
-			VitruvioActor->EvaluateRuleAttributes(VitruvioActor->GenerateAutomatically);
+			VitruvioActor->RequestGenerate(true, VitruvioActor->GenerateAutomatically);
 		}));
 
 	HeaderProperty.OverrideResetToDefault(ResetAllToDefaultOverride);
@@ -771,7 +787,7 @@ void FVitruvioComponentDetails::BuildAttributeEditor(IDetailLayoutBuilder& Detai
 				}
 			}
 			Attribute->bUserSet = true;
-			VitruvioActor->EvaluateRuleAttributes(VitruvioActor->GenerateAutomatically);
+			VitruvioActor->RequestGenerate(true, VitruvioActor->GenerateAutomatically, Event.ChangeType == EPropertyChangeType::Interactive);
 		});
 		const TArray<TSharedRef<IDetailTreeNode>> DetailTreeNodes = Generator->GetRootTreeNodes();
 
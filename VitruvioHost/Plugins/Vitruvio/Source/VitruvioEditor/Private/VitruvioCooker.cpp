@@ -17,12 +17,17 @@
 
 #include "AssetRegistry/AssetRegistryModule.h"
 #include "AssetToolsModule.h"
+#include "Async/ParallelFor.h"
+#include "Async/TaskGraphInterfaces.h"
 #include "Dialogs/DlgPickPath.h"
 #include "Factories/MaterialInstanceConstantFactoryNew.h"
 #include "GeneratedModelHISMComponent.h"
 #include "GeneratedModelStaticMeshComponent.h"
+#include "HAL/Event.h"
+#include "Hash/xxhash.h"
 #include "Materials/MaterialInstanceConstant.h"
 #include "PhysicsEngine/BodySetup.h"
+#include "Serialization/MemoryWriter.h"
 #include "StaticMeshAttributes.h"
 #include "VitruvioBatchActor.h"
 
@@ -31,6 +36,8 @@
 #include "VitruvioEditorModule.h"
 #include "VitruvioModule.h"
 
+DEFINE_LOG_CATEGORY_STATIC(LogVitruvioCooker, Log, All);
+
 namespace
 {
 
@@ -40,6 +47,28 @@ using FStaticMeshCache = TMap<UStaticMesh*, UStaticMesh*>;
 
 std::atomic<bool> IsCooking;
 
+// Stop waiting for a previous cook if it has not completed within this time
+constexpr double CookTimeoutSeconds = 600.0;
+
+FEventRef& GetCookCompletedEvent()
+{
+	static FEventRef CookCompletedEvent(EEventMode::ManualReset);
+	return CookCompletedEvent;
+}
+
+void SetCooking(bool bCooking)
+{
+	IsCooking = bCooking;
+	if (bCooking)
+	{
+		GetCookCompletedEvent()->Reset();
+	}
+	else
+	{
+		GetCookCompletedEvent()->Trigger();
+	}
+}
+
 template <typename T>
 T* AttachMeshComponent(AActor* Parent, USceneComponent* AttachParent, UStaticMesh* Mesh, const FName& Name, const FTransform& Transform)
 {
@@ -69,15 +98,32 @@ UPackage* CreateUniquePackage(const FString& InputName, FString& OutAssetName)
 	return Package;
 }
 
-void BlockUntilCookCompleted()
+bool BlockUntilCookCompleted()
 {
+	if (!IsCooking.load())
+	{
+		return true;
+	}
+
+	// Wake up at least this often to keep the progress dialog responsive
+	constexpr uint32 MaxWaitMilliseconds = 100;
+
 	FScopedSlowTask PRTGenerateCallsTasks(0, FText::FromString("Finishing previous Vitruvio cooking..."));
+	const double StartTime = FPlatformTime::Seconds();
 	while (IsCooking.load())
 	{
-		FPlatformProcess::Sleep(0); // SwitchToThread
-		int32 CurrentNumGenerateCalls = VitruvioModule::Get().GetNumGenerateCalls();
+		FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
 		PRTGenerateCallsTasks.EnterProgressFrame(0);
+
+		if (FPlatformTime::Seconds() - StartTime > CookTimeoutSeconds)
+		{
+			return false;
+		}
+
+		GetCookCompletedEvent()->Wait(MaxWaitMilliseconds);
 	}
+
+	return true;
 }
 
 ETextureSourceFormat GetTextureFormatFromPixelFormat(const EPixelFormat PixelFormat)
@@ -101,73 +147,71 @@ ETextureSourceFormat GetTextureFormatFromPixelFormat(const EPixelFormat PixelFor
 	}
 }
 
-UTexture2D* SaveTexture(UTexture2D* Original, const FString& Path, FTextureCache& TextureCache)
+struct FTexturePayload
 {
-	if (TextureCache.Contains(Original))
-	{
-		return TextureCache[Original];
-	}
-	FString AssetName;
-	UPackage* TexturePackage = CreateUniquePackage(FPaths::Combine(Path, TEXT("Textures"), Original->GetName()), AssetName);
-	UTexture2D* NewTexture = NewObject<UTexture2D>(TexturePackage, *AssetName, RF_Public | RF_Standalone);
-	NewTexture->CompressionSettings = Original->CompressionSettings;
-	NewTexture->SRGB = Original->SRGB;
-
-	FTexturePlatformData* PlatformData = new FTexturePlatformData();
-	const FTexturePlatformData* OriginalPlatformData = Original->GetPlatformData();
-	PlatformData->SizeX = OriginalPlatformData->SizeX;
-	PlatformData->SizeY = OriginalPlatformData->SizeY;
-	PlatformData->PixelFormat = OriginalPlatformData->PixelFormat;
+	UTexture2D* Original = nullptr;
+	const FTexturePlatformData* OriginalPlatformData = nullptr;
 
-	// Allocate first mipmap and upload the pixel data
-	FTexture2DMipMap* Mip = new FTexture2DMipMap();
-	const FTexture2DMipMap& OriginalMip = OriginalPlatformData->Mips[0];
+	TArray64<uint8> Pixels;
+	FXxHash128 Hash;
+};
 
-	PlatformData->Mips.Add(Mip);
-
-	Mip->SizeX = OriginalMip.SizeX;
-	Mip->SizeY = OriginalMip.SizeY;
-
-	NewTexture->SetPlatformData(PlatformData);
-
-	const uint8* SourcePixels = static_cast<const uint8*>(OriginalMip.BulkData.LockReadOnly());
-	Mip->BulkData.Lock(LOCK_READ_WRITE);
-
-	void* TextureData = Mip->BulkData.Realloc(OriginalMip.BulkData.GetBulkDataSize());
-	FMemory::Memcpy(TextureData, SourcePixels, OriginalMip.BulkData.GetBulkDataSize());
-	Mip->BulkData.Unlock();
+struct FMeshPayload
+{
+	UStaticMesh* Original = nullptr;
+	const FMeshDescription* OriginalMeshDescription = nullptr;
 
-	const ETextureSourceFormat SourceFormat = GetTextureFormatFromPixelFormat(OriginalPlatformData->PixelFormat);
-	NewTexture->Source.Init(OriginalPlatformData->SizeX, OriginalPlatformData->SizeY, 1, 1, SourceFormat, SourcePixels);
-	OriginalMip.BulkData.Unlock();
+	FMeshDescription MeshDescription;
+	FXxHash128 GeometryHash;
+};
 
-	NewTexture->PostEditChange();
-	TexturePackage->MarkPackageDirty();
-	FAssetRegistryModule::AssetCreated(NewTexture);
+struct FMaterialParameters
+{
+	TArray<TPair<FMaterialParameterInfo, float>> Scalars;
+	TArray<TPair<FMaterialParameterInfo, UTexture*>> Textures;
+	TArray<TPair<FMaterialParameterInfo, FLinearColor>> Vectors;
+};
 
-	TextureCache.Add(Original, NewTexture);
+struct FTextureContentKey
+{
+	FXxHash128 Hash;
 
-	return NewTexture;
-}
+	friend bool operator==(const FTextureContentKey& Lhs, const FTextureContentKey& Rhs)
+	{
+		return Lhs.Hash.LowPart == Rhs.Hash.LowPart && Lhs.Hash.HighPart == Rhs.Hash.HighPart;
+	}
 
-UMaterialInstanceConstant* SaveMaterial(UMaterialInstance* Material, const FString& Path, FMaterialCache& MaterialCache,
-										FTextureCache& TextureCache)
-{
-	if (MaterialCache.Contains(Material))
+	friend uint32 GetTypeHash(const FTextureContentKey& Key)
 	{
-		return MaterialCache[Material];
+		return HashCombine(GetTypeHash(Key.Hash.LowPart), GetTypeHash(Key.Hash.HighPart));
 	}
+};
 
-	FString AssetName;
-	UPackage* MaterialPackage = CreateUniquePackage(FPaths::Combine(Path, TEXT("Materials"), Material->GetName()), AssetName);
+struct FMeshContentKey
+{
+	FXxHash128 GeometryHash;
+	TArray<UMaterialInterface*> Materials;
 
-	UMaterialInstanceConstantFactoryNew* MaterialFactory = NewObject<UMaterialInstanceConstantFactoryNew>();
-	MaterialFactory->InitialParent = Material->Parent;
+	friend bool operator==(const FMeshContentKey& Lhs, const FMeshContentKey& Rhs)
+	{
+		return Lhs.GeometryHash.LowPart == Rhs.GeometryHash.LowPart && Lhs.GeometryHash.HighPart == Rhs.GeometryHash.HighPart &&
+			   Lhs.Materials == Rhs.Materials;
+	}
 
-	UMaterialInstanceConstant* NewMaterial = Cast<UMaterialInstanceConstant>(MaterialFactory->FactoryCreateNew(
-		UMaterialInstanceConstant::StaticClass(), MaterialPackage, *AssetName, RF_Public | RF_Standalone, nullptr, GWarn));
-	FAssetRegistryModule::AssetCreated(NewMaterial);
+	friend uint32 GetTypeHash(const FMeshContentKey& Key)
+	{
+		uint32 Hash = HashCombine(GetTypeHash(Key.GeometryHash.LowPart), GetTypeHash(Key.GeometryHash.HighPart));
+		for (const UMaterialInterface* Material : Key.Materials)
+		{
+			Hash = HashCombine(Hash, GetTypeHash(Material));
+		}
+		return Hash;
+	}
+};
 
+FMaterialParameters GetMaterialParameters(const UMaterialInstance* Material)
+{
+	FMaterialParameters Parameters;
 	TArray<FMaterialParameterInfo> ParameterInfos;
 	TArray<FGuid> ParameterIds;
 
@@ -176,7 +220,7 @@ UMaterialInstanceConstant* SaveMaterial(UMaterialInstance* Material, const FStri
 	{
 		float Value;
 		Material->GetScalarParameterValue(Info, Value);
-		NewMaterial->SetScalarParameterValueEditorOnly(Info, Value);
+		Parameters.Scalars.Emplace(Info, Value);
 	}
 
 	Material->GetAllTextureParameterInfo(ParameterInfos, ParameterIds);
@@ -186,15 +230,7 @@ UMaterialInstanceConstant* SaveMaterial(UMaterialInstance* Material, const FStri
 		Material->GetTextureParameterValue(Info, Value);
 		if (Value)
 		{
-			if (Value->HasAnyFlags(RF_Transient))
-			{
-				UTexture2D* PersistedTexture = SaveTexture(Cast<UTexture2D>(Value), Path, TextureCache);
-				NewMaterial->SetTextureParameterValueEditorOnly(Info, PersistedTexture);
-			}
-			else
-			{
-				NewMaterial->SetTextureParameterValueEditorOnly(Info, Value);
-			}
+			Parameters.Textures.Emplace(Info, Value);
 		}
 	}
 
@@ -203,113 +239,389 @@ UMaterialInstanceConstant* SaveMaterial(UMaterialInstance* Material, const FStri
 	{
 		FLinearColor Value;
 		Material->GetVectorParameterValue(Info, Value);
-		NewMaterial->SetVectorParameterValueEditorOnly(Info, Value);
+		Parameters.Vectors.Emplace(Info, Value);
 	}
 
-	MaterialCache.Add(Material, NewMaterial);
+	return Parameters;
+}
 
-	NewMaterial->PostEditChange();
-	MaterialPackage->MarkPackageDirty();
+bool IsCookable(AActor* Actor)
+{
+	UVitruvioComponent* VitruvioComponent = Actor->FindComponentByClass<UVitruvioComponent>();
+	if (!VitruvioComponent && !Cast<AVitruvioBatchActor>(Actor))
+	{
+		return false;
+	}
 
-	return NewMaterial;
+	return !VitruvioComponent || !VitruvioComponent->IsBatchGenerated();
 }
 
-UStaticMesh* SaveStaticMesh(UStaticMesh* Mesh, const FString& Path, FStaticMeshCache& MeshCache, FMaterialCache& MaterialCache,
-							FTextureCache& TextureCache)
+bool IsGeneratedInstanceMesh(UStaticMesh* InstanceMesh)
 {
-	if (MeshCache.Contains(Mesh))
+	return InstanceMesh->GetOutermost() == GetTransientPackage();
+}
+
+/**
+ * Cooks generated models into persistent assets in multiple phases:
+ *
+ * 1. Collect all transient meshes, materials and textures referenced by the given actors (game thread).
+ * 2. Copy mesh descriptions and texture pixels and hash their content (worker threads).
+ * 3. Create textures, materials and meshes, reusing assets with identical content. All new meshes are built in a single batch.
+ * 4. Replace the actors with cooked actors referencing the persisted assets (game thread).
+ */
+class FVitruvioCooker
+{
+	FString CookPath;
+
+	TArray<FTexturePayload> TexturePayloads;
+	TArray<FMeshPayload> MeshPayloads;
+	TMap<UMaterialInstance*, FMaterialParameters> Materials;
+	TSet<UObject*> CollectedObjects;
+
+	FTextureCache TextureCache;
+	FMaterialCache MaterialCache;
+	FStaticMeshCache MeshCache;
+
+	TMap<FTextureContentKey, UTexture2D*> TextureContentCache;
+	TMap<FString, UMaterialInstanceConstant*> MaterialContentCache;
+	TMap<FMeshContentKey, UStaticMesh*> MeshContentCache;
+
+	void CollectTexture(UTexture* Texture)
 	{
-		return MeshCache[Mesh];
+		UTexture2D* Texture2D = Cast<UTexture2D>(Texture);
+		if (!Texture2D || !Texture2D->HasAnyFlags(RF_Transient))
+		{
+			return;
+		}
+
+		bool bAlreadyCollected = false;
+		CollectedObjects.Add(Texture2D, &bAlreadyCollected);
+		if (bAlreadyCollected)
+		{
+			return;
+		}
+
+		FTexturePayload& Payload = TexturePayloads.AddDefaulted_GetRef();
+		Payload.Original = Texture2D;
+		Payload.OriginalPlatformData = Texture2D->GetPlatformData();
 	}
 
-	// Create new StaticMesh Asset
-	FString AssetName;
-	UPackage* MeshPackage = CreateUniquePackage(FPaths::Combine(Path, TEXT("Geometry"), Mesh->GetName()), AssetName);
-	UStaticMesh* PersistedMesh = NewObject<UStaticMesh>(MeshPackage, *AssetName, RF_Public | RF_Standalone);
-	PersistedMesh->InitResources();
+	void CollectMaterial(UMaterialInterface* Material)
+	{
+		UMaterialInstance* MaterialInstance = Cast<UMaterialInstance>(Material);
+		if (!MaterialInstance || Materials.Contains(MaterialInstance))
+		{
+			return;
+		}
 
-	FMeshDescription* OriginalMeshDescription = Mesh->GetMeshDescription(0);
-	FMeshDescription NewMeshDescription(*OriginalMeshDescription);
-	FStaticMeshAttributes MeshAttributes(NewMeshDescription);
+		const FMaterialParameters& Parameters = Materials.Add(MaterialInstance, GetMaterialParameters(MaterialInstance));
+		for (const TPair<FMaterialParameterInfo, UTexture*>& Texture : Parameters.Textures)
+		{
+			CollectTexture(Texture.Value);
+		}
+	}
 
-	// Copy Materials
-	TMap<UMaterialInterface*, FName> MaterialSlots;
+	void CollectOverrideMaterials(UStaticMeshComponent* MeshComponent)
+	{
+		for (int32 MaterialIndex = 0; MaterialIndex < MeshComponent->GetNumOverrideMaterials(); ++MaterialIndex)
+		{
+			CollectMaterial(MeshComponent->OverrideMaterials[MaterialIndex]);
+		}
+	}
 
-	const auto PolygonGroups = NewMeshDescription.PolygonGroups();
-	for (const auto& PolygonGroupId : PolygonGroups.GetElementIDs())
+	void CollectMesh(UStaticMesh* Mesh)
 	{
-		const FName MaterialName = MeshAttributes.GetPolygonGroupMaterialSlotNames()[PolygonGroupId];
-		int32 Index = Mesh->GetMaterialIndex(MaterialName);
+		bool bAlreadyCollected = false;
+		CollectedObjects.Add(Mesh, &bAlreadyCollected);
+		if (bAlreadyCollected)
+		{
+			return;
+		}
 
-		if (Index != INDEX_NONE)
+		FMeshPayload& Payload = MeshPayloads.AddDefaulted_GetRef();
+		Payload.Original = Mesh;
+		Payload.OriginalMeshDescription = Mesh->GetMeshDescription(0);
+
+		FStaticMeshConstAttributes MeshAttributes(*Payload.OriginalMeshDescription);
+		const auto MaterialSlotNames = MeshAttributes.GetPolygonGroupMaterialSlotNames();
+		for (const auto& PolygonGroupId : Payload.OriginalMeshDescription->PolygonGroups().GetElementIDs())
 		{
-			UMaterialInterface* Material = Mesh->GetMaterial(Index);
-			if (UMaterialInstance* MaterialInstance = Cast<UMaterialInstance>(Material))
+			const int32 Index = Mesh->GetMaterialIndex(MaterialSlotNames[PolygonGroupId]);
+			if (Index != INDEX_NONE)
 			{
-				Material = SaveMaterial(MaterialInstance, Path, MaterialCache, TextureCache);
+				CollectMaterial(Mesh->GetMaterial(Index));
 			}
-			
-			const auto MaterialResult = MaterialSlots.Find(Material);
-			if (MaterialResult)
+		}
+	}
+
+	void CollectActor(AActor* Actor)
+	{
+		TArray<UGeneratedModelStaticMeshComponent*> GeneratedModelComponents;
+		Actor->GetComponents<UGeneratedModelStaticMeshComponent>(GeneratedModelComponents);
+		for (UGeneratedModelStaticMeshComponent* GeneratedModelStaticMeshComponent : GeneratedModelComponents)
+		{
+			if (!GeneratedModelStaticMeshComponent || !GeneratedModelStaticMeshComponent->GetStaticMesh())
 			{
-				MeshAttributes.GetPolygonGroupMaterialSlotNames()[PolygonGroupId] = *MaterialResult;
+				continue;
 			}
-			else
+
+			CollectMesh(GeneratedModelStaticMeshComponent->GetStaticMesh());
+			CollectOverrideMaterials(GeneratedModelStaticMeshComponent);
+
+			for (USceneComponent* AttachedComponent : GeneratedModelStaticMeshComponent->GetAttachChildren())
 			{
-				FName NewSlot = PersistedMesh->AddMaterial(Material);
-				MeshAttributes.GetPolygonGroupMaterialSlotNames()[PolygonGroupId] = NewSlot;
-				MaterialSlots.Add(Material, NewSlot);
+				UGeneratedModelHISMComponent* GeneratedModelHismComponent = Cast<UGeneratedModelHISMComponent>(AttachedComponent);
+				if (!GeneratedModelHismComponent)
+				{
+					continue;
+				}
+
+				UStaticMesh* InstanceMesh = GeneratedModelHismComponent->GetStaticMesh();
+				if (InstanceMesh && IsGeneratedInstanceMesh(InstanceMesh))
+				{
+					CollectMesh(InstanceMesh);
+					CollectOverrideMaterials(GeneratedModelHismComponent);
+				}
 			}
 		}
 	}
 
-	// Build the Static Mesh
-	TArray<const FMeshDescription*> MeshDescriptions;
-	MeshDescriptions.Add(&NewMeshDescription);
-	PersistedMesh->BuildFromMeshDescriptions(MeshDescriptions);
+	void PreparePayloads()
+	{
+		ParallelFor(TexturePayloads.Num(), [this](int32 PayloadIndex) {
+			FTexturePayload& Payload = TexturePayloads[PayloadIndex];
+			const FTexture2DMipMap& OriginalMip = Payload.OriginalPlatformData->Mips[0];
+
+			const uint8* SourcePixels = static_cast<const uint8*>(OriginalMip.BulkData.LockReadOnly());
+			Payload.Pixels = TArray64<uint8>(SourcePixels, OriginalMip.BulkData.GetBulkDataSize());
+			OriginalMip.BulkData.Unlock();
+
+			FXxHash128Builder HashBuilder;
+			HashBuilder.Update(Payload.Pixels.GetData(), Payload.Pixels.Num());
+			const int32 Format[] = {Payload.OriginalPlatformData->SizeX, Payload.OriginalPlatformData->SizeY, Payload.OriginalPlatformData->PixelFormat,
+									Payload.Original->SRGB, Payload.Original->CompressionSettings};
+			HashBuilder.Update(Format, sizeof(Format));
+			Payload.Hash = HashBuilder.Finalize();
+		});
+
+		ParallelFor(MeshPayloads.Num(), [this](int32 PayloadIndex) {
+			FMeshPayload& Payload = MeshPayloads[PayloadIndex];
+			Payload.MeshDescription = *Payload.OriginalMeshDescription;
+
+			TArray<uint8> SerializedMeshDescription;
+			FMemoryWriter Writer(SerializedMeshDescription);
+			Writer << Payload.MeshDescription;
+			Payload.GeometryHash = FXxHash128::HashBuffer(SerializedMeshDescription.GetData(), SerializedMeshDescription.Num());
+		});
+	}
+
+	void SaveTexture(const FTexturePayload& Payload)
+	{
+		if (UTexture2D** ExistingTexture = TextureContentCache.Find({Payload.Hash}))
+		{
+			TextureCache.Add(Payload.Original, *ExistingTexture);
+			return;
+		}
 
-	check(PersistedMesh->GetNumSourceModels() == 1);
-	FStaticMeshSourceModel& SrcModel = PersistedMesh->GetSourceModel(0);
-	SrcModel.BuildSettings.bRecomputeNormals = false;
-	SrcModel.BuildSettings.bRecomputeTangents = false;
-	SrcModel.BuildSettings.bRemoveDegenerates = true;
-	PersistedMesh->GetBodySetup()->CollisionTraceFlag = ECollisionTraceFlag::CTF_UseComplexAsSimple;
+		UTexture2D* Original = Payload.Original;
+		FString AssetName;
+		UPackage* TexturePackage = CreateUniquePackage(FPaths::Combine(CookPath, TEXT("Textures"), Original->GetName()), AssetName);
+		UTexture2D* NewTexture = NewObject<UTexture2D>(TexturePackage, *AssetName, RF_Public | RF_Standalone);
+		NewTexture->CompressionSettings = Original->CompressionSettings;
+		NewTexture->SRGB = Original->SRGB;
 
-	PersistedMesh->PostEditChange();
-	PersistedMesh->MarkPackageDirty();
+		FTexturePlatformData* PlatformData = new FTexturePlatformData();
+		const FTexturePlatformData* OriginalPlatformData = Payload.OriginalPlatformData;
+		PlatformData->SizeX = OriginalPlatformData->SizeX;
+		PlatformData->SizeY = OriginalPlatformData->SizeY;
+		PlatformData->PixelFormat = OriginalPlatformData->PixelFormat;
 
-	// Notify asset registry of new asset
-	FAssetRegistryModule::AssetCreated(PersistedMesh);
+		// Allocate first mipmap and upload the pixel data
+		FTexture2DMipMap* Mip = new FTexture2DMipMap();
+		const FTexture2DMipMap& OriginalMip = OriginalPlatformData->Mips[0];
 
-	MeshCache.Add(Mesh, PersistedMesh);
-	return PersistedMesh;
-}
+		PlatformData->Mips.Add(Mip);
 
-void CookActors(const TArray<AActor*>& Actors, const FString& CookPath)
-{
-	FScopedSlowTask CookTask(Actors.Num(), FText::FromString("Cooking models..."));
-	CookTask.MakeDialog();
+		Mip->SizeX = OriginalMip.SizeX;
+		Mip->SizeY = OriginalMip.SizeY;
 
-	FMaterialCache MaterialCache;
-	FTextureCache TextureCache;
-	FStaticMeshCache MeshCache;
+		NewTexture->SetPlatformData(PlatformData);
+
+		Mip->BulkData.Lock(LOCK_READ_WRITE);
+		void* TextureData = Mip->BulkData.Realloc(Payload.Pixels.Num());
+		FMemory::Memcpy(TextureData, Payload.Pixels.GetData(), Payload.Pixels.Num());
+		Mip->BulkData.Unlock();
+
+		const ETextureSourceFormat SourceFormat = GetTextureFormatFromPixelFormat(OriginalPlatformData->PixelFormat);
+		NewTexture->Source.Init(OriginalPlatformData->SizeX, OriginalPlatformData->SizeY, 1, 1, SourceFormat, Payload.Pixels.GetData());
+
+		NewTexture->PostEditChange();
+		TexturePackage->MarkPackageDirty();
+		FAssetRegistryModule::AssetCreated(NewTexture);
 
-	for (AActor* Actor : Actors)
+		TextureCache.Add(Original, NewTexture);
+		TextureContentCache.Add({Payload.Hash}, NewTexture);
+	}
+
+	UTexture* GetCookedTexture(UTexture* Texture) const
 	{
-		CookTask.EnterProgressFrame(1);
+		UTexture2D* const* CookedTexture = TextureCache.Find(Texture);
+		return CookedTexture ? *CookedTexture : Texture;
+	}
 
-		UVitruvioComponent* VitruvioComponent = Actor->FindComponentByClass<UVitruvioComponent>();
-		AVitruvioBatchActor* VitruvioBatchActor = Cast<AVitruvioBatchActor>(Actor);
-		if (!VitruvioComponent && !VitruvioBatchActor)
+	UMaterialInterface* GetCookedMaterial(UMaterialInterface* Material) const
+	{
+		UMaterialInstanceConstant* const* CookedMaterial = MaterialCache.Find(Cast<UMaterialInstance>(Material));
+		return CookedMaterial ? *CookedMaterial : Material;
+	}
+
+	FString GetMaterialContentKey(const UMaterialInstance* Material, const FMaterialParameters& Parameters) const
+	{
+		FString Key = Material->Parent ? Material->Parent->GetPathName() : TEXT("None");
+		for (const TPair<FMaterialParameterInfo, float>& Scalar : Parameters.Scalars)
 		{
-			continue;
+			Key += FString::Printf(TEXT(";%s/%d/%d=%.9g"), *Scalar.Key.Name.ToString(), static_cast<int32>(Scalar.Key.Association), Scalar.Key.Index,
+								   Scalar.Value);
 		}
-		
-		if (VitruvioComponent && VitruvioComponent->IsBatchGenerated())
+		for (const TPair<FMaterialParameterInfo, UTexture*>& Texture : Parameters.Textures)
+		{
+			Key += FString::Printf(TEXT(";%s/%d/%d=%s"), *Texture.Key.Name.ToString(), static_cast<int32>(Texture.Key.Association), Texture.Key.Index,
+								   *GetCookedTexture(Texture.Value)->GetPathName());
+		}
+		for (const TPair<FMaterialParameterInfo, FLinearColor>& Vector : Parameters.Vectors)
+		{
+			Key += FString::Printf(TEXT(";%s/%d/%d=%.9g,%.9g,%.9g,%.9g"), *Vector.Key.Name.ToString(), static_cast<int32>(Vector.Key.Association),
+								   Vector.Key.Index, Vector.Value.R, Vector.Value.G, Vector.Value.B, Vector.Value.A);
+		}
+		return Key;
+	}
+
+	void SaveMaterial(UMaterialInstance* Material, const FMaterialParameters& Parameters)
+	{
+		const FString ContentKey = GetMaterialContentKey(Material, Parameters);
+		if (UMaterialInstanceConstant** ExistingMaterial = MaterialContentCache.Find(ContentKey))
+		{
+			MaterialCache.Add(Material, *ExistingMaterial);
+			return;
+		}
+
+		FString AssetName;
+		UPackage* MaterialPackage = CreateUniquePackage(FPaths::Combine(CookPath, TEXT("Materials"), Material->GetName()), AssetName);
+
+		UMaterialInstanceConstantFactoryNew* MaterialFactory = NewObject<UMaterialInstanceConstantFactoryNew>();
+		MaterialFactory->InitialParent = Material->Parent;
+
+		UMaterialInstanceConstant* NewMaterial = Cast<UMaterialInstanceConstant>(MaterialFactory->FactoryCreateNew(
+			UMaterialInstanceConstant::StaticClass(), MaterialPackage, *AssetName, RF_Public | RF_Standalone, nullptr, GWarn));
+		FAssetRegistryModule::AssetCreated(NewMaterial);
+
+		for (const TPair<FMaterialParameterInfo, float>& Scalar : Parameters.Scalars)
+		{
+			NewMaterial->SetScalarParameterValueEditorOnly(Scalar.Key, Scalar.Value);
+		}
+		for (const TPair<FMaterialParameterInfo, UTexture*>& Texture : Parameters.Textures)
+		{
+			NewMaterial->SetTextureParameterValueEditorOnly(Texture.Key, GetCookedTexture(Texture.Value));
+		}
+		for (const TPair<FMaterialParameterInfo, FLinearColor>& Vector : Parameters.Vectors)
+		{
+			NewMaterial->SetVectorParameterValueEditorOnly(Vector.Key, Vector.Value);
+		}
+
+		MaterialCache.Add(Material, NewMaterial);
+		MaterialContentCache.Add(ContentKey, NewMaterial);
+
+		NewMaterial->PostEditChange();
+		MaterialPackage->MarkPackageDirty();
+	}
+
+	UStaticMesh* SaveStaticMesh(FMeshPayload& Payload)
+	{
+		UStaticMesh* Mesh = Payload.Original;
+		FStaticMeshAttributes MeshAttributes(Payload.MeshDescription);
+
+		FMeshContentKey ContentKey{Payload.GeometryHash};
+		for (const auto& PolygonGroupId : Payload.MeshDescription.PolygonGroups().GetElementIDs())
+		{
+			const int32 Index = Mesh->GetMaterialIndex(MeshAttributes.GetPolygonGroupMaterialSlotNames()[PolygonGroupId]);
+			ContentKey.Materials.Add(Index != INDEX_NONE ? GetCookedMaterial(Mesh->GetMaterial(Index)) : nullptr);
+		}
+
+		if (UStaticMesh** ExistingMesh = MeshContentCache.Find(ContentKey))
+		{
+			MeshCache.Add(Mesh, *ExistingMesh);
+			return nullptr;
+		}
+
+		// Create new StaticMesh Asset
+		FString AssetName;
+		UPackage* MeshPackage = CreateUniquePackage(FPaths::Combine(CookPath, TEXT("Geometry"), Mesh->GetName()), AssetName);
+		UStaticMesh* PersistedMesh = NewObject<UStaticMesh>(MeshPackage, *AssetName, RF_Public | RF_Standalone);
+		PersistedMesh->InitResources();
+
+		// Copy Materials
+		TMap<UMaterialInterface*, FName> MaterialSlots;
+
+		int32 PolygonGroupIndex = 0;
+		for (const auto& PolygonGroupId : Payload.MeshDescription.PolygonGroups().GetElementIDs())
+		{
+			const int32 Index = Mesh->GetMaterialIndex(MeshAttributes.GetPolygonGroupMaterialSlotNames()[PolygonGroupId]);
+			UMaterialInterface* Material = ContentKey.Materials[PolygonGroupIndex++];
+
+			if (Index != INDEX_NONE)
+			{
+				const auto MaterialResult = MaterialSlots.Find(Material);
+				if (MaterialResult)
+				{
+					MeshAttributes.GetPolygonGroupMaterialSlotNames()[PolygonGroupId] = *MaterialResult;
+				}
+				else
+				{
+					FName NewSlot = PersistedMesh->AddMaterial(Material);
+					MeshAttributes.GetPolygonGroupMaterialSlotNames()[PolygonGroupId] = NewSlot;
+					MaterialSlots.Add(Material, NewSlot);
+				}
+			}
+		}
+
+		// Only commit the source model here, all new meshes are built together afterwards
+		FStaticMeshSourceModel& SrcModel = PersistedMesh->AddSourceModel();
+		SrcModel.BuildSettings.bRecomputeNormals = false;
+		SrcModel.BuildSettings.bRecomputeTangents = false;
+		SrcModel.BuildSettings.bRemoveDegenerates = true;
+		PersistedMesh->CreateMeshDescription(0, MoveTemp(Payload.MeshDescription));
+		PersistedMesh->CommitMeshDescription(0);
+
+		PersistedMesh->CreateBodySetup();
+		UBodySetup* BodySetup = PersistedMesh->GetBodySetup();
+		const UBodySetup* OriginalBodySetup = Mesh->GetBodySetup();
+		if (OriginalBodySetup && OriginalBodySetup->CollisionTraceFlag == ECollisionTraceFlag::CTF_UseSimpleAsComplex)
+		{
+			// Keep the simple collision shapes created according to the collision settings of the generated mesh
+			BodySetup->AggGeom = OriginalBodySetup->AggGeom;
+			BodySetup->CollisionTraceFlag = ECollisionTraceFlag::CTF_UseSimpleAsComplex;
+		}
+		else
+		{
+			BodySetup->CollisionTraceFlag = ECollisionTraceFlag::CTF_UseComplexAsSimple;
+		}
+
+		MeshCache.Add(Mesh, PersistedMesh);
+		MeshContentCache.Add(MoveTemp(ContentKey), PersistedMesh);
+		return PersistedMesh;
+	}
+
+	void CookOverrideMaterials(UStaticMeshComponent* OriginalMeshComponent, UStaticMeshComponent* CookedMeshComponent) const
+	{
+		for (int32 MaterialIndex = 0; MaterialIndex < OriginalMeshComponent->GetNumOverrideMaterials(); ++MaterialIndex)
 		{
-			continue;
+			CookedMeshComponent->SetMaterial(MaterialIndex, GetCookedMaterial(OriginalMeshComponent->OverrideMaterials[MaterialIndex]));
 		}
+	}
 
+	void ReplaceActor(AActor* Actor)
+	{
+		AVitruvioBatchActor* VitruvioBatchActor = Cast<AVitruvioBatchActor>(Actor);
 		AActor* OldAttachParent = Actor->GetAttachParentActor();
 
 		// Spawn new Actor with persisted geometry
@@ -340,19 +652,7 @@ void CookActors(const TArray<AActor*>& Actors, const FString& CookPath)
 				continue;
 			}
 
-			auto CookOverrideMaterials = [CookPath, &MaterialCache, &TextureCache](UStaticMeshComponent* OriginalMeshComponent, UStaticMeshComponent* CookedMeshComponent)
-			{
-				for (int32 MaterialIndex = 0; MaterialIndex < OriginalMeshComponent->GetNumOverrideMaterials(); ++MaterialIndex)
-				{
-					UMaterialInterface* Material = OriginalMeshComponent->OverrideMaterials[MaterialIndex];
-					if (UMaterialInstance* MaterialInstance = Cast<UMaterialInstance>(Material))
-					{
-						Material = SaveMaterial(MaterialInstance, CookPath, MaterialCache, TextureCache);
-					}
-					CookedMeshComponent->SetMaterial(MaterialIndex, Material);
-				}
-			};
-			UStaticMesh* PersistedMesh = SaveStaticMesh(GeneratedModelStaticMeshComponent->GetStaticMesh(), CookPath, MeshCache, MaterialCache, TextureCache);
+			UStaticMesh* PersistedMesh = MeshCache[GeneratedModelStaticMeshComponent->GetStaticMesh()];
 			UStaticMeshComponent* CookedMeshComponent = AttachMeshComponent<UStaticMeshComponent>(CookedActor, PersistedMesh, GeneratedModelStaticMeshComponent->GetFName(), GeneratedModelStaticMeshComponent->GetComponentTransform());
 
 			CookOverrideMaterials(GeneratedModelStaticMeshComponent, CookedMeshComponent);
@@ -372,9 +672,9 @@ void CookActors(const TArray<AActor*>& Actors, const FString& CookPath)
 				{
 					UHierarchicalInstancedStaticMeshComponent* InstancedStaticMeshComponent;
 					
-					if (InstanceMesh->GetOutermost() == GetTransientPackage())
+					if (IsGeneratedInstanceMesh(InstanceMesh))
 					{
-						UStaticMesh* PersistedInstanceMesh = SaveStaticMesh(InstanceMesh, CookPath, MeshCache, MaterialCache, TextureCache);
+						UStaticMesh* PersistedInstanceMesh = MeshCache[InstanceMesh];
 
 						FName Name = MakeUniqueObjectName(CookedActor, UHierarchicalInstancedStaticMeshComponent::StaticClass(), *PersistedInstanceMesh->GetName());
 						InstancedStaticMeshComponent = AttachMeshComponent<UHierarchicalInstancedStaticMeshComponent>(CookedActor, CookedMeshComponent, PersistedInstanceMesh, Name, GeneratedModelHismComponent->GetComponentTransform());
@@ -387,12 +687,13 @@ void CookActors(const TArray<AActor*>& Actors, const FString& CookPath)
 						InstancedStaticMeshComponent = AttachMeshComponent<UHierarchicalInstancedStaticMeshComponent>(CookedActor, CookedMeshComponent, InstanceMesh, Name, GeneratedModelHismComponent->GetComponentTransform());
 					}
 					
+					TArray<FTransform> InstanceTransforms;
+					InstanceTransforms.Reserve(GeneratedModelHismComponent->GetInstanceCount());
 					for (int32 InstanceIndex = 0; InstanceIndex < GeneratedModelHismComponent->GetInstanceCount(); ++InstanceIndex)
 					{
-						FTransform Transform;
-						GeneratedModelHismComponent->GetInstanceTransform(InstanceIndex, Transform);
-						InstancedStaticMeshComponent->AddInstance(Transform);
+						GeneratedModelHismComponent->GetInstanceTransform(InstanceIndex, InstanceTransforms.AddDefaulted_GetRef());
 					}
+					InstancedStaticMeshComponent->AddInstances(InstanceTransforms, false);
 				}
 			}
 		}
@@ -417,8 +718,96 @@ void CookActors(const TArray<AActor*>& Actors, const FString& CookPath)
 
 		CookedActor->SetActorLabel(OldActorLabel);
 
-		GEditor->SelectActor(CookedActor, true, false);
+		if (!IsRunningCommandlet())
+		{
+			GEditor->SelectActor(CookedActor, true, false);
+		}
 	}
+
+public:
+	explicit FVitruvioCooker(const FString& CookPath) : CookPath(CookPath) {}
+
+	void Cook(const TArray<AActor*>& Actors)
+	{
+		const TArray<AActor*> CookableActors = Actors.FilterByPredicate(IsCookable);
+
+		// Progress is weighted roughly by the time spent in the different phases
+		FScopedSlowTask CookTask(5.0f, FText::FromString("Cooking models..."));
+		CookTask.MakeDialog(true);
+
+		CookTask.EnterProgressFrame(0.5f, FText::FromString("Collecting generated models..."));
+		for (AActor* Actor : CookableActors)
+		{
+			CollectActor(Actor);
+		}
+
+		CookTask.EnterProgressFrame(1.0f, FText::FromString("Preparing meshes and textures..."));
+		PreparePayloads();
+
+		// No assets have been created so far, so cancelling here leaves the level untouched
+		if (CookTask.ShouldCancel())
+		{
+			return;
+		}
+
+		CookTask.EnterProgressFrame(0.5f, FText::FromString("Saving textures and materials..."));
+		for (const FTexturePayload& Payload : TexturePayloads)
+		{
+			SaveTexture(Payload);
+		}
+		for (const TPair<UMaterialInstance*, FMaterialParameters>& Material : Materials)
+		{
+			SaveMaterial(Material.Key, Material.Value);
+		}
+
+		CookTask.EnterProgressFrame(2.0f, FText::FromString("Building meshes..."));
+		TArray<UStaticMesh*> NewMeshes;
+		for (FMeshPayload& Payload : MeshPayloads)
+		{
+			if (UStaticMesh* NewMesh = SaveStaticMesh(Payload))
+			{
+				NewMeshes.Add(NewMesh);
+			}
+		}
+
+		// BatchBuild runs the same build and post build steps (render resources, physics meshes, component updates) as the Build triggered by
+		// PostEditChange, calling PostEditChange afterwards would only build every mesh a second time
+		{
+			FScopedSlowTask BuildTask(NewMeshes.Num(), FText::FromString("Building meshes..."));
+			UStaticMesh::BatchBuild(NewMeshes, true, [&BuildTask](UStaticMesh*) {
+				BuildTask.EnterProgressFrame(1);
+				return true;
+			});
+		}
+
+		for (UStaticMesh* NewMesh : NewMeshes)
+		{
+			NewMesh->MarkPackageDirty();
+
+			// Notify asset registry of new asset
+			FAssetRegistryModule::AssetCreated(NewMesh);
+		}
+
+		// Actors which have been replaced before cancelling stay cooked, the remaining ones are left untouched
+		CookTask.EnterProgressFrame(1.0f, FText::FromString("Replacing actors..."));
+		FScopedSlowTask ReplaceTask(CookableActors.Num());
+		for (AActor* Actor : CookableActors)
+		{
+			if (CookTask.ShouldCancel())
+			{
+				break;
+			}
+
+			ReplaceTask.EnterProgressFrame(1);
+			ReplaceActor(Actor);
+		}
+	}
+};
+
+void CookActors(const TArray<AActor*>& Actors, const FString& CookPath)
+{
+	FVitruvioCooker Cooker(CookPath);
+	Cooker.Cook(Actors);
 }
 
 } // namespace
@@ -427,13 +816,22 @@ void CookVitruvioActors(TArray<AActor*> Actors)
 {
 	// If there is a previous cooking already ongoing we have to wait until it has completed. This could happen because the last part
 	// of the cooking process is asynchronous.
-	BlockUntilCookCompleted();
+	if (!BlockUntilCookCompleted())
+	{
+		UE_LOG(LogVitruvioCooker, Warning, TEXT("Previous cooking did not complete within %.0f seconds, skipping cooking."), CookTimeoutSeconds);
+		return;
+	}
 
-	IsCooking = true;
+	SetCooking(true);
 
 	// Wait until all ongoing generate calls to PRT have finished (might happen if we try to cook before all models of a scene
 	// have been generated).
-	VitruvioEditorModule::Get().BlockUntilGenerated();
+	if (!VitruvioEditorModule::Get().BlockUntilGenerated())
+	{
+		UE_LOG(LogVitruvioCooker, Warning, TEXT("Ongoing generate calls did not complete, skipping cooking."));
+		SetCooking(false);
+		return;
+	}
 
 	// Regenerate the selected Actors to make sure we have a model to cook.
 	TArray<AActor*> ActorsToGenerate = Actors.FilterByPredicate([](const AActor* Actor)
@@ -450,14 +848,14 @@ void CookVitruvioActors(TArray<AActor*> Actors)
 
 		if (PickContentPathDlg->ShowModal() == EAppReturnType::Cancel)
 		{
-			IsCooking = false;
+			SetCooking(false);
 			return;
 		}
 		const FString CookPath = PickContentPathDlg->GetPath().ToString();
 
 		CookActors(ActorsToGenerate, CookPath);
 
-		IsCooking = false;
+		SetCooking(false);
 	}));
 
 	for (AActor* Actor : ActorsToGenerate)
@@ -471,4 +869,19 @@ void CookVitruvioActors(TArray<AActor*> Actors)
 			VitruvioBatchActor->GenerateAll(CallbackProxy);
 		}
 	}
+}
+
+bool CookVitruvioActorsUnattended(const TArray<AActor*>& Actors, const FString& CookPath)
+{
+	if (!BlockUntilCookCompleted())
+	{
+		UE_LOG(LogVitruvioCooker, Warning, TEXT("Previous cooking did not complete within %.0f seconds, skipping cooking."), CookTimeoutSeconds);
+		return false;
+	}
+
+	SetCooking(true);
+	CookActors(Actors, CookPath);
+	SetCooking(false);
+
+	return true;
 }
\ No newline at end of file
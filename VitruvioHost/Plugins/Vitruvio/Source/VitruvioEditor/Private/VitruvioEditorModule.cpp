@@ -36,14 +36,20 @@
 #include "VitruvioBatchSubsystem.h"
 #include "Modules/ModuleManager.h"
 #include "VitruvioBlueprintLibrary.h"
+#include "VitruvioLoadSubsystem.h"
 #include "VitruvioStyle.h"
 #include "Widgets/Notifications/SNotificationList.h"
 
 #define LOCTEXT_NAMESPACE "VitruvioEditorModule"
 
+DEFINE_LOG_CATEGORY_STATIC(LogVitruvioEditor, Log, All);
+
 namespace
 {
 
+// Loading only a few components (eg. after placing an actor) completes too quickly for a progress notification
+constexpr int32 MinComponentsForLoadNotification = 16;
+
 bool HasAnyViableVitruvioActor(const TArray<AActor*>& Actors)
 {
 	return Algo::AllOf(Actors, [](AActor* In) { return UVitruvioBlueprintLibrary::CanConvertToVitruvioActor(In); });
@@ -198,6 +204,8 @@ void VitruvioEditorModule::StartupModule()
 	LevelViewportContextMenuVitruvioExtenderDelegateHandle = MenuExtenders.Last().GetHandle();
 
 	GenerateCompletedDelegateHandle = VitruvioModule::Get().OnAllGenerateCompleted.AddRaw(this, &VitruvioEditorModule::OnGenerateCompleted);
+	LoadProgressDelegateHandle = UVitruvioLoadSubsystem::OnLoadProgress.AddRaw(this, &VitruvioEditorModule::OnLoadProgress);
+	LoadCompletedDelegateHandle = UVitruvioLoadSubsystem::OnLoadCompleted.AddRaw(this, &VitruvioEditorModule::OnLoadCompleted);
 
 	FCoreDelegates::OnPostEngineInit.AddRaw(this, &VitruvioEditorModule::OnPostEngineInit);
 
@@ -223,6 +231,8 @@ void VitruvioEditorModule::ShutdownModule()
 
 	FCoreDelegates::OnPostEngineInit.RemoveAll(this);
 	VitruvioModule::Get().OnAllGenerateCompleted.Remove(GenerateCompletedDelegateHandle);
+	UVitruvioLoadSubsystem::OnLoadProgress.Remove(LoadProgressDelegateHandle);
+	UVitruvioLoadSubsystem::OnLoadCompleted.Remove(LoadCompletedDelegateHandle);
 	if (GEditor)
 	{
 		GEditor->GetEditorSubsystem<UImportSubsystem>()->OnAssetReimport.Remove(OnAssetReloadHandle);
@@ -234,19 +244,38 @@ void VitruvioEditorModule::ShutdownModule()
 	FEditorDelegates::PostUndoRedo.Remove(PostUndoRedoDelegate);
 }
 
-void VitruvioEditorModule::BlockUntilGenerated() const
+bool VitruvioEditorModule::BlockUntilGenerated(double StallTimeoutSeconds) const
 {
 	// Wait until all async generate calls to PRT are finished. We want to block the UI and show a modal progress bar.
 	int32 TotalGenerateCalls = VitruvioModule::Get().GetNumGenerateCalls();
 	FScopedSlowTask PRTGenerateCallsTasks(TotalGenerateCalls, FText::FromString("Generating models..."));
 	PRTGenerateCallsTasks.MakeDialog();
-	while (VitruvioModule::Get().IsGenerating() || VitruvioModule::Get().IsLoadingRpks())
-	{
-		FPlatformProcess::Sleep(0); // SwitchToThread
-		int32 CurrentNumGenerateCalls = VitruvioModule::Get().GetNumGenerateCalls();
-		PRTGenerateCallsTasks.EnterProgressFrame(TotalGenerateCalls - CurrentNumGenerateCalls);
+
+	const bool bCompleted = VitruvioModule::Get().WaitUntilIdle(StallTimeoutSeconds, [&PRTGenerateCallsTasks, &TotalGenerateCalls](int32 CurrentNumGenerateCalls) {
+		PRTGenerateCallsTasks.EnterProgressFrame(FMath::Max(0, TotalGenerateCalls - CurrentNumGenerateCalls));
 		TotalGenerateCalls = CurrentNumGenerateCalls;
+	});
+
+	if (!bCompleted)
+	{
+		TArray<FString> StalledActorNames;
+		if (UWorld* World = GEditor->GetEditorWorldContext().World())
+		{
+			for (FActorIterator It(World); It; ++It)
+			{
+				const UVitruvioComponent* VitruvioComponent = It->FindComponentByClass<UVitruvioComponent>();
+				if (VitruvioComponent && VitruvioComponent->HasPendingPrtCalls())
+				{
+					StalledActorNames.Add(It->GetActorLabel());
+				}
+			}
+		}
+
+		UE_LOG(LogVitruvioEditor, Warning, TEXT("Stopped waiting for generate calls (%d remaining) after no progress for %.0f seconds. Waiting for: %s"),
+			   VitruvioModule::Get().GetNumGenerateCalls(), StallTimeoutSeconds, *FString::Join(StalledActorNames, TEXT(", ")));
 	}
+
+	return bCompleted;
 }
 
 void VitruvioEditorModule::OnPostEngineInit()
@@ -289,6 +318,8 @@ void VitruvioEditorModule::OnMapChanged(UWorld* World, EMapChangeType ChangeType
 	if (ChangeType == EMapChangeType::TearDownWorld)
 	{
 		VitruvioModule::Get().GetMeshCache().Empty();
+		VitruvioModule::Get().EmptyMaterialCache();
+		VitruvioModule::Get().GetGenerateResultCache().Empty();
 
 		// Close all open editor of transient meshes generated by Vitruvio to prevent GC issues while loading a new map
 		if (UAssetEditorSubsystem* AssetEditorSubsystem = GEditor->GetEditorSubsystem<UAssetEditorSubsystem>())
@@ -333,7 +364,7 @@ void VitruvioEditorModule::OnMapChanged(UWorld* World, EMapChangeType ChangeType
 	}
 }
 
-void VitruvioEditorModule::OnGenerateCompleted(int NumWarnings, int NumErrors)
+void VitruvioEditorModule::OnGenerateCompleted(int NumWarnings, int NumErrors, const TArray<FLogMessage>& Messages)
 {
 	FString NotificationText(TEXT("Generate Completed"));
 	const FSlateBrush* Image = nullptr;
@@ -350,6 +381,20 @@ void VitruvioEditorModule::OnGenerateCompleted(int NumWarnings, int NumErrors)
 
 	FNotificationInfo Info(FText::FromString(NotificationText));
 
+	// Show the last captured message of the highest level, the full log is linked below
+	const FLogMessage* MostSevereMessage = nullptr;
+	for (const FLogMessage& Message : Messages)
+	{
+		if (!MostSevereMessage || Message.Level >= MostSevereMessage->Level)
+		{
+			MostSevereMessage = &Message;
+		}
+	}
+	if (MostSevereMessage)
+	{
+		Info.SubText = FText::FromString(MostSevereMessage->Message);
+	}
+
 	Info.bFireAndForget = true;
 	Info.ExpireDuration = 5.0f;
 	Info.Image = Image;
@@ -370,6 +415,58 @@ void VitruvioEditorModule::OnGenerateCompleted(int NumWarnings, int NumErrors)
 	NotificationItem = FSlateNotificationManager::Get().AddNotification(Info);
 }
 
+void VitruvioEditorModule::OnLoadProgress(UVitruvioLoadSubsystem* LoadSubsystem, int32 NumCompleted, int32 NumTotal)
+{
+	if (IsRunningCommandlet() || (!LoadNotificationItem.IsValid() && NumTotal < MinComponentsForLoadNotification))
+	{
+		return;
+	}
+
+	const FText Text = FText::FromString(FString::Printf(TEXT("Generating Vitruvio Components (%d/%d)"), NumCompleted, NumTotal));
+	if (const TSharedPtr<SNotificationItem> LoadNotificationItemPinned = LoadNotificationItem.Pin())
+	{
+		LoadNotificationItemPinned->SetText(Text);
+		return;
+	}
+
+	FNotificationInfo Info(Text);
+	Info.bFireAndForget = false;
+	Info.bUseThrobber = true;
+	Info.ExpireDuration = 2.0f;
+
+	// clang-format off
+	Info.ButtonDetails.Add(FNotificationButtonInfo(FText::FromString("Cancel"),
+		FText::FromString("Stops generating the remaining components. Cancelled components are generated as soon as they are changed."),
+		FSimpleDelegate::CreateLambda([WeakLoadSubsystem = TWeakObjectPtr<UVitruvioLoadSubsystem>(LoadSubsystem)]()
+		{
+			if (WeakLoadSubsystem.IsValid())
+			{
+				WeakLoadSubsystem->Cancel();
+			}
+		}), SNotificationItem::CS_Pending));
+	// clang-format on
+
+	LoadNotificationItem = FSlateNotificationManager::Get().AddNotification(Info);
+	if (const TSharedPtr<SNotificationItem> LoadNotificationItemPinned = LoadNotificationItem.Pin())
+	{
+		LoadNotificationItemPinned->SetCompletionState(SNotificationItem::CS_Pending);
+	}
+}
+
+void VitruvioEditorModule::OnLoadCompleted(UVitruvioLoadSubsystem* LoadSubsystem, bool bCancelled)
+{
+	if (const TSharedPtr<SNotificationItem> LoadNotificationItemPinned = LoadNotificationItem.Pin())
+	{
+		const FString Text = bCancelled ? FString::Printf(TEXT("Cancelled after %d of %d Vitruvio Components"), LoadSubsystem->GetNumCompleted(),
+														  LoadSubsystem->GetNumTotal())
+										: FString::Printf(TEXT("Generated %d Vitruvio Components"), LoadSubsystem->GetNumTotal());
+		LoadNotificationItemPinned->SetText(FText::FromString(Text));
+		LoadNotificationItemPinned->SetCompletionState(bCancelled ? SNotificationItem::CS_Fail : SNotificationItem::CS_Success);
+		LoadNotificationItemPinned->ExpireAndFadeout();
+	}
+	LoadNotificationItem.Reset();
+}
+
 #undef LOCTEXT_NAMESPACE
 
 IMPLEMENT_MODULE(VitruvioEditorModule, VitruvioEditor)
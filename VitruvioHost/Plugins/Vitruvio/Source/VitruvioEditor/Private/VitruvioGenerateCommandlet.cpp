@@ -0,0 +1,589 @@
+/* Copyright 2024 Esri
+ *
+ * Licensed under the Apache License Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "VitruvioGenerateCommandlet.h"
+
+#include "VitruvioCooker.h"
+
+#include "Containers/Ticker.h"
+#include "Dom/JsonObject.h"
+#include "Editor.h"
+#include "EditorLoadingAndSavingUtils.h"
+#include "EngineUtils.h"
+#include "FileHelpers.h"
+#include "GenerateCompletedCallbackProxy.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "UObject/StrongObjectPtr.h"
+#include "VitruvioBatchActor.h"
+#include "VitruvioBatchSubsystem.h"
+#include "VitruvioComponent.h"
+#include "VitruvioLoadSubsystem.h"
+#include "VitruvioModule.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogVitruvioGenerateCommandlet, Log, All);
+
+namespace
+{
+
+// Wake up at least this often to tick the world even if no PRT task completes
+constexpr uint32 MaxWaitMilliseconds = 100;
+
+enum class EGenerateJobStatus
+{
+	Pending,
+	Generating,
+	Generated,
+	Failed,
+	TimedOut
+};
+
+const TCHAR* ToString(EGenerateJobStatus Status)
+{
+	switch (Status)
+	{
+	case EGenerateJobStatus::Pending:
+		return TEXT("Pending");
+	case EGenerateJobStatus::Generating:
+		return TEXT("Generating");
+	case EGenerateJobStatus::Generated:
+		return TEXT("Generated");
+	case EGenerateJobStatus::Failed:
+		return TEXT("Failed");
+	case EGenerateJobStatus::TimedOut:
+		return TEXT("TimedOut");
+	default:
+		return TEXT("Unknown");
+	}
+}
+
+/** Either a single (not batch generated) Vitruvio component or a batch actor which generates all its tiles. */
+struct FGenerateJob
+{
+	AActor* Actor = nullptr;
+	UVitruvioComponent* VitruvioComponent = nullptr;
+	AVitruvioBatchActor* VitruvioBatchActor = nullptr;
+
+	EGenerateJobStatus Status = EGenerateJobStatus::Pending;
+	FString Message;
+
+	double StartTime = 0.0;
+	double CompletedTime = 0.0;
+	bool bCompleted = false;
+
+	TArray<FIntPoint> TilesWithoutModel;
+
+	TStrongObjectPtr<UGenerateCompletedCallbackProxy> CallbackProxy;
+};
+
+using FGenerateJobRef = TSharedRef<FGenerateJob>;
+
+UWorld* LoadWorld(const FString& MapName)
+{
+	UPackage* MapPackage = LoadPackage(nullptr, *MapName, LOAD_None);
+	UWorld* World = MapPackage ? UWorld::FindWorldInPackage(MapPackage) : nullptr;
+	if (!World)
+	{
+		return nullptr;
+	}
+
+	World->AddToRoot();
+	World->WorldType = EWorldType::Editor;
+
+	if (!World->bIsWorldInitialized)
+	{
+		UWorld::InitializationValues InitializationValues;
+		InitializationValues.RequiresHitProxies(false)
+			.ShouldSimulatePhysics(false)
+			.EnableTraceCollision(false)
+			.CreateNavigation(false)
+			.CreateAISystem(false)
+			.AllowAudioPlayback(false)
+			.CreatePhysicsScene(true);
+		World->InitWorld(InitializationValues);
+	}
+
+	World->UpdateWorldComponents(true, false);
+
+	// The cooker and the Vitruvio editor utilities operate on the editor world
+	GEditor->GetEditorWorldContext().SetCurrentWorld(World);
+	GWorld = World;
+
+	return World;
+}
+
+// Undoes LoadWorld, the world and everything generated in it can then be garbage collected
+void ReleaseWorld(UWorld* World, UWorld* PreviousWorld)
+{
+	GEditor->GetEditorWorldContext().SetCurrentWorld(PreviousWorld);
+	GWorld = PreviousWorld;
+
+	World->DestroyWorld(false);
+	World->RemoveFromRoot();
+}
+
+void TickWorld(UWorld* World, float DeltaSeconds)
+{
+	// Generate results are delivered to the game thread using tasks and applied while the Vitruvio components and batch actors tick
+	FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+	World->Tick(LEVELTICK_ViewportsOnly, DeltaSeconds);
+	FTSTicker::GetCoreTicker().Tick(DeltaSeconds);
+}
+
+TArray<FGenerateJobRef> CollectJobs(UWorld* World)
+{
+	TArray<FGenerateJobRef> Jobs;
+
+	for (TActorIterator<AActor> It(World); It; ++It)
+	{
+		UVitruvioComponent* VitruvioComponent = It->FindComponentByClass<UVitruvioComponent>();
+		if (VitruvioComponent && !VitruvioComponent->IsBatchGenerated())
+		{
+			FGenerateJobRef Job = MakeShared<FGenerateJob>();
+			Job->Actor = *It;
+			Job->VitruvioComponent = VitruvioComponent;
+			Jobs.Add(Job);
+		}
+	}
+
+	UVitruvioBatchSubsystem* BatchSubsystem = World->GetSubsystem<UVitruvioBatchSubsystem>();
+	if (BatchSubsystem && BatchSubsystem->HasRegisteredVitruvioComponents())
+	{
+		AVitruvioBatchActor* VitruvioBatchActor = BatchSubsystem->GetBatchActor();
+		if (VitruvioBatchActor->GetNumTiles() > 0)
+		{
+			FGenerateJobRef Job = MakeShared<FGenerateJob>();
+			Job->Actor = VitruvioBatchActor;
+			Job->VitruvioBatchActor = VitruvioBatchActor;
+			Jobs.Add(Job);
+		}
+	}
+
+	return Jobs;
+}
+
+bool WaitForAttributes(UWorld* World, const TArray<FGenerateJobRef>& Jobs, double StallTimeoutSeconds)
+{
+	const VitruvioModule& Vitruvio = VitruvioModule::Get();
+
+	const auto IsEvaluatingAttributes = [](const FGenerateJobRef& Job) {
+		return Job->VitruvioComponent && Job->VitruvioComponent->HasValidInputData() && !Job->VitruvioComponent->GetAttributesReady();
+	};
+
+	double LastProgressTime = FPlatformTime::Seconds();
+	double LastTickTime = LastProgressTime;
+	while (Vitruvio.IsLoadingRpks() || Jobs.ContainsByPredicate(IsEvaluatingAttributes))
+	{
+		const double TickTime = FPlatformTime::Seconds();
+		TickWorld(World, static_cast<float>(TickTime - LastTickTime));
+		LastTickTime = TickTime;
+
+		if (Vitruvio.WaitForTaskCompleted(MaxWaitMilliseconds))
+		{
+			LastProgressTime = FPlatformTime::Seconds();
+		}
+		else if (StallTimeoutSeconds >= 0.0 && FPlatformTime::Seconds() - LastProgressTime > StallTimeoutSeconds)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool StartJob(const FGenerateJobRef& Job)
+{
+	Job->StartTime = FPlatformTime::Seconds();
+
+	if (Job->VitruvioComponent && !Job->VitruvioComponent->HasValidInputData())
+	{
+		Job->Status = EGenerateJobStatus::Failed;
+		Job->Message = TEXT("Missing initial shape or rule package");
+		return false;
+	}
+
+	Job->Status = EGenerateJobStatus::Generating;
+	Job->CallbackProxy.Reset(NewObject<UGenerateCompletedCallbackProxy>());
+	Job->CallbackProxy->OnGenerateCompleted.AddLambda([Job]() {
+		Job->bCompleted = true;
+		Job->CompletedTime = FPlatformTime::Seconds();
+	});
+
+	if (Job->VitruvioBatchActor)
+	{
+		Job->VitruvioBatchActor->GenerateAll(Job->CallbackProxy.Get());
+	}
+	else
+	{
+		Job->VitruvioComponent->Generate(Job->CallbackProxy.Get());
+	}
+
+	return true;
+}
+
+void FinishJob(const FGenerateJobRef& Job)
+{
+	// The callback proxy references the job, release it to break the cycle
+	Job->CallbackProxy.Reset();
+
+	if (Job->VitruvioBatchActor)
+	{
+		Job->TilesWithoutModel = Job->VitruvioBatchActor->GetTilesWithoutModel();
+		if (Job->TilesWithoutModel.IsEmpty())
+		{
+			Job->Status = EGenerateJobStatus::Generated;
+		}
+		else
+		{
+			Job->Status = EGenerateJobStatus::Failed;
+			Job->Message = FString::Printf(TEXT("%d of %d tiles have no generated model"), Job->TilesWithoutModel.Num(),
+										   Job->VitruvioBatchActor->GetNumTiles());
+		}
+	}
+	else if (Job->VitruvioComponent->HasGeneratedModel())
+	{
+		Job->Status = EGenerateJobStatus::Generated;
+	}
+	else
+	{
+		Job->Status = EGenerateJobStatus::Failed;
+		Job->Message = TEXT("No model has been generated");
+	}
+}
+
+void GenerateJobs(UWorld* World, const TArray<FGenerateJobRef>& Jobs, int32 MaxJobsInFlight, double StallTimeoutSeconds)
+{
+	const VitruvioModule& Vitruvio = VitruvioModule::Get();
+
+	TArray<FGenerateJobRef> JobsInFlight;
+	int32 NextJobIndex = 0;
+
+	double LastProgressTime = FPlatformTime::Seconds();
+	double LastTickTime = LastProgressTime;
+	while (NextJobIndex < Jobs.Num() || !JobsInFlight.IsEmpty())
+	{
+		// Only start new jobs within the CPU budget
+		while (NextJobIndex < Jobs.Num() && JobsInFlight.Num() < MaxJobsInFlight)
+		{
+			const FGenerateJobRef& Job = Jobs[NextJobIndex++];
+			if (StartJob(Job))
+			{
+				JobsInFlight.Add(Job);
+			}
+		}
+
+		const double TickTime = FPlatformTime::Seconds();
+		TickWorld(World, static_cast<float>(TickTime - LastTickTime));
+		LastTickTime = TickTime;
+
+		for (int32 JobIndex = JobsInFlight.Num() - 1; JobIndex >= 0; --JobIndex)
+		{
+			if (JobsInFlight[JobIndex]->bCompleted)
+			{
+				FinishJob(JobsInFlight[JobIndex]);
+				JobsInFlight.RemoveAtSwap(JobIndex, 1, EAllowShrinking::No);
+				LastProgressTime = FPlatformTime::Seconds();
+			}
+		}
+
+		if (Vitruvio.IsGenerating() || Vitruvio.IsLoadingRpks())
+		{
+			if (Vitruvio.WaitForTaskCompleted(MaxWaitMilliseconds))
+			{
+				LastProgressTime = FPlatformTime::Seconds();
+			}
+		}
+
+		if (StallTimeoutSeconds >= 0.0 && FPlatformTime::Seconds() - LastProgressTime > StallTimeoutSeconds)
+		{
+			UE_LOG(LogVitruvioGenerateCommandlet, Error, TEXT("Stopped generating after no progress for %.0f seconds."), StallTimeoutSeconds);
+
+			for (const FGenerateJobRef& Job : JobsInFlight)
+			{
+				Job->CallbackProxy.Reset();
+				Job->Status = EGenerateJobStatus::TimedOut;
+				Job->Message = TEXT("Generation did not complete within the stall timeout");
+			}
+			for (; NextJobIndex < Jobs.Num(); ++NextJobIndex)
+			{
+				Jobs[NextJobIndex]->Status = EGenerateJobStatus::TimedOut;
+				Jobs[NextJobIndex]->Message = TEXT("Generation has not been started because of a previous stall");
+			}
+			return;
+		}
+	}
+}
+
+bool SaveDirtyPackages()
+{
+	TArray<UPackage*> DirtyPackages;
+	FEditorFileUtils::GetDirtyWorldPackages(DirtyPackages);
+	FEditorFileUtils::GetDirtyContentPackages(DirtyPackages);
+
+	return DirtyPackages.IsEmpty() || UEditorLoadingAndSavingUtils::SavePackages(DirtyPackages, true);
+}
+
+TSharedRef<FJsonObject> CreateJobSummary(const FGenerateJob& Job)
+{
+	TSharedRef<FJsonObject> JobSummary = MakeShared<FJsonObject>();
+	JobSummary->SetStringField(TEXT("actor"), Job.Actor->GetActorLabel());
+	JobSummary->SetStringField(TEXT("path"), Job.Actor->GetPathName());
+	JobSummary->SetStringField(TEXT("type"), Job.VitruvioBatchActor ? TEXT("BatchActor") : TEXT("Component"));
+	JobSummary->SetStringField(TEXT("status"), ToString(Job.Status));
+
+	if (Job.bCompleted)
+	{
+		JobSummary->SetNumberField(TEXT("seconds"), Job.CompletedTime - Job.StartTime);
+	}
+	if (!Job.Message.IsEmpty())
+	{
+		JobSummary->SetStringField(TEXT("message"), Job.Message);
+	}
+
+	if (Job.VitruvioBatchActor)
+	{
+		JobSummary->SetNumberField(TEXT("numTiles"), Job.VitruvioBatchActor->GetNumTiles());
+		JobSummary->SetNumberField(TEXT("numComponents"), Job.VitruvioBatchActor->GetVitruvioComponents().Num());
+
+		TArray<TSharedPtr<FJsonValue>> FailedTiles;
+		for (const FIntPoint& Tile : Job.TilesWithoutModel)
+		{
+			FailedTiles.Add(MakeShared<FJsonValueString>(Tile.ToString()));
+		}
+		JobSummary->SetArrayField(TEXT("failedTiles"), FailedTiles);
+	}
+
+	return JobSummary;
+}
+
+bool WriteSummary(const FString& SummaryPath, const TSharedRef<FJsonObject>& Summary)
+{
+	FString SummaryString;
+	const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&SummaryString);
+	if (!FJsonSerializer::Serialize(Summary, Writer))
+	{
+		return false;
+	}
+
+	return FFileHelper::SaveStringToFile(SummaryString, *SummaryPath);
+}
+
+} // namespace
+
+UVitruvioGenerateCommandlet::UVitruvioGenerateCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+	ShowErrorCount = true;
+
+	HelpDescription = TEXT("Generates all Vitruvio models of a map and optionally cooks them to assets.");
+	HelpUsage = TEXT("-run=VitruvioGenerate -Map=<MapPackage> [-Cook] [-CookPath=<ContentPath>] [-Save] [-MaxThreads=<N>] "
+					 "[-StallTimeout=<Seconds>] [-Summary=<File>]");
+}
+
+FVitruvioGenerateOptions UVitruvioGenerateCommandlet::ParseOptions(const FString& Params)
+{
+	TArray<FString> Tokens;
+	TArray<FString> Switches;
+	TMap<FString, FString> ParamValues;
+	ParseCommandLine(*Params, Tokens, Switches, ParamValues);
+
+	FVitruvioGenerateOptions Options;
+
+	if (const FString* Map = ParamValues.Find(TEXT("Map")))
+	{
+		Options.MapName = *Map;
+	}
+	if (const FString* CookPath = ParamValues.Find(TEXT("CookPath")))
+	{
+		Options.CookPath = *CookPath;
+	}
+	if (const FString* SummaryPath = ParamValues.Find(TEXT("Summary")))
+	{
+		Options.SummaryPath = *SummaryPath;
+	}
+	else
+	{
+		Options.SummaryPath = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Vitruvio"), TEXT("GenerateSummary.json"));
+	}
+	if (const FString* MaxThreads = ParamValues.Find(TEXT("MaxThreads")))
+	{
+		Options.MaxThreads = FCString::Atoi(**MaxThreads);
+	}
+	if (const FString* StallTimeout = ParamValues.Find(TEXT("StallTimeout")))
+	{
+		Options.StallTimeoutSeconds = FCString::Atod(**StallTimeout);
+	}
+
+	Options.bCook = Switches.Contains(TEXT("Cook"));
+	Options.bSave = Switches.Contains(TEXT("Save"));
+
+	return Options;
+}
+
+FVitruvioGenerateThreadLimits UVitruvioGenerateCommandlet::SplitThreads(int32 MaxThreads, int32 NumJobs)
+{
+	const int32 NumThreads = FMath::Max(1, MaxThreads);
+
+	FVitruvioGenerateThreadLimits Limits;
+	Limits.MaxJobsInFlight = FMath::Clamp(NumJobs, 1, NumThreads);
+	Limits.MaxWorkerThreads = NumThreads / Limits.MaxJobsInFlight;
+	return Limits;
+}
+
+int32 UVitruvioGenerateCommandlet::Main(const FString& Params)
+{
+	const double StartTime = FPlatformTime::Seconds();
+
+	const FVitruvioGenerateOptions Options = ParseOptions(Params);
+	const int32 MaxThreads = Options.MaxThreads > 0 ? Options.MaxThreads : FPlatformMisc::NumberOfCores();
+	FVitruvioGenerateThreadLimits ThreadLimits;
+
+	TArray<FString> Errors;
+	TArray<FGenerateJobRef> Jobs;
+	double GenerateSeconds = 0.0;
+	double CookSeconds = 0.0;
+
+	UWorld* PreviousWorld = GEditor->GetEditorWorldContext().World();
+	UWorld* World = nullptr;
+	if (Options.MapName.IsEmpty())
+	{
+		Errors.Add(TEXT("No map given, use -Map=<MapPackage>"));
+	}
+	else if (!VitruvioModule::Get().InitializeForCommandlet())
+	{
+		Errors.Add(TEXT("Could not initialize PRT"));
+	}
+	else if (!(World = LoadWorld(Options.MapName)))
+	{
+		Errors.Add(FString::Printf(TEXT("Could not load map %s"), *Options.MapName));
+	}
+	else
+	{
+		// Let all Vitruvio components initialize and register with the batch subsystem before collecting them
+		TickWorld(World, 0.0f);
+		Jobs = CollectJobs(World);
+
+		// Concurrent jobs and the worker threads of their generate calls multiply, both are limited so that MaxThreads is not exceeded
+		ThreadLimits = SplitThreads(MaxThreads, Jobs.Num());
+		VitruvioModule::Get().SetMaxWorkerThreads(ThreadLimits.MaxWorkerThreads);
+
+		UE_LOG(LogVitruvioGenerateCommandlet, Display,
+			   TEXT("Generating %d Vitruvio actors of %s, %d concurrently using %d worker threads."), Jobs.Num(), *Options.MapName,
+			   ThreadLimits.MaxJobsInFlight, ThreadLimits.MaxWorkerThreads);
+
+		const double GenerateStartTime = FPlatformTime::Seconds();
+
+		// Components generate automatically once their attributes have been evaluated, which would invalidate our generate calls
+		if (!WaitForAttributes(World, Jobs, Options.StallTimeoutSeconds))
+		{
+			UE_LOG(LogVitruvioGenerateCommandlet, Warning, TEXT("Attribute evaluation did not complete within %.0f seconds."),
+				   Options.StallTimeoutSeconds);
+		}
+
+		// All components are generated by the jobs below, the generates scheduled after loading the map are not needed anymore
+		if (UVitruvioLoadSubsystem* LoadSubsystem = World->GetSubsystem<UVitruvioLoadSubsystem>())
+		{
+			LoadSubsystem->Cancel();
+		}
+
+		GenerateJobs(World, Jobs, ThreadLimits.MaxJobsInFlight, Options.StallTimeoutSeconds);
+		GenerateSeconds = FPlatformTime::Seconds() - GenerateStartTime;
+
+		if (Options.bCook)
+		{
+			TArray<AActor*> ActorsToCook;
+			for (const FGenerateJobRef& Job : Jobs)
+			{
+				if (Job->Status == EGenerateJobStatus::Generated)
+				{
+					ActorsToCook.Add(Job->Actor);
+				}
+			}
+
+			const double CookStartTime = FPlatformTime::Seconds();
+			if (!ActorsToCook.IsEmpty() && !CookVitruvioActorsUnattended(ActorsToCook, Options.CookPath))
+			{
+				Errors.Add(TEXT("Cooking has been skipped because a previous cook did not complete"));
+			}
+			CookSeconds = FPlatformTime::Seconds() - CookStartTime;
+		}
+
+		if ((Options.bCook || Options.bSave) && !SaveDirtyPackages())
+		{
+			Errors.Add(TEXT("Could not save all modified packages"));
+		}
+	}
+
+	TArray<TSharedPtr<FJsonValue>> JobSummaries;
+	int32 NumFailedJobs = 0;
+	for (const FGenerateJobRef& Job : Jobs)
+	{
+		if (Job->Status != EGenerateJobStatus::Generated)
+		{
+			++NumFailedJobs;
+			UE_LOG(LogVitruvioGenerateCommandlet, Error, TEXT("%s: %s"), *Job->Actor->GetActorLabel(), *Job->Message);
+		}
+		JobSummaries.Add(MakeShared<FJsonValueObject>(CreateJobSummary(*Job)));
+	}
+
+	TArray<TSharedPtr<FJsonValue>> ErrorValues;
+	for (const FString& Error : Errors)
+	{
+		UE_LOG(LogVitruvioGenerateCommandlet, Error, TEXT("%s"), *Error);
+		ErrorValues.Add(MakeShared<FJsonValueString>(Error));
+	}
+
+	const bool bSuccess = Errors.IsEmpty() && NumFailedJobs == 0;
+
+	TSharedRef<FJsonObject> Summary = MakeShared<FJsonObject>();
+	Summary->SetStringField(TEXT("map"), Options.MapName);
+	Summary->SetBoolField(TEXT("success"), bSuccess);
+	Summary->SetNumberField(TEXT("maxThreads"), MaxThreads);
+	Summary->SetNumberField(TEXT("maxJobsInFlight"), ThreadLimits.MaxJobsInFlight);
+	Summary->SetNumberField(TEXT("maxWorkerThreads"), ThreadLimits.MaxWorkerThreads);
+	Summary->SetNumberField(TEXT("totalSeconds"), FPlatformTime::Seconds() - StartTime);
+	Summary->SetNumberField(TEXT("generateSeconds"), GenerateSeconds);
+	Summary->SetNumberField(TEXT("cookSeconds"), CookSeconds);
+	Summary->SetBoolField(TEXT("cooked"), Options.bCook);
+	Summary->SetNumberField(TEXT("numJobs"), Jobs.Num());
+	Summary->SetNumberField(TEXT("numFailed"), NumFailedJobs);
+	Summary->SetArrayField(TEXT("jobs"), JobSummaries);
+	Summary->SetArrayField(TEXT("errors"), ErrorValues);
+
+	const bool bSummaryWritten = WriteSummary(Options.SummaryPath, Summary);
+	if (bSummaryWritten)
+	{
+		UE_LOG(LogVitruvioGenerateCommandlet, Display, TEXT("Generated %d of %d Vitruvio actors in %.1f seconds, summary written to %s"),
+			   Jobs.Num() - NumFailedJobs, Jobs.Num(), GenerateSeconds, *Options.SummaryPath);
+	}
+	else
+	{
+		UE_LOG(LogVitruvioGenerateCommandlet, Error, TEXT("Could not write summary to %s"), *Options.SummaryPath);
+	}
+
+	// The jobs reference actors of the world
+	Jobs.Empty();
+	if (World)
+	{
+		ReleaseWorld(World, PreviousWorld);
+	}
+
+	return bSuccess && bSummaryWritten ? 0 : 1;
+}
@@ -16,3 +16,13 @@
 #pragma once
 
 void CookVitruvioActors(TArray<AActor*> Actors);
+
+/**
+ * Cooks the already generated models of the given Actors to assets in CookPath without regenerating them and without any user
+ * interaction, eg. from a commandlet. The created assets and the modified level are marked dirty but not saved.
+ *
+ * @param Actors	The Actors to cook, Actors which are not cookable are ignored
+ * @param CookPath	The content path in which the cooked assets are created (eg. /Game/Cooked)
+ * @return whether cooking has been performed
+ */
+bool CookVitruvioActorsUnattended(const TArray<AActor*>& Actors, const FString& CookPath);
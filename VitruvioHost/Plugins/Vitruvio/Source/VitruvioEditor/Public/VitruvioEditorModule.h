@@ -18,13 +18,22 @@
 #include "Modules/ModuleManager.h"
 
 class UVitruvioComponent;
+class UVitruvioLoadSubsystem;
+struct FLogMessage;
 
 class VitruvioEditorModule final : public IModuleInterface
 {
 public:
 	void StartupModule() override;
 	void ShutdownModule() override;
-	void BlockUntilGenerated() const;
+
+	/**
+	 * Blocks and shows a modal progress dialog until all ongoing generate calls have completed.
+	 *
+	 * @param StallTimeoutSeconds	Stop waiting if no generate call has completed within this time, a negative value waits indefinitely
+	 * @return true if all generate calls have completed or false if waiting has been stopped
+	 */
+	bool BlockUntilGenerated(double StallTimeoutSeconds = 120.0) const;
 
 	static VitruvioEditorModule& Get()
 	{
@@ -35,12 +44,17 @@ private:
 	void OnPostEngineInit();
 	void PostUndoRedo();
 	void OnMapChanged(UWorld* World, EMapChangeType ChangeType);
-	void OnGenerateCompleted(int NumWarnings, int NumErrors);
+	void OnGenerateCompleted(int NumWarnings, int NumErrors, const TArray<FLogMessage>& Messages);
+	void OnLoadProgress(UVitruvioLoadSubsystem* LoadSubsystem, int32 NumCompleted, int32 NumTotal);
+	void OnLoadCompleted(UVitruvioLoadSubsystem* LoadSubsystem, bool bCancelled);
 
 	TWeakPtr<SNotificationItem> NotificationItem;
+	TWeakPtr<SNotificationItem> LoadNotificationItem;
 
 	FDelegateHandle LevelViewportContextMenuVitruvioExtenderDelegateHandle;
 	FDelegateHandle GenerateCompletedDelegateHandle;
+	FDelegateHandle LoadProgressDelegateHandle;
+	FDelegateHandle LoadCompletedDelegateHandle;
 	FDelegateHandle OnAssetReloadHandle;
 	FDelegateHandle MapChangedHandle;
 	FDelegateHandle PostUndoRedoDelegate;
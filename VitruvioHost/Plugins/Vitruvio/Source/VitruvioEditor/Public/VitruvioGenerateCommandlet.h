@@ -0,0 +1,76 @@
+/* Copyright 2024 Esri
+ *
+ * Licensed under the Apache License Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "Commandlets/Commandlet.h"
+
+#include "VitruvioGenerateCommandlet.generated.h"
+
+/** Options of the generate commandlet, see UVitruvioGenerateCommandlet. */
+struct FVitruvioGenerateOptions
+{
+	FString MapName;
+	FString CookPath = TEXT("/Game/VitruvioCooked");
+	FString SummaryPath;
+	bool bCook = false;
+	bool bSave = false;
+
+	// Limits the total number of threads used for generating, a value <= 0 uses all cores
+	int32 MaxThreads = 0;
+	double StallTimeoutSeconds = 120.0;
+};
+
+/** How the thread limit of the generate commandlet is split, the product of both limits does not exceed the thread limit. */
+struct FVitruvioGenerateThreadLimits
+{
+	// Number of actors which are generated concurrently
+	int32 MaxJobsInFlight = 1;
+
+	// Number of PRT worker threads shared by the concurrent generate calls, also limits the concurrently generated tiles of a batch actor
+	int32 MaxWorkerThreads = 1;
+};
+
+/**
+ * Opens a map, generates all Vitruvio components and batch tiles and optionally cooks the generated models to assets. A JSON summary
+ * with the timings and failures is written at the end. Intended to run unattended on build machines, eg.
+ *
+ * UnrealEditor-Cmd Project.uproject -run=VitruvioGenerate -Map=/Game/Maps/City -Cook -CookPath=/Game/Cooked -MaxThreads=8
+ *     -Summary=Saved/Vitruvio/Summary.json -StallTimeout=300 -nullrhi -unattended
+ */
+UCLASS()
+class UVitruvioGenerateCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UVitruvioGenerateCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+	/**
+	 * Parses the commandlet parameters, eg. "-Map=/Game/Maps/City -Cook -MaxThreads=8".
+	 */
+	static FVitruvioGenerateOptions ParseOptions(const FString& Params);
+
+	/**
+	 * Splits the given thread limit between concurrently generated actors and PRT worker threads. Many jobs favour concurrent actors, since
+	 * a single PRT call does not scale linearly with its worker threads, while a few jobs get more worker threads each.
+	 *
+	 * @param MaxThreads	The maximum number of threads, at least one thread is used
+	 * @param NumJobs		The number of actors to generate
+	 */
+	static FVitruvioGenerateThreadLimits SplitThreads(int32 MaxThreads, int32 NumJobs);
+};
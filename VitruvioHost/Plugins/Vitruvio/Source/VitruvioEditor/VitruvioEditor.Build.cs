@@ -56,6 +56,7 @@ public class VitruvioEditor : ModuleRules
 				"AppFramework",
 				"UMGEditor",
 				"Vitruvio",
+				"Json",
 			}
 		);
 	}